@@ -331,6 +331,10 @@ private:
     MemoryBlockInternal *m_stateNext = nullptr;
     //! \brief State type for the sorted list to which this block belongs, if between lists type is stateCount
     State m_stateListType = State::stateCount;
+    //! \brief Frame tracker index of the retirement queue this block is submitted to
+    uint32_t m_retireIndex = 0;
+    //! \brief Tracker ID which orders this block within its retirement queue
+    uint32_t m_retireTrackerId = m_invalidTrackerId;
 };
 
 //! \brief Describes a block of memory in a heap.
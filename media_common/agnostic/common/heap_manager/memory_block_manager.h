@@ -243,35 +243,86 @@ private:
     virtual MOS_STATUS RegisterOsInterface(PMOS_INTERFACE osInterface);
 
     //!
-    //! \brief  Determines whether or not space is available, if not enough space returns
-    //!         the amount short in \a spaceNeeded
-    //! \param  [in] sortedSizes
-    //!         Requested block sizes sorted in decending order.
+    //! \brief  Sets up memory blocks for the requested space
+    //! \details Requests are served largest first from \see m_sortedSizes. If any of them
+    //!          does not fit, all blocks acquired by this call are released again and the
+    //!          amount short is returned in \a spaceNeeded.
     //! \param  [in] params
     //!         Parameters describing the requested space
+    //! \param  [out] blocks
+    //!         A vector containing the memory blocks allocated
     //! \param  [out] spaceNeeded
     //!         Amount of space that the heap(s) are short of to complete space acquisition
     //! \return MOS_STATUS
     //!         MOS_STATUS_SUCCESS if success, else fail reason
     //!
-    MOS_STATUS IsSpaceAvailable(
+    MOS_STATUS AllocateSpace(
         AcquireParams &params,
+        std::vector<MemoryBlock> &blocks,
         uint32_t &spaceNeeded);
 
     //!
-    //! \brief  Sets up memory blocks for the requested space
-    //! \param  [in] sortedSizes
-    //!         Requested block sizes sorted in decending order with original index saved from params.
-    //! \param  [in] params
-    //!         Parameters describing the requested space
-    //! \param  [out] blocks
-    //!         A vector containing the memory blocks allocated
+    //! \brief  Finds a free block of at least \a size bytes
+    //! \details Rounds \a size up to the next free bin so that any block of the first
+    //!          non-empty bin found through the bin bitmaps fits. Only if there is none,
+    //!          the bin of \a size itself is searched.
+    //! \param  [in] size
+    //!         Aligned size of the memory requested
+    //! \return MemoryBlockInternal*
+    //!         Free block if found, nullptr if not
+    //!
+    MemoryBlockInternal *FindFreeBlock(uint32_t size);
+
+    //!
+    //! \brief  Gets the free bin for blocks of \a size
+    //! \param  [in] size
+    //!         Block size, must not be 0
+    //! \param  [out] fl
+    //!         First level index, the power of two range of \a size
+    //! \param  [out] sl
+    //!         Second level index, the subdivision within the power of two range
+    //!
+    void GetFreeBinIndex(uint32_t size, uint32_t &fl, uint32_t &sl);
+
+    //!
+    //! \brief  Returns a free block to the free bins, merged with its free neighbours
+    //! \param  [in] block
+    //!         Free block already added to the free bins
     //! \return MOS_STATUS
     //!         MOS_STATUS_SUCCESS if success, else fail reason
     //!
-    MOS_STATUS AllocateSpace(
-        AcquireParams &params,
-        std::vector<MemoryBlock> &blocks);
+    MOS_STATUS ConsolidateFreeBlock(MemoryBlockInternal *block);
+
+    //!
+    //! \brief  Frees a block allocated by the current AllocateSpace call
+    //! \param  [in] block
+    //!         Allocated block to be returned to the free bins
+    //! \return MOS_STATUS
+    //!         MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS ReleaseAcquiredBlock(MemoryBlockInternal *block);
+
+    //!
+    //! \brief  Retires the expired blocks at the head of a retirement queue
+    //! \param  [in] index
+    //!         Frame tracker index of the queue
+    //! \param  [in] currTrackerId
+    //!         Latest tracker ID, only used without tracker producer
+    //! \param  [out] blocksUpdated
+    //!         Set to true if any block is retired
+    //! \return MOS_STATUS
+    //!         MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS RetireBlocks(uint32_t index, uint32_t currTrackerId, bool &blocksUpdated);
+
+    //!
+    //! \brief  Determines whether tracker ID \a a is issued before \a b
+    //! \details Tracker producer counters wrap around, the tracker data is compared as is.
+    //!
+    bool IsTrackerIdBefore(uint32_t a, uint32_t b)
+    {
+        return m_useProducer ? (int32_t)(a - b) < 0 : a < b;
+    }
 
     //!
     //! \brief  Sets up memory blocks for the requested space
@@ -349,14 +400,14 @@ private:
     MemoryBlockInternal* GetBlockFromPool();
 
     //!
-    //! \brief  Removes all blocks with heaps matching \a heapId from the sorted block pool for \a state. \see m_sortedBlockList
-    //! \param  [in] heapId
+    //! \brief  Removes all blocks of \a heap from the sorted block lists. \see m_sortedBlockList
+    //! \param  [in] heap
     //!         Heap whose blocks should be removed
     //! \return MOS_STATUS
     //!         MOS_STATUS_SUCCESS if success, else fail reason
     //!
     MOS_STATUS RemoveHeapFromSortedBlockList(
-        uint32_t heapId);
+        HeapWithAdjacencyBlockList *heap);
 
     //!
     //! \brief  Merges two contiguous blocks into one.
@@ -411,6 +462,12 @@ private:
     static const uint16_t m_heapAlignment = MOS_PAGE_SIZE;
     //! \brief Number of submissions before a refresh, currently fixed
     static const uint16_t m_numSubmissionsForRefresh = 128;
+    //! \brief Number of first level free bins, one per power of two of the block size
+    static const uint32_t m_freeBinFlCount = 32;
+    //! \brief Log2 of the number of second level free bins per power of two
+    static const uint32_t m_freeBinSlLog2 = 2;
+    //! \brief Number of second level free bins per power of two
+    static const uint32_t m_freeBinSlCount = 1 << m_freeBinSlLog2;
 
     //! \brief Total size of all managed heaps.
     uint32_t m_totalSizeOfHeaps = 0;
@@ -419,8 +476,24 @@ private:
     //! \brief List of block pools per heap for heaps in deletion process
     std::list<std::shared_ptr<HeapWithAdjacencyBlockList>> m_deletedHeaps;
     //! \brief Pools of memory blocks sorted by their states based on the state indicated
-    //!        by the latest TrackerId. The free pool is sorted in ascending order.
+    //!        by the latest TrackerId. Free blocks are kept in \see m_freeBins and submitted
+    //!        blocks in \see m_retireQueueHead instead.
     MemoryBlockInternal *m_sortedBlockList[MemoryBlockInternal::State::stateCount] = {nullptr};
+    //! \brief   Segregated free lists, indexed by the power of two of the block size and a
+    //!          subdivision of that range.
+    //! \details A block is inserted into and removed from its bin in constant time, the
+    //!          bitmaps below locate the smallest non-empty bin which fits a request.
+    MemoryBlockInternal *m_freeBins[m_freeBinFlCount][m_freeBinSlCount] = {};
+    //! \brief Bit fl is set if any second level bin of \see m_freeBins[fl] holds a block
+    uint32_t m_freeBinFlBitmap = 0;
+    //! \brief Bit sl of entry fl is set if \see m_freeBins[fl][sl] holds a block
+    uint32_t m_freeBinSlBitmap[m_freeBinFlCount] = {};
+    //! \brief   Submitted blocks per frame tracker index, ordered by tracker ID from oldest to newest.
+    //! \details Blocks retire in tracker ID order, so a refresh stops at the first block of
+    //!          each queue which is still in use. Only index 0 is used without tracker producer.
+    MemoryBlockInternal *m_retireQueueHead[MAX_TRACKER_NUMBER] = {};
+    //! \brief Newest submitted block of each retirement queue
+    MemoryBlockInternal *m_retireQueueTail[MAX_TRACKER_NUMBER] = {};
     //! \brief Number of entries in each sorted block list.
     uint32_t m_sortedBlockListNumEntries[MemoryBlockInternal::State::stateCount] = {0};
     //! \brief Sizes of each block pool.
@@ -440,7 +513,9 @@ private:
     bool m_lockHeapsOnAllocate = false;             //!< All heaps allocated with the keep locked flag.
     
     //! \brief Persistent storage for the sorted sizes used during AcquireSpace()
-    std::list<SortedSizePair> m_sortedSizes;
+    std::vector<SortedSizePair> m_sortedSizes;
+    //! \brief Persistent storage for the blocks acquired for \see m_sortedSizes during AcquireSpace()
+    std::vector<MemoryBlockInternal *> m_acquiredBlocks;
     //! \brief TrackerProducer
     FrameTrackerProducer *m_trackerProducer = nullptr;
     //! \bried Whether trackerProducer is set
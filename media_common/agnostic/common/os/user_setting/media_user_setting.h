@@ -157,6 +157,13 @@ public:
         bool isForReport = false,
         uint32_t option = MEDIA_USER_SETTING_INTERNAL);
 
+    //!
+    //! \brief    Rebuild the lock free snapshot of internal user setting items
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if no error, otherwise will return failed reason
+    //!
+    virtual MOS_STATUS RefreshSnapshot();
+
     //!
     //! \brief    Check whether the key has been registered 
     //! \param    [in] valueName
@@ -306,6 +313,16 @@ inline MOS_STATUS ReportUserSetting(
     return userSetting->Write(valueName, value, group, true, option);
 }
 
+inline MOS_STATUS RefreshUserSettingSnapshot(
+    MediaUserSettingSharedPtr userSetting)
+{
+    if (nullptr == userSetting)
+    {
+        return MOS_STATUS_NULL_POINTER;
+    }
+    return userSetting->RefreshSnapshot();
+}
+
 inline bool IsDeclaredUserSetting(
     MediaUserSettingSharedPtr userSetting,
     const std::string &valueName)
@@ -29,6 +29,8 @@
 
 #include <string>
 #include <set>
+#include <atomic>
+#include <vector>
 #include "media_user_setting_definition.h"
 #include "mos_utilities.h"
 
@@ -42,6 +44,24 @@ typedef struct _ExtPathCFG
     bool        bStated;
 } ExtPathCFG;
 
+//!
+//! \brief    Pre-resolved value of one internal user setting item
+//!
+struct SnapshotEntry
+{
+    Value       value{};                        //!< value read from registry/env, or the default value
+    MOS_STATUS  status   = MOS_STATUS_SUCCESS;  //!< status of the registry/env read
+    bool        resolved = false;               //!< false if value is the default value
+};
+
+//!
+//! \brief    Immutable view of all internal items of all groups, indexed by key id
+//!
+struct Snapshot
+{
+    std::map<std::size_t, SnapshotEntry> entries[Group::MaxCount];
+};
+
 class Configure
 {
 public:
@@ -113,6 +133,18 @@ public:
         bool useCustomValue = false,
         uint32_t option = MEDIA_USER_SETTING_INTERNAL);
 
+    //!
+    //! \brief    Rebuild the snapshot of internal items
+    //! \details  Resolves every registered item once and publishes the result, after
+    //!           which Read of internal items is a lock free lookup. Items registered
+    //!           later, e.g. by VP or codec components, are resolved and merged by
+    //!           the next internal Read. Call it again when the registry/env is
+    //!           changed at runtime.
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if no error, otherwise will return failed reason
+    //!
+    MOS_STATUS RefreshSnapshot();
+
     //!
     //! \brief    Write value to specific item
     //! \param    [in] itemName
@@ -209,10 +241,47 @@ protected:
     //!
     size_t MakeHash(const std::string &str)
     {
-        std::hash<std::string> HashFunc;
-        return HashFunc(str);
+        return KeyId(str.c_str());
     }
 
+    //!
+    //! \brief    Read item value from registry, pid path first in debug, then env
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if the item is set, otherwise read failed reason
+    //!
+    MOS_STATUS ReadValue(
+        Value &value,
+        std::shared_ptr<Definition> def,
+        const std::string &path,
+        uint32_t option);
+
+    //!
+    //! \brief    Look up an internal item in the snapshot
+    //! \return   bool
+    //!           true if the item is in the snapshot, value and status are then set
+    //!
+    bool ReadSnapshot(
+        Value &value,
+        size_t keyId,
+        ptrdiff_t group,
+        const Value &customValue,
+        bool useCustomValue,
+        MOS_STATUS &status);
+
+    //!
+    //! \brief    Build and publish a snapshot
+    //! \param    [in] incremental
+    //!           true to only resolve items missing from the current snapshot
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if no error, otherwise will return failed reason
+    //!
+    MOS_STATUS BuildSnapshot(bool incremental);
+
+    //!
+    //! \brief    Release snapshots older than the current one if no reader holds them
+    //!
+    void RetireSnapshots();
+
     const uint32_t GetRegAccessDataType(MOS_USER_FEATURE_VALUE_TYPE type);
 
 protected:
@@ -221,6 +290,12 @@ protected:
     bool m_isDebugMode = false; //!< whether in debug/release-internal mode
     RegBufferMap m_regBufferMap{};
     MOS_USER_FEATURE_KEY_PATH_INFO *m_keyPathInfo = nullptr;
+    std::atomic<const Snapshot *> m_snapshot{nullptr};         //!< current snapshot, nullptr if not built
+    std::vector<std::unique_ptr<Snapshot>> m_snapshots{};       //!< current snapshot and the ones readers may still hold
+    std::atomic<uint32_t> m_snapshotReaders{0};                 //!< readers between snapshot load and last use
+    std::atomic<bool> m_snapshotStale{false};                   //!< items were registered after the snapshot was built
+    MosMutex m_snapshotBuildLock;                               //!< serializes snapshot builds
+    static const size_t m_maxSnapshots = 4;                     //!< bound of m_snapshots
 
     static const UFKEY_NEXT m_rootKey;
     static const char *m_configPath;
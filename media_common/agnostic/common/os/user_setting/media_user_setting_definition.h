@@ -53,6 +53,26 @@ enum Group
     MaxCount
 };
 
+//!
+//! \brief    Get the key id of a media user setting item
+//! \details  64 bit FNV-1a of the item name. It is constexpr, so callers can
+//!           resolve the id of a literal item name at compile time.
+//! \param    [in] name
+//!           Name of the item
+//! \return   std::size_t
+//!           Key id
+//!
+constexpr std::size_t KeyId(const char *name)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    while (name && *name)
+    {
+        hash ^= static_cast<uint8_t>(*name++);
+        hash *= 0x100000001b3ull;
+    }
+    return static_cast<std::size_t>(hash);
+}
+
 namespace Internal {
 
 class Definition
@@ -58,7 +58,7 @@
 #define DL_MAX_PATCHES 8           // Max patches to use
 #define DL_MAX_EXPORT_COUNT 64     // size of the symbol export table
 
-#define DL_MAX_COMBINED_KERNELS 64       // Max number of kernels in cache
+#define DL_MAX_COMBINED_KERNELS 64       // Default max number of kernels in cache
 #define DL_MAX_SYMBOLS 100               // max number of import/export symbols in a combined kernels
 #define DL_MAX_KERNEL_SIZE (160 * 1024)  // max output kernel size
 
@@ -70,6 +70,13 @@
 #define DL_NEW_COMBINED_KERNELS 4                                                      // The increased number of kernels in cache each time
 #define DL_CACHE_BLOCK_SIZE (160 * 1024)                                               // Kernel allocation block size
 #define DL_COMBINED_KERNEL_CACHE_SIZE (DL_CACHE_BLOCK_SIZE * DL_NEW_COMBINED_KERNELS)  // Combined kernel size
+#define DL_MAX_COMBINED_KERNELS_LIMIT 4096                                             // Max configurable number of kernels in cache
+#define DL_INITIAL_HASH_ENTRIES 16                                                     // Initial number of hash entries/buckets (power of 2)
+
+#define DL_DISK_CACHE_MAGIC 0x4B434644                       // 'DFCK'
+#define DL_DISK_CACHE_VERSION 2                              // Bump whenever the record layout changes
+#define DL_DISK_CACHE_MAX_SIZE (32 * 1024 * 1024)            // Max size of the persistent cache file
+#define DL_DISK_CACHE_PATH_LENGTH 256                        // Max length of the persistent cache file path
 
 #define DL_PROCAMP_DISABLED -1  // procamp is disabled
 #define DL_PROCAMP_MAX 1        // 1 Procamp entry
@@ -652,15 +659,17 @@ typedef struct tagKdll_CacheEntry
     // Cache control
     int      iKCID;      // kernel cache id (dynamically linked kernel)
     uint32_t dwLoaded;   // kernel loaded flag
-    uint32_t dwRefresh;  // refresh counter (for expiration control)
 
     struct tagKdll_CacheEntry *pNextEntry;  // Next cache entry;
+    struct tagKdll_CacheEntry *pLruPrev;    // More recently used entry (or next free entry)
+    struct tagKdll_CacheEntry *pLruNext;    // Less recently used entry
 } Kdll_CacheEntry;
 
 typedef struct tagKdll_KernelCache
 {
     int              iCacheMaxEntries;  // Max number of entries
     int              iCacheEntries;     // Current number of cache entries
+    int              iCacheLimit;       // Number of entries the cache may grow to
     int              iCacheSize;        // Cache buffer size
     int              iCacheFree;        // Cache buffer free
     int              iCacheID;          // Next kernel cache ID
@@ -668,6 +677,12 @@ typedef struct tagKdll_KernelCache
     uint8_t *        pCache;            // Cache (binary data)
     int              nExports;          // Exports count
     Kdll_LinkData *  pExports;          // Exports table
+    Kdll_CacheEntry *pLruHead;          // Most recently used entry
+    Kdll_CacheEntry *pLruTail;          // Least recently used entry
+    Kdll_CacheEntry *pFreeEntries;      // Unused entries (linked by pLruPrev)
+    uint32_t         dwHits;            // Lookups served from the cache
+    uint32_t         dwMisses;          // Lookups not found in the cache
+    uint32_t         dwEvictions;       // Entries evicted to make room for new kernels
 } Kdll_KernelCache;
 
 //--------------------------------------------------------------
@@ -675,7 +690,7 @@ typedef struct tagKdll_KernelCache
 //--------------------------------------------------------------
 typedef struct tagKdll_KernelHashEntry
 {
-    uint16_t          next;         // Next entry with same 8-bit hash + 1 (0 is null)
+    uint16_t          next;         // Next entry in the same bucket (1 based index, 0 is null)
     uint32_t          dwHash;       // 32-bit hash value (FNV-1a hash)
     int               iFilter;      // Filter size
     Kdll_FilterEntry *pFilter;      // Filter for matching
@@ -684,12 +699,53 @@ typedef struct tagKdll_KernelHashEntry
 
 typedef struct tagKdll_KernelHashTable
 {
-    uint16_t             wHashTable[256];                     // 256 hashes (1 based index)
-    uint16_t             pool;                                // first in pool (1 based index)
-    uint16_t             last;                                // last in pool (for releasing)
-    Kdll_KernelHashEntry HashEntry[DL_MAX_COMBINED_KERNELS];  // Hash table entries
+    uint16_t *            wHashTable;  // Bucket heads (1 based index), iHashSize buckets
+    uint16_t              pool;        // first in pool (1 based index)
+    uint16_t              last;        // last in pool (for releasing)
+    int                   iHashSize;   // Number of hash entries and buckets (power of 2)
+    Kdll_KernelHashEntry *HashEntry;   // Hash table entries
 } Kdll_KernelHashTable;
 
+//--------------------------------------------------------------
+// Persistent combined kernel cache
+//--------------------------------------------------------------
+typedef struct tagKdll_DiskCacheHeader
+{
+    uint32_t dwMagic;            // DL_DISK_CACHE_MAGIC
+    uint32_t dwVersion;          // DL_DISK_CACHE_VERSION
+    uint32_t dwChecksum;         // Checksum of component/patch kernel binaries
+    uint32_t dwRecords;          // Number of records following the header
+    uint32_t dwFilterEntrySize;  // sizeof(Kdll_FilterEntry) of the writer
+    uint32_t dwCscParamsSize;    // sizeof(Kdll_CSC_Params) of the writer
+} Kdll_DiskCacheHeader;
+
+typedef struct tagKdll_DiskCacheRecord
+{
+    uint32_t        dwRecordSize;      // Record size including payload (8 byte aligned)
+    uint32_t        dwHash;            // 32-bit hash of the search filter (FNV-1a hash)
+    int32_t         iFilter;           // Search filter size (-1 if record was superseded)
+    int32_t         iFilterSize;       // Modified filter size
+    int32_t         iKernelSize;       // Combined kernel size
+    uint32_t        dwChecksum;        // Checksum of CSC parameters, filters and kernel binary
+    MEDIA_CSPACE    colorfill_cspace;  // Intermediate color space for colorfill
+    Kdll_CSC_Params CscParams;         // CSC parameters associated with the kernel
+    // Followed by search filter, modified filter and kernel binary
+} Kdll_DiskCacheRecord;
+
+typedef struct tagKdll_DiskCache
+{
+    bool     bEnabled;                           // Persistent cache enabled
+    bool     bDirty;                             // Records added since the cache was loaded
+    char     szPath[DL_DISK_CACHE_PATH_LENGTH];  // Cache file path
+    uint32_t dwChecksum;                         // Checksum of component/patch kernel binaries
+    uint8_t *pData;                              // Cache image (header + records)
+    uint32_t dwDataSize;                         // Used size of cache image
+    uint32_t dwDataMax;                          // Allocated size of cache image
+    uint32_t dwHits;                             // Kernels restored from the persistent cache
+    uint32_t dwMisses;                           // Kernels not found in the persistent cache
+    uint32_t dwStores;                           // Kernels added to the persistent cache
+} Kdll_DiskCache;
+
 //--------------------------------------------------------------
 // Dynamic linking state
 //--------------------------------------------------------------
@@ -699,7 +755,6 @@ typedef struct tagKdll_SearchState *PKdll_SearchState;
 typedef struct tagKdll_State
 {
     int      iSize;        // Size of DL buffer
-    uint32_t dwRefresh;    // Refresh counter (for garbage collection)
     bool     bEnableCMFC;  // Flag to enable CMFC
 
     // Default kernel component cache and rule table
@@ -722,6 +777,7 @@ typedef struct tagKdll_State
     // Combined kernel cache and hash table
     Kdll_KernelCache     KernelCache;      // Output kernel cache
     Kdll_KernelHashTable KernelHashTable;  // Hash table for resulting kernels
+    Kdll_DiskCache       DiskCache;        // Persistent combined kernel cache
 
     Kdll_Procamp *pProcamp;      // Array of Procamp parameters
     int32_t       iProcampSize;  // Size of the array of Procamp parameters
@@ -969,6 +1025,32 @@ KernelDll_AllocateCacheEntry(Kdll_KernelCache *pCache,
 Kdll_CacheEntry *
 KernelDll_AllocateAdditionalCacheEntries(Kdll_KernelCache *pCache);
 
+// Set max number of combined kernels kept in cache
+void KernelDll_SetCombinedKernelCacheCapacity(Kdll_State *pState, int32_t iMaxKernels);
+
+// Load persistent combined kernel cache from szDir (opt-in)
+bool KernelDll_LoadDiskCache(Kdll_State *pState, const char *szDir);
+
+// Write persistent combined kernel cache back to disk
+bool KernelDll_SaveDiskCache(Kdll_State *pState);
+
+// Persistent cache image (hal_kerneldll_disk_cache.c)
+bool KernelDll_OpenDiskCache(Kdll_DiskCache *pDiskCache, const char *szDir, uint32_t dwChecksum);
+bool KernelDll_WriteDiskCache(Kdll_DiskCache *pDiskCache);
+void KernelDll_CloseDiskCache(Kdll_DiskCache *pDiskCache);
+
+Kdll_DiskCacheRecord *
+KernelDll_FindDiskCacheRecord(Kdll_DiskCache         *pDiskCache,
+                              const Kdll_FilterEntry *pFilter,
+                              int32_t                 iFilterSize,
+                              uint32_t                dwHash);
+
+bool KernelDll_AddDiskCacheRecord(Kdll_DiskCache         *pDiskCache,
+                                  const Kdll_CacheEntry  *pCacheEntry,
+                                  const Kdll_FilterEntry *pFilter,
+                                  int32_t                 iFilterSize,
+                                  uint32_t                dwHash);
+
 void KernelDll_ReleaseHashEntry(Kdll_KernelHashTable *pHashTable, uint16_t entry);
 void KernelDll_ReleaseCacheEntry(Kdll_KernelCache *pCache, Kdll_CacheEntry  *pEntry);
 
@@ -187,6 +187,11 @@ class XRenderHal_Platform_Interface;
 //!
 #define RENDERHAL_KERNEL_COUNT_MIN          2
 
+//!
+//! \brief  Kernels tracked for reload statistics per GSH kernel slot
+//!
+#define RENDERHAL_KERNEL_RELOAD_STATS_FACTOR 4
+
 //!
 //! \brief  Default kernel heap size
 //!
@@ -789,6 +794,33 @@ typedef struct _RENDERHAL_KRN_ALLOC_LIST
     int32_t                   iCount;                                           // Number of objects
 } RENDERHAL_KRN_ALLOC_LIST, *PRENDERHAL_KRN_ALLOC_LIST;
 
+//!
+//! \brief  Residency index entry, one per kernel allocation slot
+//!         Kept apart from RENDERHAL_KRN_ALLOCATION so that code moving
+//!         allocation entries around does not corrupt the links
+//!
+typedef struct _RENDERHAL_KRN_RESIDENCY
+{
+    int32_t                   iKUID;                                            // Kernel Unique ID the slot is indexed under
+    int32_t                   iKCID;                                            // Kernel Cache ID the slot is indexed under
+    int32_t                   iHashNext;                                        // Next slot in the same hash bucket (-1 if last)
+    int32_t                   iLruPrev;                                         // More recently used slot (-1 if head)
+    int32_t                   iLruNext;                                         // Less recently used slot (-1 if tail)
+    bool                      bIndexed;                                         // Slot is linked in the hash bucket and LRU list
+} RENDERHAL_KRN_RESIDENCY, *PRENDERHAL_KRN_RESIDENCY;
+
+//!
+//! \brief  Per kernel load statistics (profiling)
+//!
+typedef struct _RENDERHAL_KRN_RELOAD_STATS
+{
+    int32_t                   iKUID;                                            // Kernel Unique ID
+    int32_t                   iKCID;                                            // Kernel Cache ID
+    uint32_t                  dwLoads;                                          // Number of loads into GSH (0 if entry is empty)
+    uint32_t                  dwReloads;                                        // Number of loads after the kernel was evicted
+    uint32_t                  dwEvictions;                                      // Number of times the kernel was unloaded
+} RENDERHAL_KRN_RELOAD_STATS, *PRENDERHAL_KRN_RELOAD_STATS;
+
 typedef struct _RENDERHAL_MEDIA_STATE *PRENDERHAL_MEDIA_STATE;
 
 typedef struct _RENDERHAL_MEDIA_STATE
@@ -969,6 +1001,16 @@ typedef struct _RENDERHAL_STATE_HEAP
 
     // Arrays created dynamically
     PRENDERHAL_KRN_ALLOCATION   pKernelAllocation;                              // Kernel allocation table (or linked list)
+    PRENDERHAL_KRN_RESIDENCY    pKernelResidency;                               // Residency index entries (one per kernel allocation)
+    int32_t                     *piKernelHash;                                  // Residency hash buckets (slot index, -1 if empty)
+    int32_t                     iKernelHashSize;                                // Number of hash buckets (power of 2)
+    int32_t                     iKernelLruHead;                                 // Most recently used slot (-1 if none)
+    int32_t                     iKernelLruTail;                                 // Least recently used slot (-1 if none)
+    PRENDERHAL_KRN_RELOAD_STATS pKernelReloadStats;                             // Per kernel load statistics (open addressing)
+    int32_t                     iKernelReloadStatsSize;                         // Number of statistics entries (power of 2)
+    uint32_t                    dwKernelHits;                                   // Loads satisfied by a resident kernel
+    uint32_t                    dwKernelMisses;                                 // Loads that copied a kernel into GSH
+    uint32_t                    dwKernelStatsDropped;                           // Loads of kernels not tracked (statistics table full)
 
     // Dynamic Kernel States
     PMHW_MEMORY_POOL               pKernelAllocMemPool;                         // Kernel states memory pool (mallocs)
@@ -1835,6 +1877,17 @@ void RenderHal_GetPixelsPerSample(
     MOS_FORMAT                  format,
     uint32_t                    *pdwPixelsPerSampleUV);
 
+//!
+//! \brief    Dump Kernel Reload Statistics
+//! \details  Print GSH kernel hit/miss counters and the kernels that had to
+//!           be reloaded after eviction, for kernel heap sizing and profiling
+//! \param    PRENDERHAL_INTERFACE pRenderHal
+//!           [in] Pointer to Hardware Interface Structure
+//! \return   void
+//!
+void RenderHal_DumpKernelReloadStats(
+    PRENDERHAL_INTERFACE        pRenderHal);
+
 //!
 //! \brief    Set Surface for HW Access
 //! \details  Common Function for setting up surface state
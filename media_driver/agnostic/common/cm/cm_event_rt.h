@@ -123,6 +123,10 @@ public:
 
     int32_t Query();
 
+    // Block on the OS completion object of the flushed task and update the
+    // status once it is signaled, instead of polling the task status table.
+    int32_t WaitForOsSignal(int64_t timeOutNs);
+
     CM_STATUS GetStatusWithoutFlush();
 
 #if CM_LOG_ON
@@ -2616,6 +2616,43 @@ finish:
     return hr;
 }
 
+//*-----------------------------------------------------------------------------
+//| Purpose:    Block until the oldest flushed task completes or timeout.
+//|             It is an in-order queue, so this is the next task
+//|             QueryFlushedTasks can pop.
+//| Returns:    Result of the operation.
+//*-----------------------------------------------------------------------------
+int32_t CmQueueRT::WaitForOldestFlushedTask(uint32_t timeOutMs)
+{
+    int32_t    hr    = CM_SUCCESS;
+    CmEventRT *event = nullptr;
+
+    // Hold a reference on the event so that the task can be popped and destroyed
+    // by other threads while waiting without the flushed task lock.
+    m_criticalSectionFlushedTask.Acquire();
+    CmTaskInternal *task = m_flushedTasks.IsEmpty() ? nullptr : m_flushedTasks.Top();
+    if (task != nullptr)
+    {
+        task->GetTaskEvent(event);
+        if (event != nullptr)
+        {
+            CLock Lock(m_criticalSectionEvent);
+            event->Acquire();
+        }
+    }
+    m_criticalSectionFlushedTask.Release();
+
+    if (event != nullptr)
+    {
+        hr = event->WaitForOsSignal(1000000LL * timeOutMs);
+
+        CmEvent *eventBase = event;
+        DestroyEvent(eventBase);
+    }
+
+    return hr;
+}
+
 //*-----------------------------------------------------------------------------
 //! This is a blocking call. It will NOT return untill
 //! all tasks in GPU and all tasks in queue finishes execution.
@@ -2688,6 +2725,7 @@ int32_t CmQueueRT::CleanQueue( )
 
     while( !m_flushedTasks.IsEmpty() && status != CM_EXCEED_MAX_TIMEOUT )
     {
+        WaitForOldestFlushedTask(CM_MAX_TIMEOUT_MS);
         QueryFlushedTasks();
 
         LARGE_INTEGER current;
@@ -3328,7 +3366,9 @@ int32_t CmQueueRT::FlushTaskWithoutSync( bool flushBlocked )
             while( flushedTaskCount >= m_halMaxValues->maxTasks )
             {
                 // If the task count in flushed queue is no less than hw restrictiion,
-                // query the staus of flushed task queue. Remove any finished tasks from the queue
+                // sleep until the oldest flushed task completes instead of spinning,
+                // then remove any finished tasks from the queue
+                WaitForOldestFlushedTask(CM_MAX_TIMEOUT_MS);
                 QueryFlushedTasks();
                 flushedTaskCount = m_flushedTasks.GetCount();
             }
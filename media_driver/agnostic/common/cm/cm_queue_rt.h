@@ -292,6 +292,8 @@ protected:
 
     int32_t QueryFlushedTasks();
 
+    int32_t WaitForOldestFlushedTask(uint32_t timeOutMs);
+
     //New sub functions for different task flush
     int32_t FlushGeneralTask(CmTaskInternal *task);
 
@@ -42,21 +42,11 @@ namespace CMRT_UMD
 //*-----------------------------------------------------------------------------
 CM_RT_API int32_t CmEventRT::GetStatus(CM_STATUS &status)
 {
-    static const uint64_t TIME_OUT = 10000; // 10 microseconds.
+    static const int64_t TIME_OUT = 10000; // 10 microseconds.
     if (m_status == CM_STATUS_FLUSHED || m_status == CM_STATUS_STARTED)
     {
-        if (!m_osSignalTriggered)
-        {
-            CM_CHK_NULL_RETURN_CMERROR(m_osData);
-            MOS_LINUX_BO *buffer_object = reinterpret_cast<MOS_LINUX_BO*>(m_osData);
-            int result = mos_bo_wait(buffer_object, TIME_OUT);
-            mos_bo_clear_relocs(buffer_object, 0);
-            m_osSignalTriggered = (result == 0);
-        }
-        if (m_osSignalTriggered)
-        {
-            Query();
-        }
+        CM_CHK_NULL_RETURN_CMERROR(m_osData);
+        WaitForOsSignal(TIME_OUT);
     }
 
     m_queue->FlushTaskWithoutSync();
@@ -83,24 +73,21 @@ CM_RT_API int32_t CmEventRT::WaitForTaskFinished(uint32_t timeOutMs)
     if( m_status == CM_STATUS_FINISHED )
         goto finish;
 
-    //Make sure task flushed
+    //Make sure task flushed, blocking on the oldest flushed task if the flushed queue is full
     while ( m_status == CM_STATUS_QUEUED )
     {
-        m_queue->FlushTaskWithoutSync();  //Flush none if 1st task NOT finished yet
+        m_queue->FlushTaskWithoutSync(true);
     }
 
     CM_ASSERT(m_osData != nullptr);
 
-    //Wait bo finished
-    result = mos_bo_wait((MOS_LINUX_BO*)m_osData, 1000000LL*timeOutMs);
-    mos_bo_clear_relocs((MOS_LINUX_BO*)m_osData, 0);
-    if (result) {
-        result = CM_EXCEED_MAX_TIMEOUT;   //translate the drm ecode (-ETIME or potentional variants) to CM ecode.
+    //Wait bo finished and query status
+    result = WaitForOsSignal(1000000LL*timeOutMs);
+    if (result != CM_SUCCESS) {
+        result = CM_EXCEED_MAX_TIMEOUT;
         goto finish;
     }
 
-    //Query status
-    Query();
     if(m_status != CM_STATUS_FINISHED)
     {
         // if bo_wai() returns success but status is not finished in time stamp
@@ -117,6 +104,45 @@ finish:
     return result;
 }
 
+//*-----------------------------------------------------------------------------
+//! Wait for the bo of the flushed task to go idle, then query the task status.
+//! The wait sleeps in the kernel until the GPU signals completion.
+//! INPUT:
+//!     Timeout in nanoseconds
+//! OUTPUT:
+//!     CM_SUCCESS:  if the bo is idle or the task is not in flight any more
+//!     CM_EXCEED_MAX_TIMEOUT:  if the bo is still busy after timeout
+//!     CM_FAILURE:  if the task is not flushed yet
+//*-----------------------------------------------------------------------------
+int32_t CmEventRT::WaitForOsSignal(int64_t timeOutNs)
+{
+    if (m_status == CM_STATUS_QUEUED)
+    {
+        return CM_FAILURE;
+    }
+    if (m_status != CM_STATUS_FLUSHED && m_status != CM_STATUS_STARTED)
+    {
+        return CM_SUCCESS;
+    }
+
+    if (!m_osSignalTriggered)
+    {
+        CM_CHK_NULL_RETURN_CMERROR(m_osData);
+        MOS_LINUX_BO *buffer_object = reinterpret_cast<MOS_LINUX_BO*>(m_osData);
+        int result = mos_bo_wait(buffer_object, timeOutNs);
+        mos_bo_clear_relocs(buffer_object, 0);
+        m_osSignalTriggered = (result == 0);
+    }
+    if (!m_osSignalTriggered)
+    {
+        //translate the drm ecode (-ETIME or potentional variants) to CM ecode.
+        return CM_EXCEED_MAX_TIMEOUT;
+    }
+
+    Query();
+    return CM_SUCCESS;
+}
+
 //*-----------------------------------------------------------------------------
 //! Unreference the bo in linux.
 //! INPUT:
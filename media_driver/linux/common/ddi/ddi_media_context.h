@@ -31,6 +31,8 @@
 #include "mos_cmdbufmgr.h"
 #include "media_libva_caps.h"
 
+class MediaLibvaUtilNext_WorkerPool;
+
 //!
 //! \struct DDI_MEDIA_CONTEXT
 //! \brief  Media heap for shared internal structures
@@ -182,10 +184,12 @@ struct DDI_MEDIA_CONTEXT
 #endif
     bool                  m_apoMosEnabled     = false;
     DdiMediaFunctions     *m_compList[CompCount]    = {};
+    bool                  m_lazyCompInit            = false;  // registered components are created on first use
     MediaInterfacesHwInfo *m_hwInfo                 = nullptr;
     MediaLibvaCapsNext    *m_capsNext               = nullptr;
     bool                  m_apoDdiEnabled           = false;
     MediaUserSettingSharedPtr m_userSettingPtr      = nullptr;  // used to save user setting instance
+    std::shared_ptr<MediaLibvaUtilNext_WorkerPool> m_copyWorkerPool = nullptr;  // threads splitting large vaGetImage/vaPutImage plane copies
 };
 
 #endif // __DDI_MEDIA_CONTEXT_H_
@@ -69,6 +69,7 @@
 
 #include "media_libva_interface.h"
 #include "media_libva_interface_next.h"
+#include "media_libva_util_next.h"
 #include "media_interfaces_hwinfo_device.h"
 #include "media_libva_caps_next.h"
 
@@ -1438,6 +1439,7 @@ static VAStatus DdiMedia_HeapDestroy(
     DDI_CHK_NULL(mediaCtx, "nullptr ctx", VA_STATUS_ERROR_INVALID_CONTEXT);
     // destroy heaps
     MOS_FreeMemory(mediaCtx->pSurfaceHeap->pHeapBase);
+    MOS_Delete(mediaCtx->pSurfaceHeap->pBoIndex);
     MOS_FreeMemory(mediaCtx->pSurfaceHeap);
 
     MOS_FreeMemory(mediaCtx->pBufferHeap->pHeapBase);
@@ -1524,6 +1526,10 @@ void FreeForMediaContext(PDDI_MEDIA_CONTEXT mediaCtx)
     {
         mediaCtx->SkuTable.reset();
         mediaCtx->WaTable.reset();
+        if (mediaCtx->pSurfaceHeap)
+        {
+            MOS_Delete(mediaCtx->pSurfaceHeap->pBoIndex);
+        }
         MOS_FreeMemory(mediaCtx->pSurfaceHeap);
         MOS_FreeMemory(mediaCtx->pBufferHeap);
         MOS_FreeMemory(mediaCtx->pImageHeap);
@@ -1617,7 +1623,10 @@ VAStatus DdiMedia__InitializeSoftlet(
     {
         if(apoDdiEnabled)
         {
-            mediaCtx->m_hwInfo = MediaInterfacesHwInfoDevice::CreateFactory(mediaCtx->platform);
+            {
+                MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_HW_INFO);
+                mediaCtx->m_hwInfo = MediaInterfacesHwInfoDevice::CreateFactory(mediaCtx->platform);
+            }
             if (nullptr == mediaCtx->m_hwInfo)
             {
                 DDI_ASSERTMESSAGE("Unregister hwinfo platform.");
@@ -1625,17 +1634,19 @@ VAStatus DdiMedia__InitializeSoftlet(
                 break;
             }
 
-            mediaCtx->m_capsNext = MediaLibvaCapsNext::CreateCaps(mediaCtx);
-            if (!mediaCtx->m_capsNext)
             {
-                DDI_ASSERTMESSAGE("Caps next create failed. Not supported GFX device.");
-                status = VA_STATUS_ERROR_ALLOCATION_FAILED;
-                break;
+                MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_CAPS);
+                mediaCtx->m_capsNext = MediaLibvaCapsNext::CreateCaps(mediaCtx);
+                if (mediaCtx->m_capsNext && mediaCtx->m_capsNext->Init() != VA_STATUS_SUCCESS)
+                {
+                    DDI_ASSERTMESSAGE("Caps next init failed.");
+                    status = VA_STATUS_ERROR_ALLOCATION_FAILED;
+                    break;
+                }
             }
-
-            if(mediaCtx->m_capsNext->Init() != VA_STATUS_SUCCESS)
+            if (!mediaCtx->m_capsNext)
             {
-                DDI_ASSERTMESSAGE("Caps next init failed.");
+                DDI_ASSERTMESSAGE("Caps next create failed. Not supported GFX device.");
                 status = VA_STATUS_ERROR_ALLOCATION_FAILED;
                 break;
             }
@@ -1754,12 +1765,16 @@ VAStatus DdiMedia_InitMediaContext (
     mediaCtx->fd     = devicefd;
 
     mediaCtx->m_userSettingPtr = std::make_shared<MediaUserSetting::MediaUserSetting>();
+    mediaCtx->m_copyWorkerPool = std::make_shared<MediaLibvaUtilNext_WorkerPool>(DDI_COPY_WORKER_NUM);
 
     MOS_CONTEXT mosCtx     = {};
     mosCtx.fd              = mediaCtx->fd;
     mosCtx.m_userSettingPtr = mediaCtx->m_userSettingPtr;
 
-    MosInterface::InitOsUtilities(&mosCtx);
+    {
+        MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_OS_UTILITIES);
+        MosInterface::InitOsUtilities(&mosCtx);
+    }
     mediaCtx->m_apoMosEnabled = SetupApoMosSwitch(devicefd, mediaCtx->m_userSettingPtr);
 
     mediaCtx->pfnMemoryDecompress  = DdiMedia_MediaMemoryDecompressInternal;
@@ -1783,11 +1798,14 @@ VAStatus DdiMedia_InitMediaContext (
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
 
-        if (MosInterface::CreateOsDeviceContext(&mosCtx, &mediaCtx->m_osDeviceContext) != MOS_STATUS_SUCCESS)
         {
-            DDI_ASSERTMESSAGE("Unable to create MOS device context.");
-            FreeForMediaContext(mediaCtx);
-            return VA_STATUS_ERROR_OPERATION_FAILED;
+            MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_OS_DEVICE_CONTEXT);
+            if (MosInterface::CreateOsDeviceContext(&mosCtx, &mediaCtx->m_osDeviceContext) != MOS_STATUS_SUCCESS)
+            {
+                DDI_ASSERTMESSAGE("Unable to create MOS device context.");
+                FreeForMediaContext(mediaCtx);
+                return VA_STATUS_ERROR_OPERATION_FAILED;
+            }
         }
         mediaCtx->pDrmBufMgr                = mosCtx.bufmgr;
         mediaCtx->iDeviceId                 = mosCtx.iDeviceId;
@@ -2008,11 +2026,14 @@ VAStatus DdiMedia_InitMediaContext (
         return VA_STATUS_ERROR_INVALID_PARAMETER;
     }
 
-    if (DdiMedia_HeapInitialize(mediaCtx) != VA_STATUS_SUCCESS)
     {
-        DestroyMediaContextMutex(mediaCtx);
-        FreeForMediaContext(mediaCtx);
-        return VA_STATUS_ERROR_ALLOCATION_FAILED;
+        MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_HEAP);
+        if (DdiMedia_HeapInitialize(mediaCtx) != VA_STATUS_SUCCESS)
+        {
+            DestroyMediaContextMutex(mediaCtx);
+            FreeForMediaContext(mediaCtx);
+            return VA_STATUS_ERROR_ALLOCATION_FAILED;
+        }
     }
 
     //Caps need platform and sku table, especially in MediaLibvaCapsCp::IsDecEncryptionSupported
@@ -7614,6 +7635,92 @@ MEDIAAPI_EXPORT VAStatus DdiMedia_MapBuffer2(
     return DdiMedia_MapBufferInternal(ctx, buf_id, pbuf, flag);
 }
 
+//!
+//! \brief  Sync several surfaces with one wait, used by ULT
+//!
+//! \param  [in] ctx
+//!         Pointer to VA driver context
+//! \param  [in] surfaces
+//!         VA surface ids
+//! \param  [in] numSurfaces
+//!         Number of surfaces
+//! \param  [in] timeoutNs
+//!         Time out period for all surfaces, negative to wait forever
+//!
+//! \return VAStatus
+//!     VA_STATUS_SUCCESS if success, else fail reason
+//!
+MEDIAAPI_EXPORT VAStatus DdiMedia_SyncSurfaces(
+    VADriverContextP    ctx,
+    VASurfaceID         *surfaces,
+    uint32_t            numSurfaces,
+    int64_t             timeoutNs)
+{
+    return MediaLibvaInterfaceNext::SyncSurfaces(ctx, surfaces, numSurfaces, timeoutNs);
+}
+
+//!
+//! \brief  Export surface completion fence, used by ULT
+//!
+//! \param  [in] ctx
+//!         Pointer to VA driver context
+//! \param  [in] surfaceId
+//!         VA surface id
+//! \param  [out] syncFd
+//!         Pollable sync file fd
+//!
+//! \return VAStatus
+//!     VA_STATUS_SUCCESS if success, else fail reason
+//!
+MEDIAAPI_EXPORT VAStatus DdiMedia_ExportSurfaceSyncFd(
+    VADriverContextP    ctx,
+    VASurfaceID         surfaceId,
+    int32_t             *syncFd)
+{
+    return MediaLibvaInterfaceNext::ExportSurfaceSyncFd(ctx, surfaceId, syncFd);
+}
+
+//!
+//! \brief  Get DDI component, creating it on first use when component init is lazy, used by ULT
+//!
+//! \param  [in] ctx
+//!         Pointer to VA driver context
+//! \param  [in] type
+//!         Component type
+//!
+//! \return void*
+//!     Pointer to component, nullptr if failed
+//!
+MEDIAAPI_EXPORT void *DdiMedia_GetComponent(
+    VADriverContextP    ctx,
+    uint32_t            type)
+{
+    DDI_CHK_NULL(ctx, "nullptr ctx", nullptr);
+    return MediaLibvaInterfaceNext::GetComponent(DdiMedia_GetMediaContext(ctx), (CompType)type);
+}
+
+//!
+//! \brief  Peek DDI component slot without creating the component, used by ULT
+//!
+//! \param  [in] ctx
+//!         Pointer to VA driver context
+//! \param  [in] type
+//!         Component type
+//!
+//! \return void*
+//!     Pointer to component, nullptr if not created
+//!
+MEDIAAPI_EXPORT void *DdiMedia_PeekComponent(
+    VADriverContextP    ctx,
+    uint32_t            type)
+{
+    DDI_CHK_NULL(ctx, "nullptr ctx", nullptr);
+    PDDI_MEDIA_CONTEXT mediaCtx = DdiMedia_GetMediaContext(ctx);
+    DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", nullptr);
+    DDI_CHK_LESS(type, (uint32_t)CompCount, "invalid component type", nullptr);
+    return __atomic_load_n(&mediaCtx->m_compList[type], __ATOMIC_ACQUIRE);
+}
+
 #ifdef __cplusplus
 }
 #endif
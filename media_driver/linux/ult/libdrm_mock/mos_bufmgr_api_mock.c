@@ -294,6 +294,29 @@ mos_bo_wait(struct mos_linux_bo *bo, int64_t timeout_ns)
     return bo->bufmgr->bo_wait(bo, timeout_ns);
 }
 
+drm_export int
+mos_bo_wait_multi(struct mos_linux_bo **bos, int count, int64_t timeout_ns)
+{
+    if (bos[0]->bufmgr->bo_wait_multi)
+        return bos[0]->bufmgr->bo_wait_multi(bos, count, timeout_ns);
+
+    for (int i = 0; i < count; i++) {
+        int ret = bos[i]->bufmgr->bo_wait(bos[i], timeout_ns);
+        if (ret)
+            return ret;
+    }
+    return 0;
+}
+
+drm_export int
+mos_bo_export_sync_fd(struct mos_linux_bo *bo, int *sync_fd)
+{
+    if (!bo || !sync_fd)
+        return -EINVAL;
+
+    return bo->bufmgr->bo_export_sync_fd(bo, sync_fd);
+}
+
 drm_export void
 mos_bo_clear_relocs(struct mos_linux_bo *bo, int start)
 {
@@ -47,6 +47,7 @@
 #include <unistd.h>
 #include <assert.h>
 #include <pthread.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -343,6 +344,18 @@ static inline struct mos_bo_gem *to_bo_gem(struct mos_linux_bo *bo)
 {
         return (struct mos_bo_gem *)bo;
 }
+/**
+ * ULT hook to simulate GPU work which does not complete. While set, waits
+ * with a timeout fail with -ETIME and exported sync fds do not poll readable.
+ */
+static int mock_bo_busy = 0;
+
+extern "C" drm_export void
+mos_bufmgr_mock_set_bo_busy(int busy)
+{
+    mock_bo_busy = busy;
+}
+
 static int GetDrmMode()
 {
     return 1;//We always use SW Mode in libdrm mock.
@@ -2013,7 +2026,7 @@ static int
 mos_gem_bo_wait(struct mos_linux_bo *bo, int64_t timeout_ns)
 {
     if(GetDrmMode())
-        return 0; //libdrm_mock
+        return (mock_bo_busy && timeout_ns >= 0) ? -ETIME : 0; //libdrm_mock
 
     struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *) bo->bufmgr;
     struct mos_bo_gem *bo_gem = (struct mos_bo_gem *) bo;
@@ -2843,6 +2856,23 @@ mos_gem_bo_export_to_prime(struct mos_linux_bo *bo, int *prime_fd)
     return 0;
 }
 
+/**
+ * The mock GPU completes work on submission, so hand out an fd that polls
+ * readable right away like a signaled sync file, unless the bo is set busy.
+ */
+static int
+mos_gem_bo_export_sync_fd(struct mos_linux_bo *bo, int *sync_fd)
+{
+    if (!bo || !sync_fd)
+        return -EINVAL;
+
+    *sync_fd = eventfd(mock_bo_busy ? 0 : 1, EFD_CLOEXEC);
+    if (*sync_fd < 0)
+        return -errno;
+
+    return 0;
+}
+
 static int
 mos_gem_bo_flink(struct mos_linux_bo *bo, uint32_t * name)
 {
@@ -3895,6 +3925,7 @@ mos_bufmgr_gem_init(int fd, int batch_size, int *device_type)
     bufmgr_gem->bufmgr.get_context_param = mos_gem_get_context_param;
     bufmgr_gem->bufmgr.bo_create_from_prime = mos_gem_bo_create_from_prime;
     bufmgr_gem->bufmgr.bo_export_to_prime = mos_gem_bo_export_to_prime;
+    bufmgr_gem->bufmgr.bo_export_sync_fd = mos_gem_bo_export_sync_fd;
     bufmgr_gem->bufmgr.reg_read = mos_bufmg_reg_read;
     bufmgr_gem->bufmgr.get_reset_stats = mos_bufmg_get_reset_stats;
     bufmgr_gem->bufmgr.get_context_param_sseu = mos_bufmgr_get_context_param_sseu;
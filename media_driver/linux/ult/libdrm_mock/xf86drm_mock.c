@@ -67,6 +67,7 @@
 //#include "xf86drmCSC.h"
 #include "libdrm_macros.h"
 #include "i915_drm.h"
+#include "xe_drm.h"
 
 #if defined(__FreeBSD__) || defined(__FreeBSD_kernel__) || defined(__DragonFly__)
 #define DRM_MAJOR 145
@@ -177,11 +178,107 @@ drmIoctl(int fd, unsigned long request, void *arg)
 }
 #else
 #include "devconfig.h"
+
+/*
+ * Fake xe device for xe bufmgr ULT. Ioctls on MOS_XE_MOCK_FD are served by
+ * mosXeMockIoctl instead of the i915 device config table: device queries fail,
+ * so the bufmgr keeps its defaults, and gem, vm, exec queue and syncobj ioctls
+ * succeed with increasing handles.
+ */
+#define MOS_XE_MOCK_FD          0x7e5e
+#define MOS_XE_MOCK_IOCTL_MAX   0x100
+
+static struct
+{
+    uint32_t next_handle;
+    int      busy;
+    int      count[MOS_XE_MOCK_IOCTL_MAX];
+} xe_mock;
+
+/*
+ * Reset the fake xe device and return its fd.
+ */
+extern "C" drm_export int
+mos_xe_mock_open(void)
+{
+    memclear(xe_mock);
+    xe_mock.next_handle = 1;
+    return MOS_XE_MOCK_FD;
+}
+
+/*
+ * While busy is set, timeline syncobj waits fail with -ETIME as for GPU work which does not complete.
+ */
+extern "C" drm_export void
+mos_xe_mock_set_busy(int busy)
+{
+    xe_mock.busy = busy;
+}
+
+/*
+ * Number of ioctls of the given request served by the fake xe device since mos_xe_mock_open.
+ */
+extern "C" drm_export int
+mos_xe_mock_ioctl_count(unsigned long request)
+{
+    return xe_mock.count[_IOC_NR(request) % MOS_XE_MOCK_IOCTL_MAX];
+}
+
+static int
+mosXeMockIoctl(unsigned long request, void *arg)
+{
+    int ret = 0;
+
+    xe_mock.count[_IOC_NR(request) % MOS_XE_MOCK_IOCTL_MAX]++;
+    switch (request)
+    {
+        case DRM_IOCTL_XE_VM_CREATE:
+            ((struct drm_xe_vm_create *)arg)->vm_id = xe_mock.next_handle++;
+            break;
+        case DRM_IOCTL_XE_GEM_CREATE:
+            ((struct drm_xe_gem_create *)arg)->handle = xe_mock.next_handle++;
+            break;
+        case DRM_IOCTL_XE_EXEC_QUEUE_CREATE:
+            ((struct drm_xe_exec_queue_create *)arg)->exec_queue_id = xe_mock.next_handle++;
+            break;
+        case DRM_IOCTL_SYNCOBJ_CREATE:
+            ((struct drm_syncobj_create *)arg)->handle = xe_mock.next_handle++;
+            break;
+        case DRM_IOCTL_SYNCOBJ_TIMELINE_WAIT:
+            if (xe_mock.busy)
+            {
+                errno = ETIME;
+                ret = -1;
+            }
+            break;
+        case DRM_IOCTL_XE_VM_DESTROY:
+        case DRM_IOCTL_XE_VM_BIND:
+        case DRM_IOCTL_XE_EXEC_QUEUE_DESTROY:
+        case DRM_IOCTL_XE_EXEC:
+        case DRM_IOCTL_GEM_CLOSE:
+        case DRM_IOCTL_SYNCOBJ_DESTROY:
+        case DRM_IOCTL_SYNCOBJ_WAIT:
+            break;
+        default:
+            // DRM_IOCTL_XE_DEVICE_QUERY and others are not supported by the fake device
+            errno = EINVAL;
+            ret = -1;
+            break;
+    }
+
+    return ret;
+}
+
 int
 mosdrmIoctl(int fd, unsigned long request, void *arg)
 {
     int    ret;
 #if 1
+    if (fd == MOS_XE_MOCK_FD)
+    {
+        return mosXeMockIoctl(request, arg);
+    }
+
     int DevIdx=fd-1;//use fd to get DevIdx
     switch (request)
     {
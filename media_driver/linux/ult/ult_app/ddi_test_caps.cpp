@@ -20,6 +20,7 @@
 * OTHER DEALINGS IN THE SOFTWARE.
 */
 #include <algorithm>
+#include <chrono>
 #include <string>
 #include "ddi_test_caps.h"
 
@@ -116,6 +117,70 @@ TEST_F(MediaCapsDdiTest, DecodeEncodeProfile)
     }
 }
 
+//!
+//! \brief    Startup latency per platform against the libdrm mock: vaInitialize,
+//!           i.e. InitDriver, and the first vaCreateConfig after it, which is
+//!           the path of a short-lived worker. InitDriver also loads the driver,
+//!           so the first figure is an upper bound of the driver init.
+//!
+TEST_F(MediaCapsDdiTest, InitCreateConfigBenchmark)
+{
+    const int          iterations = 3;
+    vector<Platform_t> platforms  = m_driverLoader.GetPlatforms();
+
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        vector<FeatureID> refFeatureIDTable = m_capsData.GetRefFeatureIDTable(DeviceConfigTable[platforms[i]]);
+        if (refFeatureIDTable.empty())
+        {
+            continue;
+        }
+
+        // a decode config takes no attributes, prefer it
+        FeatureID feature = refFeatureIDTable[0];
+        for (const auto &id : refFeatureIDTable)
+        {
+            if (id.entrypoint == VAEntrypointVLD)
+            {
+                feature = id;
+                break;
+            }
+        }
+
+        double initUsec   = 0;
+        double configUsec = 0;
+        for (int iter = 0; iter < iterations; iter++)
+        {
+            auto start = chrono::steady_clock::now();
+            int  ret   = m_driverLoader.InitDriver(platforms[i]);
+            auto init  = chrono::steady_clock::now();
+            ASSERT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platforms[i]]
+                << ", Failed function = m_driverLoader.InitDriver" << endl;
+
+            VAConfigID configId = VA_INVALID_ID;
+            ret = m_driverLoader.m_ctx.vtable->vaCreateConfig(&m_driverLoader.m_ctx, feature.profile,
+                feature.entrypoint, nullptr, 0, &configId);
+            auto config = chrono::steady_clock::now();
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platforms[i]]
+                << ", Failed function = vaCreateConfig" << endl;
+
+            initUsec   += chrono::duration<double, micro>(init - start).count();
+            configUsec += chrono::duration<double, micro>(config - init).count();
+
+            if (ret == VA_STATUS_SUCCESS)
+            {
+                m_driverLoader.m_ctx.vtable->vaDestroyConfig(&m_driverLoader.m_ctx, configId);
+            }
+            ret = m_driverLoader.CloseDriver();
+            EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platforms[i]]
+                << ", Failed function = m_driverLoader.CloseDriver" << endl;
+        }
+
+        printf("[ BENCH    ] %-8s %10.0f us vaInitialize, %8.1f us first vaCreateConfig\n",
+            g_platformName[platforms[i]], initUsec / iterations, configUsec / iterations);
+    }
+}
+
 int testfunction(int a)
 {
     return a + 1;
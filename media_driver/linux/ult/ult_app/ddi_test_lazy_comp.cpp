@@ -0,0 +1,203 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     ddi_test_lazy_comp.cpp
+//! \brief    Tests DDI components created on first use when GFX_MEDIA_LAZY_COMP_INIT is set
+//!
+
+#include <stdlib.h>
+#include <atomic>
+#include <thread>
+#include "driver_loader.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+#define LAZY_TEST_ENV           "GFX_MEDIA_LAZY_COMP_INIT"
+#define LAZY_TEST_THREAD_NUM    8
+
+// CompType of the softlet DDI
+#define LAZY_TEST_COMP_COMMON   0
+static const uint32_t lazyTestCompTypes[] = {1 /*CompCodec*/, 2 /*CompEncode*/, 3 /*CompDecode*/, 4 /*CompVp*/, 5 /*CompCp*/};
+
+class MediaLazyCompDdiTest : public testing::Test
+{
+protected:
+
+    virtual void SetUp()
+    {
+        setenv(LAZY_TEST_ENV, "1", 1);
+    }
+
+    virtual void TearDown()
+    {
+        unsetenv(LAZY_TEST_ENV);
+    }
+
+    void ExecuteLazyTest(void (MediaLazyCompDdiTest::*test)(Platform_t platform));
+
+public:
+
+    void FirstUseCreates(Platform_t platform);
+
+    void ConcurrentFirstUse(Platform_t platform);
+
+    void ReleaseUncreated(Platform_t platform);
+
+protected:
+
+    void *Get(uint32_t type)
+    {
+        return m_driverLoader.GetDriverSymbols().GetComponent(&m_driverLoader.m_ctx, type);
+    }
+
+    void *Peek(uint32_t type)
+    {
+        return m_driverLoader.GetDriverSymbols().PeekComponent(&m_driverLoader.m_ctx, type);
+    }
+
+    //! Types that are registered but not yet created, unregistered types alias the common component
+    vector<uint32_t> UncreatedTypes()
+    {
+        vector<uint32_t> types;
+        void *common = Peek(LAZY_TEST_COMP_COMMON);
+        for (uint32_t type : lazyTestCompTypes)
+        {
+            void *comp = Peek(type);
+            if (comp == nullptr)
+            {
+                types.push_back(type);
+            }
+            else
+            {
+                EXPECT_EQ(common, comp) << "type = " << type << endl;
+            }
+        }
+        return types;
+    }
+
+protected:
+
+    DriverDllLoader     m_driverLoader;
+};
+
+TEST_F(MediaLazyCompDdiTest, FirstUseCreates)
+{
+    ExecuteLazyTest(&MediaLazyCompDdiTest::FirstUseCreates);
+}
+
+TEST_F(MediaLazyCompDdiTest, ConcurrentFirstUse)
+{
+    ExecuteLazyTest(&MediaLazyCompDdiTest::ConcurrentFirstUse);
+}
+
+TEST_F(MediaLazyCompDdiTest, ReleaseUncreated)
+{
+    ExecuteLazyTest(&MediaLazyCompDdiTest::ReleaseUncreated);
+}
+
+void MediaLazyCompDdiTest::ExecuteLazyTest(void (MediaLazyCompDdiTest::*test)(Platform_t platform))
+{
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        int ret = m_driverLoader.InitDriver(platforms[i]);
+        ASSERT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platforms[i]]
+            << ", Failed function = m_driverLoader.InitDriver" << endl;
+
+        // the component list only exists on the softlet DDI path
+        if (Peek(LAZY_TEST_COMP_COMMON) != nullptr)
+        {
+            (this->*test)(platforms[i]);
+        }
+
+        // the component list is released with its uncreated slots, leaks are detected here
+        ret = m_driverLoader.CloseDriver();
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platforms[i]]
+            << ", Failed function = m_driverLoader.CloseDriver" << endl;
+    }
+}
+
+void MediaLazyCompDdiTest::FirstUseCreates(Platform_t platform)
+{
+    for (uint32_t type : UncreatedTypes())
+    {
+        void *comp = Get(type);
+        ASSERT_NE(nullptr, comp) << "Platform = " << g_platformName[platform] << ", type = " << type << endl;
+        EXPECT_EQ(comp, Peek(type));
+        EXPECT_NE(Peek(LAZY_TEST_COMP_COMMON), comp);
+        // published once, later lookups return the same component
+        EXPECT_EQ(comp, Get(type));
+    }
+}
+
+void MediaLazyCompDdiTest::ConcurrentFirstUse(Platform_t platform)
+{
+    vector<uint32_t> types = UncreatedTypes();
+    void            *comps[LAZY_TEST_THREAD_NUM][sizeof(lazyTestCompTypes) / sizeof(lazyTestCompTypes[0])] = {};
+    atomic<bool>     start(false);
+    vector<thread>   threads;
+
+    for (uint32_t t = 0; t < LAZY_TEST_THREAD_NUM; t++)
+    {
+        threads.emplace_back([&, t]() {
+            while (!start.load())
+            {
+                this_thread::yield();
+            }
+            for (size_t i = 0; i < types.size(); i++)
+            {
+                comps[t][i] = Get(types[i]);
+            }
+        });
+    }
+    start.store(true);
+    for (auto &th : threads)
+    {
+        th.join();
+    }
+
+    for (size_t i = 0; i < types.size(); i++)
+    {
+        void *comp = Peek(types[i]);
+        ASSERT_NE(nullptr, comp) << "Platform = " << g_platformName[platform] << ", type = " << types[i] << endl;
+        for (uint32_t t = 0; t < LAZY_TEST_THREAD_NUM; t++)
+        {
+            EXPECT_EQ(comp, comps[t][i]) << "Platform = " << g_platformName[platform]
+                << ", type = " << types[i] << ", thread = " << t << endl;
+        }
+    }
+}
+
+void MediaLazyCompDdiTest::ReleaseUncreated(Platform_t platform)
+{
+    // create only the first lazy component, the rest are released uncreated
+    vector<uint32_t> types = UncreatedTypes();
+    if (!types.empty())
+    {
+        EXPECT_NE(nullptr, Get(types[0])) << "Platform = " << g_platformName[platform] << endl;
+        for (size_t i = 1; i < types.size(); i++)
+        {
+            EXPECT_EQ(nullptr, Peek(types[i])) << "Platform = " << g_platformName[platform] << endl;
+        }
+    }
+}
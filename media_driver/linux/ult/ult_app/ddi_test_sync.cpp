@@ -0,0 +1,185 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     ddi_test_sync.cpp
+//! \brief    Tests batched surface sync and surface sync fd export against the libdrm mock
+//!
+
+#include <dlfcn.h>
+#include <poll.h>
+#include <unistd.h>
+#include "driver_loader.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+// Exported by the preloaded libdrm mock
+typedef void (*MockSetBoBusyFunc)(int busy);
+
+#define SYNC_TEST_SURFACE_NUM   2
+#define SYNC_TEST_TIMEOUT_NS    1000000
+#define SYNC_TEST_INVALID_ID    0xFFFF
+
+class MediaSyncDdiTest : public testing::Test
+{
+protected:
+
+    virtual void SetUp()
+    {
+        m_setBoBusy = (MockSetBoBusyFunc)dlsym(RTLD_DEFAULT, "mos_bufmgr_mock_set_bo_busy");
+    }
+
+    virtual void TearDown()
+    {
+        if (m_setBoBusy)
+        {
+            m_setBoBusy(0);
+        }
+    }
+
+    void ExecuteSyncTest(void (MediaSyncDdiTest::*test)(Platform_t platform));
+
+public:
+
+    void ExportReadableFd(Platform_t platform);
+
+    void SyncTimeout(Platform_t platform);
+
+    void InvalidSurface(Platform_t platform);
+
+protected:
+
+    static bool IsReadable(int32_t fd)
+    {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+    }
+
+protected:
+
+    DriverDllLoader     m_driverLoader;
+    MockSetBoBusyFunc   m_setBoBusy = nullptr;
+    VASurfaceID         m_surfaces[SYNC_TEST_SURFACE_NUM] = {};
+};
+
+TEST_F(MediaSyncDdiTest, ExportReadableFd)
+{
+    ExecuteSyncTest(&MediaSyncDdiTest::ExportReadableFd);
+}
+
+TEST_F(MediaSyncDdiTest, SyncTimeout)
+{
+    ASSERT_NE(nullptr, m_setBoBusy) << "libdrm mock is not preloaded" << endl;
+    ExecuteSyncTest(&MediaSyncDdiTest::SyncTimeout);
+}
+
+TEST_F(MediaSyncDdiTest, InvalidSurface)
+{
+    ExecuteSyncTest(&MediaSyncDdiTest::InvalidSurface);
+}
+
+void MediaSyncDdiTest::ExecuteSyncTest(void (MediaSyncDdiTest::*test)(Platform_t platform))
+{
+    vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+    for (int i = 0; i < m_driverLoader.GetPlatformNum(); i++)
+    {
+        int ret = m_driverLoader.InitDriver(platforms[i]);
+        ASSERT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platforms[i]]
+            << ", Failed function = m_driverLoader.InitDriver" << endl;
+
+        ret = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2(&m_driverLoader.m_ctx, VA_RT_FORMAT_YUV420,
+            64, 64, m_surfaces, SYNC_TEST_SURFACE_NUM, nullptr, 0);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platforms[i]]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaCreateSurfaces2" << endl;
+
+        (this->*test)(platforms[i]);
+
+        ret = m_driverLoader.m_ctx.vtable->vaDestroySurfaces(&m_driverLoader.m_ctx, m_surfaces, SYNC_TEST_SURFACE_NUM);
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platforms[i]]
+            << ", Failed function = m_driverLoader.m_ctx.vtable->vaDestroySurfaces" << endl;
+
+        ret = m_driverLoader.CloseDriver();
+        EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platforms[i]]
+            << ", Failed function = m_driverLoader.CloseDriver" << endl;
+    }
+}
+
+void MediaSyncDdiTest::ExportReadableFd(Platform_t platform)
+{
+    const DriverSymbols &drvSyms = m_driverLoader.GetDriverSymbols();
+
+    // The mock GPU has no pending work, so the fence is signaled already.
+    int32_t fd  = -1;
+    int     ret = drvSyms.ExportSurfaceSyncFd(&m_driverLoader.m_ctx, m_surfaces[0], &fd);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform] << endl;
+    EXPECT_GE(fd, 0) << "Platform = " << g_platformName[platform] << endl;
+    if (fd >= 0)
+    {
+        EXPECT_TRUE(IsReadable(fd)) << "Platform = " << g_platformName[platform] << endl;
+        close(fd);
+    }
+}
+
+void MediaSyncDdiTest::SyncTimeout(Platform_t platform)
+{
+    const DriverSymbols &drvSyms = m_driverLoader.GetDriverSymbols();
+
+    m_setBoBusy(1);
+
+    int ret = drvSyms.SyncSurfaces(&m_driverLoader.m_ctx, m_surfaces, SYNC_TEST_SURFACE_NUM, SYNC_TEST_TIMEOUT_NS);
+    EXPECT_EQ(VA_STATUS_ERROR_TIMEDOUT, ret) << "Platform = " << g_platformName[platform] << endl;
+
+    ret = drvSyms.SyncSurfaces(&m_driverLoader.m_ctx, m_surfaces, SYNC_TEST_SURFACE_NUM, 0);
+    EXPECT_EQ(VA_STATUS_ERROR_TIMEDOUT, ret) << "Platform = " << g_platformName[platform] << endl;
+
+    // The fence of busy work must not poll readable.
+    int32_t fd = -1;
+    ret = drvSyms.ExportSurfaceSyncFd(&m_driverLoader.m_ctx, m_surfaces[1], &fd);
+    EXPECT_EQ(VA_STATUS_SUCCESS, ret) << "Platform = " << g_platformName[platform] << endl;
+    if (fd >= 0)
+    {
+        EXPECT_FALSE(IsReadable(fd)) << "Platform = " << g_platformName[platform] << endl;
+        close(fd);
+    }
+
+    m_setBoBusy(0);
+}
+
+void MediaSyncDdiTest::InvalidSurface(Platform_t platform)
+{
+    const DriverSymbols &drvSyms = m_driverLoader.GetDriverSymbols();
+
+    VASurfaceID surfaces[SYNC_TEST_SURFACE_NUM] = {m_surfaces[0], SYNC_TEST_INVALID_ID};
+    int ret = drvSyms.SyncSurfaces(&m_driverLoader.m_ctx, surfaces, SYNC_TEST_SURFACE_NUM, SYNC_TEST_TIMEOUT_NS);
+    EXPECT_EQ(VA_STATUS_ERROR_INVALID_SURFACE, ret) << "Platform = " << g_platformName[platform] << endl;
+
+    ret = drvSyms.SyncSurfaces(&m_driverLoader.m_ctx, surfaces, 0, SYNC_TEST_TIMEOUT_NS);
+    EXPECT_EQ(VA_STATUS_ERROR_INVALID_PARAMETER, ret) << "Platform = " << g_platformName[platform] << endl;
+
+    int32_t fd = -1;
+    ret = drvSyms.ExportSurfaceSyncFd(&m_driverLoader.m_ctx, SYNC_TEST_INVALID_ID, &fd);
+    EXPECT_EQ(VA_STATUS_ERROR_INVALID_SURFACE, ret) << "Platform = " << g_platformName[platform] << endl;
+    EXPECT_EQ(-1, fd) << "Platform = " << g_platformName[platform] << endl;
+
+    ret = drvSyms.ExportSurfaceSyncFd(&m_driverLoader.m_ctx, m_surfaces[0], nullptr);
+    EXPECT_EQ(VA_STATUS_ERROR_INVALID_PARAMETER, ret) << "Platform = " << g_platformName[platform] << endl;
+}
@@ -161,6 +161,11 @@ VAStatus DriverDllLoader::LoadDriverSymbols()
             m_drvSyms.MOS_SetUltFlag            = (MOS_SetUltFlagFunc)dlsym(m_umdhandle, "MOS_SetUltFlag");
             m_drvSyms.MOS_GetMemNinjaCounter    = (MOS_GetMemNinjaCounterFunc)dlsym(m_umdhandle, "MOS_GetMemNinjaCounter");
             m_drvSyms.MOS_GetMemNinjaCounterGfx = (MOS_GetMemNinjaCounterFunc)dlsym(m_umdhandle, "MOS_GetMemNinjaCounterGfx");
+            m_drvSyms.SyncSurfaces              = (SyncSurfacesFunc)dlsym(m_umdhandle, "DdiMedia_SyncSurfaces");
+            m_drvSyms.ExportSurfaceSyncFd       = (ExportSurfaceSyncFdFunc)dlsym(m_umdhandle, "DdiMedia_ExportSurfaceSyncFd");
+            m_drvSyms.BufmgrInitXe              = (BufmgrInitXeFunc)dlsym(m_umdhandle, "mos_bufmgr_gem_init_xe");
+            m_drvSyms.GetComponent              = (ComponentFunc)dlsym(m_umdhandle, "DdiMedia_GetComponent");
+            m_drvSyms.PeekComponent             = (ComponentFunc)dlsym(m_umdhandle, "DdiMedia_PeekComponent");
             m_drvSyms.ppfnUltGetCmdBuf          = (UltGetCmdBufFunc *)dlsym(m_umdhandle, "pfnUltGetCmdBuf");
             break;
         }
@@ -80,6 +80,21 @@ typedef int32_t (*MOS_GetMemNinjaCounterFunc)();
 
 typedef void (*UltGetCmdBufFunc)(PMOS_COMMAND_BUFFER pCmdBuffer);
 
+typedef VAStatus (*SyncSurfacesFunc)(
+                                VADriverContextP ctx,
+                                VASurfaceID      *surfaces,
+                                uint32_t         numSurfaces,
+                                int64_t          timeoutNs);
+
+typedef VAStatus (*ExportSurfaceSyncFdFunc)(
+                                VADriverContextP ctx,
+                                VASurfaceID      surfaceId,
+                                int32_t          *syncFd);
+
+typedef struct mos_bufmgr *(*BufmgrInitXeFunc)(int fd, int batchSize);
+
+typedef void *(*ComponentFunc)(VADriverContextP ctx, uint32_t type);
+
 struct DriverSymbols
 {
     bool Initialized() const
@@ -89,6 +104,11 @@ struct DriverSymbols
             !MOS_SetUltFlag            ||
             !MOS_GetMemNinjaCounter    ||
             !MOS_GetMemNinjaCounterGfx ||
+            !SyncSurfaces              ||
+            !ExportSurfaceSyncFd       ||
+            !BufmgrInitXe              ||
+            !GetComponent              ||
+            !PeekComponent             ||
             !ppfnUltGetCmdBuf)
         {
             return false;
@@ -102,6 +122,11 @@ struct DriverSymbols
     MOS_SetUltFlagFunc          MOS_SetUltFlag;
     MOS_GetMemNinjaCounterFunc  MOS_GetMemNinjaCounter;
     MOS_GetMemNinjaCounterFunc  MOS_GetMemNinjaCounterGfx;
+    SyncSurfacesFunc            SyncSurfaces;
+    ExportSurfaceSyncFdFunc     ExportSurfaceSyncFd;
+    BufmgrInitXeFunc            BufmgrInitXe;
+    ComponentFunc               GetComponent;
+    ComponentFunc               PeekComponent;
 
     // Data
     UltGetCmdBufFunc            *ppfnUltGetCmdBuf;
@@ -0,0 +1,306 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     kernel_dll_disk_cache_test.cpp
+//! \brief    Checks the save/restore round trip of the persistent FC kernel cache
+//!           and the rejection of stale or corrupted cache files
+//!
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "hal_kerneldll_next.h"
+
+using namespace std;
+
+//!
+//! \brief    Combined kernel as built by the kernel Dll: search filter, modified
+//!           filter, CSC parameters and binary
+//!
+struct KernelDllDiskCacheTestKernel
+{
+    KernelDllDiskCacheTestKernel(uint32_t id, int32_t kernelSize, bool procamp)
+    {
+        memset(search, 0, sizeof(search));
+        memset(modified, 0, sizeof(modified));
+        memset(&csc, 0, sizeof(csc));
+        memset(&entry, 0, sizeof(entry));
+
+        for (int32_t i = 0; i < 2; i++)
+        {
+            search[i].layer    = (Kdll_Layer)(i + 1);
+            search[i].format   = (MOS_FORMAT)(id + i);
+            search[i].procamp  = procamp ? 0 : DL_PROCAMP_DISABLED;
+            search[i].matrix   = DL_CSC_DISABLED;
+            modified[i]        = search[i];
+            modified[i].matrix = 0;
+        }
+
+        csc.ColorSpace           = CSpace_BT709;
+        csc.Matrix[0].bInUse     = 1;
+        csc.Matrix[0].iProcampID = procamp ? 0 : DL_PROCAMP_DISABLED;
+        csc.Matrix[0].Coeff[0]   = (short)id;
+        for (int32_t i = 1; i < DL_CSC_MAX; i++)
+        {
+            csc.Matrix[i].iProcampID = DL_PROCAMP_DISABLED;
+        }
+
+        binary.resize(kernelSize);
+        for (int32_t i = 0; i < kernelSize; i++)
+        {
+            binary[i] = (uint8_t)(id * 31 + i);
+        }
+
+        entry.pBinary          = binary.data();
+        entry.iSize            = kernelSize;
+        entry.iFilterSize      = 2;
+        entry.pFilter          = modified;
+        entry.pCscParams       = &csc;
+        entry.colorfill_cspace = CSpace_sRGB;
+        hash                   = id * 0x9e3779b1;  // the kernel Dll hashes the search filter
+    }
+
+    //!
+    //! \brief    Check that record holds this kernel
+    //!
+    void Check(const Kdll_DiskCacheRecord *record) const
+    {
+        ASSERT_NE(nullptr, record);
+        EXPECT_EQ(2, record->iFilterSize);
+        EXPECT_EQ(entry.iSize, record->iKernelSize);
+        EXPECT_EQ(CSpace_sRGB, record->colorfill_cspace);
+        EXPECT_EQ(0, memcmp(&csc, &record->CscParams, sizeof(csc)));
+
+        const Kdll_FilterEntry *filter = (const Kdll_FilterEntry *)(record + 1) + record->iFilter;
+        EXPECT_EQ(0, memcmp(modified, filter, sizeof(modified)));
+        EXPECT_EQ(0, memcmp(binary.data(), filter + record->iFilterSize, binary.size()));
+    }
+
+    Kdll_FilterEntry search[2];
+    Kdll_FilterEntry modified[2];
+    Kdll_CSC_Params  csc;
+    vector<uint8_t>  binary;
+    Kdll_CacheEntry  entry;
+    uint32_t         hash;
+};
+
+class KernelDllDiskCacheTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/kdll_disk_cache_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir));
+        m_dir = dir;
+        memset(&m_cache, 0, sizeof(m_cache));
+    }
+
+    void TearDown() override
+    {
+        remove(m_cache.szPath);
+        KernelDll_CloseDiskCache(&m_cache);
+        rmdir(m_dir.c_str());
+    }
+
+    bool Open(uint32_t checksum = m_checksum)
+    {
+        KernelDll_CloseDiskCache(&m_cache);
+        return KernelDll_OpenDiskCache(&m_cache, m_dir.c_str(), checksum);
+    }
+
+    bool Add(const KernelDllDiskCacheTestKernel &kernel)
+    {
+        return KernelDll_AddDiskCacheRecord(&m_cache, &kernel.entry, kernel.search, 2, kernel.hash);
+    }
+
+    Kdll_DiskCacheRecord *Find(const KernelDllDiskCacheTestKernel &kernel)
+    {
+        return KernelDll_FindDiskCacheRecord(&m_cache, kernel.search, 2, kernel.hash);
+    }
+
+    uint32_t RecordsInFile()
+    {
+        Kdll_DiskCacheHeader header = {};
+        FILE                *file   = fopen(m_cache.szPath, "rb");
+        if (!file)
+        {
+            return 0;
+        }
+        size_t read = fread(&header, sizeof(header), 1, file);
+        fclose(file);
+        return read == 1 ? header.dwRecords : 0;
+    }
+
+    static const uint32_t m_checksum = 0x5eed1234;
+    string                m_dir;
+    Kdll_DiskCache        m_cache;
+};
+
+TEST_F(KernelDllDiskCacheTest, DisabledWithoutDirectory)
+{
+    EXPECT_FALSE(KernelDll_OpenDiskCache(&m_cache, "", m_checksum));
+    EXPECT_FALSE(KernelDll_OpenDiskCache(&m_cache, nullptr, m_checksum));
+    EXPECT_FALSE(m_cache.bEnabled);
+
+    KernelDllDiskCacheTestKernel kernel(1, 64, false);
+    EXPECT_FALSE(Add(kernel));
+    EXPECT_EQ(nullptr, Find(kernel));
+    EXPECT_FALSE(KernelDll_WriteDiskCache(&m_cache));
+}
+
+TEST_F(KernelDllDiskCacheTest, RoundTrip)
+{
+    KernelDllDiskCacheTestKernel first(1, 100, false);
+    KernelDllDiskCacheTestKernel procamp(2, 200, true);
+    KernelDllDiskCacheTestKernel second(3, 4096, false);
+
+    ASSERT_TRUE(Open());
+    EXPECT_TRUE(m_cache.bEnabled);
+    EXPECT_EQ(nullptr, Find(first));
+
+    EXPECT_TRUE(Add(first));
+    EXPECT_FALSE(Add(procamp));  // procamp matrices follow the process, never persisted
+    EXPECT_TRUE(Add(second));
+    EXPECT_EQ(2u, m_cache.dwStores);
+    EXPECT_TRUE(m_cache.bDirty);
+    ASSERT_TRUE(KernelDll_WriteDiskCache(&m_cache));
+    EXPECT_FALSE(m_cache.bDirty);
+    EXPECT_EQ(2u, RecordsInFile());
+
+    ASSERT_TRUE(Open());
+    EXPECT_FALSE(m_cache.bDirty);
+    first.Check(Find(first));
+    second.Check(Find(second));
+    EXPECT_EQ(nullptr, Find(procamp));
+}
+
+TEST_F(KernelDllDiskCacheTest, RebuiltKernelSupersedesRecord)
+{
+    KernelDllDiskCacheTestKernel kernel(1, 100, false);
+    KernelDllDiskCacheTestKernel rebuilt(1, 120, false);
+    ASSERT_EQ(kernel.hash, rebuilt.hash);
+
+    ASSERT_TRUE(Open());
+    EXPECT_TRUE(Add(kernel));
+    ASSERT_TRUE(KernelDll_WriteDiskCache(&m_cache));
+
+    ASSERT_TRUE(Open());
+    EXPECT_TRUE(Add(rebuilt));
+    ASSERT_TRUE(KernelDll_WriteDiskCache(&m_cache));
+    EXPECT_EQ(1u, RecordsInFile());
+
+    ASSERT_TRUE(Open());
+    rebuilt.Check(Find(kernel));
+}
+
+TEST_F(KernelDllDiskCacheTest, CorruptKernelRejectsOnlyThatRecord)
+{
+    KernelDllDiskCacheTestKernel first(1, 100, false);
+    KernelDllDiskCacheTestKernel second(3, 256, false);
+
+    ASSERT_TRUE(Open());
+    EXPECT_TRUE(Add(first));
+    EXPECT_TRUE(Add(second));
+    ASSERT_TRUE(KernelDll_WriteDiskCache(&m_cache));
+
+    // flip one byte in the middle of the first kernel binary
+    long offset = sizeof(Kdll_DiskCacheHeader) + sizeof(Kdll_DiskCacheRecord) +
+                  4 * sizeof(Kdll_FilterEntry) + 50;
+    FILE *file = fopen(m_cache.szPath, "r+b");
+    ASSERT_NE(nullptr, file);
+    ASSERT_EQ(0, fseek(file, offset, SEEK_SET));
+    int byte = fgetc(file);
+    ASSERT_NE(EOF, byte);
+    ASSERT_EQ(0, fseek(file, offset, SEEK_SET));
+    fputc(byte ^ 0x5a, file);
+    fclose(file);
+
+    ASSERT_TRUE(Open());
+    EXPECT_EQ(nullptr, Find(first));
+    second.Check(Find(second));
+    EXPECT_TRUE(m_cache.bDirty);
+
+    // the rejected record is dropped on the next write
+    ASSERT_TRUE(KernelDll_WriteDiskCache(&m_cache));
+    EXPECT_EQ(1u, RecordsInFile());
+}
+
+TEST_F(KernelDllDiskCacheTest, CorruptCscParamsRejectsRecord)
+{
+    KernelDllDiskCacheTestKernel kernel(1, 100, false);
+
+    ASSERT_TRUE(Open());
+    EXPECT_TRUE(Add(kernel));
+    ASSERT_TRUE(KernelDll_WriteDiskCache(&m_cache));
+
+    long  offset = sizeof(Kdll_DiskCacheHeader) + offsetof(Kdll_DiskCacheRecord, CscParams) +
+                   offsetof(Kdll_CSC_Params, Matrix) + offsetof(Kdll_CSC_Matrix, Coeff);
+    FILE *file   = fopen(m_cache.szPath, "r+b");
+    ASSERT_NE(nullptr, file);
+    ASSERT_EQ(0, fseek(file, offset, SEEK_SET));
+    fputc(0x7f, file);
+    fclose(file);
+
+    ASSERT_TRUE(Open());
+    EXPECT_EQ(nullptr, Find(kernel));
+}
+
+TEST_F(KernelDllDiskCacheTest, TruncatedFileIsDiscarded)
+{
+    KernelDllDiskCacheTestKernel first(1, 100, false);
+    KernelDllDiskCacheTestKernel second(3, 256, false);
+
+    ASSERT_TRUE(Open());
+    EXPECT_TRUE(Add(first));
+    EXPECT_TRUE(Add(second));
+    ASSERT_TRUE(KernelDll_WriteDiskCache(&m_cache));
+    uint32_t size = m_cache.dwDataSize;
+    ASSERT_EQ(0, truncate(m_cache.szPath, size - 8));
+
+    // still enabled, starts over from an empty image
+    ASSERT_TRUE(Open());
+    EXPECT_EQ(sizeof(Kdll_DiskCacheHeader), m_cache.dwDataSize);
+    EXPECT_EQ(nullptr, Find(first));
+    EXPECT_EQ(nullptr, Find(second));
+}
+
+TEST_F(KernelDllDiskCacheTest, OtherKernelBuildIsIgnored)
+{
+    KernelDllDiskCacheTestKernel kernel(1, 100, false);
+
+    ASSERT_TRUE(Open());
+    EXPECT_TRUE(Add(kernel));
+    ASSERT_TRUE(KernelDll_WriteDiskCache(&m_cache));
+    string path = m_cache.szPath;
+
+    // the checksum is part of the file name, a file renamed into place is still rejected
+    ASSERT_TRUE(Open(m_checksum + 1));
+    ASSERT_EQ(0, rename(path.c_str(), m_cache.szPath));
+    ASSERT_TRUE(Open(m_checksum + 1));
+    EXPECT_EQ(sizeof(Kdll_DiskCacheHeader), m_cache.dwDataSize);
+    EXPECT_EQ(nullptr, Find(kernel));
+}
@@ -0,0 +1,167 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_copy_batch_test.cpp
+//! \brief    Checks the submission order and the copied count of batched media copies
+//!
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_copy_batch.h"
+
+using namespace std;
+
+//!
+//! \brief    Records the submissions of a batch, "B<first>+<num>" for a BLT run
+//!           and "S<index>" for a single copy, and fails the copies asked to
+//!
+class MediaCopyBatchTest : public testing::Test
+{
+protected:
+    MOS_STATUS Dispatch(const vector<bool> &engines, uint32_t &copied)
+    {
+        m_isBlt.reset(new bool[engines.size()]);
+        for (size_t i = 0; i < engines.size(); i++)
+        {
+            m_isBlt[i] = engines[i];
+        }
+        return MediaCopyBatchDispatcher::Dispatch(m_isBlt.get(), (uint32_t)engines.size(), BltRun(), SingleCopy(), copied);
+    }
+
+    MediaCopyBatchDispatcher::BltRun BltRun()
+    {
+        return [this](uint32_t first, uint32_t num, uint32_t &copied) {
+            m_log.push_back("B" + to_string(first) + "+" + to_string(num));
+            copied = 0;
+            for (uint32_t i = first; i < first + num; i++)
+            {
+                if (i == m_failIndex)
+                {
+                    return m_failStatus;
+                }
+                copied++;
+            }
+            return MOS_STATUS_SUCCESS;
+        };
+    }
+
+    MediaCopyBatchDispatcher::SingleCopy SingleCopy()
+    {
+        return [this](uint32_t index) {
+            m_log.push_back("S" + to_string(index));
+            return (index == m_failIndex) ? m_singleFailStatus : MOS_STATUS_SUCCESS;
+        };
+    }
+
+    unique_ptr<bool[]> m_isBlt;
+    vector<string>     m_log;
+    uint32_t           m_failIndex        = UINT32_MAX;
+    MOS_STATUS         m_failStatus       = MOS_STATUS_UNKNOWN;
+    MOS_STATUS         m_singleFailStatus = MOS_STATUS_UNKNOWN;
+};
+
+TEST_F(MediaCopyBatchTest, BltRunsKeepOrderAroundSingleCopies)
+{
+    uint32_t copied = 0;
+    EXPECT_EQ(MOS_STATUS_SUCCESS, Dispatch({true, true, false, true, false, false, true, true, true}, copied));
+    EXPECT_EQ(9u, copied);
+    EXPECT_EQ((vector<string>{"B0+2", "S2", "B3+1", "S4", "S5", "B6+3"}), m_log);
+}
+
+TEST_F(MediaCopyBatchTest, AllBltIsOneRun)
+{
+    uint32_t copied = 0;
+    EXPECT_EQ(MOS_STATUS_SUCCESS, Dispatch({true, true, true, true}, copied));
+    EXPECT_EQ(4u, copied);
+    EXPECT_EQ((vector<string>{"B0+4"}), m_log);
+}
+
+TEST_F(MediaCopyBatchTest, EmptyBatch)
+{
+    uint32_t copied = 1;
+    EXPECT_EQ(MOS_STATUS_SUCCESS, Dispatch({}, copied));
+    EXPECT_EQ(0u, copied);
+    EXPECT_TRUE(m_log.empty());
+
+    copied = 1;
+    EXPECT_EQ(MOS_STATUS_NULL_POINTER, MediaCopyBatchDispatcher::Dispatch(nullptr, 2, BltRun(), SingleCopy(), copied));
+    EXPECT_EQ(0u, copied);
+}
+
+TEST_F(MediaCopyBatchTest, BltFailureStopsAtPartialRun)
+{
+    // the run 3..5 submits copy 3, fails on 4, nothing after it is submitted
+    uint32_t copied = 0;
+    m_failIndex     = 4;
+    EXPECT_EQ(MOS_STATUS_UNKNOWN, Dispatch({true, false, false, true, true, true, false}, copied));
+    EXPECT_EQ(4u, copied);
+    EXPECT_EQ((vector<string>{"B0+1", "S1", "S2", "B3+3"}), m_log);
+}
+
+TEST_F(MediaCopyBatchTest, SingleCopyFailureStops)
+{
+    uint32_t copied = 0;
+    m_failIndex     = 2;
+    EXPECT_EQ(MOS_STATUS_UNKNOWN, Dispatch({true, true, false, true}, copied));
+    EXPECT_EQ(2u, copied);
+    EXPECT_EQ((vector<string>{"B0+2", "S2"}), m_log);
+}
+
+TEST_F(MediaCopyBatchTest, FallbackResumesAfterCopied)
+{
+    // no BLT state: the run from copy 2 on is not taken, the rest is copied one by one
+    uint32_t copied = 0;
+    m_failIndex     = 2;
+    m_failStatus    = MOS_STATUS_UNIMPLEMENTED;
+    MOS_STATUS status = Dispatch({false, false, true, true}, copied);
+    EXPECT_EQ(MOS_STATUS_UNIMPLEMENTED, status);
+    EXPECT_EQ(2u, copied);
+
+    m_failIndex = UINT32_MAX;
+    EXPECT_EQ(MOS_STATUS_SUCCESS, MediaCopyBatchDispatcher::FallbackToSingleCopies(status, 4, SingleCopy(), copied));
+    EXPECT_EQ(4u, copied);
+    EXPECT_EQ((vector<string>{"S0", "S1", "B2+2", "S2", "S3"}), m_log);
+}
+
+TEST_F(MediaCopyBatchTest, FallbackStopsOnSingleCopyFailure)
+{
+    uint32_t copied    = 1;
+    m_failIndex        = 3;
+    m_singleFailStatus = MOS_STATUS_INVALID_PARAMETER;
+    EXPECT_EQ(MOS_STATUS_INVALID_PARAMETER,
+        MediaCopyBatchDispatcher::FallbackToSingleCopies(MOS_STATUS_UNIMPLEMENTED, 5, SingleCopy(), copied));
+    EXPECT_EQ(3u, copied);
+    EXPECT_EQ((vector<string>{"S1", "S2", "S3"}), m_log);
+}
+
+TEST_F(MediaCopyBatchTest, NoFallbackOnOtherStatus)
+{
+    uint32_t copied = 1;
+    EXPECT_EQ(MOS_STATUS_UNKNOWN,
+        MediaCopyBatchDispatcher::FallbackToSingleCopies(MOS_STATUS_UNKNOWN, 4, SingleCopy(), copied));
+    EXPECT_EQ(MOS_STATUS_SUCCESS,
+        MediaCopyBatchDispatcher::FallbackToSingleCopies(MOS_STATUS_SUCCESS, 4, SingleCopy(), copied));
+    EXPECT_EQ(1u, copied);
+    EXPECT_TRUE(m_log.empty());
+}
@@ -0,0 +1,211 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_copy_load_balance_test.cpp
+//! \brief    Simulates engine queues and checks the media copy engine choices
+//!
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_copy_load_balance.h"
+
+using namespace std;
+
+// engine order of MCPY_ENGINE
+static const uint32_t engineVebox  = 0;
+static const uint32_t engineBlt    = 1;
+static const uint32_t engineRender = 2;
+
+//!
+//! \brief    Engine queues of one device, each engine retires a fixed number of
+//!           submissions per tick and counts how often its load is probed
+//!
+class MediaCopyEngineSim
+{
+public:
+    MediaCopyEngineSim(uint32_t veboxRate, uint32_t bltRate, uint32_t renderRate)
+    {
+        m_rate[engineVebox]  = veboxRate;
+        m_rate[engineBlt]    = bltRate;
+        m_rate[engineRender] = renderRate;
+    }
+
+    MediaCopyLoadBalancer::LoadQuery Query()
+    {
+        return [this](uint32_t engine) {
+            m_probes[engine]++;
+            return m_pending[engine];
+        };
+    }
+
+    void Submit(uint32_t engine, uint32_t count = 1)
+    {
+        m_pending[engine] += count;
+    }
+
+    void Tick()
+    {
+        for (uint32_t i = 0; i < MCPY_ENGINE_LOAD_ENGINE_NUM; i++)
+        {
+            m_pending[i] -= (m_pending[i] < m_rate[i]) ? m_pending[i] : m_rate[i];
+        }
+    }
+
+    uint32_t m_pending[MCPY_ENGINE_LOAD_ENGINE_NUM] = {};
+    uint32_t m_rate[MCPY_ENGINE_LOAD_ENGINE_NUM]    = {};
+    uint32_t m_probes[MCPY_ENGINE_LOAD_ENGINE_NUM]  = {};
+};
+
+static const bool allCapable[MCPY_ENGINE_LOAD_ENGINE_NUM] = {true, true, true};
+
+TEST(MediaCopyLoadBalanceTest, KeepsPreferredEngineWhenNearlyIdle)
+{
+    MediaCopyLoadBalancer balancer;
+    MediaCopyEngineSim    sim(1, 1, 1);
+
+    sim.Submit(engineBlt, MCPY_ENGINE_LOAD_MARGIN - 1);
+    EXPECT_EQ(engineBlt, balancer.SelectEngine(engineBlt, allCapable, 0, sim.Query()));
+    // the other engines are not probed when the preferred one is nearly idle
+    EXPECT_EQ(0u, sim.m_probes[engineVebox]);
+    EXPECT_EQ(0u, sim.m_probes[engineRender]);
+}
+
+TEST(MediaCopyLoadBalanceTest, MovesToLeastLoadedCapableEngine)
+{
+    MediaCopyLoadBalancer balancer;
+    MediaCopyEngineSim    sim(1, 1, 1);
+
+    sim.Submit(engineBlt, 6);
+    sim.Submit(engineVebox, 3);
+    sim.Submit(engineRender, 1);
+    EXPECT_EQ(engineRender, balancer.SelectEngine(engineBlt, allCapable, 0, sim.Query()));
+
+    // render is not capable, e.g. no CCS node
+    MediaCopyLoadBalancer noRender;
+    bool                  capable[MCPY_ENGINE_LOAD_ENGINE_NUM] = {true, true, false};
+    EXPECT_EQ(engineVebox, noRender.SelectEngine(engineBlt, capable, 0, sim.Query()));
+}
+
+TEST(MediaCopyLoadBalanceTest, NeedsLoadMarginToMove)
+{
+    MediaCopyLoadBalancer balancer;
+    MediaCopyEngineSim    sim(1, 1, 1);
+
+    sim.Submit(engineVebox, 4);
+    sim.Submit(engineBlt, 4 - MCPY_ENGINE_LOAD_MARGIN + 1);
+    sim.Submit(engineRender, 4 - MCPY_ENGINE_LOAD_MARGIN + 1);
+    EXPECT_EQ(engineVebox, balancer.SelectEngine(engineVebox, allCapable, 0, sim.Query()));
+}
+
+TEST(MediaCopyLoadBalanceTest, SaturatesReportedLoad)
+{
+    MediaCopyLoadBalancer balancer;
+    MediaCopyEngineSim    sim(1, 1, 1);
+
+    // both beyond the maximum look equally busy, so the copy stays
+    sim.Submit(engineBlt, 100 * MCPY_ENGINE_LOAD_MAX);
+    sim.Submit(engineVebox, 10 * MCPY_ENGINE_LOAD_MAX);
+    bool capable[MCPY_ENGINE_LOAD_ENGINE_NUM] = {true, true, false};
+    EXPECT_EQ(engineBlt, balancer.SelectEngine(engineBlt, capable, 0, sim.Query()));
+}
+
+TEST(MediaCopyLoadBalanceTest, CachesLoadWithinInterval)
+{
+    MediaCopyLoadBalancer balancer;
+    MediaCopyEngineSim    sim(1, 1, 1);
+
+    sim.Submit(engineBlt, MCPY_ENGINE_LOAD_MAX);
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        balancer.SelectEngine(engineBlt, allCapable, i, sim.Query());
+    }
+    EXPECT_EQ(1u, sim.m_probes[engineBlt]);
+    EXPECT_EQ(1u, sim.m_probes[engineVebox]);
+    EXPECT_EQ(1u, sim.m_probes[engineRender]);
+
+    balancer.SelectEngine(engineBlt, allCapable, MCPY_ENGINE_LOAD_CACHE_US, sim.Query());
+    EXPECT_EQ(2u, sim.m_probes[engineBlt]);
+}
+
+TEST(MediaCopyLoadBalanceTest, SpreadsBackToBackCopiesInsideInterval)
+{
+    MediaCopyLoadBalancer balancer;
+    MediaCopyEngineSim    sim(1, 1, 1);
+    uint32_t              picked[MCPY_ENGINE_LOAD_ENGINE_NUM] = {};
+
+    sim.Submit(engineBlt, MCPY_ENGINE_LOAD_MAX);
+    for (uint32_t i = 0; i < 12; i++)
+    {
+        uint32_t engine = balancer.SelectEngine(engineBlt, allCapable, 0, sim.Query());
+        balancer.OnSubmit(engine);
+        picked[engine]++;
+    }
+    // the cached loads grow with every pick, so idle engines do not take everything
+    EXPECT_GT(picked[engineVebox], 0u);
+    EXPECT_GT(picked[engineRender], 0u);
+    EXPECT_LE(picked[engineVebox], 8u);
+    EXPECT_LE(picked[engineRender], 8u);
+}
+
+TEST(MediaCopyLoadBalanceTest, SimulatedSaturatedBltOffloadsCopies)
+{
+    MediaCopyLoadBalancer balancer;
+    // decode saturates BLT with 2 new submissions per tick, it retires 1
+    MediaCopyEngineSim    sim(2, 1, 2);
+    uint32_t              picked[MCPY_ENGINE_LOAD_ENGINE_NUM] = {};
+    uint32_t              maxPending[MCPY_ENGINE_LOAD_ENGINE_NUM] = {};
+    uint64_t              nowUs = 0;
+
+    for (uint32_t tick = 0; tick < 1000; tick++)
+    {
+        sim.Submit(engineBlt, 2);
+        for (uint32_t copy = 0; copy < 2; copy++)
+        {
+            uint32_t engine = balancer.SelectEngine(engineBlt, allCapable, nowUs, sim.Query());
+            balancer.OnSubmit(engine);
+            sim.Submit(engine);
+            picked[engine]++;
+        }
+        sim.Tick();
+        nowUs += MCPY_ENGINE_LOAD_CACHE_US / 4;
+        for (uint32_t i = 0; i < MCPY_ENGINE_LOAD_ENGINE_NUM; i++)
+        {
+            maxPending[i] = (sim.m_pending[i] > maxPending[i]) ? sim.m_pending[i] : maxPending[i];
+        }
+    }
+
+    // copies leave the saturated BLT, and vebox and render keep up with them
+    EXPECT_GT(picked[engineVebox] + picked[engineRender], picked[engineBlt]);
+    EXPECT_LE(maxPending[engineVebox], MCPY_ENGINE_LOAD_MAX + 4u);
+    EXPECT_LE(maxPending[engineRender], MCPY_ENGINE_LOAD_MAX + 4u);
+    // loads are probed at most once per cache interval per engine
+    EXPECT_LE(sim.m_probes[engineBlt], 1000u / 4 + 1);
+}
+
+TEST(MediaCopyLoadBalanceTest, RejectsInvalidEngine)
+{
+    MediaCopyLoadBalancer balancer;
+    MediaCopyEngineSim    sim(1, 1, 1);
+
+    EXPECT_EQ((uint32_t)MCPY_ENGINE_LOAD_ENGINE_NUM, balancer.SelectEngine(MCPY_ENGINE_LOAD_ENGINE_NUM, allCapable, 0, sim.Query()));
+    EXPECT_EQ(engineBlt, balancer.SelectEngine(engineBlt, nullptr, 0, sim.Query()));
+}
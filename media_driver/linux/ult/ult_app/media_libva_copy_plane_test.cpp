@@ -0,0 +1,272 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_libva_copy_plane_test.cpp
+//! \brief    Checks the band split, the worker pool and the vaGetImage/vaPutImage plane copy
+//!
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_libva_copy_plane.h"
+
+using namespace std;
+
+TEST(MediaLibvaCopyPlaneTest, SplitBandsFewerRowsThanWorkers)
+{
+    uint32_t bandHeight = 0;
+
+    EXPECT_EQ(3u, MediaLibvaUtilNext_CopyPlane::SplitBands(3, 4, bandHeight));
+    EXPECT_EQ(1u, bandHeight);
+
+    EXPECT_EQ(1u, MediaLibvaUtilNext_CopyPlane::SplitBands(1, 4, bandHeight));
+    EXPECT_EQ(1u, bandHeight);
+}
+
+TEST(MediaLibvaCopyPlaneTest, SplitBandsUneven)
+{
+    uint32_t bandHeight = 0;
+
+    // 2, 2, 1 rows: the last worker gets nothing rather than a zero row band
+    EXPECT_EQ(3u, MediaLibvaUtilNext_CopyPlane::SplitBands(5, 4, bandHeight));
+    EXPECT_EQ(2u, bandHeight);
+
+    // 4K chroma for 4 threads: 270, 270, 270, 270
+    EXPECT_EQ(4u, MediaLibvaUtilNext_CopyPlane::SplitBands(1080, 4, bandHeight));
+    EXPECT_EQ(270u, bandHeight);
+
+    // 1081 rows: 271, 271, 271, 268
+    EXPECT_EQ(4u, MediaLibvaUtilNext_CopyPlane::SplitBands(1081, 4, bandHeight));
+    EXPECT_EQ(271u, bandHeight);
+}
+
+TEST(MediaLibvaCopyPlaneTest, SplitBandsEmpty)
+{
+    uint32_t bandHeight = 1;
+    EXPECT_EQ(0u, MediaLibvaUtilNext_CopyPlane::SplitBands(0, 4, bandHeight));
+    EXPECT_EQ(0u, bandHeight);
+
+    bandHeight = 1;
+    EXPECT_EQ(0u, MediaLibvaUtilNext_CopyPlane::SplitBands(16, 0, bandHeight));
+    EXPECT_EQ(0u, bandHeight);
+
+    // no overflow near the top of the range
+    EXPECT_EQ(2u, MediaLibvaUtilNext_CopyPlane::SplitBands(0xffffffff, 2, bandHeight));
+    EXPECT_EQ(0x80000000u, bandHeight);
+}
+
+TEST(MediaLibvaCopyPlaneTest, SplitBandsCoverAllRowsOnce)
+{
+    for (uint32_t height = 1; height <= 96; height++)
+    {
+        for (uint32_t workerNum = 1; workerNum <= 9; workerNum++)
+        {
+            uint32_t bandHeight = 0;
+            uint32_t bandNum    = MediaLibvaUtilNext_CopyPlane::SplitBands(height, workerNum, bandHeight);
+            ASSERT_GE(bandNum, 1u);
+            ASSERT_LE(bandNum, workerNum);
+            ASSERT_LE(bandNum, height);
+
+            vector<uint32_t> rowCopies(height, 0);
+            for (uint32_t band = 0; band < bandNum; band++)
+            {
+                uint32_t y = band * bandHeight;
+                ASSERT_LT(y, height) << "empty band " << band << " for " << height << " rows, " << workerNum << " workers";
+                for (uint32_t row = y; row < min(y + bandHeight, height); row++)
+                {
+                    rowCopies[row]++;
+                }
+            }
+            for (uint32_t row = 0; row < height; row++)
+            {
+                ASSERT_EQ(1u, rowCopies[row]) << "row " << row << " of " << height << ", " << workerNum << " workers";
+            }
+        }
+    }
+}
+
+TEST(MediaLibvaCopyPlaneTest, WorkerPoolRunsEveryTaskOnce)
+{
+    MediaLibvaUtilNext_WorkerPool pool(3);
+    EXPECT_GE(pool.GetMaxConcurrency(), 1u);
+    EXPECT_LE(pool.GetMaxConcurrency(), 4u);
+
+    for (uint32_t taskNum = 0; taskNum <= 17; taskNum++)
+    {
+        vector<atomic<uint32_t>> runs(taskNum);
+        for (auto &run : runs)
+        {
+            run = 0;
+        }
+
+        pool.Run(taskNum, [&](uint32_t index) { runs[index]++; });
+
+        for (uint32_t i = 0; i < taskNum; i++)
+        {
+            EXPECT_EQ(1u, runs[i].load()) << "task " << i << " of " << taskNum;
+        }
+    }
+}
+
+TEST(MediaLibvaCopyPlaneTest, WorkerPoolConcurrentCallers)
+{
+    // Callers finding the pool busy run their job inline, every job still completes.
+    MediaLibvaUtilNext_WorkerPool pool(3);
+    const uint32_t                callerNum = 4;
+    const uint32_t                jobNum    = 200;
+    const uint32_t                taskNum   = 8;
+    vector<atomic<uint32_t>>      runs(callerNum);
+    for (auto &run : runs)
+    {
+        run = 0;
+    }
+
+    vector<thread> callers;
+    for (uint32_t caller = 0; caller < callerNum; caller++)
+    {
+        callers.emplace_back([&, caller] {
+            for (uint32_t job = 0; job < jobNum; job++)
+            {
+                pool.Run(taskNum, [&](uint32_t) { runs[caller]++; });
+            }
+        });
+    }
+    for (auto &caller : callers)
+    {
+        caller.join();
+    }
+
+    for (uint32_t caller = 0; caller < callerNum; caller++)
+    {
+        EXPECT_EQ(jobNum * taskNum, runs[caller].load());
+    }
+}
+
+//!
+//! \brief    Plane of a surface mapping and its image copy, pitches differ as
+//!           in vaGetImage/vaPutImage of a tiled surface to a linear image
+//!
+struct CopyPlaneTestPlane
+{
+    const char *name;
+    uint32_t    rowSize;
+    uint32_t    height;
+};
+
+static void FillPlane(vector<uint8_t> &plane)
+{
+    uint32_t seed = 0x12345678;
+    for (auto &byte : plane)
+    {
+        seed = seed * 1103515245 + 12345;
+        byte = (uint8_t)(seed >> 16);
+    }
+}
+
+static void CheckPlane(const vector<uint8_t> &dst, uint32_t dstPitch, const vector<uint8_t> &src,
+    uint32_t srcPitch, uint32_t rowSize, uint32_t height)
+{
+    for (uint32_t y = 0; y < height; y++)
+    {
+        ASSERT_EQ(0, memcmp(&dst[(size_t)y * dstPitch], &src[(size_t)y * srcPitch], rowSize)) << "row " << y;
+    }
+}
+
+TEST(MediaLibvaCopyPlaneTest, CopyPitchMismatch)
+{
+    MediaLibvaUtilNext_WorkerPool pool(3);
+    const uint32_t                rowSize  = 4100;  // not a multiple of 16, exercises the streaming load tail
+    const uint32_t                height   = 4097;  // over 16MB, splits into 4 uneven bands
+    const uint32_t                srcPitch = 4224;
+    const uint32_t                dstPitch = rowSize;
+
+    vector<uint8_t> src((size_t)srcPitch * height + 1);
+    FillPlane(src);
+
+    for (bool srcUncached : {false, true})
+    {
+        for (MediaLibvaUtilNext_WorkerPool *workerPool : {(MediaLibvaUtilNext_WorkerPool *)nullptr, &pool})
+        {
+            vector<uint8_t> dst((size_t)dstPitch * height, 0);
+            // unaligned source rows take the streaming load head path
+            MediaLibvaUtilNext_CopyPlane::Copy(workerPool, dst.data(), dstPitch, src.data() + 1, srcPitch,
+                rowSize, height, srcUncached);
+            vector<uint8_t> srcShifted(src.begin() + 1, src.end());
+            CheckPlane(dst, dstPitch, srcShifted, srcPitch, rowSize, height);
+        }
+    }
+}
+
+//!
+//! \brief    Times 4K/8K plane copies on the calling thread and split over the
+//!           pool, for the formats vaGetImage/vaPutImage copy most. The surface
+//!           here is system memory, so the streaming load gain on a write-combined
+//!           mapping is not measured, only the band split.
+//!
+TEST(MediaLibvaCopyPlaneTest, CopyBenchmark)
+{
+    const CopyPlaneTestPlane planes[] = {
+        {"4K NV12 Y",   3840,     2160},
+        {"4K NV12 UV",  3840,     1080},
+        {"4K P010 Y",   3840 * 2, 2160},
+        {"4K Y410",     3840 * 4, 2160},
+        {"8K NV12 Y",   7680,     4320},
+        {"8K P010 Y",   7680 * 2, 4320},
+    };
+    const uint32_t                iterations = 4;
+    MediaLibvaUtilNext_WorkerPool pool(3);
+
+    printf("[ BENCH    ] %u threads\n", pool.GetMaxConcurrency());
+    for (const auto &plane : planes)
+    {
+        uint32_t        srcPitch = (plane.rowSize + 127) & ~127;
+        uint32_t        dstPitch = plane.rowSize;
+        vector<uint8_t> src((size_t)srcPitch * plane.height);
+        vector<uint8_t> dst((size_t)dstPitch * plane.height, 0);
+        FillPlane(src);
+
+        double usec[2] = {};
+        for (uint32_t mode = 0; mode < 2; mode++)
+        {
+            MediaLibvaUtilNext_WorkerPool *workerPool = mode ? &pool : nullptr;
+            // warm up, also starts the pool threads
+            MediaLibvaUtilNext_CopyPlane::Copy(workerPool, dst.data(), dstPitch, src.data(), srcPitch,
+                plane.rowSize, plane.height, false);
+
+            auto start = chrono::steady_clock::now();
+            for (uint32_t i = 0; i < iterations; i++)
+            {
+                MediaLibvaUtilNext_CopyPlane::Copy(workerPool, dst.data(), dstPitch, src.data(), srcPitch,
+                    plane.rowSize, plane.height, true);
+            }
+            usec[mode] = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / iterations;
+            CheckPlane(dst, dstPitch, src, srcPitch, plane.rowSize, plane.height);
+        }
+
+        printf("[ BENCH    ] %-10s %8.0f us single, %8.0f us pooled, %.2fx\n",
+            plane.name, usec[0], usec[1], usec[1] > 0 ? usec[0] / usec[1] : 0.0);
+    }
+}
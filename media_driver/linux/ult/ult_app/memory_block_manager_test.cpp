@@ -0,0 +1,336 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     memory_block_manager_test.cpp
+//! \brief    Drives the heap manager through acquire, submit and retire with both tracker modes
+//!
+
+#include <cstdlib>
+#include <vector>
+#include "gtest/gtest.h"
+#include "heap_manager.h"
+#include "frame_tracker.h"
+
+using namespace std;
+
+// One page heap, holds four blocks of the quarter size
+static const uint32_t heapTestHeapSize  = MOS_PAGE_SIZE;
+static const uint32_t heapTestBlockSize = heapTestHeapSize / 4;
+
+//!
+//! \brief    OS interface which backs heap resources with system memory
+//!
+struct HeapTestOsInterface : public MOS_INTERFACE
+{
+    HeapTestOsInterface() : MOS_INTERFACE()
+    {
+        pfnAllocateResource = AllocateResource;
+        pfnFreeResource     = FreeResource;
+        pfnLockResource     = LockResource;
+        pfnUnlockResource   = UnlockResource;
+        pfnSkipResourceSync = SkipResourceSync;
+    }
+
+#if MOS_MESSAGES_ENABLED
+    static MOS_STATUS AllocateResource(
+        PMOS_INTERFACE           osInterface,
+        PMOS_ALLOC_GFXRES_PARAMS params,
+        const char               *functionName,
+        const char               *filename,
+        int32_t                  line,
+        PMOS_RESOURCE            resource)
+#else
+    static MOS_STATUS AllocateResource(
+        PMOS_INTERFACE           osInterface,
+        PMOS_ALLOC_GFXRES_PARAMS params,
+        PMOS_RESOURCE            resource)
+#endif
+    {
+        resource->pData = (uint8_t *)calloc(1, params->dwBytes);
+        if (resource->pData == nullptr)
+        {
+            return MOS_STATUS_NO_SPACE;
+        }
+        static_cast<HeapTestOsInterface *>(osInterface)->m_liveResources++;
+        return MOS_STATUS_SUCCESS;
+    }
+
+#if MOS_MESSAGES_ENABLED
+    static void FreeResource(
+        PMOS_INTERFACE osInterface,
+        const char     *functionName,
+        const char     *filename,
+        int32_t        line,
+        PMOS_RESOURCE  resource)
+#else
+    static void FreeResource(
+        PMOS_INTERFACE osInterface,
+        PMOS_RESOURCE  resource)
+#endif
+    {
+        if (resource->pData != nullptr)
+        {
+            free(resource->pData);
+            resource->pData = nullptr;
+            static_cast<HeapTestOsInterface *>(osInterface)->m_liveResources--;
+        }
+    }
+
+    static void *LockResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource, PMOS_LOCK_PARAMS flags)
+    {
+        return resource->pData;
+    }
+
+    static MOS_STATUS UnlockResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE resource)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    static MOS_STATUS SkipResourceSync(PMOS_RESOURCE resource)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    int32_t m_liveResources = 0;
+};
+
+//!
+//! \brief    Tracker producer whose latest trackers live in system memory, so the test
+//!           plays the GPU by writing the completed tracker of an index
+//!
+class HeapTestTrackerProducer : public FrameTrackerProducer
+{
+public:
+    HeapTestTrackerProducer()
+    {
+        m_resourceData = m_latestTrackers;
+    }
+
+    void SetNextTracker(uint32_t index, uint32_t tracker)
+    {
+        m_counters[index] = tracker;
+    }
+
+    void Complete(uint32_t index, uint32_t tracker)
+    {
+        *GetLatestTrackerAddress(index) = tracker;
+    }
+
+protected:
+    uint32_t m_latestTrackers[MAX_TRACKER_NUMBER * m_trackerSize / sizeof(uint32_t)] = {};
+};
+
+class MemoryBlockManagerTest : public testing::Test
+{
+protected:
+
+    virtual void SetUp()
+    {
+        m_allocCounter = *MosUtilities::m_mosMemAllocCounter;
+        m_heapManager  = new HeapManager();
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_heapManager->RegisterOsInterface(&m_osInterface));
+        m_heapManager->SetDefaultBehavior(HeapManager::Behavior::clientControlled);
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_heapManager->SetInitialHeapSize(heapTestHeapSize));
+    }
+
+    virtual void TearDown()
+    {
+        delete m_heapManager;
+        EXPECT_EQ(0, m_osInterface.m_liveResources);
+        EXPECT_EQ(m_allocCounter, *MosUtilities::m_mosMemAllocCounter);
+    }
+
+    MOS_STATUS Acquire(
+        uint32_t                trackerIndex,
+        uint32_t                trackerId,
+        vector<uint32_t>        sizes,
+        vector<MemoryBlock>     &blocks,
+        uint32_t                &spaceNeeded)
+    {
+        MemoryBlockManager::AcquireParams params(trackerId, sizes);
+        params.m_trackerIndex = trackerIndex;
+        return m_heapManager->AcquireSpace(params, blocks, spaceNeeded);
+    }
+
+    //!
+    //! \brief    Acquires one quarter block of the heap and submits it right away
+    //!
+    MOS_STATUS AcquireAndSubmit(uint32_t trackerIndex, uint32_t trackerId, vector<MemoryBlock> &blocks)
+    {
+        uint32_t spaceNeeded = 0;
+        MOS_STATUS status = Acquire(trackerIndex, trackerId, {heapTestBlockSize}, blocks, spaceNeeded);
+        if (status != MOS_STATUS_SUCCESS)
+        {
+            return status;
+        }
+        return m_heapManager->SubmitBlocks(blocks);
+    }
+
+    //!
+    //! \brief    Checks the blocks lie within the heap and do not overlap each other
+    //!
+    static void ExpectDisjoint(vector<MemoryBlock> &blocks)
+    {
+        for (uint32_t i = 0; i < blocks.size(); i++)
+        {
+            EXPECT_TRUE(blocks[i].IsValid());
+            EXPECT_LE(blocks[i].GetOffset() + blocks[i].GetSize(), heapTestHeapSize);
+            for (uint32_t j = i + 1; j < blocks.size(); j++)
+            {
+                EXPECT_TRUE(blocks[i].GetOffset() + blocks[i].GetSize() <= blocks[j].GetOffset() ||
+                            blocks[j].GetOffset() + blocks[j].GetSize() <= blocks[i].GetOffset())
+                    << "Block " << i << " overlaps block " << j << endl;
+            }
+        }
+    }
+
+protected:
+
+    HeapTestOsInterface m_osInterface;
+    HeapManager         *m_heapManager  = nullptr;
+    int32_t             m_allocCounter  = 0;
+};
+
+TEST_F(MemoryBlockManagerTest, TrackerResourceAcquireSubmitRetire)
+{
+    uint32_t trackerData = 0;
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_heapManager->RegisterTrackerResource(&trackerData));
+
+    // blocks are returned in request order although they are placed largest first
+    vector<MemoryBlock> first;
+    uint32_t spaceNeeded = 0;
+    ASSERT_EQ(MOS_STATUS_SUCCESS, Acquire(0, 1, {heapTestBlockSize, 2 * heapTestBlockSize}, first, spaceNeeded));
+    ASSERT_EQ(2u, first.size());
+    EXPECT_EQ(0u, spaceNeeded);
+    EXPECT_EQ(heapTestBlockSize, first[0].GetSize());
+    EXPECT_EQ(2 * heapTestBlockSize, first[1].GetSize());
+    EXPECT_EQ(1u, first[0].GetTrackerId());
+    ExpectDisjoint(first);
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_heapManager->SubmitBlocks(first));
+
+    vector<MemoryBlock> second;
+    ASSERT_EQ(MOS_STATUS_SUCCESS, AcquireAndSubmit(0, 2, second));
+
+    // the heap is full and no tracker has completed yet
+    vector<MemoryBlock> blocks;
+    EXPECT_EQ(MOS_STATUS_CLIENT_AR_NO_SPACE, Acquire(0, 3, {heapTestBlockSize}, blocks, spaceNeeded));
+    EXPECT_EQ(heapTestBlockSize, spaceNeeded);
+    EXPECT_TRUE(blocks.empty());
+
+    // tracker 1 retires both of its blocks, which merge back into one free range
+    trackerData = 1;
+    ASSERT_EQ(MOS_STATUS_SUCCESS, Acquire(0, 3, {3 * heapTestBlockSize}, blocks, spaceNeeded));
+    ASSERT_EQ(1u, blocks.size());
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_heapManager->SubmitBlocks(blocks));
+    vector<MemoryBlock> inUse = {blocks[0], second[0]};
+    ExpectDisjoint(inUse);
+
+    // the block of tracker 2 is still in use
+    EXPECT_EQ(MOS_STATUS_CLIENT_AR_NO_SPACE, Acquire(0, 4, {heapTestBlockSize}, blocks, spaceNeeded));
+
+    trackerData = 2;
+    ASSERT_EQ(MOS_STATUS_SUCCESS, Acquire(0, 4, {heapTestBlockSize}, blocks, spaceNeeded));
+    EXPECT_EQ(second[0].GetOffset(), blocks[0].GetOffset());
+}
+
+TEST_F(MemoryBlockManagerTest, TrackerProducerAcquireSubmitRetire)
+{
+    HeapTestTrackerProducer producer;
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_heapManager->RegisterTrackerProducer(&producer));
+
+    int index = producer.AssignNewTracker();
+    ASSERT_GE(index, 0);
+    int otherIndex = producer.AssignNewTracker();
+    ASSERT_GE(otherIndex, 0);
+
+    // two blocks on each tracker index fill the heap
+    vector<MemoryBlock> blocks[4];
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        uint32_t trackerIndex = (i % 2) ? otherIndex : index;
+        ASSERT_EQ(MOS_STATUS_SUCCESS, AcquireAndSubmit(trackerIndex, producer.GetNextTracker(trackerIndex), blocks[i]));
+        ASSERT_EQ(MOS_STATUS_SUCCESS, producer.StepForward(trackerIndex));
+    }
+
+    vector<MemoryBlock> acquired;
+    uint32_t spaceNeeded = 0;
+    EXPECT_EQ(MOS_STATUS_CLIENT_AR_NO_SPACE, Acquire(index, producer.GetNextTracker(index), {heapTestBlockSize}, acquired, spaceNeeded));
+
+    // completing the first tracker of one index does not retire the blocks of the other
+    producer.Complete(otherIndex, 1);
+    vector<MemoryBlock> reused;
+    ASSERT_EQ(MOS_STATUS_SUCCESS, Acquire(index, producer.GetNextTracker(index), {heapTestBlockSize}, reused, spaceNeeded));
+    EXPECT_EQ(blocks[1][0].GetOffset(), reused[0].GetOffset());
+    EXPECT_EQ(MOS_STATUS_CLIENT_AR_NO_SPACE, Acquire(index, producer.GetNextTracker(index), {heapTestBlockSize}, acquired, spaceNeeded));
+
+    producer.Complete(index, 2);
+    ASSERT_EQ(MOS_STATUS_SUCCESS, Acquire(index, producer.GetNextTracker(index), {heapTestBlockSize, heapTestBlockSize}, acquired, spaceNeeded));
+    ASSERT_EQ(2u, acquired.size());
+    acquired.push_back(reused[0]);
+    acquired.push_back(blocks[3][0]);
+    ExpectDisjoint(acquired);
+}
+
+TEST_F(MemoryBlockManagerTest, TrackerProducerWraparound)
+{
+    HeapTestTrackerProducer producer;
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_heapManager->RegisterTrackerProducer(&producer));
+
+    int index = producer.AssignNewTracker();
+    ASSERT_GE(index, 0);
+    producer.SetNextTracker(index, 0xfffffffe);
+    producer.Complete(index, 0xfffffffd);
+
+    // trackers 0xfffffffe, 0xffffffff, 1 and 2, the producer skips 0 when it wraps
+    vector<MemoryBlock> blocks[4];
+    uint32_t trackers[4] = {};
+    uint32_t spaceNeeded = 0;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        trackers[i] = producer.GetNextTracker(index);
+        ASSERT_EQ(MOS_STATUS_SUCCESS, Acquire(index, trackers[i], {heapTestBlockSize}, blocks[i], spaceNeeded));
+        ASSERT_EQ(MOS_STATUS_SUCCESS, producer.StepForward(index));
+    }
+    EXPECT_EQ(0xffffffffu, trackers[1]);
+    EXPECT_EQ(1u, trackers[2]);
+
+    // submit out of tracker order, the retire queue must still order across the wrap
+    const uint32_t submitOrder[4] = {2, 0, 3, 1};
+    for (auto i : submitOrder)
+    {
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_heapManager->SubmitBlocks(blocks[i]));
+    }
+
+    vector<MemoryBlock> acquired;
+    EXPECT_EQ(MOS_STATUS_CLIENT_AR_NO_SPACE, Acquire(index, producer.GetNextTracker(index), {heapTestBlockSize}, acquired, spaceNeeded));
+
+    // the trackers before the wrap retire while the ones after it stay in use
+    producer.Complete(index, 0xffffffff);
+    ASSERT_EQ(MOS_STATUS_SUCCESS, Acquire(index, producer.GetNextTracker(index), {2 * heapTestBlockSize}, acquired, spaceNeeded));
+    vector<MemoryBlock> inUse = {acquired[0], blocks[2][0], blocks[3][0]};
+    ExpectDisjoint(inUse);
+    EXPECT_EQ(MOS_STATUS_CLIENT_AR_NO_SPACE, Acquire(index, producer.GetNextTracker(index), {heapTestBlockSize}, acquired, spaceNeeded));
+
+    producer.Complete(index, 1);
+    ASSERT_EQ(MOS_STATUS_SUCCESS, Acquire(index, producer.GetNextTracker(index), {heapTestBlockSize}, acquired, spaceNeeded));
+    EXPECT_EQ(blocks[2][0].GetOffset(), acquired[0].GetOffset());
+}
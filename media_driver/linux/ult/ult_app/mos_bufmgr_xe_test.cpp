@@ -0,0 +1,187 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_bufmgr_xe_test.cpp
+//! \brief    Tests xe bo reuse against the fake xe device of the libdrm mock
+//!
+
+#include <dlfcn.h>
+#include <stdlib.h>
+#include "driver_loader.h"
+#include "mos_bufmgr.h"
+#include "mos_bufmgr_priv.h"
+#include "xe_drm.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+// Exported by the preloaded libdrm mock
+typedef int (*MockXeOpenFunc)();
+typedef void (*MockXeSetBusyFunc)(int busy);
+typedef int (*MockXeIoctlCountFunc)(unsigned long request);
+
+#define XE_TEST_BO_SIZE         (64 * 1024)
+// the fake device reports no memory regions, so there is no default alignment
+#define XE_TEST_BO_ALIGNMENT    4096
+
+class MosBufmgrXeTest : public testing::Test
+{
+protected:
+
+    virtual void SetUp()
+    {
+        m_open       = (MockXeOpenFunc)dlsym(RTLD_DEFAULT, "mos_xe_mock_open");
+        m_setBusy    = (MockXeSetBusyFunc)dlsym(RTLD_DEFAULT, "mos_xe_mock_set_busy");
+        m_ioctlCount = (MockXeIoctlCountFunc)dlsym(RTLD_DEFAULT, "mos_xe_mock_ioctl_count");
+        ASSERT_TRUE(m_open && m_setBusy && m_ioctlCount) << "libdrm mock is not preloaded" << endl;
+
+        vector<Platform_t> platforms = m_driverLoader.GetPlatforms();
+        ASSERT_FALSE(platforms.empty());
+        ASSERT_EQ(VA_STATUS_SUCCESS, m_driverLoader.InitDriver(platforms[0]));
+    }
+
+    virtual void TearDown()
+    {
+        if (m_setBusy)
+        {
+            m_setBusy(0);
+        }
+        if (m_bufmgr)
+        {
+            m_bufmgr->destroy(m_bufmgr);
+            m_bufmgr = nullptr;
+        }
+        unsetenv("INTEL_XE_BO_CACHE_SIZE");
+        EXPECT_EQ(VA_STATUS_SUCCESS, m_driverLoader.CloseDriver());
+    }
+
+    void InitBufmgr(const char *cacheSizeMb)
+    {
+        if (cacheSizeMb)
+        {
+            setenv("INTEL_XE_BO_CACHE_SIZE", cacheSizeMb, 1);
+        }
+        else
+        {
+            unsetenv("INTEL_XE_BO_CACHE_SIZE");
+        }
+
+        m_bufmgr = m_driverLoader.GetDriverSymbols().BufmgrInitXe(m_open(), 0);
+        ASSERT_NE(nullptr, m_bufmgr);
+        m_bufmgr->enable_reuse(m_bufmgr);
+    }
+
+    struct mos_linux_bo *Alloc()
+    {
+        struct mos_drm_bo_alloc alloc;
+        alloc.name      = "xe reuse test";
+        alloc.size      = XE_TEST_BO_SIZE;
+        alloc.alignment = XE_TEST_BO_ALIGNMENT;
+        return m_bufmgr->bo_alloc(m_bufmgr, &alloc);
+    }
+
+protected:
+
+    DriverDllLoader         m_driverLoader;
+    MockXeOpenFunc          m_open       = nullptr;
+    MockXeSetBusyFunc       m_setBusy    = nullptr;
+    MockXeIoctlCountFunc    m_ioctlCount = nullptr;
+    struct mos_bufmgr       *m_bufmgr    = nullptr;
+};
+
+TEST_F(MosBufmgrXeTest, ReuseIsOffByDefault)
+{
+    InitBufmgr(nullptr);
+
+    struct mos_linux_bo *bo = Alloc();
+    ASSERT_NE(nullptr, bo);
+    m_bufmgr->bo_unreference(bo);
+    EXPECT_EQ(1, m_ioctlCount(DRM_IOCTL_GEM_CLOSE));
+
+    bo = Alloc();
+    ASSERT_NE(nullptr, bo);
+    EXPECT_EQ(2, m_ioctlCount(DRM_IOCTL_XE_GEM_CREATE));
+    m_bufmgr->bo_unreference(bo);
+}
+
+TEST_F(MosBufmgrXeTest, ReleasedBoIsReused)
+{
+    InitBufmgr("64");
+
+    struct mos_linux_bo *bo = Alloc();
+    ASSERT_NE(nullptr, bo);
+    uint32_t handle = bo->handle;
+    m_bufmgr->bo_unreference(bo);
+    EXPECT_EQ(0, m_ioctlCount(DRM_IOCTL_GEM_CLOSE));
+
+    bo = Alloc();
+    ASSERT_NE(nullptr, bo);
+    EXPECT_EQ(handle, bo->handle);
+    EXPECT_EQ(1, m_ioctlCount(DRM_IOCTL_XE_GEM_CREATE));
+    m_bufmgr->bo_unreference(bo);
+
+    // the cached bo is closed when the bufmgr goes away
+    m_bufmgr->destroy(m_bufmgr);
+    m_bufmgr = nullptr;
+    EXPECT_EQ(1, m_ioctlCount(DRM_IOCTL_GEM_CLOSE));
+}
+
+TEST_F(MosBufmgrXeTest, BusyCachedBoIsNotReused)
+{
+    InitBufmgr("64");
+
+    struct drm_xe_engine_class_instance engine = {};
+    engine.engine_class = DRM_XE_ENGINE_CLASS_RENDER;
+    struct mos_linux_context *ctx = m_bufmgr->context_create_shared(m_bufmgr, nullptr, 0, false, &engine, 1, 1, 0);
+    ASSERT_NE(nullptr, ctx);
+
+    struct mos_linux_bo *bo = Alloc();
+    ASSERT_NE(nullptr, bo);
+    uint32_t handle = bo->handle;
+    EXPECT_EQ(0, m_bufmgr->bo_context_exec3(&bo, 1, ctx, nullptr, 0, 0, 0, nullptr));
+
+    m_setBusy(1);
+    EXPECT_TRUE(m_bufmgr->bo_busy(bo));
+    m_bufmgr->bo_unreference(bo);
+
+    // the only cached bo is still busy, a new one is created
+    struct mos_linux_bo *bo2 = Alloc();
+    ASSERT_NE(nullptr, bo2);
+    EXPECT_NE(handle, bo2->handle);
+    EXPECT_EQ(2, m_ioctlCount(DRM_IOCTL_XE_GEM_CREATE));
+    m_bufmgr->bo_unreference(bo2);
+
+    // once idle, the oldest cached bo comes back without the deps of its last use
+    m_setBusy(0);
+    bo = Alloc();
+    ASSERT_NE(nullptr, bo);
+    EXPECT_EQ(handle, bo->handle);
+    m_setBusy(1);
+    EXPECT_FALSE(m_bufmgr->bo_busy(bo));
+    m_setBusy(0);
+    m_bufmgr->bo_unreference(bo);
+
+    m_bufmgr->context_destroy(ctx);
+    m_bufmgr->destroy(m_bufmgr);
+    m_bufmgr = nullptr;
+    EXPECT_EQ(2, m_ioctlCount(DRM_IOCTL_GEM_CLOSE));
+}
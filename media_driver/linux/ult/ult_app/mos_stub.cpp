@@ -19,8 +19,13 @@
 * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
 * OTHER DEALINGS IN THE SOFTWARE.
 */
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <unistd.h>
 #include "mos_utilities.h"
+#include "mos_interface.h"
 using namespace std;
 
 void MosUtilities::MosZeroMemory(void *pDestination, size_t stLength)
@@ -31,3 +36,172 @@ void MosUtilities::MosZeroMemory(void *pDestination, size_t stLength)
     }
 }
 
+// Allocation counter checked by the heap manager tests for leaks
+static int32_t g_mosMemAllocCounter = 0;
+int32_t *MosUtilities::m_mosMemAllocCounter = &g_mosMemAllocCounter;
+
+int32_t MosUtilities::MosAtomicIncrement(int32_t *pValue)
+{
+    return pValue ? __sync_add_and_fetch(pValue, 1) : 0;
+}
+
+int32_t MosUtilities::MosAtomicDecrement(int32_t *pValue)
+{
+    return pValue ? __sync_sub_and_fetch(pValue, 1) : 0;
+}
+
+#if MOS_MESSAGES_ENABLED
+void *MosUtilities::MosAllocAndZeroMemoryUtils(
+    size_t     size,
+    const char *functionName,
+    const char *filename,
+    int32_t    line)
+#else
+void *MosUtilities::MosAllocAndZeroMemory(size_t size)
+#endif
+{
+    void *ptr = calloc(1, size);
+    if (ptr != nullptr)
+    {
+        MosAtomicIncrement(m_mosMemAllocCounter);
+    }
+    return ptr;
+}
+
+#if MOS_MESSAGES_ENABLED
+void MosUtilities::MosFreeMemoryUtils(
+    void       *ptr,
+    const char *functionName,
+    const char *filename,
+    int32_t    line)
+#else
+void MosUtilities::MosFreeMemory(void *ptr)
+#endif
+{
+    if (ptr != nullptr)
+    {
+        MosAtomicDecrement(m_mosMemAllocCounter);
+        free(ptr);
+    }
+}
+
+#if MOS_MESSAGES_ENABLED
+void *MosUtilities::MosReallocMemoryUtils(
+    void       *ptr,
+    size_t     newSize,
+    const char *functionName,
+    const char *filename,
+    int32_t    line)
+#else
+void *MosUtilities::MosReallocMemory(
+    void       *ptr,
+    size_t     newSize)
+#endif
+{
+    void *newPtr = realloc(ptr, newSize);
+    if (ptr == nullptr && newPtr != nullptr)
+    {
+        MosAtomicIncrement(m_mosMemAllocCounter);
+    }
+    return newPtr;
+}
+
+MOS_STATUS MosUtilities::MosSecureMemcpy(
+    void       *pDestination,
+    size_t     dstLength,
+    const void *pSource,
+    size_t     srcLength)
+{
+    if (pDestination == nullptr || pSource == nullptr || dstLength < srcLength)
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+    memcpy(pDestination, pSource, srcLength);
+    return MOS_STATUS_SUCCESS;
+}
+
+int32_t MosUtilities::MosSecureStringPrint(
+    char              *buffer,
+    size_t            bufSize,
+    size_t            length,
+    const char *const format,
+    ...)
+{
+    if (buffer == nullptr || format == nullptr || bufSize < length)
+    {
+        return -1;
+    }
+    va_list var_args;
+    va_start(var_args, format);
+    int32_t ret = vsnprintf(buffer, length, format, var_args);
+    va_end(var_args);
+    return ret;
+}
+
+MOS_STATUS MosUtilities::MosWriteFileFromPtr(
+    const char *pFilename,
+    void       *lpBuffer,
+    uint32_t   writeSize)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
+
+void MosUtilities::MosSleep(uint32_t mSec)
+{
+    usleep(mSec * 1000);
+}
+
+int32_t MosUtilities::MosGetPid()
+{
+    return getpid();
+}
+
+bool MosInterface::MosResourceIsNull(PMOS_RESOURCE resource)
+{
+    return resource == nullptr || (resource->bo == nullptr && resource->pData == nullptr);
+}
+
+#if MOS_MESSAGES_ENABLED
+bool MosUtilities::MosSimulateAllocMemoryFail(
+    size_t     size,
+    size_t     alignment,
+    const char *functionName,
+    const char *filename,
+    int32_t    line)
+{
+    return false;
+}
+
+double MosUtilities::MosGetTime()
+{
+    return 0;
+}
+
+MOS_STATUS MosUtilities::MosPrintCPUAllocateMemory(int32_t event_id, int32_t level,
+    int32_t param_id_1, int64_t value_1, int32_t param_id_2, int64_t value_2, const char *funName, const char *fileName, int32_t line)
+{
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MosUtilities::MosPrintCPUDestroyMemory(int32_t event_id, int32_t level,
+    int32_t param_id_1, int64_t value_1, const char *funName, const char *fileName, int32_t line)
+{
+    return MOS_STATUS_SUCCESS;
+}
+
+void MosUtilities::MosTraceEvent(
+    uint16_t   usId,
+    uint8_t    ucType,
+    const void *pArg1,
+    uint32_t   dwSize1,
+    const void *pArg2,
+    uint32_t   dwSize2)
+{
+}
+#endif
+
+#if MOS_ASSERT_ENABLED
+void MosUtilDebug::MosAssert(MOS_COMPONENT_ID compID, uint8_t subCompID)
+{
+}
+#endif
@@ -0,0 +1,233 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     mos_vma_test.cpp
+//! \brief    Replays random allocation sequences on mos_vma against a reference model
+//!
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mos_vma.h"
+
+using namespace std;
+
+// The reference model tracks the heap in units, every request is a multiple of it
+static const uint64_t vmaUnit      = 0x1000;
+static const uint64_t vmaStart     = 0x100000;
+static const uint64_t vmaUnitCount = 2048;
+
+class MosVmaReference
+{
+public:
+    MosVmaReference() : m_used(vmaUnitCount, false) {}
+
+    bool IsFree(uint64_t offset, uint64_t size) const
+    {
+        for (uint64_t i = ToUnit(offset); i < ToUnit(offset + size); i++)
+        {
+            if (m_used[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Mark(uint64_t offset, uint64_t size, bool used)
+    {
+        for (uint64_t i = ToUnit(offset); i < ToUnit(offset + size); i++)
+        {
+            m_used[i] = used;
+        }
+    }
+
+    // Whether any free range can hold an aligned allocation
+    bool CanFit(uint64_t size, uint64_t alignment) const
+    {
+        for (uint64_t offset = vmaStart; offset + size <= vmaStart + vmaUnitCount * vmaUnit; offset += alignment)
+        {
+            if (offset % alignment == 0 && IsFree(offset, size))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void GetStats(mos_vma_heap_stats &stats) const
+    {
+        stats = {};
+        uint64_t run = 0;
+        for (uint64_t i = 0; i <= vmaUnitCount; i++)
+        {
+            if (i < vmaUnitCount && !m_used[i])
+            {
+                run++;
+                continue;
+            }
+            if (run)
+            {
+                stats.hole_count++;
+                stats.free_size   += run * vmaUnit;
+                stats.largest_hole = max(stats.largest_hole, run * vmaUnit);
+            }
+            run = 0;
+        }
+    }
+
+private:
+    static uint64_t ToUnit(uint64_t offset) { return (offset - vmaStart) / vmaUnit; }
+
+    vector<bool> m_used;
+};
+
+struct MosVmaRange
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+static void ReplayRandomSequence(uint32_t seed, bool allocHigh)
+{
+    mt19937               rng(seed);
+    mos_vma_heap          heap = {};
+    MosVmaReference       ref;
+    vector<MosVmaRange>   ranges;
+    uint64_t              allocCount  = 0;
+    uint64_t              freeCount   = 0;
+    uint64_t              failedCount = 0;
+
+    mos_vma_heap_init(&heap, vmaStart, vmaUnitCount * vmaUnit);
+    heap.alloc_high = allocHigh;
+
+    for (uint32_t step = 0; step < 10000; step++)
+    {
+        uint32_t op = rng() % 8;
+        if (op < 4 || ranges.empty())
+        {
+            uint64_t size      = (1 + rng() % 64) * vmaUnit;
+            uint64_t alignment = (1ull << (rng() % 5)) * vmaUnit;
+            bool     canFit    = ref.CanFit(size, alignment);
+            uint64_t offset    = mos_vma_heap_alloc(&heap, size, alignment);
+            if (offset == 0)
+            {
+                ASSERT_FALSE(canFit) << "seed " << seed << " step " << step;
+                failedCount++;
+                continue;
+            }
+            ASSERT_EQ(offset % alignment, 0u);
+            ASSERT_GE(offset, vmaStart);
+            ASSERT_LE(offset + size, vmaStart + vmaUnitCount * vmaUnit);
+            ASSERT_TRUE(ref.IsFree(offset, size)) << "seed " << seed << " step " << step;
+            ref.Mark(offset, size, true);
+            ranges.push_back({offset, size});
+            allocCount++;
+        }
+        else if (op < 5)
+        {
+            uint64_t offset  = vmaStart + (rng() % vmaUnitCount) * vmaUnit;
+            uint64_t size    = (1 + rng() % 16) * vmaUnit;
+            size             = min(size, vmaStart + vmaUnitCount * vmaUnit - offset);
+            bool     isFree  = ref.IsFree(offset, size);
+            ASSERT_EQ(mos_vma_heap_alloc_addr(&heap, offset, size), isFree) << "seed " << seed << " step " << step;
+            if (isFree)
+            {
+                ref.Mark(offset, size, true);
+                ranges.push_back({offset, size});
+                allocCount++;
+            }
+        }
+        else
+        {
+            size_t      index = rng() % ranges.size();
+            MosVmaRange range = ranges[index];
+            ranges[index]     = ranges.back();
+            ranges.pop_back();
+            mos_vma_heap_free(&heap, range.offset, range.size);
+            ref.Mark(range.offset, range.size, false);
+            freeCount++;
+        }
+
+        mos_vma_heap_stats stats    = {};
+        mos_vma_heap_stats expected = {};
+        mos_vma_heap_get_stats(&heap, &stats);
+        ref.GetStats(expected);
+        ASSERT_EQ(stats.free_size, expected.free_size) << "seed " << seed << " step " << step;
+        ASSERT_EQ(stats.hole_count, expected.hole_count) << "seed " << seed << " step " << step;
+        ASSERT_EQ(stats.largest_hole, expected.largest_hole) << "seed " << seed << " step " << step;
+        ASSERT_EQ(stats.alloc_count, allocCount);
+        ASSERT_EQ(stats.free_count, freeCount);
+        ASSERT_EQ(stats.failed_count, failedCount);
+    }
+
+    // Releasing everything must coalesce back into the initial range
+    for (auto &range : ranges)
+    {
+        mos_vma_heap_free(&heap, range.offset, range.size);
+    }
+    mos_vma_heap_stats stats = {};
+    mos_vma_heap_get_stats(&heap, &stats);
+    EXPECT_EQ(stats.free_size, vmaUnitCount * vmaUnit);
+    EXPECT_EQ(stats.hole_count, 1u);
+    EXPECT_EQ(stats.fragmentation, 0u);
+
+    mos_vma_heap_finish(&heap);
+}
+
+TEST(MosVmaTest, ReplayRandomAllocFreeHigh)
+{
+    for (uint32_t seed = 1; seed <= 4; seed++)
+    {
+        ReplayRandomSequence(seed, true);
+    }
+}
+
+TEST(MosVmaTest, ReplayRandomAllocFreeLow)
+{
+    for (uint32_t seed = 1; seed <= 4; seed++)
+    {
+        ReplayRandomSequence(seed, false);
+    }
+}
+
+TEST(MosVmaTest, BestFitPicksSmallestHole)
+{
+    mos_vma_heap heap = {};
+    mos_vma_heap_init(&heap, vmaStart, 16 * vmaUnit);
+    heap.alloc_high = false;
+
+    // Leave a 4 unit hole at the bottom and a 1 unit hole in the middle
+    ASSERT_TRUE(mos_vma_heap_alloc_addr(&heap, vmaStart + 4 * vmaUnit, 4 * vmaUnit));
+    ASSERT_TRUE(mos_vma_heap_alloc_addr(&heap, vmaStart + 9 * vmaUnit, 7 * vmaUnit));
+
+    EXPECT_EQ(mos_vma_heap_alloc(&heap, vmaUnit, vmaUnit), vmaStart + 8 * vmaUnit);
+    EXPECT_EQ(mos_vma_heap_alloc(&heap, vmaUnit, vmaUnit), vmaStart);
+
+    mos_vma_heap_stats stats = {};
+    mos_vma_heap_get_stats(&heap, &stats);
+    EXPECT_EQ(stats.hole_count, 1u);
+    EXPECT_EQ(stats.free_size, 3 * vmaUnit);
+    EXPECT_EQ(stats.alloc_count, 4u);
+
+    mos_vma_heap_finish(&heap);
+}
@@ -171,6 +171,11 @@ MOS_STATUS MediaCopyStateM12_0::MediaRenderCopy(PMOS_RESOURCE src, PMOS_RESOURCE
 MOS_STATUS MediaCopyStateM12_0::TaskDispatch(MCPY_STATE_PARAMS mcpySrc, MCPY_STATE_PARAMS mcpyDst, MCPY_ENGINE mcpyEngine)
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+    DumpCopySurface(mcpySrc, true);
+#endif
+
     MosUtilities::MosLockMutex(m_inUseGPUMutex);
     switch (mcpyEngine)
     {
@@ -219,8 +224,25 @@ MOS_STATUS MediaCopyStateM12_0::TaskDispatch(MCPY_STATE_PARAMS mcpySrc, MCPY_STA
             copyEngine,
             MediaUserSetting::Group::Device);
     }
+
+    DumpCopySurface(mcpyDst, false);
 #endif
     MCPY_NORMALMESSAGE("Media Copy works on %s Engine", mcpyEngine ? (mcpyEngine == MCPY_ENGINE_BLT ? "BLT" : "Render") : "VeBox");
 
     return eStatus;
+}
+
+MOS_STATUS MediaCopyStateM12_0::TaskDispatchBltBatch(MCPY_STATE_PARAMS *mcpySrc, MCPY_STATE_PARAMS *mcpyDst, uint32_t count, uint32_t &copied)
+{
+    copied = 0;
+    MCPY_CHK_NULL_RETURN(mcpySrc);
+    MCPY_CHK_NULL_RETURN(mcpyDst);
+
+    // gen12 BLT needs compressed sources resolved first, keep one submission per copy.
+    for (uint32_t i = 0; i < count; i++)
+    {
+        MCPY_CHK_STATUS_RETURN(TaskDispatch(mcpySrc[i], mcpyDst[i], MCPY_ENGINE_BLT));
+        copied++;
+    }
+    return MOS_STATUS_SUCCESS;
 }
\ No newline at end of file
@@ -120,6 +120,7 @@ protected:
 
     virtual bool IsVeboxCopySupported(PMOS_RESOURCE src, PMOS_RESOURCE dst);
     virtual MOS_STATUS TaskDispatch(MCPY_STATE_PARAMS mcpySrc, MCPY_STATE_PARAMS mcpyDst, MCPY_ENGINE mcpyEngine);
+    virtual MOS_STATUS TaskDispatchBltBatch(MCPY_STATE_PARAMS *mcpySrc, MCPY_STATE_PARAMS *mcpyDst, uint32_t count, uint32_t &copied);
 
     MhwInterfaces   *m_mhwInterfaces  = nullptr;
     BltState        *m_bltState       = nullptr;
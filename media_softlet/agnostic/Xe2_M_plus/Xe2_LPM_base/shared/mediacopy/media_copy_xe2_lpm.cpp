@@ -156,6 +156,19 @@ MOS_STATUS MediaCopyStateXe2_Lpm::MediaBltCopy(PMOS_RESOURCE src, PMOS_RESOURCE
     }
 }
 
+MOS_STATUS MediaCopyStateXe2_Lpm::MediaBltCopyBatch(PMOS_RESOURCE *src, PMOS_RESOURCE *dst, uint32_t count, uint32_t &copied)
+{
+    // implementation
+    if (m_bltCopy != nullptr)
+    {
+        return m_bltCopy->CopyMainSurfaces(src, dst, count, copied);
+    }
+    else
+    {
+        return MOS_STATUS_UNIMPLEMENTED;
+    }
+}
+
 MOS_STATUS MediaCopyStateXe2_Lpm::MediaVeboxCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst)
 {
     // implementation
@@ -156,6 +156,19 @@ MOS_STATUS MediaCopyStateXe3_Lpm_Base::MediaBltCopy(PMOS_RESOURCE src, PMOS_RESO
     }
 }
 
+MOS_STATUS MediaCopyStateXe3_Lpm_Base::MediaBltCopyBatch(PMOS_RESOURCE *src, PMOS_RESOURCE *dst, uint32_t count, uint32_t &copied)
+{
+    // implementation
+    if (m_bltCopy != nullptr)
+    {
+        return m_bltCopy->CopyMainSurfaces(src, dst, count, copied);
+    }
+    else
+    {
+        return MOS_STATUS_UNIMPLEMENTED;
+    }
+}
+
 MOS_STATUS MediaCopyStateXe3_Lpm_Base::MediaVeboxCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst)
 {
     // implementation
@@ -90,6 +90,22 @@ protected:
     //!
     virtual MOS_STATUS MediaBltCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst);
 
+    //!
+    //! \brief    use blt engine to do batched surface copy.
+    //! \details  implementation media blt copy of several surfaces.
+    //! \param    src
+    //!           [in] Array of source surfaces
+    //! \param    dst
+    //!           [in] Array of destination surfaces
+    //! \param    count
+    //!           [in] Number of copies
+    //! \param    copied
+    //!           [out] Number of leading copies submitted
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if support, otherwise return unspoort.
+    //!
+    virtual MOS_STATUS MediaBltCopyBatch(PMOS_RESOURCE *src, PMOS_RESOURCE *dst, uint32_t count, uint32_t &copied);
+
     //!
     //! \brief    use Render engie to do surface copy.
     //! \details  implementation media Render copy.
@@ -49,18 +49,35 @@ HevcVdencRoi::HevcVdencRoi(
     m_basicFeature = dynamic_cast<EncodeBasicFeature *>(m_featureManager->GetFeature(FeatureIDs::basicFeature));
     ENCODE_CHK_NULL_NO_STATUS_RETURN(m_basicFeature);
 }
+
+HevcVdencRoi::~HevcVdencRoi()
+{
+    MOS_FreeMemAndSetNull(m_streamInTemp);
+    MOS_FreeMemAndSetNull(m_streamInPrev);
+}
+
 MOS_STATUS HevcVdencRoi::ClearStreaminBuffer(uint32_t lucNumber)
 {
-    // Clear streamin
-    ENCODE_CHK_NULL_RETURN(m_streamInTemp);
+    // The streamin image lives across frames so it can be diffed with the last one.
+    if (m_lcuVersion.size() != m_streamInSize / CODECHAL_CACHELINE_SIZE)
+    {
+        MOS_FreeMemAndSetNull(m_streamInTemp);
+        MOS_FreeMemAndSetNull(m_streamInPrev);
+        m_lcuVersion.clear();
 
-    uint8_t *data = (uint8_t *)m_allocator->LockResourceForWrite(m_streamIn);
-    ENCODE_CHK_NULL_RETURN(data);
+        m_streamInTemp = (uint8_t *)MOS_AllocMemory(m_streamInSize);
+        ENCODE_CHK_NULL_RETURN(m_streamInTemp);
+        m_streamInPrev = (uint8_t *)MOS_AllocAndZeroMemory(m_streamInSize);
+        ENCODE_CHK_NULL_RETURN(m_streamInPrev);
 
-    MOS_ZeroMemory(m_streamInTemp, lucNumber * 64);
-    MOS_SecureMemcpy(data, m_streamInSize, m_streamInTemp, m_streamInSize);
+        // Every ring slot starts unknown and gets one full copy.
+        m_lcuVersion.assign(m_streamInSize / CODECHAL_CACHELINE_SIZE, 1);
+        m_streamInVersion = 1;
+        MOS_ZeroMemory(m_slotVersion, sizeof(m_slotVersion));
+    }
 
-    ENCODE_CHK_STATUS_RETURN(m_allocator->UnLock(m_streamIn));
+    ENCODE_CHK_COND_RETURN(lucNumber * CODECHAL_CACHELINE_SIZE > m_streamInSize, "streamin buffer is too small for %d LCUs", lucNumber);
+    MOS_ZeroMemory(m_streamInTemp, m_streamInSize);
 
     return MOS_STATUS_SUCCESS;
 }
@@ -95,7 +112,7 @@ MOS_STATUS HevcVdencRoi::Init(void *setting)
 
     allocParams.pBufName = "VDEnc StreamIn Data Buffer";
     allocParams.ResUsageType = MOS_HW_RESOURCE_USAGE_ENCODE_INTERNAL_READ_WRITE_NOCACHE;
-    m_basicFeature->m_recycleBuf->RegisterResource(RecycleResId::StreamInBuffer, allocParams);
+    m_basicFeature->m_recycleBuf->RegisterResource(RecycleResId::StreamInBuffer, allocParams, m_streamInRingSize);
 
 #if _KERNEL_RESERVED
     ENCODE_CHK_NULL_RETURN(m_featureManager);
@@ -148,12 +165,16 @@ MOS_STATUS HevcVdencRoi::Update(void *params)
 
     if (!m_isArbRoi)
     {
-        m_streamIn = m_basicFeature->m_recycleBuf->GetBuffer(RecycleResId::StreamInBuffer, m_basicFeature->m_frameNum);
+        m_streamIn     = m_basicFeature->m_recycleBuf->GetBuffer(RecycleResId::StreamInBuffer, m_basicFeature->m_frameNum);
+        m_streamInSlot = m_basicFeature->m_frameNum % m_streamInRingSize;
     }
     else
     {
         uint32_t streamInBufferIdx = hevcPicParams->CodingType == I_TYPE ? 0 : 1;
         m_streamIn                 = m_basicFeature->m_recycleBuf->GetBuffer(RecycleResId::StreamInBuffer, streamInBufferIdx);
+        // ARB rewrites its slot at a per frame offset, always copy it in full.
+        m_streamInSlot             = m_invalidRingSlot;
+        m_slotVersion[streamInBufferIdx] = 0;
 
         uint16_t ArbBoostRow[8] = {0, 3, 5, 2, 7, 4, 1, 6};
         uint16_t factor = 8 - ArbBoostRow[m_basicFeature->m_frameNum % 8];
@@ -178,9 +199,6 @@ MOS_STATUS HevcVdencRoi::Update(void *params)
 
     if (!m_isArbRoi || (hevcPicParams->CodingType == I_TYPE && !IFrameIsSet) || ((hevcPicParams->CodingType == P_TYPE || hevcPicParams->CodingType == B_TYPE) && !PBFrameIsSet))
     {
-        m_streamInTemp = (uint8_t *)MOS_AllocMemory(m_streamInSize);
-        ENCODE_CHK_NULL_RETURN(m_streamInTemp);
-
         uint32_t lcuNumber = GetLCUNumber();
 
         ENCODE_CHK_STATUS_RETURN(ClearStreaminBuffer(lcuNumber));
@@ -212,8 +230,6 @@ MOS_STATUS HevcVdencRoi::Update(void *params)
 
         ENCODE_CHK_STATUS_RETURN(WriteStreaminData());
 
-        MOS_SafeFreeMemory(m_streamInTemp);
-
 #if (_DEBUG || _RELEASE_INTERNAL)
         ENCODE_CHK_NULL_RETURN(m_hwInterface);
         ENCODE_CHK_NULL_RETURN(m_hwInterface->GetOsInterface());
@@ -241,18 +257,81 @@ MOS_STATUS HevcVdencRoi::WriteStreaminData()
 {
     ENCODE_CHK_NULL_RETURN(m_streamIn);
     ENCODE_CHK_NULL_RETURN(m_streamInTemp);
-
-    uint8_t *streaminBuffer = (uint8_t *)m_allocator->LockResourceForWrite(m_streamIn);
-    ENCODE_CHK_NULL_RETURN(streaminBuffer);
+    ENCODE_CHK_NULL_RETURN(m_streamInPrev);
 
     m_roiOverlap.WriteStreaminData(
         m_strategyFactory.GetRoi(), 
         m_strategyFactory.GetDirtyRoi(),
         m_streamInTemp);
 
-    MOS_SecureMemcpy(streaminBuffer, m_streamInSize, m_streamInTemp, m_streamInSize);
+    // Find the LCUs whose streamin data differs from the last frame.
+    bool     changed  = false;
+    uint32_t lcuCount = (uint32_t)m_lcuVersion.size();
+    for (uint32_t i = 0; i < lcuCount; i++)
+    {
+        uint32_t offset = i * CODECHAL_CACHELINE_SIZE;
+        if (memcmp(m_streamInTemp + offset, m_streamInPrev + offset, CODECHAL_CACHELINE_SIZE) != 0)
+        {
+            if (!changed)
+            {
+                m_streamInVersion++;
+                changed = true;
+            }
+            m_lcuVersion[i] = m_streamInVersion;
+            MOS_SecureMemcpy(m_streamInPrev + offset, CODECHAL_CACHELINE_SIZE, m_streamInTemp + offset, CODECHAL_CACHELINE_SIZE);
+        }
+    }
 
-    m_allocator->UnLock(m_streamIn);
+    return UpdateStreaminBuffer();
+}
+
+MOS_STATUS HevcVdencRoi::UpdateStreaminBuffer()
+{
+    bool fullCopy = (m_streamInSlot == m_invalidRingSlot) || (m_slotVersion[m_streamInSlot] == 0);
+
+    // Slot already holds the current data, no need to touch the resource.
+    if (!fullCopy && m_slotVersion[m_streamInSlot] == m_streamInVersion)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    uint8_t *streaminBuffer = (uint8_t *)m_allocator->LockResourceForWrite(m_streamIn);
+    ENCODE_CHK_NULL_RETURN(streaminBuffer);
+
+    if (fullCopy)
+    {
+        MOS_SecureMemcpy(streaminBuffer, m_streamInSize, m_streamInTemp, m_streamInSize);
+    }
+    else
+    {
+        // Copy runs of LCUs changed after the slot was last written.
+        uint32_t slotVersion = m_slotVersion[m_streamInSlot];
+        uint32_t lcuCount    = (uint32_t)m_lcuVersion.size();
+        uint32_t i           = 0;
+        while (i < lcuCount)
+        {
+            if (m_lcuVersion[i] <= slotVersion)
+            {
+                i++;
+                continue;
+            }
+            uint32_t start = i;
+            while (i < lcuCount && m_lcuVersion[i] > slotVersion)
+            {
+                i++;
+            }
+            uint32_t offset = start * CODECHAL_CACHELINE_SIZE;
+            uint32_t size   = (i - start) * CODECHAL_CACHELINE_SIZE;
+            MOS_SecureMemcpy(streaminBuffer + offset, m_streamInSize - offset, m_streamInTemp + offset, size);
+        }
+    }
+
+    ENCODE_CHK_STATUS_RETURN(m_allocator->UnLock(m_streamIn));
+
+    if (m_streamInSlot != m_invalidRingSlot)
+    {
+        m_slotVersion[m_streamInSlot] = m_streamInVersion;
+    }
     return MOS_STATUS_SUCCESS;
 }
 
@@ -63,7 +63,7 @@ public:
         CodechalHwInterfaceNext *hwInterface,
         void *constSettings);
 
-    virtual ~HevcVdencRoi() {}
+    virtual ~HevcVdencRoi();
 
     //!
     //! \brief  Init encode parameter
@@ -187,11 +187,23 @@ protected:
 
     //!
     //! \brief    Write the Streamin data according to the overlap settings.
+    //!
+    //! \detail   The streamin image is built in system memory and compared
+    //!           with the last frame per LCU. Only the LCUs changed since the
+    //!           current ring slot was last written are copied to it.
+    //!
     //! \return   MOS_STATUS
     //!           MOS_STATUS_SUCCESS if success, else fail reason
     //!
     MOS_STATUS WriteStreaminData();
 
+    //!
+    //! \brief    Copy the changed LCUs into the streamin buffer of current ring slot
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS UpdateStreaminBuffer();
+
     //!
     //! \brief    Get the LCU number
     //! \return   uint32_t
@@ -208,7 +220,7 @@ protected:
     }
 
     //!
-    //! \brief    ClearStreaminBuffer
+    //! \brief    Clear the system memory streamin image before it is rebuilt
     //! \return   MOS_STATUS
     //!           MOS_STATUS_SUCCESS if success, else fail reason
     //!
@@ -237,6 +249,8 @@ protected:
 
     static constexpr uint8_t m_maxNumRoi       = 16;  //!< VDEnc maximum number of ROI supported
     static constexpr uint8_t m_maxNumNativeRoi = 3;   //!< Number of native ROI supported by VDEnc HW
+    static constexpr uint8_t m_streamInRingSize = 6;  //!< Streamin buffers in rotation, so the CPU never writes the one being read
+    static constexpr uint8_t m_invalidRingSlot  = 0xFF;
 
     bool m_roiEnabled        = false;    //!< ROI enabled
     bool m_dirtyRoiEnabled   = false;    //!< dirty ROI enabled
@@ -248,7 +262,12 @@ protected:
 
     PMOS_RESOURCE      m_streamIn = nullptr; //!< Stream in buffer
     uint8_t *          m_streamInTemp = nullptr;
+    uint8_t *          m_streamInPrev = nullptr;                    //!< Stream in data of the last frame
     uint32_t           m_streamInSize = 0;
+    UintVector         m_lcuVersion;                                //!< Version in which each LCU last changed
+    uint32_t           m_streamInVersion = 0;                       //!< Version of the last written stream in data
+    uint32_t           m_slotVersion[m_streamInRingSize] = {};      //!< Version held by each ring slot, 0 if unknown
+    uint8_t            m_streamInSlot = m_invalidRingSlot;          //!< Ring slot of m_streamIn
     RoiStrategyFactory m_strategyFactory;    //!< Factory of strategy
     RoiOverlap         m_roiOverlap;         //!< ROI and dirty ROI overlap
 
@@ -24,8 +24,21 @@
 //! \brief    Implements functionalities pertaining to the memory block manager
 //!
 
+#include <algorithm>
 #include "memory_block_manager.h"
 
+//! \brief  Index of the lowest set bit, \a mask must not be 0
+static inline uint32_t FindLowestSetBit(uint32_t mask)
+{
+    return (uint32_t)__builtin_ctz(mask);
+}
+
+//! \brief  Index of the highest set bit, 0 for \a value 0
+static inline uint32_t FindHighestSetBit(uint32_t value)
+{
+    return value ? 31 - (uint32_t)__builtin_clz(value) : 0;
+}
+
 MemoryBlockManager::~MemoryBlockManager()
 {
     HEAP_FUNCTION_ENTER;
@@ -69,24 +82,15 @@ MOS_STATUS MemoryBlockManager::AcquireSpace(
         m_sortedSizes.resize(params.m_blockSizes.size());
     }
     uint32_t alignment = MOS_MAX(m_blockAlignment, MOS_ALIGN_CEIL(params.m_alignment, m_blockAlignment));
-    uint32_t idx = 0;
-    auto sortedIterator = m_sortedSizes.begin();
-    for (auto requestIterator = params.m_blockSizes.begin();
-        requestIterator != params.m_blockSizes.end();
-        ++requestIterator)
+    for (uint32_t idx = 0; idx < params.m_blockSizes.size(); ++idx)
     {
-        if (sortedIterator == m_sortedSizes.end())
-        {
-            HEAP_ASSERTMESSAGE("sortedSizes is expected to be the same size as the number of blocks requested");
-            return MOS_STATUS_UNKNOWN;
-        }
-        (*sortedIterator).m_originalIdx = idx++;
-        (*sortedIterator).m_blockSize = MOS_ALIGN_CEIL(*requestIterator, alignment);
-        ++sortedIterator;
+        m_sortedSizes[idx].m_originalIdx = idx;
+        m_sortedSizes[idx].m_blockSize = MOS_ALIGN_CEIL(params.m_blockSizes[idx], alignment);
     }
     if (m_sortedSizes.size() > 1)
     {
-        m_sortedSizes.sort([](SortedSizePair &a, SortedSizePair &b) { return a.m_blockSize > b.m_blockSize; });
+        std::stable_sort(m_sortedSizes.begin(), m_sortedSizes.end(),
+            [](const SortedSizePair &a, const SortedSizePair &b) { return a.m_blockSize > b.m_blockSize; });
     }
 
     if (m_sortedBlockListNumEntries[MemoryBlockInternal::submitted] > m_numSubmissionsForRefresh)
@@ -95,11 +99,20 @@ MOS_STATUS MemoryBlockManager::AcquireSpace(
         HEAP_CHK_STATUS(RefreshBlockStates(blocksUpdated));
     }
 
+    if (m_freeBinFlBitmap == 0)
+    {
+        bool blocksUpdated = false;
+        HEAP_CHK_STATUS(RefreshBlockStates(blocksUpdated));
+        if (!blocksUpdated)
+        {
+            HEAP_NORMALMESSAGE("All heap space is in use by active workloads.");
+        }
+    }
+
     spaceNeeded = 0;
-    HEAP_CHK_STATUS(IsSpaceAvailable(params, spaceNeeded));
+    HEAP_CHK_STATUS(AllocateSpace(params, blocks, spaceNeeded));
     if (spaceNeeded == 0)
     {
-        HEAP_CHK_STATUS(AllocateSpace(params, blocks));
         return MOS_STATUS_SUCCESS;
     }
 
@@ -168,65 +181,90 @@ MOS_STATUS MemoryBlockManager::RefreshBlockStates(bool &blocksUpdated)
     }
 
     blocksUpdated = false;
-    uint32_t currTrackerId = 0;
     if (!m_useProducer)
     {
-        currTrackerId = *m_trackerData;
+        HEAP_CHK_STATUS(RetireBlocks(0, *m_trackerData, blocksUpdated));
+    }
+    else
+    {
+        for (uint32_t index = 0; index < MAX_TRACKER_NUMBER; ++index)
+        {
+            if (m_retireQueueHead[index] != nullptr)
+            {
+                HEAP_CHK_STATUS(RetireBlocks(index, 0, blocksUpdated));
+            }
+        }
+    }
+
+    if (blocksUpdated && !m_deletedHeaps.empty())
+    {
+        HEAP_CHK_STATUS(CompleteHeapDeletion());
     }
 
-    auto block = m_sortedBlockList[MemoryBlockInternal::State::submitted];
-    MemoryBlockInternal *nextSubmitted = nullptr;
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MemoryBlockManager::RetireBlocks(uint32_t index, uint32_t currTrackerId, bool &blocksUpdated)
+{
+    HEAP_FUNCTION_ENTER_VERBOSE;
+
+    auto block = m_retireQueueHead[index];
     while (block != nullptr)
     {
-        nextSubmitted = block->m_stateNext;
-        FrameTrackerToken *trackerToken = block->GetTrackerToken();
-        if ( (!m_useProducer && block->GetTrackerId() <= currTrackerId)
-            ||(m_useProducer && trackerToken->IsExpired()))
+        // the queue is ordered by tracker ID, all blocks after the first one in use are in use as well
+        if ((!m_useProducer && block->GetTrackerId() > currTrackerId)
+            || (m_useProducer && !block->GetTrackerToken()->IsExpired()))
         {
-            auto heap = block->GetHeap();
-            HEAP_CHK_NULL(heap);
+            break;
+        }
 
-            if (heap->IsFreeInProgress())
-            {
-                // Add the block to deleted list instead of freed to prevent it from being reused
-                HEAP_CHK_STATUS(RemoveBlockFromSortedList(block, block->GetState()));
-                HEAP_CHK_STATUS(block->Delete());
-                HEAP_CHK_STATUS(AddBlockToSortedList(block, block->GetState()));
-                block = nextSubmitted;
-                continue;
-            }
+        auto nextSubmitted = block->m_stateNext;
+        auto heap = block->GetHeap();
+        HEAP_CHK_NULL(heap);
 
-            HEAP_CHK_STATUS(RemoveBlockFromSortedList(block, block->GetState()));
+        HEAP_CHK_STATUS(RemoveBlockFromSortedList(block, block->GetState()));
+        if (heap->IsFreeInProgress())
+        {
+            // Add the block to deleted list instead of freed to prevent it from being reused
+            HEAP_CHK_STATUS(block->Delete());
+            HEAP_CHK_STATUS(AddBlockToSortedList(block, block->GetState()));
+        }
+        else
+        {
             HEAP_CHK_STATUS(block->Free());
             HEAP_CHK_STATUS(AddBlockToSortedList(block, block->GetState()));
+            HEAP_CHK_STATUS(ConsolidateFreeBlock(block));
+        }
 
-            // Consolidate free blocks
-            auto prev = block->GetPrev(), next = block->GetNext();
-            if (prev && prev->GetState() == MemoryBlockInternal::State::free)
-            {
-                HEAP_CHK_STATUS(MergeBlocks(prev, block));
-                // re-assign block to pPrev for use in MergeBlocks with pNext
-                block = prev;
-            }
-            else if (prev == nullptr)
-            {
-                HEAP_ASSERTMESSAGE("The previous block should always be valid");
-                return MOS_STATUS_UNKNOWN;
-            }
+        blocksUpdated = true;
+        block = nextSubmitted;
+    }
 
-            if (next && next->GetState() == MemoryBlockInternal::State::free)
-            {
-                HEAP_CHK_STATUS(MergeBlocks(block, next));
-            }
+    return MOS_STATUS_SUCCESS;
+}
 
-            blocksUpdated = true;
-        }
-        block = nextSubmitted;
+MOS_STATUS MemoryBlockManager::ConsolidateFreeBlock(MemoryBlockInternal *block)
+{
+    HEAP_FUNCTION_ENTER_VERBOSE;
+
+    HEAP_CHK_NULL(block);
+
+    auto prev = block->GetPrev(), next = block->GetNext();
+    if (prev && prev->GetState() == MemoryBlockInternal::State::free)
+    {
+        HEAP_CHK_STATUS(MergeBlocks(prev, block));
+        // re-assign block to pPrev for use in MergeBlocks with pNext
+        block = prev;
+    }
+    else if (prev == nullptr)
+    {
+        HEAP_ASSERTMESSAGE("The previous block should always be valid");
+        return MOS_STATUS_UNKNOWN;
     }
 
-    if (blocksUpdated && !m_deletedHeaps.empty())
+    if (next && next->GetState() == MemoryBlockInternal::State::free)
     {
-        HEAP_CHK_STATUS(CompleteHeapDeletion());
+        HEAP_CHK_STATUS(MergeBlocks(block, next));
     }
 
     return MOS_STATUS_SUCCESS;
@@ -324,27 +362,16 @@ MOS_STATUS MemoryBlockManager::UnregisterHeap(uint32_t heapId)
             m_totalSizeOfHeaps -= (*iterator)->m_heap->GetSize();
 
             // free blocks may be removed right away
-            auto block = m_sortedBlockList[MemoryBlockInternal::State::free];
-            MemoryBlockInternal *next = nullptr;
+            auto block = (*iterator)->m_adjacencyListBegin->GetNext();
             while (block != nullptr)
             {
-                next = block->m_stateNext;
-                auto heap = block->GetHeap();
-                if (heap != nullptr)
-                {
-                    if (heap->GetId() == heapId)
-                    {
-                        HEAP_CHK_STATUS(RemoveBlockFromSortedList(block, block->GetState()));
-                        HEAP_CHK_STATUS(block->Delete());
-                        HEAP_CHK_STATUS(AddBlockToSortedList(block, block->GetState()));
-                    }
-                }
-                else
+                if (block->GetState() == MemoryBlockInternal::State::free)
                 {
-                    HEAP_ASSERTMESSAGE("A block with an invalid heap is in the free list!");
-                    return MOS_STATUS_UNKNOWN;
+                    HEAP_CHK_STATUS(RemoveBlockFromSortedList(block, block->GetState()));
+                    HEAP_CHK_STATUS(block->Delete());
+                    HEAP_CHK_STATUS(AddBlockToSortedList(block, block->GetState()));
                 }
-                block = next;
+                block = block->GetNext();
             }
 
             m_deletedHeaps.push_back((*iterator));
@@ -367,8 +394,7 @@ MOS_STATUS MemoryBlockManager::CompleteHeapDeletion()
         // if the heap is still not empty, continue with the loop
         if ((*iterator)->m_heap->GetUsedSize() == 0)
         {
-            uint32_t heapId = (*iterator)->m_heap->GetId();
-            HEAP_CHK_STATUS(RemoveHeapFromSortedBlockList(heapId));
+            HEAP_CHK_STATUS(RemoveHeapFromSortedBlockList((*iterator).get()));
             iterator = m_deletedHeaps.erase(iterator);
         }
         else
@@ -405,8 +431,9 @@ MOS_STATUS MemoryBlockManager::RegisterOsInterface(PMOS_INTERFACE osInterface)
     return MOS_STATUS_SUCCESS;
 }
 
-MOS_STATUS MemoryBlockManager::IsSpaceAvailable(
+MOS_STATUS MemoryBlockManager::AllocateSpace(
     AcquireParams &params,
+    std::vector<MemoryBlock> &blocks,
     uint32_t &spaceNeeded)
 {
     HEAP_FUNCTION_ENTER_VERBOSE;
@@ -416,144 +443,141 @@ MOS_STATUS MemoryBlockManager::IsSpaceAvailable(
         HEAP_ASSERTMESSAGE("No space is being requested");
         return MOS_STATUS_INVALID_PARAMETER;
     }
-    if (m_sortedBlockList[MemoryBlockInternal::State::free] == nullptr)
+
+    m_acquiredBlocks.assign(m_sortedSizes.size(), nullptr);
+    for (uint32_t i = 0; i < m_sortedSizes.size(); ++i)
     {
-        bool blocksUpdated = false;
-        HEAP_CHK_STATUS(RefreshBlockStates(blocksUpdated));
-        if (!blocksUpdated)
+        auto block = FindFreeBlock(m_sortedSizes[i].m_blockSize);
+        if (block == nullptr)
         {
-            HEAP_NORMALMESSAGE("All heap space is in use by active workloads.");
+            // keep going to report the full amount of space missing
+            spaceNeeded += m_sortedSizes[i].m_blockSize;
+            continue;
         }
-    }
 
-    auto block = m_sortedBlockList[MemoryBlockInternal::State::free];
- 
-    for (auto requestIterator = m_sortedSizes.begin();
-        requestIterator != m_sortedSizes.end();
-        ++requestIterator)
-    {
-        if (block == nullptr)
+        if (!m_useProducer)
         {
-            // There is no free space available, add up all requested sizes
-            spaceNeeded += (*requestIterator).m_blockSize;
+            HEAP_CHK_STATUS(AllocateBlock(
+                m_sortedSizes[i].m_blockSize,
+                params.m_trackerId,
+                params.m_staticBlock,
+                block));
         }
         else
         {
-            // Determine whether or not there is space available
-            if ((*requestIterator).m_blockSize > block->GetSize())
-            {
-                // The requested size is larger than the largest free block size
-                spaceNeeded += (*requestIterator).m_blockSize;
-                continue;
-            }
-            else
+            HEAP_CHK_STATUS(AllocateBlock(
+                m_sortedSizes[i].m_blockSize,
+                params.m_trackerIndex,
+                params.m_trackerId,
+                params.m_staticBlock,
+                block));
+        }
+        m_acquiredBlocks[i] = block;
+    }
+
+    if (spaceNeeded != 0)
+    {
+        // Undo in reverse order so that split blocks merge back as they were
+        for (auto iterator = m_acquiredBlocks.rbegin(); iterator != m_acquiredBlocks.rend(); ++iterator)
+        {
+            if (*iterator != nullptr)
             {
-                // determine if there is enough space in the heaps
-                auto freeBlockSize = block->GetSize();
-                while (requestIterator != m_sortedSizes.end())
-                {
-                    if ((*requestIterator).m_blockSize < freeBlockSize)
-                    {
-                        // if the aligned size fits within the current free block, consider it used
-                        freeBlockSize -= (*requestIterator).m_blockSize;
-                        ++requestIterator;
-                    }
-                    else
-                    {
-                        // if the aligned size does not fit within the curret free block, continue for loop
-                        break;
-                    }
-                }
-                if (requestIterator == m_sortedSizes.end())
-                {
-                    break;
-                }
+                HEAP_CHK_STATUS(ReleaseAcquiredBlock(*iterator));
             }
         }
-        if (block != nullptr)
+        return MOS_STATUS_SUCCESS;
+    }
+
+    if (blocks.size() != m_sortedSizes.size())
+    {
+        blocks.resize(m_sortedSizes.size());
+    }
+
+    for (uint32_t i = 0; i < m_sortedSizes.size(); ++i)
+    {
+        auto block = m_acquiredBlocks[i];
+        auto heap = block->GetHeap();
+        HEAP_CHK_NULL(heap);
+        if (m_sortedSizes[i].m_originalIdx >= m_sortedSizes.size())
         {
-            block = block->m_stateNext;
+            HEAP_ASSERTMESSAGE("Index is out of bounds");
+            return MOS_STATUS_INVALID_PARAMETER;
         }
+        HEAP_CHK_STATUS(blocks[m_sortedSizes[i].m_originalIdx].CreateFromInternalBlock(
+            block,
+            heap,
+            heap->m_keepLocked ? heap->m_lockedHeap : nullptr));
     }
 
     return MOS_STATUS_SUCCESS;
 }
 
-MOS_STATUS MemoryBlockManager::AllocateSpace(
-    AcquireParams &params,
-    std::vector<MemoryBlock> &blocks)
+MOS_STATUS MemoryBlockManager::ReleaseAcquiredBlock(MemoryBlockInternal *block)
 {
     HEAP_FUNCTION_ENTER_VERBOSE;
 
-    if (m_sortedSizes.empty())
-    {
-        HEAP_ASSERTMESSAGE("No space is being requested");
-        return MOS_STATUS_INVALID_PARAMETER;
-    }
+    HEAP_CHK_NULL(block);
+
+    HEAP_CHK_STATUS(RemoveBlockFromSortedList(block, block->GetState()));
+    block->ClearStatic();
+    HEAP_CHK_STATUS(block->Free());
+    HEAP_CHK_STATUS(AddBlockToSortedList(block, block->GetState()));
+    HEAP_CHK_STATUS(ConsolidateFreeBlock(block));
+
+    return MOS_STATUS_SUCCESS;
+}
+
+void MemoryBlockManager::GetFreeBinIndex(uint32_t size, uint32_t &fl, uint32_t &sl)
+{
+    fl = FindHighestSetBit(size);
+    sl = (fl < m_freeBinSlLog2) ? 0 : (size >> (fl - m_freeBinSlLog2)) & (m_freeBinSlCount - 1);
+}
 
-    if (m_sortedBlockList[MemoryBlockInternal::State::free] == nullptr)
+MemoryBlockInternal *MemoryBlockManager::FindFreeBlock(uint32_t size)
+{
+    HEAP_FUNCTION_ENTER_VERBOSE;
+
+    if (size == 0 || m_freeBinFlBitmap == 0)
     {
-        HEAP_ASSERTMESSAGE("No free blocks available");
-        return MOS_STATUS_INVALID_PARAMETER;
+        return nullptr;
     }
 
-    if (blocks.size() != m_sortedSizes.size())
+    uint32_t fl = 0, sl = 0;
+    uint32_t roundedSize = size;
+    uint32_t msb = FindHighestSetBit(size);
+    if (msb >= m_freeBinSlLog2)
     {
-        blocks.resize(m_sortedSizes.size());
+        uint32_t round = (1u << (msb - m_freeBinSlLog2)) - 1;
+        roundedSize = (size > 0xffffffff - round) ? 0xffffffff : size + round;
     }
+    GetFreeBinIndex(roundedSize, fl, sl);
 
-    for (auto requestIterator = m_sortedSizes.begin();
-        requestIterator != m_sortedSizes.end();
-        ++requestIterator)
+    uint32_t slBitmap = m_freeBinSlBitmap[fl] & (0xffffffff << sl);
+    if (slBitmap == 0 && fl + 1 < m_freeBinFlCount)
     {
-        bool allocated = false;
-        auto block = m_sortedBlockList[MemoryBlockInternal::State::free];
-        while (block != nullptr)
+        uint32_t flBitmap = m_freeBinFlBitmap & (0xffffffff << (fl + 1));
+        if (flBitmap != 0)
         {
-            if (block->GetSize() >= (*requestIterator).m_blockSize)
-            {
-                auto heap = block->GetHeap();
-                HEAP_CHK_NULL(heap);
-                if (!m_useProducer)
-                {
-                    HEAP_CHK_STATUS(AllocateBlock(
-                        (*requestIterator).m_blockSize,
-                        params.m_trackerId,
-                        params.m_staticBlock,
-                        block));
-                }
-                else
-                {
-                    HEAP_CHK_STATUS(AllocateBlock(
-                        (*requestIterator).m_blockSize,
-                        params.m_trackerIndex,
-                        params.m_trackerId,
-                        params.m_staticBlock,
-                        block));
-                }
-                if ((*requestIterator).m_originalIdx >= m_sortedSizes.size())
-                {
-                    HEAP_ASSERTMESSAGE("Index is out of bounds");
-                    return MOS_STATUS_INVALID_PARAMETER;
-                }
-                HEAP_CHK_STATUS(blocks[(*requestIterator).m_originalIdx].CreateFromInternalBlock(
-                    block,
-                    heap,
-                    heap->m_keepLocked ? heap->m_lockedHeap : nullptr));
-                allocated = true;
-                break;
-            }
-            block = block->m_stateNext;
+            fl = FindLowestSetBit(flBitmap);
+            slBitmap = m_freeBinSlBitmap[fl];
         }
+    }
+    if (slBitmap != 0)
+    {
+        return m_freeBins[fl][FindLowestSetBit(slBitmap)];
+    }
 
-        if (!allocated)
+    // Blocks in the bin of the requested size itself may still be large enough
+    GetFreeBinIndex(size, fl, sl);
+    for (auto block = m_freeBins[fl][sl]; block != nullptr; block = block->m_stateNext)
+    {
+        if (block->GetSize() >= size)
         {
-            HEAP_ASSERTMESSAGE("No free block was found for the data! This should not occur.");
-            return MOS_STATUS_UNKNOWN;
+            return block;
         }
     }
 
-    return MOS_STATUS_SUCCESS;
+    return nullptr;
 }
 
 MOS_STATUS MemoryBlockManager::AllocateBlock(
@@ -592,6 +616,8 @@ MOS_STATUS MemoryBlockManager::AllocateBlock(
         freeBlock->SetStatic();
     }
     HEAP_CHK_STATUS(freeBlock->Allocate(trackerId));
+    freeBlock->m_retireIndex = 0;
+    freeBlock->m_retireTrackerId = trackerId;
     HEAP_CHK_STATUS(AddBlockToSortedList(freeBlock, freeBlock->GetState()));
 
     return MOS_STATUS_SUCCESS;
@@ -640,6 +666,8 @@ MOS_STATUS MemoryBlockManager::AllocateBlock(
         freeBlock->SetStatic();
     }
     HEAP_CHK_STATUS(freeBlock->Allocate(index, trackerId, m_trackerProducer));
+    freeBlock->m_retireIndex = index;
+    freeBlock->m_retireTrackerId = trackerId;
     HEAP_CHK_STATUS(AddBlockToSortedList(freeBlock, freeBlock->GetState()));
 
     return MOS_STATUS_SUCCESS;
@@ -673,41 +701,54 @@ MOS_STATUS MemoryBlockManager::AddBlockToSortedList(
     {
         case MemoryBlockInternal::State::free:
         {
-            bool inserted = false;
-            MemoryBlockInternal *prev = nullptr;
-            while (curr != nullptr)
+            uint32_t fl = 0, sl = 0;
+            GetFreeBinIndex(block->GetSize(), fl, sl);
+            curr = m_freeBins[fl][sl];
+            block->m_stateNext = curr;
+            if (curr)
             {
-                if (curr->GetSize() <= block->GetSize())
-                {
-                    if (prev)
-                    {
-                        prev->m_stateNext = block;
-                    }
-                    else
-                    {
-                        m_sortedBlockList[state] = block;
-                    }
-                    curr->m_statePrev = block;
-                    block->m_statePrev = prev;
-                    block->m_stateNext = curr;
-                    inserted = true;
-                    break;
-                }
-                prev = curr;
-                curr = curr->m_stateNext;
+                curr->m_statePrev = block;
             }
-            if (!inserted)
+            m_freeBins[fl][sl] = block;
+            m_freeBinSlBitmap[fl] |= (1u << sl);
+            m_freeBinFlBitmap |= (1u << fl);
+            block->m_stateListType = state;
+            m_sortedBlockListNumEntries[state]++;
+            m_sortedBlockListSizes[state] += block->GetSize();
+            break;
+        }
+        case MemoryBlockInternal::State::submitted:
+        {
+            uint32_t index = block->m_retireIndex;
+            if (index >= MAX_TRACKER_NUMBER)
             {
-                if (prev == nullptr)
-                {
-                    block->m_stateNext = m_sortedBlockList[state];
-                    m_sortedBlockList[state] = block;
-                }
-                else
-                {
-                    block->m_statePrev = prev;
-                    prev->m_stateNext = block;
-                }
+                HEAP_ASSERTMESSAGE("Tracker index is out of bounds");
+                return MOS_STATUS_INVALID_PARAMETER;
+            }
+            // Submissions mostly come in tracker ID order, so the insertion point is found at the tail
+            auto prev = m_retireQueueTail[index];
+            while (prev != nullptr && IsTrackerIdBefore(block->m_retireTrackerId, prev->m_retireTrackerId))
+            {
+                prev = prev->m_statePrev;
+            }
+            auto next = prev ? prev->m_stateNext : m_retireQueueHead[index];
+            block->m_statePrev = prev;
+            block->m_stateNext = next;
+            if (prev)
+            {
+                prev->m_stateNext = block;
+            }
+            else
+            {
+                m_retireQueueHead[index] = block;
+            }
+            if (next)
+            {
+                next->m_statePrev = block;
+            }
+            else
+            {
+                m_retireQueueTail[index] = block;
             }
             block->m_stateListType = state;
             m_sortedBlockListNumEntries[state]++;
@@ -715,7 +756,6 @@ MOS_STATUS MemoryBlockManager::AddBlockToSortedList(
             break;
         }
         case MemoryBlockInternal::State::allocated:
-        case MemoryBlockInternal::State::submitted:
         case MemoryBlockInternal::State::deleted:
             block->m_stateNext = curr;
             if (curr)
@@ -760,6 +800,27 @@ MOS_STATUS MemoryBlockManager::RemoveBlockFromSortedList(
         case MemoryBlockInternal::State::submitted:
         case MemoryBlockInternal::State::deleted:
         {
+            uint32_t fl = 0, sl = 0;
+            MemoryBlockInternal **head = &m_sortedBlockList[state];
+            if (state == MemoryBlockInternal::State::free)
+            {
+                GetFreeBinIndex(block->GetSize(), fl, sl);
+                head = &m_freeBins[fl][sl];
+            }
+            else if (state == MemoryBlockInternal::State::submitted)
+            {
+                if (block->m_retireIndex >= MAX_TRACKER_NUMBER)
+                {
+                    HEAP_ASSERTMESSAGE("Tracker index is out of bounds");
+                    return MOS_STATUS_INVALID_PARAMETER;
+                }
+                head = &m_retireQueueHead[block->m_retireIndex];
+                if (block->m_stateNext == nullptr)
+                {
+                    m_retireQueueTail[block->m_retireIndex] = block->m_statePrev;
+                }
+            }
+
             if (block->m_statePrev)
             {
                 block->m_statePrev->m_stateNext = block->m_stateNext;
@@ -767,12 +828,20 @@ MOS_STATUS MemoryBlockManager::RemoveBlockFromSortedList(
             else
             {
                 // special case for beginning of list
-                m_sortedBlockList[state] = block->m_stateNext;
+                *head = block->m_stateNext;
             }
             if (block->m_stateNext)
             {
                 block->m_stateNext->m_statePrev = block->m_statePrev;
             }
+            if (state == MemoryBlockInternal::State::free && *head == nullptr)
+            {
+                m_freeBinSlBitmap[fl] &= ~(1u << sl);
+                if (m_freeBinSlBitmap[fl] == 0)
+                {
+                    m_freeBinFlBitmap &= ~(1u << fl);
+                }
+            }
             block->m_statePrev = block->m_stateNext = nullptr;
             block->m_stateListType = MemoryBlockInternal::State::stateCount;
             m_sortedBlockListNumEntries[state]--;
@@ -815,29 +884,20 @@ MemoryBlockInternal *MemoryBlockManager::GetBlockFromPool()
     return block;
 }
 
-MOS_STATUS MemoryBlockManager::RemoveHeapFromSortedBlockList(uint32_t heapId)
+MOS_STATUS MemoryBlockManager::RemoveHeapFromSortedBlockList(HeapWithAdjacencyBlockList *heap)
 {
-    for (auto state = 0; state < MemoryBlockInternal::State::stateCount; ++state)
-    {
-        if (state == MemoryBlockInternal::State::pool)
-        {
-            continue;
-        }
+    HEAP_CHK_NULL(heap);
+    HEAP_CHK_NULL(heap->m_adjacencyListBegin);
 
-        auto curr = m_sortedBlockList[state];
-        Heap *heap = nullptr;
-        MemoryBlockInternal *nextBlock = nullptr;
-        while (curr != nullptr)
+    // all non-pool blocks of the heap are in its adjacency list
+    auto curr = heap->m_adjacencyListBegin->GetNext();
+    while (curr != nullptr)
+    {
+        if (curr->m_stateListType != MemoryBlockInternal::State::stateCount)
         {
-            nextBlock = curr->m_stateNext;
-            heap = curr->GetHeap();
-            HEAP_CHK_NULL(heap);
-            if (heap->GetId() == heapId)
-            {
-                HEAP_CHK_STATUS(RemoveBlockFromSortedList(curr, curr->GetState()));
-            }
-            curr = nextBlock;
+            HEAP_CHK_STATUS(RemoveBlockFromSortedList(curr, curr->GetState()));
         }
+        curr = curr->GetNext();
     }
 
     return MOS_STATUS_SUCCESS;
@@ -233,6 +233,20 @@ public:
     
     virtual MOS_GPU_COMPONENT_ID GetGpuComponentId() = 0;
 
+    //!
+    //! \brief    Get the number of submitted command buffers not yet completed by GPU
+    //! \param    [in] maxCount
+    //!           Stop counting at maxCount, most recent submissions are checked first
+    //! \param    [in, out] probeBudget
+    //!           Busy checks left, decremented by every check
+    //! \return   uint32_t
+    //!           Pending submission count, 0 if not tracked
+    //!
+    virtual uint32_t GetPendingSubmissions(uint32_t maxCount, uint32_t &probeBudget)
+    {
+        return 0;
+    }
+
     virtual MOS_STATUS SetHybridCmdMgr(HybridCmdMgr *hybridCmdMgr)
     {
         m_hybridCmdMgr = hybridCmdMgr;
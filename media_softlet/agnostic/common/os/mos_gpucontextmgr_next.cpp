@@ -209,6 +209,31 @@ GpuContextNext *GpuContextMgrNext::CreateGpuContext(
     return gpuContext;
 }
 
+uint32_t GpuContextMgrNext::GetPendingSubmissions(MOS_GPU_NODE node, uint32_t maxCount)
+{
+    uint32_t pending     = 0;
+    // bounds the busy checks made under the array mutex, whatever the context count
+    uint32_t probeBudget = 2 * maxCount;
+
+    MosUtilities::MosLockMutex(m_gpuContextArrayMutex);
+    for (auto &curGpuCtx : m_gpuContextMap)
+    {
+        GpuContextNext *gpuContext = curGpuCtx.second;
+        if (gpuContext == nullptr || gpuContext->GetContextNode() != node)
+        {
+            continue;
+        }
+        pending += gpuContext->GetPendingSubmissions(maxCount - pending, probeBudget);
+        if (pending >= maxCount || probeBudget == 0)
+        {
+            break;
+        }
+    }
+    MosUtilities::MosUnlockMutex(m_gpuContextArrayMutex);
+
+    return pending;
+}
+
 GpuContextNext *GpuContextMgrNext::GetGpuContext(GPU_CONTEXT_HANDLE gpuContextHandle)
 {
     MOS_OS_FUNCTION_ENTER;
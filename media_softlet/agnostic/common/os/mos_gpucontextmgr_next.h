@@ -152,6 +152,18 @@ public:
         return m_initialized;
     }
 
+    //!
+    //! \brief    Get pending submissions of all gpu contexts on one engine node
+    //! \details  At most 2 * maxCount command buffers are checked in total.
+    //! \param    [in] node
+    //!           Hardware node to query
+    //! \param    [in] maxCount
+    //!           Saturation value of the returned count
+    //! \return   uint32_t
+    //!           Pending submission count, no larger than maxCount
+    //!
+    uint32_t GetPendingSubmissions(MOS_GPU_NODE node, uint32_t maxCount);
+
     PMOS_MUTEX GetGpuContextArrayMutex()
     {
         return m_gpuContextArrayMutex;
@@ -1842,6 +1842,26 @@ public:
     static uint64_t GetGpuStatusSyncTag(
         MOS_STREAM_HANDLE streamState,
         GPU_CONTEXT_HANDLE gpuContext);
+
+    //!
+    //! \brief   Get load of one engine node
+    //! \details Counts the submissions of all gpu contexts of the device on the
+    //!          node which are not yet completed by GPU.
+    //!
+    //! \param    [in] streamState
+    //!           Handle of Os Stream State
+    //! \param    [in] node
+    //!           Hardware node to query
+    //! \param    [in] maxCount
+    //!           Saturation value of the returned count
+    //!
+    //! \return   uint32_t
+    //!           Pending submission count, 0 if not available
+    //!
+    static uint32_t GetEngineLoad(
+        MOS_STREAM_HANDLE streamState,
+        MOS_GPU_NODE      node,
+        uint32_t          maxCount);
     
     //!
     //! \brief   Get Gpu Status Buffer Resource
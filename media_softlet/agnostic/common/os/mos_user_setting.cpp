@@ -73,6 +73,13 @@ MOS_STATUS MosUserSetting::InitMosCommonUserSetting(MediaUserSettingSharedPtr us
         uint32_t(0),
         true);
 
+    DeclareUserSettingKey(
+        userSettingPtr,
+        __MEDIA_USER_FEATURE_MCPY_LOAD_AWARE_ENGINE_SELECT,
+        MediaUserSetting::Group::Device,
+        false,
+        true);  // move media copy to the least loaded capable engine
+
     DeclareUserSettingKey(
         userSettingPtr,
         __MEDIA_USER_FEATURE_VALUE_PROTECT_MODE_ENABLE,
@@ -36,6 +36,12 @@ MOS_STATUS MosUtilities::MosUtilitiesInit(MediaUserSettingSharedPtr userSettingP
 
     eStatus = MosOsUtilitiesInit(userSettingPtr);
 
+    // Resolve the declared items once, later reads of them are lock free lookups.
+    if (eStatus == MOS_STATUS_SUCCESS && userSettingPtr != nullptr)
+    {
+        RefreshUserSettingSnapshot(userSettingPtr);
+    }
+
 #if (_DEBUG || _RELEASE_INTERNAL)
     //Initialize MOS simulate random alloc memorflag
 #if COMMON_DLL_SEPARATION_SUPPORT
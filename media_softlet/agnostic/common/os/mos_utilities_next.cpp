@@ -747,43 +747,82 @@ void MosUtilities::MosSwizzleData(
 
     int32_t LinearOffset;
     int32_t TileOffset;
+    int32_t LastOffset;
+    int32_t SurfaceSize;
+    int32_t Span;
+    int32_t CopySize;
     int32_t x;
     int32_t y;
+    int32_t i;
+    MOS_TILE_TYPE TileFormat;
+    bool    bTiledToLinear;
+
+    if (IS_TILED_TO_LINEAR(SrcTiling, DstTiling))
+    {
+        bTiledToLinear = true;
+        TileFormat     = SrcTiling;
+    }
+    else if (IS_LINEAR_TO_TILED(SrcTiling, DstTiling))
+    {
+        bTiledToLinear = false;
+        TileFormat     = DstTiling;
+    }
+    else
+    {
+        MOS_OS_ASSERT(0);
+        return;
+    }
+
+    // Swizzling only reorders whole micro-tile rows (16B OWords for TileY/Tile4,
+    // 512B rows for TileX), so bytes inside one span stay contiguous on both
+    // sides and can be moved with one memcpy instead of one swizzle per byte.
+    Span        = (TileFormat == MOS_TILE_X) ? 512 : 16;
+    SurfaceSize = iHeight * iPitch;
 
     // Translate from one format to another
-    for (y = 0, LinearOffset = 0, TileOffset = 0; y < iHeight; y++)
+    for (y = 0, LinearOffset = 0; y < iHeight; y++)
     {
-        for (x = 0; x < iPitch; x++, LinearOffset++)
+        for (x = 0; x < iPitch; x += CopySize, LinearOffset += CopySize)
         {
-            // x or y --> linear
-            if (IS_TILED_TO_LINEAR(SrcTiling, DstTiling))
+            CopySize   = MOS_MIN(Span - (x & (Span - 1)), iPitch - x);
+            TileOffset = Mos_SwizzleOffset(x, y, iPitch, TileFormat, false, extFlags);
+            LastOffset = Mos_SwizzleOffset(x + CopySize - 1, y, iPitch, TileFormat, false, extFlags);
+
+            if (LastOffset != TileOffset + CopySize - 1)
             {
-                TileOffset = Mos_SwizzleOffset(
-                    x,
-                    y,
-                    iPitch,
-                    SrcTiling,
-                    false,
-                    extFlags);
-                if(TileOffset < iHeight * iPitch)
-                    *(pDst + LinearOffset) = *(pSrc + TileOffset);
+                // Layout does not keep this span contiguous, fall back to per byte swizzle
+                for (i = 0; i < CopySize; i++)
+                {
+                    TileOffset = Mos_SwizzleOffset(x + i, y, iPitch, TileFormat, false, extFlags);
+                    if (TileOffset < SurfaceSize)
+                    {
+                        if (bTiledToLinear)
+                        {
+                            *(pDst + LinearOffset + i) = *(pSrc + TileOffset);
+                        }
+                        else
+                        {
+                            *(pDst + TileOffset) = *(pSrc + LinearOffset + i);
+                        }
+                    }
+                }
+                continue;
             }
-            // linear --> x or y
-            else if (IS_LINEAR_TO_TILED(SrcTiling, DstTiling))
+
+            if (TileOffset >= SurfaceSize)
             {
-                TileOffset = Mos_SwizzleOffset(
-                    x,
-                    y,
-                    iPitch,
-                    DstTiling,
-                    false,
-                    extFlags);
-                if(TileOffset < iHeight * iPitch)
-                    *(pDst + TileOffset) = *(pSrc + LinearOffset);
+                continue;
             }
+
+            // x or y --> linear
+            if (bTiledToLinear)
+            {
+                memcpy(pDst + LinearOffset, pSrc + TileOffset, MOS_MIN(CopySize, SurfaceSize - TileOffset));
+            }
+            // linear --> x or y
             else
             {
-                MOS_OS_ASSERT(0);
+                memcpy(pDst + TileOffset, pSrc + LinearOffset, MOS_MIN(CopySize, SurfaceSize - TileOffset));
             }
         }
     }
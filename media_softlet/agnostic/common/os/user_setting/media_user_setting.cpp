@@ -77,6 +77,11 @@ MOS_STATUS MediaUserSetting::Read(Value &value,
     return status;
 }
 
+MOS_STATUS MediaUserSetting::RefreshSnapshot()
+{
+    return m_configure.RefreshSnapshot();
+}
+
 MOS_STATUS MediaUserSetting::Write(
     const std::string &valueName,
     const Value &value,
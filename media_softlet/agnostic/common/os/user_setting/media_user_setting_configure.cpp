@@ -125,6 +125,9 @@ MOS_STATUS Configure::Register(
                 m_rootKey,
                 statePath)));
 
+    // Items declared after the snapshot is built are merged into it by the next internal Read.
+    m_snapshotStale.store(true, std::memory_order_release);
+
     m_mutexLock.Unlock();
 
     return MOS_STATUS_SUCCESS;
@@ -137,29 +140,69 @@ MOS_STATUS Configure::Read(Value &value,
     bool useCustomValue,
     uint32_t option)
 {
-    int32_t     ret     = 0;
     MOS_STATUS  status  = MOS_STATUS_UNKNOWN;
+    size_t      keyId   = MakeHash(valueName);
     auto        &defs   = GetDefinitions(group);
-    auto        def     = defs[MakeHash(valueName)];
-    if (def == nullptr)
+
+    // Internal items are read from the snapshot without lock once it is built.
+    if (option == MEDIA_USER_SETTING_INTERNAL &&
+        ReadSnapshot(value, keyId, &defs - m_definitions, customValue, useCustomValue, status))
+    {
+        return status;
+    }
+
+    auto defIt = defs.find(keyId);
+    if (defIt == defs.end() || defIt->second == nullptr)
     {
         return MOS_STATUS_INVALID_HANDLE;
     }
-    auto        defaultType = def->DefaultValue().ValueType();
+    auto def = defIt->second;
 
     if (def->IsDebugOnly() && !m_isDebugMode)
     {
         value = useCustomValue ? customValue : def->DefaultValue();
         return MOS_STATUS_SUCCESS;
     }
-    std::string path = GetReadPath(def, option);
+
+    status = ReadValue(value, def, GetReadPath(def, option), option);
+
+    if (status != MOS_STATUS_SUCCESS)
+    {
+        // customValue is only for internal user setting Read
+        if (option == MEDIA_USER_SETTING_INTERNAL)
+        {
+            value = useCustomValue ? customValue : def->DefaultValue();
+        }
+        else
+        {
+            // For external user setting, no customValue
+            if (useCustomValue == true)
+            {
+                MOS_OS_ASSERTMESSAGE("External user setting %s customValue will not be used.", valueName.c_str());
+            }
+        }
+    }
+
+    return status;
+}
+
+MOS_STATUS Configure::ReadValue(
+    Value &value,
+    std::shared_ptr<Definition> def,
+    const std::string &path,
+    uint32_t option)
+{
+    MOS_STATUS          status      = MOS_STATUS_UNKNOWN;
+    const std::string   &valueName  = def->ItemName();
+    auto                defaultType = def->DefaultValue().ValueType();
+
 #if (_DEBUG || _RELEASE_INTERNAL)
     //First, Read pid path user setting. If succeed, return;
+    m_mutexLock.Lock();
     if (m_nonPidRegPaths.find(path) == m_nonPidRegPaths.end())
     {
         std::string pathPidSuffix = path + m_pidPath;
         UFKEY_NEXT  keyPidSuffix  = {};
-        m_mutexLock.Lock();
         status = MosUtilities::MosOpenRegKey(m_rootKey, pathPidSuffix, KEY_READ, &keyPidSuffix, m_regBufferMap);
         if (status == MOS_STATUS_SUCCESS)
         {
@@ -171,8 +214,8 @@ MOS_STATUS Configure::Read(Value &value,
             // Record the reg path which does not have inner pid reg path.
             m_nonPidRegPaths.insert(path);
         }
-        m_mutexLock.Unlock();
     }
+    m_mutexLock.Unlock();
     //Second, if reading pid path failed, read non-pid path. If succeed, return;
     if (status != MOS_STATUS_SUCCESS)
 #endif
@@ -198,24 +241,140 @@ MOS_STATUS Configure::Read(Value &value,
         status = MosUtilities::MosReadEnvVariable(def->ItemEnvName(), defaultType, value);
     }
 
-    if (status != MOS_STATUS_SUCCESS)
+    return status;
+}
+
+bool Configure::ReadSnapshot(
+    Value &value,
+    size_t keyId,
+    ptrdiff_t group,
+    const Value &customValue,
+    bool useCustomValue,
+    MOS_STATUS &status)
+{
+    // Items declared since the last build are merged once, by whichever reader sees them first.
+    if (m_snapshot.load(std::memory_order_acquire) != nullptr &&
+        m_snapshotStale.load(std::memory_order_acquire) &&
+        m_snapshotStale.exchange(false))
     {
-        // customValue is only for internal user setting Read
-        if (option == MEDIA_USER_SETTING_INTERNAL)
+        BuildSnapshot(true);
+    }
+
+    // The reader count is raised before the snapshot is loaded, so BuildSnapshot only
+    // retires old snapshots after every reader which may have loaded one is gone.
+    m_snapshotReaders.fetch_add(1, std::memory_order_seq_cst);
+    const Snapshot *snapshot = m_snapshot.load(std::memory_order_seq_cst);
+    bool            found    = false;
+    if (snapshot != nullptr)
+    {
+        auto &entries = snapshot->entries[group];
+        auto it       = entries.find(keyId);
+        if (it != entries.end())
         {
-            value = useCustomValue ? customValue : def->DefaultValue();
+            const SnapshotEntry &entry = it->second;
+            value  = (!entry.resolved && useCustomValue) ? customValue : entry.value;
+            status = entry.status;
+            found  = true;
+        }
+    }
+    m_snapshotReaders.fetch_sub(1, std::memory_order_release);
+
+    return found;
+}
+
+MOS_STATUS Configure::RefreshSnapshot()
+{
+    return BuildSnapshot(false);
+}
+
+MOS_STATUS Configure::BuildSnapshot(bool incremental)
+{
+    std::vector<std::pair<uint32_t, std::shared_ptr<Definition>>> items;
+
+    // Builds are serialized so a slower build never publishes over a newer one.
+    m_snapshotBuildLock.Lock();
+
+    RetireSnapshots();
+    if (m_snapshots.size() >= m_maxSnapshots)
+    {
+        // Readers never drained, keep serving the current snapshot. Items missing
+        // from it are still read from registry, a later Read retries the merge.
+        m_snapshotStale.store(true, std::memory_order_release);
+        m_snapshotBuildLock.Unlock();
+        return MOS_STATUS_NO_SPACE;
+    }
+
+    std::unique_ptr<Snapshot> snapshot(new (std::nothrow) Snapshot);
+    if (snapshot == nullptr)
+    {
+        m_snapshotBuildLock.Unlock();
+        return MOS_STATUS_NO_SPACE;
+    }
+
+    // Only this thread publishes, so the current snapshot stays alive while it is copied.
+    const Snapshot *current = m_snapshot.load(std::memory_order_acquire);
+    if (incremental && current != nullptr)
+    {
+        *snapshot = *current;
+    }
+
+    m_mutexLock.Lock();
+    for (uint32_t group = Group::Device; group < Group::MaxCount; group++)
+    {
+        for (auto &def : m_definitions[group])
+        {
+            if (def.second != nullptr && snapshot->entries[group].find(def.first) == snapshot->entries[group].end())
+            {
+                items.push_back(std::make_pair(group, def.second));
+            }
+        }
+    }
+    m_mutexLock.Unlock();
+
+    if (incremental && current != nullptr && items.empty())
+    {
+        m_snapshotBuildLock.Unlock();
+        return MOS_STATUS_SUCCESS;
+    }
+
+    for (auto &item : items)
+    {
+        auto          &def  = item.second;
+        SnapshotEntry entry = {};
+
+        if (def->IsDebugOnly() && !m_isDebugMode)
+        {
+            entry.value  = def->DefaultValue();
+            entry.status = MOS_STATUS_SUCCESS;
         }
         else
         {
-            // For external user setting, no customValue
-            if (useCustomValue == true)
+            entry.status   = ReadValue(entry.value, def, def->GetSubPath(), MEDIA_USER_SETTING_INTERNAL);
+            entry.resolved = (entry.status == MOS_STATUS_SUCCESS);
+            if (!entry.resolved)
             {
-                MOS_OS_ASSERTMESSAGE("External user setting %s customValue will not be used.", valueName.c_str());
+                entry.value = def->DefaultValue();
             }
         }
+        snapshot->entries[item.first].insert(std::make_pair(KeyId(def->ItemName().c_str()), entry));
     }
 
-    return status;
+    m_snapshots.push_back(std::move(snapshot));
+    m_snapshot.store(m_snapshots.back().get(), std::memory_order_seq_cst);
+    RetireSnapshots();
+
+    m_snapshotBuildLock.Unlock();
+    return MOS_STATUS_SUCCESS;
+}
+
+void Configure::RetireSnapshots()
+{
+    // A reader which comes after this check loads the current snapshot, so all
+    // older snapshots can go once no reader is in flight.
+    if (m_snapshots.size() > 1 && m_snapshotReaders.load(std::memory_order_seq_cst) == 0)
+    {
+        m_snapshots.erase(m_snapshots.begin(), m_snapshots.end() - 1);
+    }
 }
 
 MOS_STATUS Configure::Write(
@@ -976,6 +976,436 @@ void RenderHal_GetPixelsPerSample(
     }
 }
 
+//!
+//! \brief    Round up to power of 2
+//! \param    int32_t iValue
+//!           [in] Value to round up
+//! \return   int32_t
+//!           Smallest power of 2 greater or equal to iValue (1 if iValue <= 1)
+//!
+static int32_t RenderHal_RoundUpPow2(int32_t iValue)
+{
+    int32_t iResult = 1;
+    while (iResult < iValue)
+    {
+        iResult <<= 1;
+    }
+    return iResult;
+}
+
+//!
+//! \brief    Get Kernel Index Size
+//! \details  Size of the kernel residency index (residency entries, hash
+//!           buckets and reload statistics), stored in the State Heap control
+//!           structure right after the kernel allocation table
+//! \param    PRENDERHAL_STATE_HEAP_SETTINGS pSettings
+//!           [in] Pointer to state heap settings
+//! \return   uint32_t
+//!           Size in bytes
+//!
+static uint32_t RenderHal_GetKernelIndexSize(
+    PRENDERHAL_STATE_HEAP_SETTINGS pSettings)
+{
+    int32_t  iHashSize  = RenderHal_RoundUpPow2(pSettings->iKernelCount);
+    int32_t  iStatsSize = RenderHal_RoundUpPow2(pSettings->iKernelCount * RENDERHAL_KERNEL_RELOAD_STATS_FACTOR);
+    uint32_t dwSize;
+
+    dwSize  = MOS_ALIGN_CEIL(pSettings->iKernelCount * sizeof(RENDERHAL_KRN_RESIDENCY), 16);
+    dwSize += MOS_ALIGN_CEIL(iHashSize  * sizeof(int32_t), 16);
+    dwSize += MOS_ALIGN_CEIL(iStatsSize * sizeof(RENDERHAL_KRN_RELOAD_STATS), 16);
+
+    return dwSize;
+}
+
+//!
+//! \brief    Setup Kernel Index
+//! \details  Setup pointers to the kernel residency index arrays; contents
+//!           are initialized by RenderHal_ResetKernelIndex
+//! \param    PRENDERHAL_STATE_HEAP pStateHeap
+//!           [in] Pointer to State Heap control structure
+//! \param    PRENDERHAL_STATE_HEAP_SETTINGS pSettings
+//!           [in] Pointer to state heap settings
+//! \param    uint8_t *ptr
+//!           [in] Start of the kernel index in the State Heap control structure
+//! \return   uint8_t *
+//!           End of the kernel index
+//!
+static uint8_t *RenderHal_SetupKernelIndex(
+    PRENDERHAL_STATE_HEAP          pStateHeap,
+    PRENDERHAL_STATE_HEAP_SETTINGS pSettings,
+    uint8_t                        *ptr)
+{
+    pStateHeap->iKernelHashSize        = RenderHal_RoundUpPow2(pSettings->iKernelCount);
+    pStateHeap->iKernelReloadStatsSize = RenderHal_RoundUpPow2(pSettings->iKernelCount * RENDERHAL_KERNEL_RELOAD_STATS_FACTOR);
+
+    pStateHeap->pKernelResidency = (PRENDERHAL_KRN_RESIDENCY)ptr;
+    ptr += MOS_ALIGN_CEIL(pSettings->iKernelCount * sizeof(RENDERHAL_KRN_RESIDENCY), 16);
+
+    pStateHeap->piKernelHash = (int32_t *)ptr;
+    ptr += MOS_ALIGN_CEIL(pStateHeap->iKernelHashSize * sizeof(int32_t), 16);
+
+    pStateHeap->pKernelReloadStats = (PRENDERHAL_KRN_RELOAD_STATS)ptr;
+    ptr += MOS_ALIGN_CEIL(pStateHeap->iKernelReloadStatsSize * sizeof(RENDERHAL_KRN_RELOAD_STATS), 16);
+
+    return ptr;
+}
+
+//!
+//! \brief    Hash Kernel Key
+//! \param    int32_t iKUID
+//!           [in] Kernel Unique ID
+//! \param    int32_t iKCID
+//!           [in] Kernel Cache ID
+//! \return   uint32_t
+//!           Hash value (to be masked by the table size)
+//!
+static inline uint32_t RenderHal_HashKernelKey(int32_t iKUID, int32_t iKCID)
+{
+    uint32_t dwHash = ((uint32_t)iKUID * 0x9E3779B1u) ^ (((uint32_t)iKCID + 0x7F4A7C15u) * 0x85EBCA77u);
+    return dwHash ^ (dwHash >> 16);
+}
+
+//!
+//! \brief    Reset Kernel Index
+//! \details  Empty hash buckets and LRU list, all slots not indexed
+//! \param    PRENDERHAL_STATE_HEAP pStateHeap
+//!           [in] Pointer to State Heap control structure
+//! \param    int32_t iKernelCount
+//!           [in] Number of kernel allocation slots
+//! \return   void
+//!
+static void RenderHal_ResetKernelIndex(
+    PRENDERHAL_STATE_HEAP pStateHeap,
+    int32_t               iKernelCount)
+{
+    PRENDERHAL_KRN_RESIDENCY pResidency;
+    int32_t                  i;
+
+    if (pStateHeap->pKernelResidency == nullptr || pStateHeap->piKernelHash == nullptr)
+    {
+        return;
+    }
+
+    for (i = 0; i < pStateHeap->iKernelHashSize; i++)
+    {
+        pStateHeap->piKernelHash[i] = -1;
+    }
+
+    pResidency = pStateHeap->pKernelResidency;
+    for (i = 0; i < iKernelCount; i++, pResidency++)
+    {
+        pResidency->iKUID     = -1;
+        pResidency->iKCID     = -1;
+        pResidency->iHashNext = -1;
+        pResidency->iLruPrev  = -1;
+        pResidency->iLruNext  = -1;
+        pResidency->bIndexed  = false;
+    }
+
+    pStateHeap->iKernelLruHead = -1;
+    pStateHeap->iKernelLruTail = -1;
+}
+
+//!
+//! \brief    Unlink slot from the kernel LRU list
+//! \param    PRENDERHAL_STATE_HEAP pStateHeap
+//!           [in] Pointer to State Heap control structure
+//! \param    int32_t iSlot
+//!           [in] Kernel allocation slot
+//! \return   void
+//!
+static void RenderHal_UnlinkKernelLru(
+    PRENDERHAL_STATE_HEAP pStateHeap,
+    int32_t               iSlot)
+{
+    PRENDERHAL_KRN_RESIDENCY pResidency = &pStateHeap->pKernelResidency[iSlot];
+
+    if (pResidency->iLruPrev >= 0)
+    {
+        pStateHeap->pKernelResidency[pResidency->iLruPrev].iLruNext = pResidency->iLruNext;
+    }
+    else
+    {
+        pStateHeap->iKernelLruHead = pResidency->iLruNext;
+    }
+
+    if (pResidency->iLruNext >= 0)
+    {
+        pStateHeap->pKernelResidency[pResidency->iLruNext].iLruPrev = pResidency->iLruPrev;
+    }
+    else
+    {
+        pStateHeap->iKernelLruTail = pResidency->iLruPrev;
+    }
+
+    pResidency->iLruPrev = -1;
+    pResidency->iLruNext = -1;
+}
+
+//!
+//! \brief    Link slot at the head (most recently used) of the kernel LRU list
+//! \param    PRENDERHAL_STATE_HEAP pStateHeap
+//!           [in] Pointer to State Heap control structure
+//! \param    int32_t iSlot
+//!           [in] Kernel allocation slot
+//! \return   void
+//!
+static void RenderHal_LinkKernelLru(
+    PRENDERHAL_STATE_HEAP pStateHeap,
+    int32_t               iSlot)
+{
+    PRENDERHAL_KRN_RESIDENCY pResidency = &pStateHeap->pKernelResidency[iSlot];
+
+    pResidency->iLruPrev = -1;
+    pResidency->iLruNext = pStateHeap->iKernelLruHead;
+    if (pStateHeap->iKernelLruHead >= 0)
+    {
+        pStateHeap->pKernelResidency[pStateHeap->iKernelLruHead].iLruPrev = iSlot;
+    }
+    else
+    {
+        pStateHeap->iKernelLruTail = iSlot;
+    }
+    pStateHeap->iKernelLruHead = iSlot;
+}
+
+//!
+//! \brief    Remove slot from the kernel residency index
+//! \param    PRENDERHAL_STATE_HEAP pStateHeap
+//!           [in] Pointer to State Heap control structure
+//! \param    int32_t iSlot
+//!           [in] Kernel allocation slot
+//! \return   void
+//!
+static void RenderHal_RemoveKernelIndex(
+    PRENDERHAL_STATE_HEAP pStateHeap,
+    int32_t               iSlot)
+{
+    PRENDERHAL_KRN_RESIDENCY pResidency;
+    int32_t                  *piLink;
+
+    if (pStateHeap->pKernelResidency == nullptr ||
+        pStateHeap->pKernelResidency[iSlot].bIndexed == false)
+    {
+        return;
+    }
+
+    pResidency = &pStateHeap->pKernelResidency[iSlot];
+
+    // Unlink from hash bucket
+    piLink = &pStateHeap->piKernelHash[RenderHal_HashKernelKey(pResidency->iKUID, pResidency->iKCID) &
+                                       (pStateHeap->iKernelHashSize - 1)];
+    while (*piLink >= 0)
+    {
+        if (*piLink == iSlot)
+        {
+            *piLink = pResidency->iHashNext;
+            break;
+        }
+        piLink = &pStateHeap->pKernelResidency[*piLink].iHashNext;
+    }
+
+    RenderHal_UnlinkKernelLru(pStateHeap, iSlot);
+
+    pResidency->iKUID     = -1;
+    pResidency->iKCID     = -1;
+    pResidency->iHashNext = -1;
+    pResidency->bIndexed  = false;
+}
+
+//!
+//! \brief    Insert slot in the kernel residency index
+//! \details  Slot is hashed by kernel UID/cache ID and placed at the head of the LRU list
+//! \param    PRENDERHAL_STATE_HEAP pStateHeap
+//!           [in] Pointer to State Heap control structure
+//! \param    int32_t iSlot
+//!           [in] Kernel allocation slot
+//! \param    int32_t iKUID
+//!           [in] Kernel Unique ID
+//! \param    int32_t iKCID
+//!           [in] Kernel Cache ID
+//! \return   void
+//!
+static void RenderHal_InsertKernelIndex(
+    PRENDERHAL_STATE_HEAP pStateHeap,
+    int32_t               iSlot,
+    int32_t               iKUID,
+    int32_t               iKCID)
+{
+    PRENDERHAL_KRN_RESIDENCY pResidency;
+    int32_t                  iBucket;
+
+    if (pStateHeap->pKernelResidency == nullptr)
+    {
+        return;
+    }
+
+    RenderHal_RemoveKernelIndex(pStateHeap, iSlot);
+
+    pResidency = &pStateHeap->pKernelResidency[iSlot];
+    iBucket    = RenderHal_HashKernelKey(iKUID, iKCID) & (pStateHeap->iKernelHashSize - 1);
+
+    pResidency->iKUID                 = iKUID;
+    pResidency->iKCID                 = iKCID;
+    pResidency->iHashNext             = pStateHeap->piKernelHash[iBucket];
+    pResidency->bIndexed              = true;
+    pStateHeap->piKernelHash[iBucket] = iSlot;
+
+    RenderHal_LinkKernelLru(pStateHeap, iSlot);
+}
+
+//!
+//! \brief    Search kernel in the residency index
+//! \details  The index is a hint: the slot is validated against the kernel
+//!           allocation table before being reported as resident
+//! \param    PRENDERHAL_STATE_HEAP pStateHeap
+//!           [in] Pointer to State Heap control structure
+//! \param    int32_t iKernelCount
+//!           [in] Number of kernel allocation slots
+//! \param    int32_t iKUID
+//!           [in] Kernel Unique ID
+//! \param    int32_t iKCID
+//!           [in] Kernel Cache ID
+//! \return   int32_t
+//!           Kernel allocation slot, -1 if the kernel is not resident
+//!
+static int32_t RenderHal_SearchKernelIndex(
+    PRENDERHAL_STATE_HEAP pStateHeap,
+    int32_t               iKernelCount,
+    int32_t               iKUID,
+    int32_t               iKCID)
+{
+    PRENDERHAL_KRN_ALLOCATION pKernelAllocation;
+    int32_t                   iSlot;
+    int32_t                   iSteps;
+
+    if (pStateHeap->pKernelResidency == nullptr)
+    {
+        return -1;
+    }
+
+    iSlot = pStateHeap->piKernelHash[RenderHal_HashKernelKey(iKUID, iKCID) & (pStateHeap->iKernelHashSize - 1)];
+    for (iSteps = 0; iSlot >= 0 && iSteps < iKernelCount; iSteps++)
+    {
+        if (pStateHeap->pKernelResidency[iSlot].iKUID == iKUID &&
+            pStateHeap->pKernelResidency[iSlot].iKCID == iKCID)
+        {
+            pKernelAllocation = &pStateHeap->pKernelAllocation[iSlot];
+            if (pKernelAllocation->iKUID   == iKUID &&
+                pKernelAllocation->iKCID   == iKCID &&
+                pKernelAllocation->dwFlags != RENDERHAL_KERNEL_ALLOCATION_FREE)
+            {
+                return iSlot;
+            }
+            break;
+        }
+        iSlot = pStateHeap->pKernelResidency[iSlot].iHashNext;
+    }
+
+    return -1;
+}
+
+//!
+//! \brief    Get kernel reload statistics entry
+//! \param    PRENDERHAL_STATE_HEAP pStateHeap
+//!           [in] Pointer to State Heap control structure
+//! \param    int32_t iKUID
+//!           [in] Kernel Unique ID
+//! \param    int32_t iKCID
+//!           [in] Kernel Cache ID
+//! \param    bool bCreate
+//!           [in] Claim an empty entry if the kernel is not tracked yet
+//! \return   PRENDERHAL_KRN_RELOAD_STATS
+//!           Statistics entry, nullptr if not found (or table full)
+//!
+static PRENDERHAL_KRN_RELOAD_STATS RenderHal_GetKernelReloadStats(
+    PRENDERHAL_STATE_HEAP pStateHeap,
+    int32_t               iKUID,
+    int32_t               iKCID,
+    bool                  bCreate)
+{
+    PRENDERHAL_KRN_RELOAD_STATS pStats;
+    uint32_t                    dwMask;
+    uint32_t                    dwIndex;
+    int32_t                     i;
+
+    if (pStateHeap->pKernelReloadStats == nullptr)
+    {
+        return nullptr;
+    }
+
+    dwMask  = (uint32_t)pStateHeap->iKernelReloadStatsSize - 1;
+    dwIndex = RenderHal_HashKernelKey(iKUID, iKCID) & dwMask;
+    for (i = 0; i < pStateHeap->iKernelReloadStatsSize; i++, dwIndex = (dwIndex + 1) & dwMask)
+    {
+        pStats = &pStateHeap->pKernelReloadStats[dwIndex];
+        if (pStats->dwLoads == 0)
+        {
+            if (!bCreate)
+            {
+                return nullptr;
+            }
+            pStats->iKUID       = iKUID;
+            pStats->iKCID       = iKCID;
+            pStats->dwReloads   = 0;
+            pStats->dwEvictions = 0;
+            return pStats;
+        }
+        if (pStats->iKUID == iKUID && pStats->iKCID == iKCID)
+        {
+            return pStats;
+        }
+    }
+
+    return nullptr;
+}
+
+//!
+//! \brief    Dump Kernel Reload Statistics
+//! \details  Print GSH kernel hit/miss counters and the kernels that had to
+//!           be reloaded after eviction, for kernel heap sizing and profiling
+//! \param    PRENDERHAL_INTERFACE pRenderHal
+//!           [in] Pointer to Hardware Interface Structure
+//! \return   void
+//!
+void RenderHal_DumpKernelReloadStats(
+    PRENDERHAL_INTERFACE pRenderHal)
+{
+    PRENDERHAL_STATE_HEAP       pStateHeap;
+    PRENDERHAL_KRN_RELOAD_STATS pStats;
+    int32_t                     i;
+
+    MHW_RENDERHAL_CHK_NULL_NO_STATUS_RETURN(pRenderHal);
+    MHW_RENDERHAL_CHK_NULL_NO_STATUS_RETURN(pRenderHal->pStateHeap);
+
+    pStateHeap = pRenderHal->pStateHeap;
+    if (pStateHeap->pKernelReloadStats == nullptr)
+    {
+        return;
+    }
+
+    MHW_RENDERHAL_NORMALMESSAGE("GSH kernels: %d slots, %u hits, %u loads, %u untracked loads.",
+        pRenderHal->StateHeapSettings.iKernelCount,
+        pStateHeap->dwKernelHits,
+        pStateHeap->dwKernelMisses,
+        pStateHeap->dwKernelStatsDropped);
+
+    pStats = pStateHeap->pKernelReloadStats;
+    for (i = 0; i < pStateHeap->iKernelReloadStatsSize; i++, pStats++)
+    {
+        if (pStats->dwLoads == 0 || pStats->dwReloads == 0)
+        {
+            continue;
+        }
+        MHW_RENDERHAL_NORMALMESSAGE("GSH kernel KUID %d KCID %d: %u loads, %u reloads, %u evictions.",
+            pStats->iKUID,
+            pStats->iKCID,
+            pStats->dwLoads,
+            pStats->dwReloads,
+            pStats->dwEvictions);
+    }
+}
+
 //!
 //! \brief    Allocate GSH, SSH, ISH control structures and heaps
 //! \details  Allocates State Heap control structure (system memory)
@@ -1112,6 +1542,10 @@ void RenderHal_GetPixelsPerSample(
 |  |         |                    .                      |
 |  |         | Kernel Allocation [K-1]                   |
 |  |         |-------------------------------------------|
+|  |         | Kernel Residency [0] to [K-1]             |
+|  |         | Kernel Hash Buckets                       |
+|  |         | Kernel Reload Statistics                  |
+|  |         |-------------------------------------------|
 |  |         | Media State Control Structure [0]         |--+
 |  |         | Media State Control Structure [1]         |--|--+
 |  |         |                    .                      |  |  |
@@ -1220,6 +1654,7 @@ MOS_STATUS RenderHal_AllocateStateHeaps(
     // Calculate size of State Heap control structure
     dwSizeAlloc  = MOS_ALIGN_CEIL(stateHeapSize, 16);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iKernelCount     * sizeof(RENDERHAL_KRN_ALLOCATION)     , 16);
+    dwSizeAlloc += RenderHal_GetKernelIndexSize(pSettings);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iMediaStateHeaps * mediaStateSize, 16);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iMediaStateHeaps * pSettings->iMediaIDs * sizeof(int32_t)   , 16);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iSurfaceStates   * sizeof(RENDERHAL_SURFACE_STATE_ENTRY), 16);
@@ -1257,6 +1692,9 @@ MOS_STATUS RenderHal_AllocateStateHeaps(
     pStateHeap->pKernelAllocation = (PRENDERHAL_KRN_ALLOCATION) ptr;
     ptr += MOS_ALIGN_CEIL(pSettings->iKernelCount * sizeof(RENDERHAL_KRN_ALLOCATION), 16);
 
+    // Pointer to Kernel residency index
+    ptr = RenderHal_SetupKernelIndex(pStateHeap, pSettings, ptr);
+
     // Pointer to Media State allocations
     pStateHeap->pMediaStates = (PRENDERHAL_MEDIA_STATE) ptr;
     ptr += MOS_ALIGN_CEIL(pSettings->iMediaStateHeaps * mediaStateSize, 16);
@@ -1653,6 +2091,7 @@ MOS_STATUS RenderHal_ReAllocateStateHeapsforAdvFeatureWithSshEnlarged(
     // Calculate size of State Heap control structure
     dwSizeAlloc  = MOS_ALIGN_CEIL(stateHeapSize                                                      , 16);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iKernelCount     * sizeof(RENDERHAL_KRN_ALLOCATION)     , 16);
+    dwSizeAlloc += RenderHal_GetKernelIndexSize(pSettings);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iMediaStateHeaps * mediaStateSize                       , 16);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iMediaStateHeaps * pSettings->iMediaIDs * sizeof(int32_t)   , 16);
     dwSizeAlloc += MOS_ALIGN_CEIL(pSettings->iSurfaceStates   * sizeof(RENDERHAL_SURFACE_STATE_ENTRY), 16);
@@ -1680,6 +2119,9 @@ MOS_STATUS RenderHal_ReAllocateStateHeapsforAdvFeatureWithSshEnlarged(
     pStateHeap->pKernelAllocation = (PRENDERHAL_KRN_ALLOCATION)ptr;
     ptr += MOS_ALIGN_CEIL(pSettings->iKernelCount * sizeof(RENDERHAL_KRN_ALLOCATION), 16);
 
+    // Pointer to Kernel residency index (contents copied from the old heap)
+    ptr = RenderHal_SetupKernelIndex(pStateHeap, pSettings, ptr);
+
     // Pointer to Media State allocations
     pStateHeap->pMediaStates = (PRENDERHAL_MEDIA_STATE)ptr;
     ptr += MOS_ALIGN_CEIL(pSettings->iMediaStateHeaps * mediaStateSize, 16);
@@ -1844,6 +2286,8 @@ MOS_STATUS RenderHal_FreeStateHeaps(PRENDERHAL_INTERFACE pRenderHal)
     pOsInterface = pRenderHal->pOsInterface;
     pStateHeap   = pRenderHal->pStateHeap;
 
+    RenderHal_DumpKernelReloadStats(pRenderHal);
+
     // Free SSH Resource
     if (pStateHeap->pSshBuffer)
     {
@@ -2277,9 +2721,14 @@ int32_t RenderHal_LoadKernel(
     int32_t iKernelSize;
     int32_t iSearchIndex;
     int32_t iMaxKernels;            // Max number of kernels allowed in GSH
+    int32_t iFreeIndex;             // First free allocation index
+    int32_t iMinSize;               // Size of the minimum deallocated block that fits
+    int32_t iSlot;
+    int32_t iSteps;
     uint32_t dwOffset;
     int32_t iSize;
     MOS_STATUS eStatus;
+    PRENDERHAL_KRN_RELOAD_STATS pStats;
 
     iKernelAllocationID = RENDERHAL_KERNEL_LOAD_FAIL;
     eStatus             = MOS_STATUS_SUCCESS;
@@ -2323,115 +2772,64 @@ int32_t RenderHal_LoadKernel(
         iKernelUniqueID = pKernel->iKUID;
         iKernelCacheID  = pKernel->iKCID;
 
-        // Check if kernel is already loaded; Search free allocation index
-        iSearchIndex      = -1;
-        iMaxKernels       = pRenderHal->StateHeapSettings.iKernelCount;
-        pKernelAllocation = pStateHeap->pKernelAllocation;
-        for (iKernelAllocationID = 0;
-             iKernelAllocationID < iMaxKernels;
-             iKernelAllocationID++, pKernelAllocation++)
-        {
-            if (pKernelAllocation->iKUID == iKernelUniqueID &&
-                pKernelAllocation->iKCID == iKernelCacheID)
-            {
-                if (iKernelAllocationID != RENDERHAL_KERNEL_LOAD_FAIL)
-                {
-                    // Update kernel usage
-                    pRenderHal->pfnTouchKernel(pRenderHal, iKernelAllocationID);
+        iMaxKernels = pRenderHal->StateHeapSettings.iKernelCount;
 
-                    // Increment reference counter
-                    if (pKernelEntry)
-                    {
-                        pKernelEntry->dwLoaded = 1;
-                    }
-                    pRenderHal->iKernelAllocationID = iKernelAllocationID;
-                }
+        // Check if kernel is already loaded
+        iKernelAllocationID = RenderHal_SearchKernelIndex(pStateHeap, iMaxKernels, iKernelUniqueID, iKernelCacheID);
+        if (iKernelAllocationID >= 0)
+        {
+            pStateHeap->dwKernelHits++;
 
-                // Return kernel allocation index
-                return iKernelAllocationID;
-            }
+            // Update kernel usage
+            pRenderHal->pfnTouchKernel(pRenderHal, iKernelAllocationID);
 
-            if (iSearchIndex < 0 &&
-                pKernelAllocation->dwFlags == RENDERHAL_KERNEL_ALLOCATION_FREE)
+            // Increment reference counter
+            if (pKernelEntry)
             {
-                iSearchIndex = iKernelAllocationID;
+                pKernelEntry->dwLoaded = 1;
             }
+            pRenderHal->iKernelAllocationID = iKernelAllocationID;
+
+            // Return kernel allocation index
+            return iKernelAllocationID;
         }
+        iKernelAllocationID = RENDERHAL_KERNEL_LOAD_FAIL;
 
         // The kernel size to be dumped in oca buffer.
         pStateHeap->iKernelUsedForDump = iKernelSize;
 
-        // Kernel already loaded: refresh timer; return allocation index
-        if (iKernelAllocationID < iMaxKernels)
-        {
-            // To reload the kernel forcibly if needed
-            if (pKernel->bForceReload)
-            {
-                // The ForceReload function is only utilized in legacy code.
-                // Since APO does not follow this execution path,
-                // there is no need to include padding size code here.
-                dwOffset = pKernelAllocation->dwOffset;
-                MOS_SecureMemcpy(pStateHeap->pIshBuffer + dwOffset, iKernelSize, pKernelPtr, iKernelSize);
-
-                pKernel->bForceReload = false;
-            }
-            break;
-        }
-
-        // Kernel parameters
-        pKernelPtr      = pKernel->pBinary;
-        iKernelSize     = pKernel->iSize;
-        iKernelUniqueID = pKernel->iKUID;
-        iKernelCacheID  = pKernel->iKCID;
-
-        // Check if kernel is already loaded; Search free allocation index
+        // Search free allocation index and minimum deallocated block that fits
+        iFreeIndex        = -1;
         iSearchIndex      = -1;
-        iMaxKernels       = pRenderHal->StateHeapSettings.iKernelCount;
+        iMinSize          = 0;
         pKernelAllocation = pStateHeap->pKernelAllocation;
-        for (iKernelAllocationID = 0;
-             iKernelAllocationID < iMaxKernels;
-             iKernelAllocationID++, pKernelAllocation++)
+        for (iSlot = 0; iSlot < iMaxKernels; iSlot++, pKernelAllocation++)
         {
-            if (pKernelAllocation->iKUID == iKernelUniqueID &&
-                pKernelAllocation->iKCID == iKernelCacheID)
+            if (pKernelAllocation->dwFlags != RENDERHAL_KERNEL_ALLOCATION_FREE)
             {
-                break;
+                continue;
             }
 
-            if (iSearchIndex < 0 &&
-                pKernelAllocation->dwFlags == RENDERHAL_KERNEL_ALLOCATION_FREE)
+            if (iFreeIndex < 0)
             {
-                iSearchIndex = iKernelAllocationID;
+                iFreeIndex = iSlot;
             }
-        }
-
-        // The kernel size to be dumped in oca buffer.
-        pStateHeap->iKernelUsedForDump = iKernelSize;
 
-        // Kernel already loaded: refresh timer; return allocation index
-        if (iKernelAllocationID < iMaxKernels)
-        {
-            // To reload the kernel forcibly if needed
-            if (pKernel->bForceReload)
+            if (pKernelAllocation->iSize >= iKernelSize &&
+                (iSearchIndex < 0 || pKernelAllocation->iSize < iMinSize))
             {
-                // The ForceReload function is only utilized in legacy code.
-                // Since APO does not follow this execution path,
-                // there is no need to include padding size code here.
-                dwOffset = pKernelAllocation->dwOffset;
-                MOS_SecureMemcpy(pStateHeap->pIshBuffer + dwOffset, iKernelSize, pKernelPtr, iKernelSize);
-
-                pKernel->bForceReload = false;
+                iSearchIndex = iSlot;
+                iMinSize     = pKernelAllocation->iSize;
             }
-            break;
         }
 
         // Simple allocation: allocation index available, space available
-        if ((iSearchIndex >= 0) &&
+        if ((iFreeIndex >= 0) &&
             (pStateHeap->iKernelUsed + iKernelSize <= pStateHeap->iKernelSize))
         {
             // Allocate kernel at the end of the heap
-            iKernelAllocationID = iSearchIndex;
-            pKernelAllocation   = &(pStateHeap->pKernelAllocation[iSearchIndex]);
+            iKernelAllocationID = iFreeIndex;
+            pKernelAllocation   = &(pStateHeap->pKernelAllocation[iFreeIndex]);
 
             // Allocate block from the end of the heap
             dwOffset = pStateHeap->dwKernelBase + pStateHeap->iKernelUsed;
@@ -2444,72 +2842,27 @@ int32_t RenderHal_LoadKernel(
             goto loadkernel;
         }
 
-        // Search block from deallocated entry
-        if (iSearchIndex >= 0)
-        {
-            int32_t iMinSize = 0;
-
-            iSearchIndex      = -1;
-            pKernelAllocation = pStateHeap->pKernelAllocation;
-            for (iKernelAllocationID = 0;
-                 iKernelAllocationID < iMaxKernels;
-                 iKernelAllocationID++, pKernelAllocation++)
-            {
-                // Skip allocated/empty entries
-                if (pKernelAllocation->dwFlags != RENDERHAL_KERNEL_ALLOCATION_FREE ||
-                    pKernelAllocation->iSize == 0)
-                {
-                    continue;
-                }
-
-                // Allocate minimum available block
-                if (pKernelAllocation->iSize >= iKernelSize)
-                {
-                    if (iSearchIndex < 0 ||
-                        pKernelAllocation->iSize < iMinSize)
-                    {
-                        iSearchIndex = iKernelAllocationID;
-                        iMinSize     = pKernelAllocation->iSize;
-                    }
-                }
-            }
-        }
-
-        // Did not find block, try to deallocate a kernel not recently used
+        // Did not find block, deallocate the least recently used kernel that fits
         if (iSearchIndex < 0)
         {
-            uint32_t dwOldest = 0;
-            uint32_t dwLastUsed;
-
-            // Search and deallocate least used kernel
-            pKernelAllocation = pStateHeap->pKernelAllocation;
-            for (iKernelAllocationID = 0;
-                 iKernelAllocationID < iMaxKernels;
-                 iKernelAllocationID++, pKernelAllocation++)
+            iSlot = pStateHeap->iKernelLruTail;
+            for (iSteps = 0; iSlot >= 0 && iSteps < iMaxKernels; iSteps++)
             {
-                // Skip unused entries and entries that would not fit
-                // Skip kernels flagged as locked (cannot be automatically deallocated)
-                if (pKernelAllocation->dwFlags == RENDERHAL_KERNEL_ALLOCATION_FREE ||
-                    pKernelAllocation->dwFlags == RENDERHAL_KERNEL_ALLOCATION_LOCKED ||
-                    pKernelAllocation->iSize < iKernelSize)
-                {
-                    continue;
-                }
+                pKernelAllocation = &(pStateHeap->pKernelAllocation[iSlot]);
 
-                // Check if kernel may be replaced (not in use by GPU)
-                if ((int32_t)(pStateHeap->dwSyncTag - pKernelAllocation->dwSync) < 0)
+                // Skip entries that would not fit
+                // Skip kernels flagged as locked (cannot be automatically deallocated)
+                // Skip kernels that may not be replaced (in use by GPU)
+                if (pKernelAllocation->dwFlags != RENDERHAL_KERNEL_ALLOCATION_FREE   &&
+                    pKernelAllocation->dwFlags != RENDERHAL_KERNEL_ALLOCATION_LOCKED &&
+                    pKernelAllocation->iSize >= iKernelSize                          &&
+                    (int32_t)(pStateHeap->dwSyncTag - pKernelAllocation->dwSync) >= 0)
                 {
-                    continue;
+                    iSearchIndex = iSlot;
+                    break;
                 }
 
-                // Find kernel not used for the greater amount of time (measured in number of operations)
-                // Must not unload recently allocated kernels
-                dwLastUsed = (uint32_t)(pStateHeap->dwAccessCounter - pKernelAllocation->dwCount);
-                if (dwLastUsed > dwOldest)
-                {
-                    iSearchIndex = iKernelAllocationID;
-                    dwOldest     = dwLastUsed;
-                }
+                iSlot = pStateHeap->pKernelResidency[iSlot].iLruPrev;
             }
 
             // Did not found any entry for deallocation
@@ -2551,6 +2904,23 @@ int32_t RenderHal_LoadKernel(
         pKernelAllocation->pKernelEntry = pKernelEntry;
         pKernelAllocation->iAllocIndex  = iKernelAllocationID;
 
+        // Index kernel as resident, track reloads of evicted kernels
+        RenderHal_InsertKernelIndex(pStateHeap, iKernelAllocationID, iKernelUniqueID, iKernelCacheID);
+        pStateHeap->dwKernelMisses++;
+        pStats = RenderHal_GetKernelReloadStats(pStateHeap, iKernelUniqueID, iKernelCacheID, true);
+        if (pStats)
+        {
+            if (pStats->dwLoads > 0)
+            {
+                pStats->dwReloads++;
+            }
+            pStats->dwLoads++;
+        }
+        else
+        {
+            pStateHeap->dwKernelStatsDropped++;
+        }
+
         // Copy kernel data
         int32_t iCopyKernelSize = iKernelSize - pKernel->iPaddingSize;
         MOS_SecureMemcpy(pStateHeap->pIshBuffer + dwOffset, iCopyKernelSize, pKernelPtr, iCopyKernelSize);
@@ -2596,6 +2966,7 @@ MOS_STATUS RenderHal_UnloadKernel(
 {
     PRENDERHAL_STATE_HEAP       pStateHeap;
     PRENDERHAL_KRN_ALLOCATION   pKernelAllocation;
+    PRENDERHAL_KRN_RELOAD_STATS pStats;
     MOS_STATUS                  eStatus;
 
     //---------------------------------------
@@ -2634,6 +3005,14 @@ MOS_STATUS RenderHal_UnloadKernel(
         pKernelAllocation->pKernelEntry->dwLoaded = 0;
     }
 
+    // Remove kernel from residency index
+    pStats = RenderHal_GetKernelReloadStats(pStateHeap, pKernelAllocation->iKUID, pKernelAllocation->iKCID, false);
+    if (pStats)
+    {
+        pStats->dwEvictions++;
+    }
+    RenderHal_RemoveKernelIndex(pStateHeap, iKernelAllocationID);
+
     // Release kernel entry (Offset/size may be used for reallocation)
     pKernelAllocation->iKID             = -1;
     pKernelAllocation->iKUID            = -1;
@@ -2680,6 +3059,15 @@ void RenderHal_TouchKernel(
         pKernelAllocation->dwFlags != RENDERHAL_KERNEL_ALLOCATION_LOCKED)
     {
         pKernelAllocation->dwCount = pStateHeap->dwAccessCounter++;
+
+        // Move to the head of the LRU list
+        if (pStateHeap->pKernelResidency &&
+            pStateHeap->pKernelResidency[iKernelAllocationID].bIndexed &&
+            pStateHeap->iKernelLruHead != iKernelAllocationID)
+        {
+            RenderHal_UnlinkKernelLru(pStateHeap, iKernelAllocationID);
+            RenderHal_LinkKernelLru(pStateHeap, iKernelAllocationID);
+        }
     }
 
     // Set sync tag, for deallocation control
@@ -2733,6 +3121,9 @@ void RenderHal_ResetKernels(
         pKernelAllocation->Params           = g_cRenderHal_InitKernelParams;
     }
 
+    // Empty residency index
+    RenderHal_ResetKernelIndex(pStateHeap, pRenderHal->StateHeapSettings.iKernelCount);
+
     // Free Kernel Heap
     pStateHeap->dwAccessCounter = 0;
     pStateHeap->iKernelSize = pRenderHal->StateHeapSettings.iKernelHeapSize;
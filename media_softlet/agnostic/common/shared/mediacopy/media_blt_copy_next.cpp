@@ -670,6 +670,84 @@ MOS_STATUS BltStateNext::CopyMainSurface(
 
 }
 
+//!
+//! \brief    Copy main surfaces
+//! \details  BLT engine will copy every source resource to its destination resource,
+//!           up to BLT_BATCH_MAX_COPIES copies share one command buffer submission.
+//!           Copies are submitted in order, copied tells how many were submitted
+//!           when an error stops the batch.
+//! \param    src
+//!           [in] Array of source resources
+//! \param    dst
+//!           [in] Array of destination resources
+//! \param    count
+//!           [in] Number of copies
+//! \param    copied
+//!           [out] Number of leading copies submitted
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if successful, otherwise failed
+//!
+MOS_STATUS BltStateNext::CopyMainSurfaces(
+    PMOS_RESOURCE *src,
+    PMOS_RESOURCE *dst,
+    uint32_t       count,
+    uint32_t      &copied)
+{
+    BLT_STATE_PARAM bltStateParams[BLT_BATCH_MAX_COPIES];
+    uint32_t        batchCount = 0;
+
+    copied = 0;
+    BLT_CHK_NULL_RETURN(src);
+    BLT_CHK_NULL_RETURN(dst);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        BLT_CHK_NULL_RETURN(src[i]);
+        BLT_CHK_NULL_RETURN(dst[i]);
+        BLT_CHK_NULL_RETURN(src[i]->pGmmResInfo);
+        BLT_CHK_NULL_RETURN(dst[i]->pGmmResInfo);
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // oversized buffers override the gmm layout around their own submission, copy them alone
+        // after the copies queued before them.
+        if ((src[i]->pGmmResInfo->GetResourceType() == RESOURCE_BUFFER) &&
+            (dst[i]->pGmmResInfo->GetResourceType() == RESOURCE_BUFFER) &&
+            ((src[i]->pGmmResInfo->GetBaseWidth() > MAX_BLT_BLOCK_COPY_WIDTH) || (dst[i]->pGmmResInfo->GetBaseWidth() > MAX_BLT_BLOCK_COPY_WIDTH)))
+        {
+            if (batchCount > 0)
+            {
+                BLT_CHK_STATUS_RETURN(SubmitBatchCMD(bltStateParams, batchCount));
+                copied += batchCount;
+                batchCount = 0;
+            }
+            BLT_CHK_STATUS_RETURN(CopyMainSurface(src[i], dst[i]));
+            copied++;
+            continue;
+        }
+
+        MOS_ZeroMemory(&bltStateParams[batchCount], sizeof(BLT_STATE_PARAM));
+        bltStateParams[batchCount].bCopyMainSurface = true;
+        bltStateParams[batchCount].pSrcSurface      = src[i];
+        bltStateParams[batchCount].pDstSurface      = dst[i];
+        if (++batchCount == BLT_BATCH_MAX_COPIES)
+        {
+            BLT_CHK_STATUS_RETURN(SubmitBatchCMD(bltStateParams, batchCount));
+            copied += batchCount;
+            batchCount = 0;
+        }
+    }
+
+    if (batchCount > 0)
+    {
+        BLT_CHK_STATUS_RETURN(SubmitBatchCMD(bltStateParams, batchCount));
+        copied += batchCount;
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
 //!
 //! \brief    Setup fast copy parameters
 //! \details  Setup fast copy parameters for BLT Engine
@@ -818,24 +896,49 @@ MOS_STATUS BltStateNext::SetupBltCopyParam(
 MOS_STATUS BltStateNext::SubmitCMD(
     PBLT_STATE_PARAM pBltStateParam)
 {
-    MOS_STATUS                   eStatus;
-    MOS_COMMAND_BUFFER           cmdBuffer;
-    MHW_FAST_COPY_BLT_PARAM      fastCopyBltParam;
-    MHW_CTRL_SURF_COPY_BLT_PARAM ctrlSurfCopyBltParam;
+    return SubmitBatchCMD(pBltStateParam, 1);
+}
+
+//!
+//! \brief    Submit batched command
+//! \details  Record all BLT copies into one command buffer and submit it once. An
+//!           MI_FLUSH_DW separates the copies, so a copy reading or writing the
+//!           destination of an earlier one sees its result. Either all copies
+//!           are submitted or none.
+//! \param    pBltStateParam
+//!           [in] Array of BLT_STATE_PARAM
+//! \param    count
+//!           [in] Number of entries in pBltStateParam, up to BLT_BATCH_MAX_COPIES
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if successful, otherwise failed
+//!
+MOS_STATUS BltStateNext::SubmitBatchCMD(
+    PBLT_STATE_PARAM pBltStateParam,
+    uint32_t         count)
+{
+    MOS_STATUS                       eStatus = MOS_STATUS_SUCCESS;
+    MOS_COMMAND_BUFFER               cmdBuffer;
     MOS_GPUCTX_CREATOPTIONS_ENHANCED createOption = {};
-    int                          planeNum = 1;
 
     BLT_CHK_NULL_RETURN(m_miItf);
     BLT_CHK_NULL_RETURN(m_bltItf);
     BLT_CHK_NULL_RETURN(pBltStateParam);
     BLT_CHK_NULL_RETURN(m_osInterface);
-    // need consolidate both input/output surface information to decide cp context.
-    PMOS_RESOURCE surfaceArray[2];
-    surfaceArray[0] = pBltStateParam->pSrcSurface;
-    surfaceArray[1] = pBltStateParam->pDstSurface;
+    if (count == 0 || count > BLT_BATCH_MAX_COPIES)
+    {
+        BLT_ASSERTMESSAGE("Invalid BLT batch size %d", count);
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+    // need consolidate both input/output surface information of every copy to decide cp context.
+    PMOS_RESOURCE surfaceArray[2 * BLT_BATCH_MAX_COPIES];
+    for (uint32_t i = 0; i < count; i++)
+    {
+        surfaceArray[2 * i]     = pBltStateParam[i].pSrcSurface;
+        surfaceArray[2 * i + 1] = pBltStateParam[i].pDstSurface;
+    }
     if (m_osInterface->osCpInterface)
     {
-        m_osInterface->osCpInterface->PrepareResources((void **)&surfaceArray, sizeof(surfaceArray) / sizeof(PMOS_RESOURCE), nullptr, 0);
+        m_osInterface->osCpInterface->PrepareResources((void **)surfaceArray, 2 * count, nullptr, 0);
     }
     // no gpucontext will be created if the gpu context has been created before.
     BLT_CHK_STATUS_RETURN(m_osInterface->pfnCreateGpuContext(
@@ -855,70 +958,29 @@ MOS_STATUS BltStateNext::SubmitCMD(
     BLT_CHK_STATUS_RETURN(m_osInterface->pfnGetCommandBuffer(m_osInterface, &cmdBuffer, 0));
     BLT_CHK_STATUS_RETURN(SetPrologParamsforCmdbuffer(&cmdBuffer));
 
-    MOS_SURFACE       srcResDetails;
-    MOS_SURFACE       dstResDetails;
-    MOS_ZeroMemory(&srcResDetails, sizeof(MOS_SURFACE));
-    MOS_ZeroMemory(&dstResDetails, sizeof(MOS_SURFACE));
-    srcResDetails.Format = Format_Invalid;
-    dstResDetails.Format = Format_Invalid;
-    BLT_CHK_STATUS_RETURN(m_osInterface->pfnGetResourceInfo(m_osInterface, pBltStateParam->pSrcSurface, &srcResDetails));
-    BLT_CHK_STATUS_RETURN(m_osInterface->pfnGetResourceInfo(m_osInterface, pBltStateParam->pDstSurface, &dstResDetails));
-
-    if (srcResDetails.Format != dstResDetails.Format)
-    {
-        MCPY_ASSERTMESSAGE("BLT copy can't support CSC copy. input format = %d, output format = %d", srcResDetails.Format, dstResDetails.Format);
-        return MOS_STATUS_INVALID_PARAMETER;
-    }
-    planeNum = GetPlaneNum(dstResDetails.Format);
     m_osInterface->pfnSetPerfTag(m_osInterface, BLT_COPY);
     MediaPerfProfiler* perfProfiler = MediaPerfProfiler::Instance();
     BLT_CHK_NULL_RETURN(perfProfiler);
     BLT_CHK_STATUS_RETURN(perfProfiler->AddPerfCollectStartCmd((void*)this, m_osInterface, m_miItf, &cmdBuffer));
 
-    if (pBltStateParam->bCopyMainSurface)
+    for (uint32_t i = 0; i < count && eStatus == MOS_STATUS_SUCCESS; i++)
     {
-        BLT_CHK_STATUS_RETURN(SetupBltCopyParam(
-            &fastCopyBltParam,
-            pBltStateParam->pSrcSurface,
-            pBltStateParam->pDstSurface,
-            MCPY_PLANE_Y));
-
-        BLT_CHK_STATUS_RETURN(SetBCSSWCTR(&cmdBuffer));
-        BLT_CHK_STATUS_RETURN(m_miItf->AddBLTMMIOPrologCmd(&cmdBuffer));
-        BLT_CHK_STATUS_RETURN(m_bltItf->AddBlockCopyBlt(
-            &cmdBuffer,
-            &fastCopyBltParam,
-            srcResDetails.YPlaneOffset.iSurfaceOffset,
-            dstResDetails.YPlaneOffset.iSurfaceOffset));
-
-        if (planeNum == TWO_PLANES || planeNum == THREE_PLANES)
+        if (i > 0)
         {
-            BLT_CHK_STATUS_RETURN(SetupBltCopyParam(
-             &fastCopyBltParam,
-             pBltStateParam->pSrcSurface,
-             pBltStateParam->pDstSurface,
-             MCPY_PLANE_U));
-             BLT_CHK_STATUS_RETURN(m_bltItf->AddBlockCopyBlt(
-                    &cmdBuffer,
-                    &fastCopyBltParam,
-                    srcResDetails.UPlaneOffset.iSurfaceOffset,
-                    dstResDetails.UPlaneOffset.iSurfaceOffset));
-
-            if (planeNum == THREE_PLANES)
-            {
-                BLT_CHK_STATUS_RETURN(SetupBltCopyParam(
-                    &fastCopyBltParam,
-                    pBltStateParam->pSrcSurface,
-                    pBltStateParam->pDstSurface,
-                    MCPY_PLANE_V));
-                BLT_CHK_STATUS_RETURN(m_bltItf->AddBlockCopyBlt(
-                    &cmdBuffer,
-                    &fastCopyBltParam,
-                    srcResDetails.VPlaneOffset.iSurfaceOffset,
-                    dstResDetails.VPlaneOffset.iSurfaceOffset));
-            }
-
-         }
+            auto &copyFlushParams = m_miItf->MHW_GETPAR_F(MI_FLUSH_DW)();
+            copyFlushParams       = {};
+            eStatus               = m_miItf->MHW_ADDCMD_F(MI_FLUSH_DW)(&cmdBuffer);
+        }
+        if (eStatus == MOS_STATUS_SUCCESS && pBltStateParam[i].bCopyMainSurface)
+        {
+            eStatus = AddMainSurfaceCopyCmd(&cmdBuffer, &pBltStateParam[i]);
+        }
+    }
+    if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        // nothing was submitted, drop the recorded copies.
+        m_osInterface->pfnReturnCommandBuffer(m_osInterface, &cmdBuffer, 0);
+        BLT_CHK_STATUS_RETURN(eStatus);
     }
     BLT_CHK_STATUS_RETURN(perfProfiler->AddPerfCollectEndCmd((void*)this, m_osInterface, m_miItf, &cmdBuffer));
 
@@ -943,6 +1005,87 @@ MOS_STATUS BltStateNext::SubmitCMD(
     return MOS_STATUS_SUCCESS;
 }
 
+//!
+//! \brief    Add main surface copy commands
+//! \details  Add the block copy of every plane of one surface into the command buffer
+//! \param    cmdBuffer
+//!           [in/out] Command buffer the copy is recorded into
+//! \param    pBltStateParam
+//!           [in] Pointer to BLT_STATE_PARAM
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if successful, otherwise failed
+//!
+MOS_STATUS BltStateNext::AddMainSurfaceCopyCmd(
+    PMOS_COMMAND_BUFFER cmdBuffer,
+    PBLT_STATE_PARAM    pBltStateParam)
+{
+    MHW_FAST_COPY_BLT_PARAM fastCopyBltParam;
+    int                     planeNum = 1;
+
+    BLT_CHK_NULL_RETURN(cmdBuffer);
+    BLT_CHK_NULL_RETURN(pBltStateParam);
+
+    MOS_SURFACE       srcResDetails;
+    MOS_SURFACE       dstResDetails;
+    MOS_ZeroMemory(&srcResDetails, sizeof(MOS_SURFACE));
+    MOS_ZeroMemory(&dstResDetails, sizeof(MOS_SURFACE));
+    srcResDetails.Format = Format_Invalid;
+    dstResDetails.Format = Format_Invalid;
+    BLT_CHK_STATUS_RETURN(m_osInterface->pfnGetResourceInfo(m_osInterface, pBltStateParam->pSrcSurface, &srcResDetails));
+    BLT_CHK_STATUS_RETURN(m_osInterface->pfnGetResourceInfo(m_osInterface, pBltStateParam->pDstSurface, &dstResDetails));
+
+    if (srcResDetails.Format != dstResDetails.Format)
+    {
+        MCPY_ASSERTMESSAGE("BLT copy can't support CSC copy. input format = %d, output format = %d", srcResDetails.Format, dstResDetails.Format);
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+    planeNum = GetPlaneNum(dstResDetails.Format);
+
+    BLT_CHK_STATUS_RETURN(SetupBltCopyParam(
+        &fastCopyBltParam,
+        pBltStateParam->pSrcSurface,
+        pBltStateParam->pDstSurface,
+        MCPY_PLANE_Y));
+
+    BLT_CHK_STATUS_RETURN(SetBCSSWCTR(cmdBuffer));
+    BLT_CHK_STATUS_RETURN(m_miItf->AddBLTMMIOPrologCmd(cmdBuffer));
+    BLT_CHK_STATUS_RETURN(m_bltItf->AddBlockCopyBlt(
+        cmdBuffer,
+        &fastCopyBltParam,
+        srcResDetails.YPlaneOffset.iSurfaceOffset,
+        dstResDetails.YPlaneOffset.iSurfaceOffset));
+
+    if (planeNum == TWO_PLANES || planeNum == THREE_PLANES)
+    {
+        BLT_CHK_STATUS_RETURN(SetupBltCopyParam(
+         &fastCopyBltParam,
+         pBltStateParam->pSrcSurface,
+         pBltStateParam->pDstSurface,
+         MCPY_PLANE_U));
+         BLT_CHK_STATUS_RETURN(m_bltItf->AddBlockCopyBlt(
+                cmdBuffer,
+                &fastCopyBltParam,
+                srcResDetails.UPlaneOffset.iSurfaceOffset,
+                dstResDetails.UPlaneOffset.iSurfaceOffset));
+
+        if (planeNum == THREE_PLANES)
+        {
+            BLT_CHK_STATUS_RETURN(SetupBltCopyParam(
+                &fastCopyBltParam,
+                pBltStateParam->pSrcSurface,
+                pBltStateParam->pDstSurface,
+                MCPY_PLANE_V));
+            BLT_CHK_STATUS_RETURN(m_bltItf->AddBlockCopyBlt(
+                cmdBuffer,
+                &fastCopyBltParam,
+                srcResDetails.VPlaneOffset.iSurfaceOffset,
+                dstResDetails.VPlaneOffset.iSurfaceOffset));
+        }
+     }
+
+    return MOS_STATUS_SUCCESS;
+}
+
 uint32_t BltStateNext::GetBlkCopyColorDepth(
     GMM_RESOURCE_FORMAT dstFormat,
     uint32_t            BitsPerPixel)
@@ -85,6 +85,29 @@ public:
         PMOS_RESOURCE src,
         PMOS_RESOURCE dst);
 
+    //!
+    //! \brief    Copy main surfaces
+    //! \details  BLT engine will copy every source resource to its destination resource,
+    //!           up to BLT_BATCH_MAX_COPIES copies share one command buffer submission.
+    //!           Copies are submitted in order, copied tells how many were submitted
+    //!           when an error stops the batch.
+    //! \param    src
+    //!           [in] Array of source resources
+    //! \param    dst
+    //!           [in] Array of destination resources
+    //! \param    count
+    //!           [in] Number of copies
+    //! \param    copied
+    //!           [out] Number of leading copies submitted
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if successful, otherwise failed
+    //!
+    virtual MOS_STATUS CopyMainSurfaces(
+        PMOS_RESOURCE *src,
+        PMOS_RESOURCE *dst,
+        uint32_t       count,
+        uint32_t      &copied);
+
     //!
     //! \brief    Setup blt copy parameters
     //! \details  Setup blt copy parameters for BLT Engine
@@ -116,6 +139,21 @@ public:
     virtual MOS_STATUS SubmitCMD(
         PBLT_STATE_PARAM pBltStateParam);
 
+    //!
+    //! \brief    Submit batched command
+    //! \details  Record all BLT copies into one command buffer, separated by
+    //!           MI_FLUSH_DW, and submit it once. Either all copies are submitted or none.
+    //! \param    pBltStateParam
+    //!           [in] Array of BLT_STATE_PARAM
+    //! \param    count
+    //!           [in] Number of entries in pBltStateParam, up to BLT_BATCH_MAX_COPIES
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if successful, otherwise failed
+    //!
+    virtual MOS_STATUS SubmitBatchCMD(
+        PBLT_STATE_PARAM pBltStateParam,
+        uint32_t         count);
+
     //!
     //! \brief    Get Block copy color depth.
     //! \details  get different format's color depth.
@@ -318,6 +356,20 @@ protected:
     //!
     MOS_STATUS SetPrologParamsforCmdbuffer(PMOS_COMMAND_BUFFER cmdBuffer);
 
+    //!
+    //! \brief    Add main surface copy commands
+    //! \details  Add the block copy of every plane of one surface into the command buffer
+    //! \param    cmdBuffer
+    //!           [in/out] Command buffer the copy is recorded into
+    //! \param    pBltStateParam
+    //!           [in] Pointer to BLT_STATE_PARAM
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if successful, otherwise failed
+    //!
+    virtual MOS_STATUS AddMainSurfaceCopyCmd(
+        PMOS_COMMAND_BUFFER cmdBuffer,
+        PBLT_STATE_PARAM    pBltStateParam);
+
      //!
     //! \brief    Set BCS_SWCTR cmd
     //! \details  Set BCS_SWCTR for Cmdbuffer
@@ -116,6 +116,14 @@ MOS_STATUS MediaCopyBaseState::Initialize(PMOS_INTERFACE osInterface)
             MediaUserSetting::Group::Device);
     }
 #endif
+    if (m_osInterface)
+    {
+        ReadUserSetting(
+            m_osInterface->pfnGetUserSettingInstance(m_osInterface),
+            m_loadAwareEngineSelect,
+            __MEDIA_USER_FEATURE_MCPY_LOAD_AWARE_ENGINE_SELECT,
+            MediaUserSetting::Group::Device);
+    }
     return MOS_STATUS_SUCCESS;
 }
 
@@ -255,6 +263,90 @@ MOS_STATUS MediaCopyBaseState::CopyEnigneSelect(MCPY_METHOD& preferMethod, MCPY_
     return MOS_STATUS_SUCCESS;
 }
 
+uint32_t MediaCopyBaseState::GetEngineLoad(MCPY_ENGINE mcpyEngine)
+{
+    MOS_GPU_NODE node = MOS_GPU_NODE_BLT;
+
+    if (m_osInterface == nullptr)
+    {
+        return 0;
+    }
+
+    switch (mcpyEngine)
+    {
+        case MCPY_ENGINE_VEBOX:
+            node = MOS_GPU_NODE_VE;
+            break;
+        case MCPY_ENGINE_RENDER:
+            node = MOS_GPU_NODE_COMPUTE;
+            break;
+        case MCPY_ENGINE_BLT:
+        default:
+            node = MOS_GPU_NODE_BLT;
+            break;
+    }
+
+    return MosInterface::GetEngineLoad(m_osInterface->osStreamState, node, MCPY_ENGINE_LOAD_MAX);
+}
+
+static bool IsCopySizeValidForAllEngines(const MOS_SURFACE &res)
+{
+    return res.dwWidth >= VE_MIN_WIDTH && res.dwHeight >= VE_MIN_HEIGHT &&
+           res.dwWidth <= BLT_MAX_WIDTH && res.dwHeight <= BLT_MAX_HEIGHT && res.dwPitch <= BLT_MAX_PITCH;
+}
+
+MOS_STATUS MediaCopyBaseState::LoadBalanceEngine(
+    MCPY_METHOD        preferMethod,
+    MCPY_ENGINE       &mcpyEngine,
+    MCPY_ENGINE_CAPS  &caps,
+    MCPY_STATE_PARAMS &mcpySrc,
+    MCPY_STATE_PARAMS &mcpyDst,
+    const MOS_SURFACE &src,
+    const MOS_SURFACE &dst)
+{
+    // power saving asks for BCS explicitly, keep it there.
+    if (!m_loadAwareEngineSelect || preferMethod == MCPY_METHOD_POWERSAVING)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+#if (_DEBUG || _RELEASE_INTERNAL)
+    if (MCPY_METHOD_DEFAULT != m_MCPYForceMode)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+#endif
+    // only move copies which every engine can take, the size limits differ per engine.
+    if (!IsCopySizeValidForAllEngines(src) || !IsCopySizeValidForAllEngines(dst))
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    MCPY_CHK_NULL_RETURN(m_inUseGPUMutex);
+    MEDIA_FEATURE_TABLE *skuTable = m_osInterface->pfnGetSkuTable(m_osInterface);
+    bool capable[MCPY_ENGINE_LOAD_ENGINE_NUM] = {
+        caps.engineVebox != 0,
+        caps.engineBlt != 0 && mcpySrc.CpMode != MCPY_CPMODE_CP && mcpyDst.CpMode != MCPY_CPMODE_CP,
+        caps.engineRender != 0 && skuTable != nullptr && MEDIA_IS_SKU(skuTable, FtrCCSNode)};
+
+    // the cached loads are shared by all copies of this media copy state.
+    MosUtilities::MosLockMutex(m_inUseGPUMutex);
+    MCPY_ENGINE bestEngine = (MCPY_ENGINE)m_loadBalancer.SelectEngine(
+        mcpyEngine,
+        capable,
+        MosUtilities::MosGetCurTime(),
+        [this](uint32_t engine) { return GetEngineLoad((MCPY_ENGINE)engine); });
+    m_loadBalancer.OnSubmit(bestEngine);
+    MosUtilities::MosUnlockMutex(m_inUseGPUMutex);
+
+    if (bestEngine != mcpyEngine)
+    {
+        MCPY_NORMALMESSAGE("copy engine %d busy, use engine %d", mcpyEngine, bestEngine);
+        mcpyEngine = bestEngine;
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
 uint32_t GetMinRequiredSurfaceSizeInBytes(uint32_t pitch, uint32_t height, MOS_FORMAT format)
 {
     uint32_t nBytes = 0;
@@ -403,6 +495,114 @@ MOS_STATUS MediaCopyBaseState::SurfaceCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst,
     MOS_TraceEventExt(EVENT_MEDIA_COPY, EVENT_TYPE_START, nullptr, 0, nullptr, 0);
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
 
+    MCPY_STATE_PARAMS     mcpySrc = {};
+    MCPY_STATE_PARAMS     mcpyDst = {};
+    MCPY_ENGINE           mcpyEngine = MCPY_ENGINE_BLT;
+
+    MCPY_CHK_STATUS_RETURN(PrepareCopy(src, dst, preferMethod, mcpySrc, mcpyDst, mcpyEngine));
+
+    MCPY_CHK_STATUS_RETURN(TaskDispatch(mcpySrc, mcpyDst, mcpyEngine));
+
+    MOS_TraceEventExt(EVENT_MEDIA_COPY, EVENT_TYPE_END, nullptr, 0, nullptr, 0);
+    return eStatus;
+}
+
+//!
+//! \brief    batched surface copy func.
+//! \details  copy every src[i] to dst[i], in order. Every pair is checked and gets its
+//!           engine like SurfaceCopy before anything is submitted, then consecutive
+//!           BLT copies are recorded into shared command buffers instead of one
+//!           submission per copy.
+//! \param    src
+//!           [in] Array of source surfaces
+//! \param    dst
+//!           [in] Array of destination surfaces
+//! \param    count
+//!           [in] Number of copies
+//! \param    copied
+//!           [out] Optional, number of leading copies submitted
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if support, otherwise return unspoort.
+//!
+MOS_STATUS MediaCopyBaseState::SurfaceCopyBatch(
+    PMOS_RESOURCE *src,
+    PMOS_RESOURCE *dst,
+    uint32_t       count,
+    MCPY_METHOD    preferMethod,
+    uint32_t      *copied)
+{
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+    uint32_t   done    = 0;
+
+    if (copied)
+    {
+        *copied = 0;
+    }
+    MCPY_CHK_NULL_RETURN(src);
+    MCPY_CHK_NULL_RETURN(dst);
+    MOS_TraceEventExt(EVENT_MEDIA_COPY, EVENT_TYPE_START, nullptr, 0, nullptr, 0);
+
+    std::vector<MCPY_STATE_PARAMS> mcpySrc(count);
+    std::vector<MCPY_STATE_PARAMS> mcpyDst(count);
+    std::vector<MCPY_ENGINE>       mcpyEngine(count, MCPY_ENGINE_BLT);
+    std::unique_ptr<bool[]>        isBlt(new bool[count]);
+
+    // an unsupported copy fails the batch before anything is submitted.
+    for (uint32_t i = 0; i < count; i++)
+    {
+        MCPY_CHK_NULL_RETURN(src[i]);
+        MCPY_CHK_NULL_RETURN(dst[i]);
+        MCPY_CHK_STATUS_RETURN(PrepareCopy(src[i], dst[i], preferMethod, mcpySrc[i], mcpyDst[i], mcpyEngine[i]));
+        isBlt[i] = (mcpyEngine[i] == MCPY_ENGINE_BLT);
+    }
+
+    eStatus = MediaCopyBatchDispatcher::Dispatch(
+        isBlt.get(),
+        count,
+        [&](uint32_t first, uint32_t num, uint32_t &runCopied) {
+            return TaskDispatchBltBatch(&mcpySrc[first], &mcpyDst[first], num, runCopied);
+        },
+        [&](uint32_t index) {
+            return TaskDispatch(mcpySrc[index], mcpyDst[index], mcpyEngine[index]);
+        },
+        done);
+
+    if (copied)
+    {
+        *copied = done;
+    }
+    MCPY_CHK_STATUS_RETURN(eStatus);
+
+    MOS_TraceEventExt(EVENT_MEDIA_COPY, EVENT_TYPE_END, nullptr, 0, nullptr, 0);
+    return MOS_STATUS_SUCCESS;
+}
+
+//!
+//! \brief    prepare one copy.
+//! \details  query both resources, check the caps and select the copy engine.
+//! \param    src
+//!           [in] Pointer to source surface
+//! \param    dst
+//!           [in] Pointer to destination surface
+//! \param    preferMethod
+//!           [in] preferred copy method
+//! \param    mcpySrc
+//!           [out] source surface state
+//! \param    mcpyDst
+//!           [out] destination surface state
+//! \param    mcpyEngine
+//!           [out] selected copy engine
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if support, otherwise return unspoort.
+//!
+MOS_STATUS MediaCopyBaseState::PrepareCopy(
+    PMOS_RESOURCE      src,
+    PMOS_RESOURCE      dst,
+    MCPY_METHOD        preferMethod,
+    MCPY_STATE_PARAMS &mcpySrc,
+    MCPY_STATE_PARAMS &mcpyDst,
+    MCPY_ENGINE       &mcpyEngine)
+{
     MOS_SURFACE SrcResDetails, DstResDetails;
     MOS_ZeroMemory(&SrcResDetails, sizeof(MOS_SURFACE));
     MOS_ZeroMemory(&DstResDetails, sizeof(MOS_SURFACE));
@@ -411,9 +611,9 @@ MOS_STATUS MediaCopyBaseState::SurfaceCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst,
     DstResDetails.Format     = Format_Invalid;
     DstResDetails.OsResource = *dst;
 
-    MCPY_STATE_PARAMS     mcpySrc = {nullptr, MOS_MMC_DISABLED, MOS_TILE_LINEAR, MCPY_CPMODE_CLEAR, false};
-    MCPY_STATE_PARAMS     mcpyDst = {nullptr, MOS_MMC_DISABLED, MOS_TILE_LINEAR, MCPY_CPMODE_CLEAR, false};
-    MCPY_ENGINE           mcpyEngine = MCPY_ENGINE_BLT;
+    mcpySrc = {nullptr, MOS_MMC_DISABLED, MOS_TILE_LINEAR, MCPY_CPMODE_CLEAR, false};
+    mcpyDst = {nullptr, MOS_MMC_DISABLED, MOS_TILE_LINEAR, MCPY_CPMODE_CLEAR, false};
+    mcpyEngine = MCPY_ENGINE_BLT;
     MCPY_ENGINE_CAPS      mcpyEngineCaps = {1, 1, 1, 1};
 
     MCPY_CHK_STATUS_RETURN(m_osInterface->pfnGetResourceInfo(m_osInterface, src, &SrcResDetails));
@@ -494,50 +694,19 @@ MOS_STATUS MediaCopyBaseState::SurfaceCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst,
 
     MCPY_CHK_STATUS_RETURN(CopyEnigneSelect(preferMethod, mcpyEngine, mcpyEngineCaps));
 
-    MCPY_CHK_STATUS_RETURN(ValidateResource(SrcResDetails, DstResDetails, mcpyEngine));
+    MCPY_CHK_STATUS_RETURN(LoadBalanceEngine(preferMethod, mcpyEngine, mcpyEngineCaps, mcpySrc, mcpyDst, SrcResDetails, DstResDetails));
 
-    MCPY_CHK_STATUS_RETURN(TaskDispatch(mcpySrc, mcpyDst, mcpyEngine));
+    MCPY_CHK_STATUS_RETURN(ValidateResource(SrcResDetails, DstResDetails, mcpyEngine));
 
-    MOS_TraceEventExt(EVENT_MEDIA_COPY, EVENT_TYPE_END, nullptr, 0, nullptr, 0);
-    return eStatus;
+    return MOS_STATUS_SUCCESS;
 }
 
 MOS_STATUS MediaCopyBaseState::TaskDispatch(MCPY_STATE_PARAMS mcpySrc, MCPY_STATE_PARAMS mcpyDst, MCPY_ENGINE mcpyEngine)
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
 
-
 #if (_DEBUG || _RELEASE_INTERNAL)
-    MOS_SURFACE sourceSurface = {};
-    MOS_SURFACE targetSurface = {};
-
-    targetSurface.Format = Format_Invalid;
-    targetSurface.OsResource = *mcpyDst.OsRes;
-
-#if !defined(LINUX) && !defined(ANDROID) && !EMUL
-    MOS_ZeroMemory(&targetSurface.OsResource.AllocationInfo, sizeof(SResidencyInfo));
-#endif
-
-    sourceSurface.Format = Format_Invalid;
-    sourceSurface.OsResource = *mcpySrc.OsRes;
-
-    m_osInterface->pfnGetResourceInfo(m_osInterface, &sourceSurface.OsResource, &sourceSurface);
-    m_osInterface->pfnGetResourceInfo(m_osInterface, &targetSurface.OsResource, &targetSurface);
-
-    // Set the dump location like "dumpLocation before MCPY=path_to_dump_folder" in user feature configure file
-    // Otherwise, the surface may not be dumped
-    // Only dump linear surface
-    if (m_surfaceDumper && mcpySrc.TileMode == MOS_TILE_LINEAR)
-    {
-        if ((*m_dumpLocation_in == '\0') || (*m_dumpLocation_in == ' '))
-        {
-            MCPY_NORMALMESSAGE("Invalid dump location set, the surface will not be dumped");
-        }
-        else
-        {
-            m_surfaceDumper->DumpSurfaceToFile(m_osInterface, &sourceSurface, m_dumpLocation_in, m_surfaceDumper->m_frameNum, true, false, nullptr);
-        }
-    }
+    DumpCopySurface(mcpySrc, true);
 #endif
 
     MosUtilities::MosLockMutex(m_inUseGPUMutex);
@@ -583,27 +752,162 @@ MOS_STATUS MediaCopyBaseState::TaskDispatch(MCPY_STATE_PARAMS mcpySrc, MCPY_STAT
             MediaUserSetting::Group::Device);
     }
 
-    // Set the dump location like "dumpLocation after MCPY=path_to_dump_folder" in user feature configure file
-    // Otherwise, the surface may not be dumped
-    // Only dump linear surface
-    if (m_surfaceDumper && mcpyDst.TileMode == MOS_TILE_LINEAR)
+    DumpCopySurface(mcpyDst, false);
+#endif
+    MCPY_NORMALMESSAGE("Media Copy works on %s Engine", mcpyEngine ?(mcpyEngine == MCPY_ENGINE_BLT?"BLT":"Render"):"VeBox");
+
+    return eStatus;
+}
+
+//!
+//! \brief    dispatch batched BLT copy task.
+//! \details  record all BLT copies into shared command buffers. A destination which
+//!           needs decompression is resolved after the copies before it are
+//!           submitted, as if every copy went through TaskDispatch.
+//! \param    mcpySrc
+//!           [in] Array of source surface states
+//! \param    mcpyDst
+//!           [in] Array of destination surface states
+//! \param    count
+//!           [in] Number of copies
+//! \param    copied
+//!           [out] Number of leading copies submitted
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if support, otherwise return unspoort.
+//!
+MOS_STATUS MediaCopyBaseState::TaskDispatchBltBatch(MCPY_STATE_PARAMS *mcpySrc, MCPY_STATE_PARAMS *mcpyDst, uint32_t count, uint32_t &copied)
+{
+    MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
+    uint32_t   start   = 0;
+
+    copied = 0;
+    MCPY_CHK_NULL_RETURN(mcpySrc);
+    MCPY_CHK_NULL_RETURN(mcpyDst);
+
+    std::vector<PMOS_RESOURCE> srcRes(count);
+    std::vector<PMOS_RESOURCE> dstRes(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        srcRes[i] = mcpySrc[i].OsRes;
+        dstRes[i] = mcpyDst[i].OsRes;
+#if (_DEBUG || _RELEASE_INTERNAL)
+        DumpCopySurface(mcpySrc[i], true);
+#endif
+    }
+
+    MosUtilities::MosLockMutex(m_inUseGPUMutex);
+    for (uint32_t i = 0; i <= count && eStatus == MOS_STATUS_SUCCESS; i++)
     {
-        if ((*m_dumpLocation_out == '\0') || (*m_dumpLocation_out == ' '))
+        bool decompress = (i < count) && (mcpyDst[i].TileMode != MOS_TILE_LINEAR) && (mcpyDst[i].CompressionMode == MOS_MMC_RC);
+        if ((i == count || decompress) && i > start)
         {
-            MCPY_NORMALMESSAGE("Invalid dump location set, the surface will not be dumped");
+            uint32_t batchCopied = 0;
+            eStatus = MediaBltCopyBatch(&srcRes[start], &dstRes[start], i - start, batchCopied);
+            copied += batchCopied;
+            start = i;
         }
-        else
+        if (decompress && eStatus == MOS_STATUS_SUCCESS)
         {
-            m_surfaceDumper->DumpSurfaceToFile(m_osInterface, &targetSurface, m_dumpLocation_out, m_surfaceDumper->m_frameNum, true, false, nullptr);
+            MCPY_NORMALMESSAGE("mmc on, mcpyDst.TileMode= %d, mcpyDst.CompressionMode = %d", mcpyDst[i].TileMode, mcpyDst[i].CompressionMode);
+            eStatus = m_osInterface->pfnDecompResource(m_osInterface, mcpyDst[i].OsRes);
         }
-        m_surfaceDumper->m_frameNum++;
+    }
+    MosUtilities::MosUnlockMutex(m_inUseGPUMutex);
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+    if (m_bRegReport)
+    {
+        MediaUserSettingSharedPtr userSettingPtr = m_osInterface->pfnGetUserSettingInstance(m_osInterface);
+        ReportUserSettingForDebug(
+            userSettingPtr,
+            __MEDIA_USER_FEATURE_MCPY_MODE,
+            std::string("BLT"),
+            MediaUserSetting::Group::Device);
+    }
+
+    for (uint32_t i = 0; i < copied; i++)
+    {
+        DumpCopySurface(mcpyDst[i], false);
     }
 #endif
-    MCPY_NORMALMESSAGE("Media Copy works on %s Engine", mcpyEngine ?(mcpyEngine == MCPY_ENGINE_BLT?"BLT":"Render"):"VeBox");
+    MCPY_NORMALMESSAGE("Media Copy works on BLT Engine, %d of %d copies in batch", copied, count);
 
     return eStatus;
 }
 
+//!
+//! \brief    use blt engine to do batched surface copy.
+//! \details  default implementation submits every copy on its own.
+//! \param    src
+//!           [in] Array of source surfaces
+//! \param    dst
+//!           [in] Array of destination surfaces
+//! \param    count
+//!           [in] Number of copies
+//! \param    copied
+//!           [out] Number of leading copies submitted
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if support, otherwise return unspoort.
+//!
+MOS_STATUS MediaCopyBaseState::MediaBltCopyBatch(PMOS_RESOURCE *src, PMOS_RESOURCE *dst, uint32_t count, uint32_t &copied)
+{
+    copied = 0;
+    MCPY_CHK_NULL_RETURN(src);
+    MCPY_CHK_NULL_RETURN(dst);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        MCPY_CHK_STATUS_RETURN(MediaBltCopy(src[i], dst[i]));
+        copied++;
+    }
+    return MOS_STATUS_SUCCESS;
+}
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+//!
+//! \brief    dump copy surface.
+//! \details  dump a linear copy source or target, the target dump advances the frame number.
+//! \param    mcpy
+//!           [in] surface state of the copy source or target
+//! \param    isInput
+//!           [in] true for the copy source
+//!
+void MediaCopyBaseState::DumpCopySurface(const MCPY_STATE_PARAMS &mcpy, bool isInput)
+{
+    char *dumpLocation = isInput ? m_dumpLocation_in : m_dumpLocation_out;
+
+    // Set the dump location like "dumpLocation before MCPY=path_to_dump_folder" or
+    // "dumpLocation after MCPY=path_to_dump_folder" in user feature configure file
+    // Otherwise, the surface may not be dumped
+    // Only dump linear surface
+    if (m_surfaceDumper == nullptr || mcpy.OsRes == nullptr || mcpy.TileMode != MOS_TILE_LINEAR)
+    {
+        return;
+    }
+
+    if ((*dumpLocation == '\0') || (*dumpLocation == ' '))
+    {
+        MCPY_NORMALMESSAGE("Invalid dump location set, the surface will not be dumped");
+    }
+    else
+    {
+        MOS_SURFACE surface = {};
+        surface.Format      = Format_Invalid;
+        surface.OsResource  = *mcpy.OsRes;
+#if !defined(LINUX) && !defined(ANDROID) && !EMUL
+        MOS_ZeroMemory(&surface.OsResource.AllocationInfo, sizeof(SResidencyInfo));
+#endif
+        m_osInterface->pfnGetResourceInfo(m_osInterface, &surface.OsResource, &surface);
+        m_surfaceDumper->DumpSurfaceToFile(m_osInterface, &surface, dumpLocation, m_surfaceDumper->m_frameNum, true, false, nullptr);
+    }
+
+    if (!isInput)
+    {
+        m_surfaceDumper->m_frameNum++;
+    }
+}
+#endif
+
 //!
 //! \brief    aux surface copy.
 //! \details  copy surface.
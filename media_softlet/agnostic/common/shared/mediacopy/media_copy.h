@@ -29,6 +29,7 @@
 #define __MEDIA_COPY_H__
 
 #include <stdint.h>
+#include <vector>
 #include "mos_defs.h"
 #include "mos_defs_specific.h"
 #include "mos_os_specific.h"
@@ -36,6 +37,8 @@
 #include "mos_util_debug.h"
 #include "mos_os.h"
 #include "mos_interface.h"
+#include "media_copy_load_balance.h"
+#include "media_copy_batch.h"
 
 class CommonSurfaceDumper;
 
@@ -146,6 +149,30 @@ public:
     //!
     virtual MOS_STATUS SurfaceCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst, MCPY_METHOD preferMethod = MCPY_METHOD_PERFORMANCE);
 
+    //!
+    //! \brief    batched surface copy func.
+    //! \details  copy src[i] to dst[i] for every i, in order. The BLT copies of the batch
+    //!           are recorded into shared command buffers instead of one submission each.
+    //!           All copies are checked before any is submitted, so an unsupported copy
+    //!           fails the batch with nothing copied.
+    //! \param    src
+    //!           [in] Array of source surfaces
+    //! \param    dst
+    //!           [in] Array of destination surfaces
+    //! \param    count
+    //!           [in] Number of copies
+    //! \param    copied
+    //!           [out] Optional, number of leading copies submitted, count on success
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if support, otherwise return unspoort.
+    //!
+    virtual MOS_STATUS SurfaceCopyBatch(
+        PMOS_RESOURCE *src,
+        PMOS_RESOURCE *dst,
+        uint32_t       count,
+        MCPY_METHOD    preferMethod = MCPY_METHOD_PERFORMANCE,
+        uint32_t      *copied       = nullptr);
+
     //!
     //! \brief    aux surface copy.
     //! \details  copy surface.
@@ -193,6 +220,63 @@ protected:
     //!
     virtual MOS_STATUS TaskDispatch(MCPY_STATE_PARAMS mcpySrc, MCPY_STATE_PARAMS mcpyDst, MCPY_ENGINE mcpyEngine);
 
+    //!
+    //! \brief    dispatch batched BLT copy task.
+    //! \details  record all BLT copies into shared command buffers. A destination
+    //!           which needs decompression is resolved after the copies before it
+    //!           are submitted.
+    //! \param    mcpySrc
+    //!           [in] Array of source surface states
+    //! \param    mcpyDst
+    //!           [in] Array of destination surface states
+    //! \param    count
+    //!           [in] Number of copies
+    //! \param    copied
+    //!           [out] Number of leading copies submitted
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if support, otherwise return unspoort.
+    //!
+    virtual MOS_STATUS TaskDispatchBltBatch(MCPY_STATE_PARAMS *mcpySrc, MCPY_STATE_PARAMS *mcpyDst, uint32_t count, uint32_t &copied);
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+    //!
+    //! \brief    dump copy surface.
+    //! \details  dump a linear copy source to "dumpLocation before MCPY" or a linear
+    //!           copy target to "dumpLocation after MCPY".
+    //! \param    mcpy
+    //!           [in] surface state of the copy source or target
+    //! \param    isInput
+    //!           [in] true for the copy source
+    //!
+    void DumpCopySurface(const MCPY_STATE_PARAMS &mcpy, bool isInput);
+#endif
+
+    //!
+    //! \brief    prepare one copy.
+    //! \details  query both resources, check the caps and select the copy engine.
+    //! \param    src
+    //!           [in] Pointer to source surface
+    //! \param    dst
+    //!           [in] Pointer to destination surface
+    //! \param    preferMethod
+    //!           [in] preferred copy method
+    //! \param    mcpySrc
+    //!           [out] source surface state
+    //! \param    mcpyDst
+    //!           [out] destination surface state
+    //! \param    mcpyEngine
+    //!           [out] selected copy engine
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if support, otherwise return unspoort.
+    //!
+    MOS_STATUS PrepareCopy(
+        PMOS_RESOURCE      src,
+        PMOS_RESOURCE      dst,
+        MCPY_METHOD        preferMethod,
+        MCPY_STATE_PARAMS &mcpySrc,
+        MCPY_STATE_PARAMS &mcpyDst,
+        MCPY_ENGINE       &mcpyEngine);
+
     //!
     //! \brief    vebox format support.
     //! \details  surface format support.
@@ -251,6 +335,48 @@ protected:
     //!
     virtual MOS_STATUS CopyEnigneSelect(MCPY_METHOD& preferMethod, MCPY_ENGINE &mcpyEngine, MCPY_ENGINE_CAPS &caps);
 
+    //!
+    //! \brief    get load of copy engine
+    //! \details  number of submissions on the engine node which are not completed yet,
+    //!           counted across all gpu contexts of the device.
+    //! \param    mcpyEngine
+    //!           [in] copy engine
+    //! \return   uint32_t
+    //!           pending submissions, saturated at MCPY_ENGINE_LOAD_MAX
+    //!
+    virtual uint32_t GetEngineLoad(MCPY_ENGINE mcpyEngine);
+
+    //!
+    //! \brief    move copy to a less loaded engine
+    //! \details  keeps the engine picked by CopyEnigneSelect unless another capable engine
+    //!           has at least MCPY_ENGINE_LOAD_MARGIN fewer pending submissions. Only
+    //!           active when "MCPY Load Aware Engine Select" is set.
+    //! \param    preferMethod
+    //!           [in] copy method
+    //! \param    mcpyEngine
+    //!           [in, out] copy engine
+    //! \param    caps
+    //!           [in] reference of featue supported engine
+    //! \param    mcpySrc
+    //!           [in] source parameters
+    //! \param    mcpyDst
+    //!           [in] destination parameters
+    //! \param    src
+    //!           [in] source surface details
+    //! \param    dst
+    //!           [in] destination surface details
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS
+    //!
+    virtual MOS_STATUS LoadBalanceEngine(
+        MCPY_METHOD        preferMethod,
+        MCPY_ENGINE       &mcpyEngine,
+        MCPY_ENGINE_CAPS  &caps,
+        MCPY_STATE_PARAMS &mcpySrc,
+        MCPY_STATE_PARAMS &mcpyDst,
+        const MOS_SURFACE &src,
+        const MOS_SURFACE &dst);
+
     //!
     //! \brief    use blt engie to do surface copy.
     //! \details  implementation media blt copy.
@@ -264,6 +390,22 @@ protected:
     virtual MOS_STATUS MediaBltCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst)
     {return MOS_STATUS_SUCCESS;}
 
+    //!
+    //! \brief    use blt engine to do batched surface copy.
+    //! \details  copy src[i] to dst[i], default implementation calls MediaBltCopy per copy.
+    //! \param    src
+    //!           [in] Array of source surfaces
+    //! \param    dst
+    //!           [in] Array of destination surfaces
+    //! \param    count
+    //!           [in] Number of copies
+    //! \param    copied
+    //!           [out] Number of leading copies submitted
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if support, otherwise return unspoort.
+    //!
+    virtual MOS_STATUS MediaBltCopyBatch(PMOS_RESOURCE *src, PMOS_RESOURCE *dst, uint32_t count, uint32_t &copied);
+
     //!
     //! \brief    use Render engie to do surface copy.
     //! \details  implementation media Render copy.
@@ -307,6 +449,8 @@ protected:
     char                 m_dumpLocation_out[MAX_PATH] = {};
 #endif
     bool                 m_bRenderFallbackToBlt  = false;
+    bool                 m_loadAwareEngineSelect = false;  // pick the least loaded capable engine, opt in by user setting
+    MediaCopyLoadBalancer m_loadBalancer;                  // cached engine loads, protected by m_inUseGPUMutex
 MEDIA_CLASS_DEFINE_END(MediaCopyBaseState)
 };
 #endif
@@ -0,0 +1,91 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_copy_batch.cpp
+//! \brief    Submission order of a batched media copy
+//!
+
+#include "media_copy_batch.h"
+
+MOS_STATUS MediaCopyBatchDispatcher::Dispatch(
+    const bool        *isBlt,
+    uint32_t           count,
+    const BltRun      &bltRun,
+    const SingleCopy  &singleCopy,
+    uint32_t          &copied)
+{
+    MOS_STATUS status = MOS_STATUS_SUCCESS;
+
+    copied = 0;
+    if (isBlt == nullptr)
+    {
+        return MOS_STATUS_NULL_POINTER;
+    }
+
+    uint32_t i = 0;
+    while (i < count && status == MOS_STATUS_SUCCESS)
+    {
+        if (isBlt[i])
+        {
+            uint32_t end       = i;
+            uint32_t runCopied = 0;
+            while (end < count && isBlt[end])
+            {
+                end++;
+            }
+            status = bltRun(i, end - i, runCopied);
+            copied += runCopied;
+            i = end;
+        }
+        else
+        {
+            // vebox and render copy have no multi surface path, submit them one by one
+            // between the BLT runs to keep the submission order.
+            status = singleCopy(i);
+            copied += (status == MOS_STATUS_SUCCESS) ? 1 : 0;
+            i++;
+        }
+    }
+
+    return status;
+}
+
+MOS_STATUS MediaCopyBatchDispatcher::FallbackToSingleCopies(
+    MOS_STATUS         status,
+    uint32_t           count,
+    const SingleCopy  &singleCopy,
+    uint32_t          &copied)
+{
+    if (status != MOS_STATUS_UNIMPLEMENTED)
+    {
+        return status;
+    }
+
+    status = MOS_STATUS_SUCCESS;
+    while (copied < count && status == MOS_STATUS_SUCCESS)
+    {
+        status = singleCopy(copied);
+        copied += (status == MOS_STATUS_SUCCESS) ? 1 : 0;
+    }
+
+    return status;
+}
@@ -0,0 +1,102 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_copy_batch.h
+//! \brief    Submission order of a batched media copy
+//! \details  Splits a batch into BLT runs and single copies and counts the
+//!           leading copies submitted. It has no HW dependency, the copies
+//!           are submitted through callbacks.
+//!
+
+#ifndef __MEDIA_COPY_BATCH_H__
+#define __MEDIA_COPY_BATCH_H__
+
+#include <stdint.h>
+#include <functional>
+#include "mos_defs.h"
+#include "media_class_trace.h"
+
+class MediaCopyBatchDispatcher
+{
+public:
+    //!
+    //! \brief    submit copies first .. first + num - 1 as one BLT batch
+    //! \details  sets copied to the number of leading copies of the run submitted
+    //!
+    using BltRun = std::function<MOS_STATUS(uint32_t first, uint32_t num, uint32_t &copied)>;
+
+    //!
+    //! \brief    submit copy index on its own
+    //!
+    using SingleCopy = std::function<MOS_STATUS(uint32_t index)>;
+
+    //!
+    //! \brief    dispatch a batch in order
+    //! \details  consecutive BLT copies go to bltRun together, other copies go
+    //!           to singleCopy one by one between the BLT runs. The first
+    //!           failure stops the batch.
+    //! \param    isBlt
+    //!           [in] whether each copy runs on the BLT engine
+    //! \param    count
+    //!           [in] number of copies
+    //! \param    bltRun
+    //!           [in] BLT run submission
+    //! \param    singleCopy
+    //!           [in] single copy submission
+    //! \param    copied
+    //!           [out] number of leading copies submitted
+    //! \return   MOS_STATUS
+    //!           status of the failing submission, MOS_STATUS_SUCCESS if all are submitted
+    //!
+    static MOS_STATUS Dispatch(
+        const bool        *isBlt,
+        uint32_t           count,
+        const BltRun      &bltRun,
+        const SingleCopy  &singleCopy,
+        uint32_t          &copied);
+
+    //!
+    //! \brief    finish a batch the copy state could not take
+    //! \details  when the batch failed with MOS_STATUS_UNIMPLEMENTED, e.g. the copy
+    //!           state has no BLT state to record a batch, copies copied .. count - 1
+    //!           are submitted one by one. Any other status is returned as is.
+    //! \param    status
+    //!           [in] status of the batch
+    //! \param    count
+    //!           [in] number of copies
+    //! \param    singleCopy
+    //!           [in] single copy submission
+    //! \param    copied
+    //!           [in, out] number of leading copies submitted
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if all are submitted
+    //!
+    static MOS_STATUS FallbackToSingleCopies(
+        MOS_STATUS         status,
+        uint32_t           count,
+        const SingleCopy  &singleCopy,
+        uint32_t          &copied);
+
+MEDIA_CLASS_DEFINE_END(MediaCopyBatchDispatcher)
+};
+
+#endif  // __MEDIA_COPY_BATCH_H__
@@ -46,6 +46,7 @@
 #define BLT_CHK_NULL_RETURN(_ptr)           MOS_CHK_NULL_RETURN(MOS_COMPONENT_MCPY, MOS_MCPY_SUBCOMP_BLT, _ptr)
 #define BLT_ASSERTMESSAGE(_message, ...)    MOS_ASSERTMESSAGE(MOS_COMPONENT_MCPY, MOS_MCPY_SUBCOMP_BLT, _message, ##__VA_ARGS__)
 #define BLT_BITS_PER_BYTE                   8
+#define BLT_BATCH_MAX_COPIES                32      // copies recorded into one BLT command buffer
 
 #define VEBOX_COPY                          ((uint32_t)(VPHAL_MCP_VEBOX_COPY))
 #define RENDER_COPY                         ((uint32_t)(VPHAL_MCP_RENDER_COPY))
@@ -0,0 +1,84 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_copy_load_balance.cpp
+//! \brief    Load aware copy engine selection
+//! \details  Picks the least loaded capable copy engine.
+//!
+
+#include "media_copy_load_balance.h"
+
+uint32_t MediaCopyLoadBalancer::GetLoad(uint32_t engine, uint64_t nowUs, const LoadQuery &queryLoad)
+{
+    if (!m_loadValid[engine] || nowUs - m_loadTime[engine] >= MCPY_ENGINE_LOAD_CACHE_US)
+    {
+        uint32_t load       = queryLoad(engine);
+        m_load[engine]      = load < MCPY_ENGINE_LOAD_MAX ? load : MCPY_ENGINE_LOAD_MAX;
+        m_loadTime[engine]  = nowUs;
+        m_loadValid[engine] = true;
+    }
+    return m_load[engine];
+}
+
+uint32_t MediaCopyLoadBalancer::SelectEngine(
+    uint32_t         preferEngine,
+    const bool       capable[MCPY_ENGINE_LOAD_ENGINE_NUM],
+    uint64_t         nowUs,
+    const LoadQuery &queryLoad)
+{
+    if (preferEngine >= MCPY_ENGINE_LOAD_ENGINE_NUM || capable == nullptr || !queryLoad)
+    {
+        return preferEngine;
+    }
+
+    uint32_t preferLoad = GetLoad(preferEngine, nowUs, queryLoad);
+    if (preferLoad < MCPY_ENGINE_LOAD_MARGIN)
+    {
+        return preferEngine;  // preferred engine is nearly idle.
+    }
+
+    uint32_t bestEngine = preferEngine;
+    uint32_t bestLoad   = preferLoad;
+    for (uint32_t engine = 0; engine < MCPY_ENGINE_LOAD_ENGINE_NUM; engine++)
+    {
+        if (engine == preferEngine || !capable[engine])
+        {
+            continue;
+        }
+        uint32_t load = GetLoad(engine, nowUs, queryLoad);
+        if (load < bestLoad && load + MCPY_ENGINE_LOAD_MARGIN <= preferLoad)
+        {
+            bestLoad   = load;
+            bestEngine = engine;
+        }
+    }
+
+    return bestEngine;
+}
+
+void MediaCopyLoadBalancer::OnSubmit(uint32_t engine)
+{
+    if (engine < MCPY_ENGINE_LOAD_ENGINE_NUM && m_loadValid[engine] && m_load[engine] < MCPY_ENGINE_LOAD_MAX)
+    {
+        m_load[engine]++;
+    }
+}
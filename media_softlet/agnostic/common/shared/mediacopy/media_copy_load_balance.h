@@ -0,0 +1,92 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_copy_load_balance.h
+//! \brief    Load aware copy engine selection
+//! \details  Picks the least loaded capable copy engine. It has no OS
+//!           dependency, the engine load is queried through a callback.
+//!
+
+#ifndef __MEDIA_COPY_LOAD_BALANCE_H__
+#define __MEDIA_COPY_LOAD_BALANCE_H__
+
+#include <stdint.h>
+#include <functional>
+#include "media_class_trace.h"
+
+#define MCPY_ENGINE_LOAD_ENGINE_NUM   3     // vebox, blt, render, in MCPY_ENGINE order
+#define MCPY_ENGINE_LOAD_MAX          8     // pending submissions counted per engine node
+#define MCPY_ENGINE_LOAD_MARGIN       2     // load gap needed to leave the method preferred engine
+#define MCPY_ENGINE_LOAD_CACHE_US     1000  // engine load is probed at most once per interval
+
+//!
+//! \brief    Least loaded capable engine selection with a short lived load cache
+//!
+class MediaCopyLoadBalancer
+{
+public:
+    //!
+    //! \brief    query load of one engine
+    //! \details  returns the pending submissions of the engine, saturated at MCPY_ENGINE_LOAD_MAX
+    //!
+    using LoadQuery = std::function<uint32_t(uint32_t engine)>;
+
+    //!
+    //! \brief    select copy engine
+    //! \details  keeps preferEngine unless another capable engine has at least
+    //!           MCPY_ENGINE_LOAD_MARGIN fewer pending submissions. Loads younger
+    //!           than MCPY_ENGINE_LOAD_CACHE_US are reused instead of probed.
+    //! \param    preferEngine
+    //!           [in] engine picked by the copy method
+    //! \param    capable
+    //!           [in] whether each engine can take the copy, indexed by engine
+    //! \param    nowUs
+    //!           [in] current time in us
+    //! \param    queryLoad
+    //!           [in] load probe
+    //! \return   uint32_t
+    //!           selected engine
+    //!
+    uint32_t SelectEngine(
+        uint32_t         preferEngine,
+        const bool       capable[MCPY_ENGINE_LOAD_ENGINE_NUM],
+        uint64_t         nowUs,
+        const LoadQuery &queryLoad);
+
+    //!
+    //! \brief    account a copy submitted to engine
+    //! \details  bumps the cached load so back to back copies inside one cache
+    //!           interval do not all pick the same engine.
+    //!
+    void OnSubmit(uint32_t engine);
+
+private:
+    uint32_t GetLoad(uint32_t engine, uint64_t nowUs, const LoadQuery &queryLoad);
+
+    uint32_t m_load[MCPY_ENGINE_LOAD_ENGINE_NUM]      = {};
+    uint64_t m_loadTime[MCPY_ENGINE_LOAD_ENGINE_NUM]  = {};
+    bool     m_loadValid[MCPY_ENGINE_LOAD_ENGINE_NUM] = {};
+
+MEDIA_CLASS_DEFINE_END(MediaCopyLoadBalancer)
+};
+
+#endif  // __MEDIA_COPY_LOAD_BALANCE_H__
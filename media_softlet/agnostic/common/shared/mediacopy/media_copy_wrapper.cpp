@@ -94,3 +94,48 @@ MOS_STATUS MediaCopyWrapper::MediaCopy(
 
     return status;
 }
+
+MOS_STATUS MediaCopyWrapper::MediaCopyBatch(
+    PMOS_RESOURCE *inputResources,
+    PMOS_RESOURCE *outputResources,
+    uint32_t       count,
+    MCPY_METHOD    preferMethod,
+    uint32_t      *copied)
+{
+    MOS_STATUS status = MOS_STATUS_SUCCESS;
+    uint32_t   done   = 0;
+
+    if (copied)
+    {
+        *copied = 0;
+    }
+    MCPY_CHK_NULL_RETURN(inputResources);
+    MCPY_CHK_NULL_RETURN(outputResources);
+    if (nullptr == m_mediaCopyState)
+    {
+        CreateMediaCopyState();
+    }
+    MCPY_CHK_NULL_RETURN(m_mediaCopyState);
+
+    status = m_mediaCopyState->SurfaceCopyBatch(
+        inputResources,
+        outputResources,
+        count,
+        preferMethod,
+        &done);
+
+    // No BLT state to record the batch on, copy the rest one by one.
+    status = MediaCopyBatchDispatcher::FallbackToSingleCopies(
+        status,
+        count,
+        [&](uint32_t index) {
+            return m_mediaCopyState->SurfaceCopy(inputResources[index], outputResources[index], preferMethod);
+        },
+        done);
+
+    if (copied)
+    {
+        *copied = done;
+    }
+    return status;
+}
@@ -95,6 +95,31 @@ public:
         PMOS_RESOURCE outputResource,
         MCPY_METHOD   preferMethod);
 
+    //!
+    //! \brief    Media copy batch
+    //! \details  Copy inputResources[i] to outputResources[i] for every i, in order.
+    //!            The BLT copies share command buffer submissions. If the copy state
+    //!            has no BLT state to record a batch, the copies not done yet go
+    //!            through SurfaceCopy one by one.
+    //! \param    [in] inputResources
+    //!            Array of source resources
+    //! \param    [out] outputResources
+    //!            Array of target resources
+    //! \param    [in] count
+    //!            Number of copies
+    //! \param    [in] preferMethod
+    //!            The preferred copy mode
+    //! \param    [out] copied
+    //!            Optional, number of leading copies submitted, count on success
+    //! \return   MOS_STATUS_SUCCESS if succeeded, else error code.
+    //!
+    MOS_STATUS MediaCopyBatch(
+        PMOS_RESOURCE *inputResources,
+        PMOS_RESOURCE *outputResources,
+        uint32_t       count,
+        MCPY_METHOD    preferMethod,
+        uint32_t      *copied = nullptr);
+
 private:
     PMOS_INTERFACE     m_osInterface     = nullptr;
     MediaCopyBaseState *m_mediaCopyState = nullptr;
@@ -169,7 +169,8 @@ MOS_STATUS VphdrResourceManager::AssignRenderResource(VP_EXECUTE_CAPS &caps, std
                 deferredDestroyed,
                 MOS_HW_RESOURCE_USAGE_VP_INTERNAL_READ_RENDER));
 
-        surfSetting.OETF1DLUTAllocated = allocated;
+        // One flag covers all layers, keep it set if any layer got a new surface.
+        surfSetting.OETF1DLUTAllocated |= allocated;
         surfSetting.surfGroup.emplace((SurfaceType)(SurfaceTypeHdrOETF1DLUTSurface0 + i), m_hdrOETF1DLUTSurface[i]);
     }
 
@@ -207,7 +208,7 @@ MOS_STATUS VphdrResourceManager::AssignRenderResource(VP_EXECUTE_CAPS &caps, std
              nullptr,
              dwDepth));
 
-         surfSetting.Cri3DLUTAllocated = allocated;
+         surfSetting.Cri3DLUTAllocated |= allocated;
          surfSetting.surfGroup.emplace((SurfaceType)(SurfaceTypeHdrCRI3DLUTSurface0 + i), m_hdrCri3DLUTSurface[i]);
     }
 
@@ -34,6 +34,7 @@
 #include "vp_cgc_filter.h"
 #include "vp_user_feature_control.h"
 #include "vp_ai_filter.h"
+#include <type_traits>
 
 
 namespace vp
@@ -48,6 +49,8 @@ Policy::Policy(VpInterface &vpInterface) : m_vpInterface(vpInterface)
 
 Policy::~Policy()
 {
+    VP_PUBLIC_NORMALMESSAGE("Policy decision cache: hit %llu, miss %llu, uncacheable %llu, mismatch %llu",
+        m_decisionCacheStats.hit, m_decisionCacheStats.miss, m_decisionCacheStats.uncacheable, m_decisionCacheStats.mismatch);
     UnregisterFeatures();
 }
 
@@ -730,10 +733,7 @@ MOS_STATUS Policy::BuildExecutionEngines(SwFilterPipe &swFilterPipe, bool isInpu
         }
         else
         {
-            for (auto filterID : m_featurePool)
-            {
-                VP_PUBLIC_CHK_STATUS_RETURN(GetExecutionCapsForSingleFeature(filterID, *pipe, engineCapsCombined));
-            }
+            VP_PUBLIC_CHK_STATUS_RETURN(GetExecutionCapsWithDecisionCache(*pipe, isInputPipe, engineCapsCombined));
         }
         engineCapsCombinedAllPipes.value |= engineCapsCombined.value;
         VP_PUBLIC_CHK_STATUS_RETURN(FilterFeatureCombination(swFilterPipe, isInputPipe, index, engineCapsCombined, engineCapsCombinedAllPipes));
@@ -741,6 +741,456 @@ MOS_STATUS Policy::BuildExecutionEngines(SwFilterPipe &swFilterPipe, bool isInpu
     return MOS_STATUS_SUCCESS;
 }
 
+MOS_STATUS Policy::GetExecutionCapsForAllFeatures(SwFilterSubPipe &swFilterPipe, VP_EngineEntry &engineCapsCombined)
+{
+    VP_FUNC_CALL();
+
+    for (auto filterID : m_featurePool)
+    {
+        VP_PUBLIC_CHK_STATUS_RETURN(GetExecutionCapsForSingleFeature(filterID, swFilterPipe, engineCapsCombined));
+    }
+    return MOS_STATUS_SUCCESS;
+}
+
+// Only named fields take part in the signature, struct padding and addresses never do.
+template <typename T>
+static void AppendDecisionValue(std::vector<uint8_t> &signature, T value)
+{
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only plain values are serialized");
+    const uint8_t *bytes = (const uint8_t *)&value;
+    signature.insert(signature.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T, size_t N>
+static void AppendDecisionArray(std::vector<uint8_t> &signature, const T (&values)[N])
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        AppendDecisionValue(signature, values[i]);
+    }
+}
+
+static void AppendDecisionValue(std::vector<uint8_t> &signature, const RECT &rect)
+{
+    AppendDecisionValue(signature, rect.left);
+    AppendDecisionValue(signature, rect.top);
+    AppendDecisionValue(signature, rect.right);
+    AppendDecisionValue(signature, rect.bottom);
+}
+
+static void AppendDecisionValue(std::vector<uint8_t> &signature, const VPHAL_IEF_PARAMS &params)
+{
+    AppendDecisionValue(signature, params.bEnabled);
+    AppendDecisionValue(signature, params.bSmoothMode);
+    AppendDecisionValue(signature, params.bSkintoneTuned);
+    AppendDecisionValue(signature, params.bEmphasizeSkinDetail);
+    AppendDecisionValue(signature, params.fIEFFactor);
+    AppendDecisionValue(signature, params.StrongEdgeWeight);
+    AppendDecisionValue(signature, params.RegularWeight);
+    AppendDecisionValue(signature, params.StrongEdgeThreshold);
+    AppendDecisionValue(signature, params.pExtParam != nullptr);
+}
+
+static void AppendDecisionValue(std::vector<uint8_t> &signature, const VPHAL_ALPHA_PARAMS &params)
+{
+    AppendDecisionValue(signature, params.fAlpha);
+    AppendDecisionValue(signature, params.AlphaMode);
+}
+
+static void AppendDecisionValue(std::vector<uint8_t> &signature, const VPHAL_COLORFILL_PARAMS &params)
+{
+    AppendDecisionValue(signature, params.bYCbCr);
+    AppendDecisionValue(signature, params.isFloat);
+    AppendDecisionValue(signature, params.Color);
+    AppendDecisionArray(signature, params.ColorFloat);
+    AppendDecisionValue(signature, params.Color1.R);
+    AppendDecisionValue(signature, params.Color1.G);
+    AppendDecisionValue(signature, params.Color1.B);
+    AppendDecisionValue(signature, params.Color1.A);
+    AppendDecisionValue(signature, params.CSpace);
+    AppendDecisionValue(signature, params.bDisableColorfillinSFC);
+    AppendDecisionValue(signature, params.bOnePixelBiasinSFC);
+}
+
+static void AppendDecisionValue(std::vector<uint8_t> &signature, const VPHAL_PROCAMP_PARAMS &params)
+{
+    AppendDecisionValue(signature, params.bEnabled);
+    AppendDecisionValue(signature, params.fBrightness);
+    AppendDecisionValue(signature, params.fContrast);
+    AppendDecisionValue(signature, params.fHue);
+    AppendDecisionValue(signature, params.fSaturation);
+}
+
+static void AppendDecisionValue(std::vector<uint8_t> &signature, const VPHAL_LUMAKEY_PARAMS &params)
+{
+    AppendDecisionValue(signature, params.LumaLow);
+    AppendDecisionValue(signature, params.LumaHigh);
+}
+
+static void AppendDecisionValue(std::vector<uint8_t> &signature, const VPHAL_BLENDING_PARAMS &params)
+{
+    AppendDecisionValue(signature, params.BlendType);
+    AppendDecisionValue(signature, params.fAlpha);
+}
+
+// The content of pointed params takes part in the decision, the address does not.
+template <typename T>
+static void AppendDecisionContent(std::vector<uint8_t> &signature, const T *data)
+{
+    AppendDecisionValue(signature, data != nullptr);
+    if (data)
+    {
+        AppendDecisionValue(signature, *data);
+    }
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParam &params)
+{
+    AppendDecisionValue(signature, params.type);
+    AppendDecisionValue(signature, params.formatInput);
+    AppendDecisionValue(signature, params.formatOutput);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamCsc &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionValue(signature, params.input.colorSpace);
+    AppendDecisionValue(signature, params.input.chromaSiting);
+    AppendDecisionValue(signature, params.input.tileMode);
+    AppendDecisionValue(signature, params.output.colorSpace);
+    AppendDecisionValue(signature, params.output.chromaSiting);
+    AppendDecisionValue(signature, params.output.tileMode);
+    AppendDecisionContent(signature, params.pIEFParams);
+    AppendDecisionContent(signature, params.pAlphaParams);
+    AppendDecisionValue(signature, params.formatforCUS);
+    AppendDecisionValue(signature, params.isFullRgbG10P709);
+}
+
+static void AppendDecisionValue(std::vector<uint8_t> &signature, const FeatureParamScaling::SCALING_PARAMS &params)
+{
+    AppendDecisionValue(signature, params.dwWidth);
+    AppendDecisionValue(signature, params.dwHeight);
+    AppendDecisionValue(signature, params.dwPitch);
+    AppendDecisionValue(signature, params.rcSrc);
+    AppendDecisionValue(signature, params.rcDst);
+    AppendDecisionValue(signature, params.rcMaxSrc);
+    AppendDecisionValue(signature, params.sampleType);
+    AppendDecisionValue(signature, params.tileMode);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamScaling &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionValue(signature, params.input);
+    AppendDecisionValue(signature, params.output);
+    AppendDecisionValue(signature, params.isPrimary);
+    AppendDecisionValue(signature, params.scalingMode);
+    AppendDecisionValue(signature, params.scalingPreference);
+    AppendDecisionValue(signature, params.bDirectionalScalar);
+    AppendDecisionValue(signature, params.bTargetRectangle);
+    AppendDecisionContent(signature, params.pColorFillParams);
+    AppendDecisionContent(signature, params.pCompAlpha);
+    AppendDecisionValue(signature, params.interlacedScalingType);
+    AppendDecisionValue(signature, params.csc.colorSpaceOutput);
+    AppendDecisionValue(signature, params.rotation.rotationNeeded);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamRotMir &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionValue(signature, params.rotation);
+    AppendDecisionValue(signature, params.surfInfo.tileOutput);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamSte &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionValue(signature, params.bEnableSTE);
+    AppendDecisionValue(signature, params.dwSTEFactor);
+    AppendDecisionValue(signature, params.bEnableSTD);
+    // STD output buffer is not used by policy.
+    AppendDecisionValue(signature, params.STDParam.paraSizeInBytes);
+    AppendDecisionValue(signature, params.STDParam.bOutputSkinScore);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamTcc &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionValue(signature, params.bEnableTCC);
+    AppendDecisionValue(signature, params.Red);
+    AppendDecisionValue(signature, params.Green);
+    AppendDecisionValue(signature, params.Blue);
+    AppendDecisionValue(signature, params.Cyan);
+    AppendDecisionValue(signature, params.Magenta);
+    AppendDecisionValue(signature, params.Yellow);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamProcamp &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionContent(signature, params.procampParams);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamLumakey &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionContent(signature, params.lumaKeyParams);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamBlending &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionContent(signature, params.blendingParams);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamColorFill &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionContent(signature, params.colorFillParams);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamAlpha &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionContent(signature, params.compAlpha);
+    AppendDecisionValue(signature, params.calculatingAlpha);
+}
+
+static void AppendDecisionParams(std::vector<uint8_t> &signature, const FeatureParamCgc &params)
+{
+    AppendDecisionParams(signature, static_cast<const FeatureParam &>(params));
+    AppendDecisionValue(signature, params.GCompMode);
+    AppendDecisionValue(signature, params.colorSpace);
+    AppendDecisionValue(signature, params.dstColorSpace);
+    AppendDecisionValue(signature, params.bBt2020ToRGB);
+    AppendDecisionValue(signature, params.bExtendedSrcGamut);
+    AppendDecisionValue(signature, params.bExtendedDstGamut);
+    AppendDecisionValue(signature, params.dwAttenuation);
+    AppendDecisionArray(signature, params.displayRGBW_x);
+    AppendDecisionArray(signature, params.displayRGBW_y);
+}
+
+template <typename TFilter>
+static bool AppendDecisionFilter(std::vector<uint8_t> &signature, SwFilter *feature)
+{
+    TFilter *filter = dynamic_cast<TFilter *>(feature);
+    if (nullptr == filter)
+    {
+        return false;
+    }
+    AppendDecisionParams(signature, filter->GetSwFilterParams());
+    return true;
+}
+
+bool Policy::GetDecisionSignature(SwFilterSubPipe &swFilterPipe, bool isInputPipe, std::vector<uint8_t> &signature)
+{
+    VP_FUNC_CALL();
+
+    auto hwInterface = m_vpInterface.GetHwInterface();
+    if (nullptr == hwInterface || nullptr == hwInterface->m_userFeatureControl ||
+        hwInterface->m_userFeatureControl->IsPolicyDecisionCacheDisabled())
+    {
+        return false;
+    }
+    auto userFeatureControl = hwInterface->m_userFeatureControl;
+
+    signature.clear();
+    signature.push_back(isInputPipe ? 1 : 0);
+    signature.push_back(userFeatureControl->IsSfcDisabled() ? 1 : 0);
+    signature.push_back(userFeatureControl->IsVeboxOutputDisabled() ? 1 : 0);
+    signature.push_back(userFeatureControl->IsVeboxTypeHMode() ? 1 : 0);
+    signature.push_back(userFeatureControl->IsFallbackScalingToRender8K() ? 1 : 0);
+    signature.push_back(userFeatureControl->IsSFCLinearOutputByTileConvertEnabled() ? 1 : 0);
+
+    for (auto featureType : m_featurePool)
+    {
+        SwFilter *feature = swFilterPipe.GetSwFilter(featureType);
+        if (nullptr == feature)
+        {
+            continue;
+        }
+        AppendDecisionValue(signature, featureType);
+
+        bool appended = false;
+        switch (featureType)
+        {
+        case FeatureTypeCsc:
+            appended = AppendDecisionFilter<SwFilterCsc>(signature, feature);
+            break;
+        case FeatureTypeScaling:
+            appended = AppendDecisionFilter<SwFilterScaling>(signature, feature);
+            break;
+        case FeatureTypeRotMir:
+            appended = AppendDecisionFilter<SwFilterRotMir>(signature, feature);
+            break;
+        case FeatureTypeSte:
+            appended = AppendDecisionFilter<SwFilterSte>(signature, feature);
+            break;
+        case FeatureTypeTcc:
+            appended = AppendDecisionFilter<SwFilterTcc>(signature, feature);
+            break;
+        case FeatureTypeProcamp:
+            appended = AppendDecisionFilter<SwFilterProcamp>(signature, feature);
+            break;
+        case FeatureTypeLumakey:
+            appended = AppendDecisionFilter<SwFilterLumakey>(signature, feature);
+            break;
+        case FeatureTypeBlending:
+            appended = AppendDecisionFilter<SwFilterBlending>(signature, feature);
+            break;
+        case FeatureTypeColorFill:
+            appended = AppendDecisionFilter<SwFilterColorFill>(signature, feature);
+            break;
+        case FeatureTypeAlpha:
+            appended = AppendDecisionFilter<SwFilterAlpha>(signature, feature);
+            break;
+        case FeatureTypeCgc:
+            appended = AppendDecisionFilter<SwFilterCgc>(signature, feature);
+            break;
+        default:
+            // HDR and DI depend on the state kept by policy and resource manager, DN sets
+            // render target type. Other features are not known to be stateless.
+            return false;
+        }
+        if (!appended)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+MOS_STATUS Policy::GetExecutionCapsWithDecisionCache(SwFilterSubPipe &swFilterPipe, bool isInputPipe, VP_EngineEntry &engineCapsCombined)
+{
+    VP_FUNC_CALL();
+
+    std::vector<uint8_t> signature;
+    bool                 cacheable = true;
+
+    // Features already processed, e.g. by previous pass, skip their own evaluation.
+    for (auto featureType : m_featurePool)
+    {
+        SwFilter *feature = swFilterPipe.GetSwFilter(featureType);
+        if (feature && feature->GetFilterEngineCaps().value != 0)
+        {
+            cacheable = false;
+            break;
+        }
+    }
+
+    if (!cacheable || !GetDecisionSignature(swFilterPipe, isInputPipe, signature))
+    {
+        ++m_decisionCacheStats.uncacheable;
+        return GetExecutionCapsForAllFeatures(swFilterPipe, engineCapsCombined);
+    }
+
+    auto it = m_decisionCache.begin();
+    for (; it != m_decisionCache.end(); ++it)
+    {
+        if (it->signature == signature)
+        {
+            break;
+        }
+    }
+
+    if (it != m_decisionCache.end())
+    {
+        m_decisionCache.splice(m_decisionCache.begin(), m_decisionCache, it);
+        if (!it->cacheable)
+        {
+            ++m_decisionCacheStats.uncacheable;
+            return GetExecutionCapsForAllFeatures(swFilterPipe, engineCapsCombined);
+        }
+        ++m_decisionCacheStats.hit;
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+        if (m_vpInterface.GetHwInterface()->m_userFeatureControl->IsPolicyDecisionCacheVerifyEnabled())
+        {
+            VP_PUBLIC_CHK_STATUS_RETURN(GetExecutionCapsForAllFeatures(swFilterPipe, engineCapsCombined));
+            uint32_t i = 0;
+            for (auto featureType : m_featurePool)
+            {
+                SwFilter *feature = swFilterPipe.GetSwFilter(featureType);
+                if (nullptr == feature)
+                {
+                    continue;
+                }
+                if (i >= it->engineCaps.size() || it->engineCaps[i].value != feature->GetFilterEngineCaps().value)
+                {
+                    VP_PUBLIC_ASSERTMESSAGE("Policy decision cache mismatch for feature %d, cached 0x%llx, evaluated 0x%llx", featureType,
+                        i < it->engineCaps.size() ? it->engineCaps[i].value : 0, feature->GetFilterEngineCaps().value);
+                    ++m_decisionCacheStats.mismatch;
+                    m_decisionCache.erase(it);
+                    return MOS_STATUS_SUCCESS;
+                }
+                ++i;
+            }
+            return MOS_STATUS_SUCCESS;
+        }
+#endif
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+        if (it->reportFallbackScalingToRender8K)
+        {
+            VP_PUBLIC_CHK_NULL_RETURN(m_vpInterface.GetHwInterface()->m_reporting);
+            m_vpInterface.GetHwInterface()->m_reporting->GetFeatures().fallbackScalingToRender8K = true;
+        }
+#endif
+
+        uint32_t i = 0;
+        for (auto featureType : m_featurePool)
+        {
+            SwFilter *feature = swFilterPipe.GetSwFilter(featureType);
+            if (nullptr == feature)
+            {
+                continue;
+            }
+            VP_PUBLIC_CHK_VALUE_RETURN(i < it->engineCaps.size(), true);
+            feature->GetFilterEngineCaps() = it->engineCaps[i++];
+            engineCapsCombined.value |= feature->GetFilterEngineCaps().value;
+            PrintFeatureExecutionCaps(__FUNCTION__, feature->GetFilterEngineCaps());
+        }
+        return MOS_STATUS_SUCCESS;
+    }
+
+    ++m_decisionCacheStats.miss;
+#if (_DEBUG || _RELEASE_INTERNAL)
+    m_reportFallbackScalingToRender8K = false;
+#endif
+    VP_PUBLIC_CHK_STATUS_RETURN(GetExecutionCapsForAllFeatures(swFilterPipe, engineCapsCombined));
+
+    POLICY_DECISION_ENTRY entry   = {};
+    std::vector<uint8_t>  updated;
+#if (_DEBUG || _RELEASE_INTERNAL)
+    // The debug report written by the evaluation is replayed on hit.
+    entry.reportFallbackScalingToRender8K = m_reportFallbackScalingToRender8K;
+#endif
+    // Only cache the decision if the evaluation left the feature params untouched,
+    // otherwise skipping it next time would skip the param update too.
+    entry.cacheable = GetDecisionSignature(swFilterPipe, isInputPipe, updated) && updated == signature;
+    entry.signature = std::move(signature);
+    if (entry.cacheable)
+    {
+        for (auto featureType : m_featurePool)
+        {
+            SwFilter *feature = swFilterPipe.GetSwFilter(featureType);
+            if (feature)
+            {
+                entry.engineCaps.push_back(feature->GetFilterEngineCaps());
+            }
+        }
+    }
+
+    m_decisionCache.push_front(std::move(entry));
+    if (m_decisionCache.size() > VP_POLICY_DECISION_CACHE_SIZE)
+    {
+        m_decisionCache.pop_back();
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
 MOS_STATUS Policy::Update3DLutoutputColorAndFormat(FeatureParamCsc *cscParams, FeatureParamHdr *hdrParams, MOS_FORMAT Format, VPHAL_CSPACE CSpace)
 {
     // For vebox + render, e.g. BT2020 P010->SRGB, if not correct the format here, since forceCscToRender being enabled, outputFormat in csc filter of
@@ -1460,6 +1910,7 @@ MOS_STATUS Policy::GetScalingExecutionCaps(SwFilter *feature, bool isHdrEnabled,
         scalingEngine->sfcNotSupported    = 1;
 #if (_DEBUG || _RELEASE_INTERNAL)
         reporting->GetFeatures().fallbackScalingToRender8K = fallbackScalingToRender8K;
+        m_reportFallbackScalingToRender8K                  = fallbackScalingToRender8K;
 #endif
 
         VP_PUBLIC_NORMALMESSAGE("VPOutputPipe will be render(0) since fallbackScalingToRender8K is true and the input height %d is greater than 3072.", scalingParams->input.dwHeight);
@@ -39,6 +39,7 @@
 #include "sw_filter_pipe.h"
 #include "vp_resource_manager.h"
 #include <map>
+#include <list>
 
 namespace vp
 {
@@ -46,6 +47,7 @@ namespace vp
 #define ENGINE_SUPPORT_MASK(supported) (supported & 0x3)
 #define ENGINE_MUST(supported)         (supported << 1)
 #define FEATURE_TYPE_EXECUTE(feature, engine) FeatureType##feature##On##engine
+#define VP_POLICY_DECISION_CACHE_SIZE  32
 
 class VpInterface;
 
@@ -88,6 +90,16 @@ protected:
     MOS_STATUS UpdateExecuteEngineCapsForHDR(SwFilterPipe &swFilterPipe, VP_EngineEntry &engineCapsCombinedAllPipes);
     MOS_STATUS UpdateExecuteEngineCapsForCrossPipeFeatures(SwFilterPipe &swFilterPipe, VP_EngineEntry &engineCapsCombinedAllPipes);
     MOS_STATUS         BuildExecutionEngines(SwFilterPipe &swFilterPipe, bool isInputPipe, uint32_t index, bool isAiPipe, VP_EngineEntry &engineCapsCombinedAllPipes);
+    MOS_STATUS GetExecutionCapsForAllFeatures(SwFilterSubPipe &swFilterPipe, VP_EngineEntry &engineCapsCombined);
+    MOS_STATUS GetExecutionCapsWithDecisionCache(SwFilterSubPipe &swFilterPipe, bool isInputPipe, VP_EngineEntry &engineCapsCombined);
+    //!
+    //! \brief    Build the signature of everything the feature execution caps depend on
+    //! \details  Feature params are taken by value with pointed params inlined, so the
+    //!           signature does not depend on where the caller keeps them.
+    //! \return   bool
+    //!           false if the sub pipe contains a feature whose decision cannot be cached
+    //!
+    bool GetDecisionSignature(SwFilterSubPipe &swFilterPipe, bool isInputPipe, std::vector<uint8_t> &signature);
     MOS_STATUS GetHwFilterParam(SwFilterPipe& subSwFilterPipe, HW_FILTER_PARAMS& params);
     MOS_STATUS ReleaseHwFilterParam(HW_FILTER_PARAMS &params);
     MOS_STATUS InitExecuteCaps(VP_EXECUTE_CAPS &caps, VP_EngineEntry &engineCapsInputPipe, VP_EngineEntry &engineCapsOutputPipe);
@@ -211,6 +223,28 @@ protected:
     uint32_t            m_savedMaxCLL   = 4000;
     VPHAL_HDR_MODE      m_savedHdrMode  = VPHAL_HDR_MODE_NONE;
 
+    // Engine caps decided for recently seen sub pipes, most recently used first.
+    struct POLICY_DECISION_ENTRY
+    {
+        std::vector<uint8_t>        signature;
+        bool                        cacheable = false;  //!< false if the evaluation updates the feature params
+        std::vector<VP_EngineEntry> engineCaps;         //!< engine caps of enabled features in m_featurePool order
+#if (_DEBUG || _RELEASE_INTERNAL)
+        bool                        reportFallbackScalingToRender8K = false;  //!< feature report set by the evaluation
+#endif
+    };
+    std::list<POLICY_DECISION_ENTRY> m_decisionCache;
+    struct
+    {
+        uint64_t hit          = 0;
+        uint64_t miss         = 0;
+        uint64_t uncacheable  = 0;
+        uint64_t mismatch     = 0;
+    } m_decisionCacheStats;
+#if (_DEBUG || _RELEASE_INTERNAL)
+    bool m_reportFallbackScalingToRender8K = false;  //!< set when scaling evaluation reports fallbackScalingToRender8K
+#endif
+
     //!
     //! \brief    Check whether Alpha Supported
     //! \details  Check whether Alpha Supported.
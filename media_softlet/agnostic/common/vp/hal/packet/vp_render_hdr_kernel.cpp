@@ -3234,6 +3234,70 @@ MOS_STATUS VpRenderHdrKernel::UpdatePerLayerPipelineStates(
     return eStatus;
 }
 
+MOS_STATUS VpRenderHdrKernel::GetLutCacheKey(
+    uint32_t             layerMask,
+    VP_SURFACE           *surface,
+    VP_HDR_LUT_CACHE_KEY &key)
+{
+    VP_FUNC_CALL();
+    VP_RENDER_CHK_NULL_RETURN(m_hdrParams);
+    VP_RENDER_CHK_NULL_RETURN(surface);
+    VP_RENDER_CHK_NULL_RETURN(surface->osSurface);
+
+    // Zero padding too, keys are compared with memcmp.
+    MOS_ZeroMemory(&key, sizeof(key));
+
+    for (uint32_t i = 0; i < VPHAL_MAX_HDR_INPUT_LAYER; i++)
+    {
+        if ((layerMask & (1 << i)) == 0 || !m_hdrParams->InputSrc[i])
+        {
+            continue;
+        }
+
+        VP_HDR_LUT_LAYER_KEY &layer = key.layer[i];
+        auto        inputSurface    = m_surfaceGroup->find(SurfaceType(SurfaceTypeHdrInputLayer0 + i));
+        VP_SURFACE *input           = (m_surfaceGroup->end() != inputSurface) ? inputSurface->second : nullptr;
+
+        layer.inputSrc     = m_hdrParams->InputSrc[i];
+        layer.stageEnables = m_hdrParams->StageEnableFlags[i].value;
+        layer.lutMode      = m_hdrParams->LUTMode[i];
+        layer.eotfGamma    = m_hdrParams->EOTFGamma[i];
+        layer.oetfGamma    = m_hdrParams->OETFGamma[i];
+        layer.hdrMode      = m_hdrParams->HdrMode[i];
+        layer.ccm          = m_hdrParams->CCM[i];
+        layer.ccmExt1      = m_hdrParams->CCMExt1[i];
+        layer.ccmExt2      = m_hdrParams->CCMExt2[i];
+        layer.priorCsc     = m_hdrParams->PriorCSC[i];
+        layer.postCsc      = m_hdrParams->PostCSC[i];
+        layer.inputFormat  = (input && input->osSurface) ? input->osSurface->Format : Format_Invalid;
+        layer.srcHDRParams = m_hdrParams->srcHDRParams[i];
+    }
+
+    key.targetHDRParams  = m_hdrParams->targetHDRParams[0];
+    key.maxDisplayLum    = m_hdrParams->uiMaxDisplayLum;
+    key.cri3DLUTSize     = m_hdrParams->Cri3DLUTSize;
+    key.gpuGenerate3DLUT = m_hdrParams->bGpuGenerate3DLUT;
+    key.format           = surface->osSurface->Format;
+    key.width            = surface->osSurface->dwWidth;
+    key.height           = surface->osSurface->dwHeight;
+    key.pitch            = surface->osSurface->dwPitch;
+    key.valid            = true;
+
+    return MOS_STATUS_SUCCESS;
+}
+
+bool VpRenderHdrKernel::IsLutCacheHit(
+    const VP_HDR_LUT_CACHE_KEY &cached,
+    const VP_HDR_LUT_CACHE_KEY &key,
+    bool                       allocated)
+{
+    if (allocated || !cached.valid)
+    {
+        return false;
+    }
+    return 0 == memcmp(&cached, &key, sizeof(key));
+}
+
 MOS_STATUS VpRenderHdrKernel::SetCacheCntl(PVP_RENDER_CACHE_CNTL surfMemCacheCtl)
 {
     VP_FUNC_CALL();
@@ -3448,18 +3512,35 @@ MOS_STATUS VpRenderHdrKernel::SetupSurfaceState()
         auto OETF1DLUT = m_surfaceGroup->find(SurfaceType(SurfaceTypeHdrOETF1DLUTSurface0 + i));
         VP_SURFACE *OETF1DLUTSrc = (m_surfaceGroup->end() != OETF1DLUT) ? OETF1DLUT->second : nullptr;
 
-        if (OETF1DLUTSrc && (m_hdrParams->OETF1DLUTAllocated || (dwUpdateMask & (1 << i)) || (dwUpdateMask & (1 << VPHAL_MAX_HDR_INPUT_LAYER))))
+        if (OETF1DLUTSrc)
         {
-            InitOETF1DLUT(m_hdrParams, i, OETF1DLUTSrc);
+            VP_HDR_LUT_CACHE_KEY key = {};
+            VP_RENDER_CHK_STATUS_RETURN(GetLutCacheKey(1 << i, OETF1DLUTSrc, key));
+            if (!IsLutCacheHit(m_oetf1DLUTKey[i], key, m_hdrParams->OETF1DLUTAllocated))
+            {
+                m_oetf1DLUTKey[i].valid = false;
+                if (MOS_SUCCEEDED(InitOETF1DLUT(m_hdrParams, i, OETF1DLUTSrc)))
+                {
+                    MOS_SecureMemcpy(&m_oetf1DLUTKey[i], sizeof(m_oetf1DLUTKey[i]), &key, sizeof(key));
+                }
+            }
         }
 
         auto        Cri3DLUT     = m_surfaceGroup->find(SurfaceType(SurfaceTypeHdrCRI3DLUTSurface0 + i));
         VP_SURFACE *Cri3DLUTSrc = (m_surfaceGroup->end() != Cri3DLUT) ? Cri3DLUT->second : nullptr;
 
-        if (Cri3DLUTSrc && (m_hdrParams->Cri3DLUTAllocated || (dwUpdateMask & (1 << i)) || (dwUpdateMask & (1 << VPHAL_MAX_HDR_INPUT_LAYER))) ||
-            m_hdrParams->HdrMode[i] == VPHAL_HDR_MODE_TONE_MAPPING_AUTO_MODE)
+        if (Cri3DLUTSrc)
         {
-            InitCri3DLUT(m_hdrParams, i, Cri3DLUTSrc);
+            VP_HDR_LUT_CACHE_KEY key = {};
+            VP_RENDER_CHK_STATUS_RETURN(GetLutCacheKey(1 << i, Cri3DLUTSrc, key));
+            if (!IsLutCacheHit(m_cri3DLUTKey[i], key, m_hdrParams->Cri3DLUTAllocated))
+            {
+                m_cri3DLUTKey[i].valid = false;
+                if (MOS_SUCCEEDED(InitCri3DLUT(m_hdrParams, i, Cri3DLUTSrc)))
+                {
+                    MOS_SecureMemcpy(&m_cri3DLUTKey[i], sizeof(m_cri3DLUTKey[i]), &key, sizeof(key));
+                }
+            }
         }
 
         KERNEL_SURFACE_STATE_PARAM surfaceResource = {};
@@ -3534,9 +3615,15 @@ MOS_STATUS VpRenderHdrKernel::SetupSurfaceState()
     VP_SURFACE *coeffSrc = (m_surfaceGroup->end() != coeff) ? coeff->second : nullptr;
     VP_RENDER_CHK_NULL_RETURN(coeffSrc);
 
-    if (dwUpdateMask || m_hdrParams->coeffAllocated)
+    VP_HDR_LUT_CACHE_KEY coeffKey = {};
+    VP_RENDER_CHK_STATUS_RETURN(GetLutCacheKey((1 << VPHAL_MAX_HDR_INPUT_LAYER) - 1, coeffSrc, coeffKey));
+    if (!IsLutCacheHit(m_coeffKey, coeffKey, m_hdrParams->coeffAllocated))
     {
-        HdrInitCoeff(m_hdrParams, coeffSrc);
+        m_coeffKey.valid = false;
+        if (MOS_SUCCEEDED(HdrInitCoeff(m_hdrParams, coeffSrc)))
+        {
+            MOS_SecureMemcpy(&m_coeffKey, sizeof(m_coeffKey), &coeffKey, sizeof(coeffKey));
+        }
     }
 
     KERNEL_SURFACE_STATE_PARAM surfCoeffParam = {};
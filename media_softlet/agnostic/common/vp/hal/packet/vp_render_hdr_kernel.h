@@ -858,6 +858,43 @@ struct VP_HDR_LAYER
     PVPHAL_PROCAMP_PARAMS   procampParams;
 };
 
+//!
+//! \brief Per layer inputs of the HDR LUT and coefficient surface contents
+//!
+struct VP_HDR_LUT_LAYER_KEY
+{
+    uint16_t                inputSrc;
+    uint16_t                stageEnables;
+    VPHAL_HDR_LUT_MODE      lutMode;
+    VPHAL_GAMMA_TYPE        eotfGamma;
+    VPHAL_GAMMA_TYPE        oetfGamma;
+    VPHAL_HDR_MODE          hdrMode;
+    VPHAL_HDR_CCM_TYPE      ccm;
+    VPHAL_HDR_CCM_TYPE      ccmExt1;
+    VPHAL_HDR_CCM_TYPE      ccmExt2;
+    VPHAL_HDR_CSC_TYPE      priorCsc;
+    VPHAL_HDR_CSC_TYPE      postCsc;
+    MOS_FORMAT              inputFormat;
+    HDR_PARAMS              srcHDRParams;                       //!< Mastering display and MaxCLL/MaxFALL metadata
+};
+
+//!
+//! \brief Content key of a LUT or coefficient surface, compared with memcmp
+//!
+struct VP_HDR_LUT_CACHE_KEY
+{
+    bool                    valid;
+    VP_HDR_LUT_LAYER_KEY    layer[VPHAL_MAX_HDR_INPUT_LAYER];   //!< Only layers the surface depends on are filled
+    HDR_PARAMS              targetHDRParams;
+    uint32_t                maxDisplayLum;
+    uint32_t                cri3DLUTSize;
+    bool                    gpuGenerate3DLUT;
+    MOS_FORMAT              format;                             //!< Format and layout of the cached surface
+    uint32_t                width;
+    uint32_t                height;
+    uint32_t                pitch;
+};
+
 class VpRenderHdrKernel : public VpRenderKernelObj
 {
 public:
@@ -1006,6 +1043,24 @@ protected:
     MOS_STATUS UpdatePerLayerPipelineStates(
         uint32_t           *pdwUpdateMask);
 
+    //!
+    //! \brief    Build the content key of a HDR LUT or coefficient surface
+    //! \param    [in] layerMask
+    //!           Layers whose stage settings and metadata decide the surface content
+    //! \param    [in] surface
+    //!           Surface to be filled
+    //! \param    [out] key
+    //!           Content key
+    //! \return   MOS_STATUS
+    //!
+    MOS_STATUS GetLutCacheKey(uint32_t layerMask, VP_SURFACE *surface, VP_HDR_LUT_CACHE_KEY &key);
+
+    //!
+    //! \brief    Check whether surface content built for cached is still valid for key
+    //! \details  Newly allocated surfaces never hit.
+    //!
+    bool IsLutCacheHit(const VP_HDR_LUT_CACHE_KEY &cached, const VP_HDR_LUT_CACHE_KEY &key, bool allocated);
+
     VP_EXECUTE_CAPS     m_executeCaps       = {};
     Kdll_FilterDesc     m_searchFilter      = {};
     Kdll_SearchState    m_kernelSearch      = {};
@@ -1035,6 +1090,13 @@ protected:
 
     PRENDER_HDR_PARAMS   m_hdrParams = nullptr;
     MEDIA_WALKER_HDR_STATIC_DATA m_hdrCurbe = {};
+
+    // Content keys of the LUT and coefficient surfaces. m_hdrParams is rebuilt from
+    // zeroed filter params every frame, so the update mask cannot tell whether the
+    // surfaces owned by the resource manager already hold the data.
+    VP_HDR_LUT_CACHE_KEY m_oetf1DLUTKey[VPHAL_MAX_HDR_INPUT_LAYER] = {};
+    VP_HDR_LUT_CACHE_KEY m_cri3DLUTKey[VPHAL_MAX_HDR_INPUT_LAYER]  = {};
+    VP_HDR_LUT_CACHE_KEY m_coeffKey                                = {};
     MHW_VFE_SCOREBOARD      m_scoreboardParams;
 
     bool                m_cscCoeffPatchModeEnabled = false;      //!< Set CSC Coeff using patch mode
@@ -139,6 +139,30 @@ MOS_STATUS VpPlatformInterface::InitVPFCKernels(
             patchKernelSize,
             ModifyFunctionPointers);
 
+        // Max number of dynamically linked kernels kept in the kernel dll cache
+        uint32_t   kernelCacheCapacity = DL_MAX_COMBINED_KERNELS;
+        MOS_STATUS status              = ReadUserSetting(
+            m_userSettingPtr,
+            kernelCacheCapacity,
+            __VPHAL_FC_KERNEL_CACHE_CAPACITY,
+            MediaUserSetting::Group::Sequence);
+        if (MOS_SUCCEEDED(status))
+        {
+            KernelDll_SetCombinedKernelCacheCapacity(vpKernel.GetKdllState(), (int32_t)kernelCacheCapacity);
+        }
+
+        // Combined kernels persisted by previous runs (opt-in)
+        MediaUserSetting::Value kernelCacheDirectory;
+        status = ReadUserSetting(
+            m_userSettingPtr,
+            kernelCacheDirectory,
+            __VPHAL_FC_KERNEL_CACHE_DIRECTORY,
+            MediaUserSetting::Group::Sequence);
+        if (MOS_SUCCEEDED(status) && kernelCacheDirectory.ConstString().size() > 0)
+        {
+            KernelDll_LoadDiskCache(vpKernel.GetKdllState(), kernelCacheDirectory.ConstString().c_str());
+        }
+
         m_kernelPool.emplace(vpKernel.GetKernelName(), vpKernel);
     }
 
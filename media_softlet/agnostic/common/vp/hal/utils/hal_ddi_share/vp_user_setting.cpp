@@ -21,6 +21,7 @@
 */
 #include "vp_user_setting.h"
 #include "vp_utils.h"
+#include "hal_kerneldll_next.h"
 
 MOS_STATUS VpUserSetting::InitVpUserSetting(MediaUserSettingSharedPtr userSettingPtr, bool clearViewMode)
 {
@@ -118,6 +119,13 @@ MOS_STATUS VpUserSetting::InitVpUserSetting(MediaUserSettingSharedPtr userSettin
             0,
             true);
 
+        DeclareUserSettingKey(
+            userSettingPtr,
+            __MEDIA_USER_FEATURE_VALUE_DISABLE_POLICY_DECISION_CACHE,
+            MediaUserSetting::Group::Sequence,
+            0,
+            true);
+
         DeclareUserSettingKey(
             userSettingPtr,
             __VPHAL_HDR_LUT_MODE,
@@ -176,6 +184,20 @@ MOS_STATUS VpUserSetting::InitVpUserSetting(MediaUserSettingSharedPtr userSettin
             0,
             true);
 
+        DeclareUserSettingKey(  // Max number of dynamically linked FC kernels kept in cache
+            userSettingPtr,
+            __VPHAL_FC_KERNEL_CACHE_CAPACITY,
+            MediaUserSetting::Group::Sequence,
+            uint32_t(DL_MAX_COMBINED_KERNELS),
+            true);
+
+        DeclareUserSettingKey(  // Directory of the persistent FC kernel cache, empty to disable
+            userSettingPtr,
+            __VPHAL_FC_KERNEL_CACHE_DIRECTORY,
+            MediaUserSetting::Group::Sequence,
+            "",
+            true);
+
         DeclareUserSettingKey(  // VP Primary Input Compression Mode
             userSettingPtr,
             __VPHAL_PRIMARY_MMC_COMPRESSMODE,
@@ -467,6 +489,13 @@ MOS_STATUS VpUserSetting::InitVpUserSetting(MediaUserSettingSharedPtr userSettin
         0,
         true);
 
+    DeclareUserSettingKeyForDebug(  // Re-evaluate policy on decision cache hit and assert on mismatch
+        userSettingPtr,
+        __MEDIA_USER_FEATURE_VALUE_VERIFY_POLICY_DECISION_CACHE,
+        MediaUserSetting::Group::Sequence,
+        0,
+        true);
+
 #endif
 
     return MOS_STATUS_SUCCESS;
@@ -189,6 +189,23 @@ VpUserFeatureControl::VpUserFeatureControl(MOS_INTERFACE &osInterface, VpPlatfor
     }
     VP_PUBLIC_NORMALMESSAGE("enablePacketReuseTeamsAlways %d", m_ctrlValDefault.enablePacketReuseTeamsAlways);
 
+    bool disablePolicyDecisionCache = false;
+    status = ReadUserSetting(
+        m_userSettingPtr,
+        disablePolicyDecisionCache,
+        __MEDIA_USER_FEATURE_VALUE_DISABLE_POLICY_DECISION_CACHE,
+        MediaUserSetting::Group::Sequence);
+    if (MOS_SUCCEEDED(status))
+    {
+        m_ctrlValDefault.disablePolicyDecisionCache = disablePolicyDecisionCache;
+    }
+    else
+    {
+        // Default value
+        m_ctrlValDefault.disablePolicyDecisionCache = false;
+    }
+    VP_PUBLIC_NORMALMESSAGE("disablePolicyDecisionCache %d", m_ctrlValDefault.disablePolicyDecisionCache);
+
     // bComputeContextEnabled is true only if Gen12+. 
     // Gen12+, compute context(MOS_GPU_NODE_COMPUTE, MOS_GPU_CONTEXT_COMPUTE) can be used for render engine.
     // Before Gen12, we only use MOS_GPU_NODE_3D and MOS_GPU_CONTEXT_RENDER.
@@ -381,6 +398,22 @@ MOS_STATUS VpUserFeatureControl::CreateUserSettingForDebug()
         m_ctrlValDefault.enabledSFCNv12P010LinearOutput = 0;
     }
 
+    bool verifyPolicyDecisionCache = false;
+    eRegKeyReadStatus = ReadUserSettingForDebug(
+        m_userSettingPtr,
+        verifyPolicyDecisionCache,
+        __MEDIA_USER_FEATURE_VALUE_VERIFY_POLICY_DECISION_CACHE,
+        MediaUserSetting::Group::Sequence);
+    if (MOS_SUCCEEDED(eRegKeyReadStatus))
+    {
+        m_ctrlValDefault.verifyPolicyDecisionCache = verifyPolicyDecisionCache;
+    }
+    else
+    {
+        // Default value
+        m_ctrlValDefault.verifyPolicyDecisionCache = false;
+    }
+
     //SFC RGBP Linear/Tile RGB24 Linear Output.
     uint32_t enabledSFCRGBPRGB24Output = 0;
     eRegKeyReadStatus =ReadUserSettingForDebug(
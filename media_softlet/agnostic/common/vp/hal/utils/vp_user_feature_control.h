@@ -60,6 +60,7 @@ public:
         uint32_t enabledSFCNv12P010LinearOutput = 0;
         uint32_t enabledSFCRGBPRGB24Output  = 0;
         bool     enableIFNCC                    = false;
+        bool     verifyPolicyDecisionCache      = false;
 #endif
         VP_CTRL enableOcl3DLut              = VP_CTRL_DEFAULT;
         VP_CTRL forceOclFC                  = VP_CTRL_DEFAULT;
@@ -67,6 +68,7 @@ public:
 
         bool disablePacketReuse             = false;
         bool enablePacketReuseTeamsAlways   = false;
+        bool disablePolicyDecisionCache     = false;
 
         VPHAL_HDR_LUT_MODE globalLutMode      = VPHAL_HDR_LUT_MODE_NONE;  //!< Global LUT mode control for debugging purpose
         bool               gpuGenerate3DLUT   = false;                        //!< Flag for per frame GPU generation of 3DLUT
@@ -115,6 +117,11 @@ public:
     {
         return m_ctrlVal.bDisableOclFcFp;
     }
+
+    bool IsPolicyDecisionCacheVerifyEnabled()
+    {
+        return m_ctrlVal.verifyPolicyDecisionCache;
+    }
 #endif
 
     bool IsSFCLinearOutputByTileConvertEnabled()
@@ -177,6 +184,11 @@ public:
         return m_ctrlVal.enablePacketReuseTeamsAlways;
     }
 
+    bool IsPolicyDecisionCacheDisabled()
+    {
+        return m_ctrlVal.disablePolicyDecisionCache;
+    }
+
     uint32_t GetGlobalLutMode()
     {
         return m_ctrlVal.globalLutMode;
@@ -309,6 +309,8 @@ protected:
 #define __MEDIA_USER_FEATURE_VALUE_DISABLE_PACKET_REUSE                 "Disable PacketReuse"
 #define __MEDIA_USER_FEATURE_VALUE_ENABLE_PACKET_REUSE_TEAMS_ALWAYS     "Enable PacketReuse Teams mode Always"
 #define __MEDIA_USER_FEATURE_VALUE_FORCE_ENABLE_VEBOX_OUTPUT_SURF       "Force Enable Vebox Output Surf"
+#define __MEDIA_USER_FEATURE_VALUE_DISABLE_POLICY_DECISION_CACHE        "Disable VP Policy Decision Cache"
+#define __MEDIA_USER_FEATURE_VALUE_VERIFY_POLICY_DECISION_CACHE         "Verify VP Policy Decision Cache"
 
 #define __VPHAL_HDR_LUT_MODE                                            "HDR Lut Mode"
 #define __VPHAL_HDR_GPU_GENERTATE_3DLUT                                 "HDR GPU generate 3DLUT"
@@ -318,6 +320,8 @@ protected:
 #define __VPHAL_PRIMARY_MMC_COMPRESSMODE                                "VP Primary Surface Compress Mode"
 #define __VPHAL_RT_MMC_COMPRESSMODE                                     "VP RT Compress Mode"
 #define __VPHAL_RT_Cache_Setting                                        "VP RT Cache Setting"
+#define __VPHAL_FC_KERNEL_CACHE_CAPACITY                                "VP FC Kernel Cache Capacity"
+#define __VPHAL_FC_KERNEL_CACHE_DIRECTORY                               "VP FC Kernel Cache Directory"
 
 #if (_DEBUG || _RELEASE_INTERNAL)
 #define __VPHAL_RT_Old_Cache_Setting                                    "VP RT Old Cache Setting"
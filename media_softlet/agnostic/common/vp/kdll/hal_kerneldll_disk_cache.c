@@ -0,0 +1,475 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file      hal_kerneldll_disk_cache.c
+//! \brief     Persistent cache image of dynamically linked FC kernels
+//! \details   Reads, validates, updates and writes back the cache file. It does
+//!            not link kernels, so the ULT tests it without the kernel Dll.
+//!
+
+#include <stdio.h>
+#include <string.h>
+#include "hal_kerneldll_next.h"
+
+#define KDLL_DISK_CACHE_NORMALMESSAGE(_message, ...) \
+    MOS_NORMALMESSAGE(MOS_COMPONENT_VP, MOS_VP_SUBCOMP_RENDER, _message, ##__VA_ARGS__)
+
+//--------------------------------------------------------------
+// KernelDll_DiskCacheHash - Fowler/Noll/Vo FNV-1a hash, continued from dwHash
+//--------------------------------------------------------------
+static uint32_t KernelDll_DiskCacheHash(uint32_t dwHash, const void *pData, uint32_t dwSize)
+{
+    const uint8_t *p = (const uint8_t *)pData;
+
+    for (; dwSize > 0; dwSize--)
+    {
+        dwHash ^= *p++;
+        dwHash *= 0x1000193;
+    }
+
+    return dwHash;
+}
+
+//--------------------------------------------------------------
+// KernelDll_DiskCacheRecordChecksum - Checksum of CSC/patch parameters, filters and kernel binary
+//--------------------------------------------------------------
+static uint32_t KernelDll_DiskCacheRecordChecksum(const Kdll_DiskCacheRecord *pRecord)
+{
+    uint32_t dwPayload = (pRecord->iFilter + pRecord->iFilterSize) * sizeof(Kdll_FilterEntry) + pRecord->iKernelSize;
+    uint32_t dwHash    = 0x811c9dc5;
+
+    dwHash = KernelDll_DiskCacheHash(dwHash, &pRecord->colorfill_cspace, sizeof(pRecord->colorfill_cspace));
+    dwHash = KernelDll_DiskCacheHash(dwHash, &pRecord->CscParams, sizeof(pRecord->CscParams));
+    return KernelDll_DiskCacheHash(dwHash, pRecord + 1, dwPayload);
+}
+
+//--------------------------------------------------------------
+// KernelDll_DiskCacheUsesProcamp - Whether any CSC matrix of the kernel applies procamp
+//--------------------------------------------------------------
+static bool KernelDll_DiskCacheUsesProcamp(const Kdll_CSC_Params *pCscParams)
+{
+    int32_t i;
+
+    for (i = 0; i < DL_CSC_MAX; i++)
+    {
+        if (pCscParams->Matrix[i].bInUse &&
+            pCscParams->Matrix[i].iProcampID != DL_PROCAMP_DISABLED)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------
+// KernelDll_ReserveDiskCache - Make sure the cache image can hold dwSize more bytes
+//--------------------------------------------------------------
+static bool KernelDll_ReserveDiskCache(Kdll_DiskCache *pDiskCache, uint32_t dwSize)
+{
+    uint8_t *pData;
+    uint32_t dwDataMax;
+
+    if (pDiskCache->dwDataSize + dwSize <= pDiskCache->dwDataMax)
+    {
+        return true;
+    }
+
+    if (pDiskCache->dwDataSize + dwSize > DL_DISK_CACHE_MAX_SIZE)
+    {
+        return false;
+    }
+
+    dwDataMax = MOS_MAX(pDiskCache->dwDataMax * 2, pDiskCache->dwDataSize + dwSize);
+    dwDataMax = MOS_MIN(dwDataMax, DL_DISK_CACHE_MAX_SIZE);
+
+    pData = (uint8_t *)MOS_ReallocMemory(pDiskCache->pData, dwDataMax);
+    if (!pData)
+    {
+        return false;
+    }
+
+    pDiskCache->pData     = pData;
+    pDiskCache->dwDataMax = dwDataMax;
+    return true;
+}
+
+//--------------------------------------------------------------
+// KernelDll_FindDiskCacheRecord - Find record matching the search filter
+//--------------------------------------------------------------
+Kdll_DiskCacheRecord *KernelDll_FindDiskCacheRecord(
+    Kdll_DiskCache         *pDiskCache,
+    const Kdll_FilterEntry *pFilter,
+    int32_t                 iFilterSize,
+    uint32_t                dwHash)
+{
+    Kdll_DiskCacheRecord *pRecord;
+    uint32_t              dwOffset;
+
+    if (!pDiskCache->bEnabled)
+    {
+        return nullptr;
+    }
+
+    // Records are only scanned when the kernel is missing from the in-memory
+    // cache, i.e. right before an otherwise full kernel search and build
+    for (dwOffset = sizeof(Kdll_DiskCacheHeader); dwOffset < pDiskCache->dwDataSize; dwOffset += pRecord->dwRecordSize)
+    {
+        pRecord = (Kdll_DiskCacheRecord *)(pDiskCache->pData + dwOffset);
+
+        if (pRecord->dwHash  == dwHash &&
+            pRecord->iFilter == iFilterSize &&
+            memcmp(pRecord + 1, pFilter, iFilterSize * sizeof(Kdll_FilterEntry)) == 0)
+        {
+            return pRecord;
+        }
+    }
+
+    return nullptr;
+}
+
+//--------------------------------------------------------------
+// KernelDll_AddDiskCacheRecord - Append combined kernel to the persistent cache image
+//
+// Kernels using procamp are not stored: their CSC coefficients follow the procamp
+// version of the running process, so they are rebuilt on first use in every run.
+//--------------------------------------------------------------
+bool KernelDll_AddDiskCacheRecord(
+    Kdll_DiskCache         *pDiskCache,
+    const Kdll_CacheEntry  *pCacheEntry,
+    const Kdll_FilterEntry *pFilter,
+    int32_t                 iFilterSize,
+    uint32_t                dwHash)
+{
+    Kdll_DiskCacheRecord *pRecord;
+    uint8_t              *ptr;
+    uint32_t              dwSize;
+
+    if (!pDiskCache->bEnabled || !pCacheEntry || !pCacheEntry->pCscParams)
+    {
+        return false;
+    }
+
+    // Kernel rebuilt - supersede the stale record
+    pRecord = KernelDll_FindDiskCacheRecord(pDiskCache, pFilter, iFilterSize, dwHash);
+    if (pRecord)
+    {
+        pRecord->iFilter   = -1;
+        pDiskCache->bDirty = true;
+    }
+
+    if (KernelDll_DiskCacheUsesProcamp(pCacheEntry->pCscParams))
+    {
+        return false;
+    }
+
+    dwSize = sizeof(Kdll_DiskCacheRecord) +
+             (iFilterSize + pCacheEntry->iFilterSize) * sizeof(Kdll_FilterEntry) +
+             pCacheEntry->iSize;
+    dwSize = MOS_ALIGN_CEIL(dwSize, 8);
+
+    if (!KernelDll_ReserveDiskCache(pDiskCache, dwSize))
+    {
+        KDLL_DISK_CACHE_NORMALMESSAGE("Persistent kernel cache is full, kernel not stored.");
+        return false;
+    }
+
+    pRecord = (Kdll_DiskCacheRecord *)(pDiskCache->pData + pDiskCache->dwDataSize);
+    MOS_ZeroMemory(pRecord, dwSize);
+    pRecord->dwRecordSize     = dwSize;
+    pRecord->dwHash           = dwHash;
+    pRecord->iFilter          = iFilterSize;
+    pRecord->iFilterSize      = pCacheEntry->iFilterSize;
+    pRecord->iKernelSize      = pCacheEntry->iSize;
+    pRecord->colorfill_cspace = pCacheEntry->colorfill_cspace;
+    MOS_SecureMemcpy(&pRecord->CscParams, sizeof(Kdll_CSC_Params), pCacheEntry->pCscParams, sizeof(Kdll_CSC_Params));
+
+    ptr = (uint8_t *)(pRecord + 1);
+    MOS_SecureMemcpy(ptr, iFilterSize * sizeof(Kdll_FilterEntry), pFilter, iFilterSize * sizeof(Kdll_FilterEntry));
+    ptr += iFilterSize * sizeof(Kdll_FilterEntry);
+    MOS_SecureMemcpy(ptr, pCacheEntry->iFilterSize * sizeof(Kdll_FilterEntry), pCacheEntry->pFilter, pCacheEntry->iFilterSize * sizeof(Kdll_FilterEntry));
+    ptr += pCacheEntry->iFilterSize * sizeof(Kdll_FilterEntry);
+    MOS_SecureMemcpy(ptr, pCacheEntry->iSize, pCacheEntry->pBinary, pCacheEntry->iSize);
+
+    pRecord->dwChecksum = KernelDll_DiskCacheRecordChecksum(pRecord);
+
+    pDiskCache->dwDataSize += dwSize;
+    pDiskCache->bDirty      = true;
+    pDiskCache->dwStores++;
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+// KernelDll_OpenDiskCache - Load persistent combined kernel cache file
+//
+// Parameters:
+//    Kdll_DiskCache *pDiskCache - [out] Persistent cache
+//    const char     *szDir      - [in]  Cache directory
+//    uint32_t        dwChecksum - [in]  Checksum of the kernel binaries and linking rules
+//
+// Output: true  - Persistent cache is enabled (file may be empty or missing)
+//         false - Persistent cache is disabled
+//
+// The file name includes the checksum, so each platform and driver build owns its own
+// file. Stale or structurally corrupted files are discarded as a whole, records whose
+// own checksum does not match are dropped and the rest of the file is kept.
+//-----------------------------------------------------------------------------------------
+bool KernelDll_OpenDiskCache(Kdll_DiskCache *pDiskCache, const char *szDir, uint32_t dwChecksum)
+{
+    Kdll_DiskCacheHeader *pHeader;
+    Kdll_DiskCacheRecord *pRecord;
+    FILE                 *pFile;
+    long                  lFileSize;
+    uint32_t              dwOffset;
+    uint32_t              dwRecords;
+    uint32_t              dwRejected;
+    uint32_t              dwPayload;
+
+    if (!pDiskCache)
+    {
+        return false;
+    }
+
+    MOS_ZeroMemory(pDiskCache, sizeof(Kdll_DiskCache));
+    if (!szDir || !szDir[0])
+    {
+        return false;
+    }
+
+    pDiskCache->dwChecksum = dwChecksum;
+    if (MOS_SecureStringPrint(
+            pDiskCache->szPath,
+            sizeof(pDiskCache->szPath),
+            sizeof(pDiskCache->szPath),
+            "%s/vp_fc_kernels_%08x.bin",
+            szDir,
+            dwChecksum) < 0)
+    {
+        KDLL_DISK_CACHE_NORMALMESSAGE("Invalid persistent kernel cache path.");
+        return false;
+    }
+
+    // Start with an empty image, then try to fill it from disk
+    if (!KernelDll_ReserveDiskCache(pDiskCache, sizeof(Kdll_DiskCacheHeader)))
+    {
+        return false;
+    }
+    pDiskCache->dwDataSize = sizeof(Kdll_DiskCacheHeader);
+    pDiskCache->bEnabled   = true;
+
+    pFile = fopen(pDiskCache->szPath, "rb");
+    if (!pFile)
+    {
+        return true;
+    }
+
+    if (fseek(pFile, 0, SEEK_END) != 0 ||
+        (lFileSize = ftell(pFile)) < (long)sizeof(Kdll_DiskCacheHeader) ||
+        lFileSize > DL_DISK_CACHE_MAX_SIZE ||
+        fseek(pFile, 0, SEEK_SET) != 0 ||
+        !KernelDll_ReserveDiskCache(pDiskCache, (uint32_t)lFileSize - sizeof(Kdll_DiskCacheHeader)) ||
+        fread(pDiskCache->pData, 1, (size_t)lFileSize, pFile) != (size_t)lFileSize)
+    {
+        fclose(pFile);
+        KDLL_DISK_CACHE_NORMALMESSAGE("Discarding unreadable persistent kernel cache %s.", pDiskCache->szPath);
+        return true;
+    }
+    fclose(pFile);
+
+    pHeader = (Kdll_DiskCacheHeader *)pDiskCache->pData;
+    if (pHeader->dwMagic           != DL_DISK_CACHE_MAGIC      ||
+        pHeader->dwVersion         != DL_DISK_CACHE_VERSION    ||
+        pHeader->dwChecksum        != pDiskCache->dwChecksum   ||
+        pHeader->dwFilterEntrySize != sizeof(Kdll_FilterEntry) ||
+        pHeader->dwCscParamsSize   != sizeof(Kdll_CSC_Params))
+    {
+        KDLL_DISK_CACHE_NORMALMESSAGE("Discarding stale persistent kernel cache %s.", pDiskCache->szPath);
+        return true;
+    }
+
+    // Validate the layout of all records before accepting any of them
+    dwRecords  = 0;
+    dwRejected = 0;
+    for (dwOffset = sizeof(Kdll_DiskCacheHeader); dwOffset < (uint32_t)lFileSize; dwOffset += pRecord->dwRecordSize)
+    {
+        if ((uint32_t)lFileSize - dwOffset < sizeof(Kdll_DiskCacheRecord))
+        {
+            break;
+        }
+
+        pRecord = (Kdll_DiskCacheRecord *)(pDiskCache->pData + dwOffset);
+        if (pRecord->iFilter     <= 0 || pRecord->iFilter     > DL_MAX_SEARCH_FILTER_SIZE ||
+            pRecord->iFilterSize <= 0 || pRecord->iFilterSize > DL_MAX_SEARCH_FILTER_SIZE ||
+            pRecord->iKernelSize <= 0 || pRecord->iKernelSize > DL_MAX_KERNEL_SIZE)
+        {
+            break;
+        }
+
+        dwPayload = sizeof(Kdll_DiskCacheRecord) +
+                    (pRecord->iFilter + pRecord->iFilterSize) * sizeof(Kdll_FilterEntry) +
+                    pRecord->iKernelSize;
+        if (pRecord->dwRecordSize != MOS_ALIGN_CEIL(dwPayload, 8) ||
+            pRecord->dwRecordSize > (uint32_t)lFileSize - dwOffset)
+        {
+            break;
+        }
+
+        dwRecords++;
+    }
+
+    if (dwOffset != (uint32_t)lFileSize || dwRecords != pHeader->dwRecords)
+    {
+        KDLL_DISK_CACHE_NORMALMESSAGE("Discarding corrupted persistent kernel cache %s.", pDiskCache->szPath);
+        return true;
+    }
+
+    // A kernel or patch data mismatch only drops that record, it is removed on the next write
+    for (dwOffset = sizeof(Kdll_DiskCacheHeader); dwOffset < (uint32_t)lFileSize; dwOffset += pRecord->dwRecordSize)
+    {
+        pRecord = (Kdll_DiskCacheRecord *)(pDiskCache->pData + dwOffset);
+        if (pRecord->dwChecksum != KernelDll_DiskCacheRecordChecksum(pRecord) ||
+            KernelDll_DiskCacheUsesProcamp(&pRecord->CscParams))
+        {
+            pRecord->iFilter   = -1;
+            pDiskCache->bDirty = true;
+            dwRejected++;
+        }
+    }
+
+    pDiskCache->dwDataSize = (uint32_t)lFileSize;
+    KDLL_DISK_CACHE_NORMALMESSAGE("Loaded %d kernels from persistent kernel cache %s, %d rejected.",
+        dwRecords - dwRejected, pDiskCache->szPath, dwRejected);
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+// KernelDll_WriteDiskCache - Write persistent combined kernel cache back to disk
+//
+// Parameters:
+//    Kdll_DiskCache *pDiskCache - [in] Persistent cache
+//
+// Output: true  - Cache file is up to date
+//         false - Failed to write the cache file
+//
+// The image is written to a temporary file private to this process and cache, which
+// is then renamed over the cache file. Concurrent writers, including several kernel
+// Dll states of one process, never share a file, and readers never observe a
+// partially written one; the last writer wins.
+//-----------------------------------------------------------------------------------------
+bool KernelDll_WriteDiskCache(Kdll_DiskCache *pDiskCache)
+{
+    Kdll_DiskCacheHeader *pHeader;
+    Kdll_DiskCacheRecord *pRecord;
+    char                  szTmpPath[DL_DISK_CACHE_PATH_LENGTH + 48];
+    FILE                 *pFile;
+    uint32_t              dwOffset;
+    uint32_t              dwCompact;
+    uint32_t              dwRecordSize;
+    uint32_t              dwRecords;
+    bool                  bWritten;
+
+    if (!pDiskCache || !pDiskCache->bEnabled)
+    {
+        return false;
+    }
+
+    if (!pDiskCache->bDirty)
+    {
+        return true;
+    }
+
+    // Drop superseded and rejected records
+    dwRecords = 0;
+    dwCompact = sizeof(Kdll_DiskCacheHeader);
+    for (dwOffset = sizeof(Kdll_DiskCacheHeader); dwOffset < pDiskCache->dwDataSize; dwOffset += dwRecordSize)
+    {
+        pRecord      = (Kdll_DiskCacheRecord *)(pDiskCache->pData + dwOffset);
+        dwRecordSize = pRecord->dwRecordSize;
+        if (pRecord->iFilter < 0)
+        {
+            continue;
+        }
+
+        if (dwCompact != dwOffset)
+        {
+            memmove(pDiskCache->pData + dwCompact, pRecord, dwRecordSize);
+        }
+        dwCompact += dwRecordSize;
+        dwRecords++;
+    }
+    pDiskCache->dwDataSize = dwCompact;
+
+    pHeader                    = (Kdll_DiskCacheHeader *)pDiskCache->pData;
+    pHeader->dwMagic           = DL_DISK_CACHE_MAGIC;
+    pHeader->dwVersion         = DL_DISK_CACHE_VERSION;
+    pHeader->dwChecksum        = pDiskCache->dwChecksum;
+    pHeader->dwRecords         = dwRecords;
+    pHeader->dwFilterEntrySize = sizeof(Kdll_FilterEntry);
+    pHeader->dwCscParamsSize   = sizeof(Kdll_CSC_Params);
+
+    if (MOS_SecureStringPrint(
+            szTmpPath,
+            sizeof(szTmpPath),
+            sizeof(szTmpPath),
+            "%s.%d.%p.tmp",
+            pDiskCache->szPath,
+            MosUtilities::MosGetPid(),
+            (void *)pDiskCache) < 0)
+    {
+        return false;
+    }
+
+    pFile = fopen(szTmpPath, "wb");
+    if (!pFile)
+    {
+        KDLL_DISK_CACHE_NORMALMESSAGE("Failed to create persistent kernel cache %s.", szTmpPath);
+        return false;
+    }
+
+    bWritten = (fwrite(pDiskCache->pData, 1, pDiskCache->dwDataSize, pFile) == pDiskCache->dwDataSize);
+    bWritten = (fclose(pFile) == 0) && bWritten;
+
+    if (!bWritten || rename(szTmpPath, pDiskCache->szPath) != 0)
+    {
+        KDLL_DISK_CACHE_NORMALMESSAGE("Failed to write persistent kernel cache %s.", pDiskCache->szPath);
+        remove(szTmpPath);
+        return false;
+    }
+
+    pDiskCache->bDirty = false;
+    return true;
+}
+
+//--------------------------------------------------------------
+// KernelDll_CloseDiskCache - Release the persistent cache image
+//--------------------------------------------------------------
+void KernelDll_CloseDiskCache(Kdll_DiskCache *pDiskCache)
+{
+    if (!pDiskCache)
+    {
+        return;
+    }
+
+    MOS_FreeMemory(pDiskCache->pData);
+    MOS_ZeroMemory(pDiskCache, sizeof(Kdll_DiskCache));
+}
@@ -69,10 +69,9 @@
 extern "C" {
 #endif  // __cplusplus
 
-#define FOLD_HASH(folded_hash, hash)                                   \
+#define HASH_BUCKET(bucket, hash, size)                                \
     {                                                                  \
-        folded_hash = (((hash) >> 8) ^ (hash)) & 0x00ff00ff;           \
-        folded_hash = ((folded_hash >> 16) ^ folded_hash) & 0xff;      \
+        bucket = (((hash) >> 16) ^ (hash)) & ((size) - 1);             \
     }                                                                  \
 
 const bool g_cIsFormatYUV[Format_Count] =
@@ -1227,6 +1226,83 @@ uint32_t KernelDll_SimpleHash(void *pData, int32_t iSize)
    return hash;
 }
 
+static Kdll_CacheEntry *KernelDll_StoreKernel(
+    Kdll_State             *pState,
+    const uint8_t          *pKernel,
+    int32_t                 iKernelSize,
+    const Kdll_FilterEntry *pModifiedFilter,
+    int32_t                 iModifiedFilterSize,
+    const Kdll_CSC_Params  *pCscParams,
+    MEDIA_CSPACE            colorfill_cspace,
+    Kdll_FilterEntry       *pFilter,
+    int32_t                 iFilterSize,
+    uint32_t                dwHash);
+
+static Kdll_CacheEntry *KernelDll_RestoreKernelFromDiskCache(
+    Kdll_State       *pState,
+    Kdll_FilterEntry *pFilter,
+    int32_t           iFilterSize,
+    uint32_t          dwHash);
+
+static bool KernelDll_ExtendHashTable(Kdll_KernelHashTable *pHashTable);
+
+//--------------------------------------------------------------
+// KernelDll_UnlinkCacheEntry - Remove combined kernel from the LRU list
+//--------------------------------------------------------------
+static void KernelDll_UnlinkCacheEntry(Kdll_KernelCache *pCache, Kdll_CacheEntry *pEntry)
+{
+    if (pEntry->pLruPrev)
+    {
+        pEntry->pLruPrev->pLruNext = pEntry->pLruNext;
+    }
+    else
+    {
+        pCache->pLruHead = pEntry->pLruNext;
+    }
+
+    if (pEntry->pLruNext)
+    {
+        pEntry->pLruNext->pLruPrev = pEntry->pLruPrev;
+    }
+    else
+    {
+        pCache->pLruTail = pEntry->pLruPrev;
+    }
+
+    pEntry->pLruPrev = nullptr;
+    pEntry->pLruNext = nullptr;
+}
+
+//--------------------------------------------------------------
+// KernelDll_LinkCacheEntry - Insert combined kernel as most recently used
+//--------------------------------------------------------------
+static void KernelDll_LinkCacheEntry(Kdll_KernelCache *pCache, Kdll_CacheEntry *pEntry)
+{
+    pEntry->pLruPrev = nullptr;
+    pEntry->pLruNext = pCache->pLruHead;
+    if (pCache->pLruHead)
+    {
+        pCache->pLruHead->pLruPrev = pEntry;
+    }
+    else
+    {
+        pCache->pLruTail = pEntry;
+    }
+    pCache->pLruHead = pEntry;
+}
+
+//--------------------------------------------------------------
+// KernelDll_TouchCacheEntry - Mark combined kernel as most recently used
+//--------------------------------------------------------------
+static void KernelDll_TouchCacheEntry(Kdll_KernelCache *pCache, Kdll_CacheEntry *pEntry)
+{
+    if (pCache->pLruHead != pEntry)
+    {
+        KernelDll_UnlinkCacheEntry(pCache, pEntry);
+        KernelDll_LinkCacheEntry(pCache, pEntry);
+    }
+}
+
 //--------------------------------------------------------------
 // KernelDll_GetCombinedKernel - Search combined kernel
 //--------------------------------------------------------------
@@ -1237,26 +1313,29 @@ Kdll_CacheEntry *KernelDll_GetCombinedKernel(
     uint32_t            dwHash)
 {
     Kdll_KernelHashTable *pHashTable;
-    Kdll_KernelHashEntry *entries, *curr, *next;
-    uint32_t folded_hash;
+    Kdll_KernelCache     *pCache;
+    Kdll_KernelHashEntry *entries, *curr = nullptr;
+    uint32_t bucket;
     uint16_t entry;
 
     VP_RENDER_FUNCTION_ENTER;
 
     // Get hash table
     pHashTable = &pState->KernelHashTable;
+    pCache     = &pState->KernelCache;
 
-    // fold hash from 32 to 8 bit :-)
-    FOLD_HASH(folded_hash, dwHash)
-
-    // No entries
-    entry = pHashTable->wHashTable[folded_hash];
-    if (entry == 0 || entry > DL_MAX_COMBINED_KERNELS ) return nullptr;
+    entry = 0;
+    if (pHashTable->iHashSize > 0)
+    {
+        HASH_BUCKET(bucket, dwHash, pHashTable->iHashSize)
+        entry = pHashTable->wHashTable[bucket];
+    }
 
-    entries = (&pHashTable->HashEntry[0]) - 1;  // all indices are 1 based (0 means null)
-    curr    = &entries[entry];
-    for (; (curr != nullptr); curr = next)
+    entries = pHashTable->HashEntry - 1;  // all indices are 1 based (0 means null)
+    for (; entry != 0; entry = curr->next)
     {
+        curr = &entries[entry];
+
         // match 32-bit hash, then compare filter
         if (curr->dwHash  == dwHash &&
             curr->iFilter == iFilterSize)
@@ -1266,19 +1345,18 @@ Kdll_CacheEntry *KernelDll_GetCombinedKernel(
                 break;
             }
         }
-
-        // Next entry with the same 8-bit folded hash
-        next = (curr->next) ? (&entries[curr->next]) : nullptr;
     }
 
-    if (curr)
+    if (entry)
     {   // Kernel already cached
-        curr->pCacheEntry->dwRefresh = pState->dwRefresh++;
+        pCache->dwHits++;
+        KernelDll_TouchCacheEntry(pCache, curr->pCacheEntry);
         return (curr->pCacheEntry);
     }
     else
-    {   // Kernel must be built
-        return nullptr;
+    {   // Kernel must be built, unless it was persisted by a previous run
+        pCache->dwMisses++;
+        return KernelDll_RestoreKernelFromDiskCache(pState, pFilter, iFilterSize, dwHash);
     }
 }
 
@@ -3421,8 +3499,6 @@ Kdll_State *KernelDll_AllocateStates(
     Kdll_State *          pState;
     Kdll_CacheEntry *     pCacheEntry;
     Kdll_KernelCache *    pKernelCache;
-    Kdll_KernelHashTable *pHashTable;
-    Kdll_KernelHashEntry *pHashEntries;
 
     int32_t              iSize;
     int32_t              nExports    = 0;
@@ -3455,7 +3531,6 @@ Kdll_State *KernelDll_AllocateStates(
         goto cleanup;
     }
     pState->iSize        = i;
-    pState->dwRefresh    = 0;
     pState->pProcamp     = nullptr;
     pState->iProcampSize = 0;
     pState->pSortedRules = nullptr;
@@ -3501,7 +3576,6 @@ Kdll_State *KernelDll_AllocateStates(
         pCacheEntry->iKUID      = i;
         pCacheEntry->iKCID      = -1;
         pCacheEntry->dwLoaded   = 0;
-        pCacheEntry->dwRefresh  = 0;
         pCacheEntry->wHashEntry = 0;
         pCacheEntry->szName     = g_cInit_ComponentNames[i];
         pCacheEntry->iSize      = pOffsets[i + 1] - pOffsets[i];
@@ -3527,7 +3601,6 @@ Kdll_State *KernelDll_AllocateStates(
             pCacheEntry->iKUID      = i;
             pCacheEntry->iKCID      = -1;
             pCacheEntry->dwLoaded   = 0;
-            pCacheEntry->dwRefresh  = 0;
             pCacheEntry->wHashEntry = 0;
             pCacheEntry->szName     = g_cInit_ComponentNames[i];
             pCacheEntry->iSize      = pOffsets[i + 1] - pOffsets[i];
@@ -3543,11 +3616,13 @@ Kdll_State *KernelDll_AllocateStates(
     pKernelCache                   = &pState->KernelCache;
     pKernelCache->iCacheMaxEntries = DL_DEFAULT_COMBINED_KERNELS;
     pKernelCache->iCacheEntries    = 0;
+    pKernelCache->iCacheLimit      = DL_MAX_COMBINED_KERNELS;
     pKernelCache->iCacheSize       = DL_COMBINED_KERNEL_CACHE_SIZE;                           // Size of kernel cache
     pKernelCache->iCacheFree       = DL_COMBINED_KERNEL_CACHE_SIZE;                           // Free cache size
     pKernelCache->iCacheID         = 0x00010000;                                              // Cache ID
     pKernelCache->pCacheEntries    = pCacheEntry;                                             // Cached kernel entries
     pKernelCache->pCache           = (uint8_t *)(pCacheEntry + DL_DEFAULT_COMBINED_KERNELS);  // kernels
+    pKernelCache->pFreeEntries     = pCacheEntry;                                             // All entries are free
 
     // reset cache entries
     for (i = 0; i < DL_DEFAULT_COMBINED_KERNELS; i++, pCacheEntry++)
@@ -3558,27 +3633,23 @@ Kdll_State *KernelDll_AllocateStates(
         if (i != DL_DEFAULT_COMBINED_KERNELS - 1)
         {
             pCacheEntry->pNextEntry = pCacheEntry + 1;
+            pCacheEntry->pLruPrev   = pCacheEntry + 1;
         }
         else
         {
             pCacheEntry->pNextEntry = nullptr;
+            pCacheEntry->pLruPrev   = nullptr;
         }
     }
 
     //------------------------------------
     // Setup hash table
     //------------------------------------
-    pHashTable   = &pState->KernelHashTable;
-    pHashEntries = pState->KernelHashTable.HashEntry - 1;
-
-    pHashTable->pool = 1;                        // first in pool (1 based index)
-    pHashTable->last = DL_MAX_COMBINED_KERNELS;  // last in pool (for releasing)
-
-    for (i = 1; i <= DL_MAX_COMBINED_KERNELS; i++)
+    if (!KernelDll_ExtendHashTable(&pState->KernelHashTable))
     {
-        pHashEntries[i].next = i + 1;
+        VP_RENDER_ASSERTMESSAGE("Failed to allocate kernel hash table.");
+        goto cleanup;
     }
-    pHashEntries[i - 1].next = 0;  // last entry
 
     //------------------------------------
     // Setup dynamic linking import/export array
@@ -3680,6 +3751,8 @@ cleanup:
     if (pState)
     {
         MOS_FreeMemory(pState->pSortedRules);
+        MOS_FreeMemory(pState->KernelHashTable.wHashTable);
+        MOS_FreeMemory(pState->KernelHashTable.HashEntry);
         pState->pSortedRules = nullptr;
     }
 
@@ -3725,7 +3798,24 @@ void KernelDll_ReleaseStates(Kdll_State *pState)
 
     if (!pState)
         return;
+    if (pState->DiskCache.bEnabled)
+    {
+        VP_RENDER_NORMALMESSAGE("Persistent kernel cache: %d hits, %d misses, %d stores.",
+            pState->DiskCache.dwHits,
+            pState->DiskCache.dwMisses,
+            pState->DiskCache.dwStores);
+        KernelDll_SaveDiskCache(pState);
+        KernelDll_CloseDiskCache(&pState->DiskCache);
+    }
+    VP_RENDER_NORMALMESSAGE("Combined kernel cache: %d hits, %d misses, %d evictions, %d/%d entries.",
+        pState->KernelCache.dwHits,
+        pState->KernelCache.dwMisses,
+        pState->KernelCache.dwEvictions,
+        pState->KernelCache.iCacheEntries,
+        pState->KernelCache.iCacheLimit);
     KernelDll_ReleaseAdditionalCacheEntries(&pState->KernelCache);
+    MOS_FreeMemory(pState->KernelHashTable.wHashTable);
+    MOS_FreeMemory(pState->KernelHashTable.HashEntry);
     MOS_FreeMemory(pState->ComponentKernelCache.pCache);
     MOS_FreeMemory(pState->CmFcPatchCache.pCache);
     MOS_FreeMemory(pState->pSortedRules);
@@ -4069,27 +4159,100 @@ finish:
     return res;
 }
 
+//--------------------------------------------------------------
+// KernelDll_ExtendHashTable - Double the number of hash entries and buckets
+//--------------------------------------------------------------
+static bool KernelDll_ExtendHashTable(Kdll_KernelHashTable *pHashTable)
+{
+    Kdll_KernelHashEntry *pNewEntries;
+    Kdll_KernelHashEntry *pHashEntry;
+    uint16_t *pNewBuckets;
+    uint32_t bucket;
+    int32_t iPrevSize, iNewSize;
+    int32_t i;
+
+    VP_RENDER_FUNCTION_ENTER;
+
+    iPrevSize = pHashTable->iHashSize;
+    iNewSize  = (iPrevSize) ? (iPrevSize * 2) : DL_INITIAL_HASH_ENTRIES;
+    if (iNewSize > DL_MAX_COMBINED_KERNELS_LIMIT)
+    {
+        return false;
+    }
+
+    pNewEntries = (Kdll_KernelHashEntry *)MOS_AllocAndZeroMemory(iNewSize * sizeof(Kdll_KernelHashEntry));
+    pNewBuckets = (uint16_t *)MOS_AllocAndZeroMemory(iNewSize * sizeof(uint16_t));
+    if (!pNewEntries || !pNewBuckets)
+    {
+        MOS_FreeMemory(pNewEntries);
+        MOS_FreeMemory(pNewBuckets);
+        return false;
+    }
+
+    // Transfer the hash entries to the larger table, rehash the entries in use
+    if (iPrevSize)
+    {
+        MOS_SecureMemcpy(pNewEntries, iNewSize * sizeof(Kdll_KernelHashEntry), pHashTable->HashEntry, iPrevSize * sizeof(Kdll_KernelHashEntry));
+    }
+
+    pHashEntry = pNewEntries - 1;  // all indices are 1 based (0 = null)
+    for (i = 1; i <= iPrevSize; i++)
+    {
+        if (pHashEntry[i].pCacheEntry)
+        {
+            HASH_BUCKET(bucket, pHashEntry[i].dwHash, iNewSize);
+            pHashEntry[i].next   = pNewBuckets[bucket];
+            pNewBuckets[bucket]  = (uint16_t)i;
+        }
+    }
+
+    // Chain the new entries, append them to the pool
+    for (i = iPrevSize + 1; i < iNewSize; i++)
+    {
+        pHashEntry[i].next = (uint16_t)(i + 1);
+    }
+    pHashEntry[iNewSize].next = 0;  // last entry
+
+    if (pHashTable->pool == 0)
+    {
+        pHashTable->pool = (uint16_t)(iPrevSize + 1);
+    }
+    else
+    {
+        pHashEntry[pHashTable->last].next = (uint16_t)(iPrevSize + 1);
+    }
+    pHashTable->last = (uint16_t)iNewSize;
+
+    MOS_FreeMemory(pHashTable->HashEntry);
+    MOS_FreeMemory(pHashTable->wHashTable);
+    pHashTable->HashEntry  = pNewEntries;
+    pHashTable->wHashTable = pNewBuckets;
+    pHashTable->iHashSize  = iNewSize;
+
+    return true;
+}
+
 //--------------------------------------------------------------
 // KernelDll_AllocateHashEntry - Allocate hash entry
 //--------------------------------------------------------------
 uint16_t KernelDll_AllocateHashEntry(Kdll_KernelHashTable *pHashTable,
                                  uint32_t              hash)
 {
-    Kdll_KernelHashEntry *pHashEntry = &pHashTable->HashEntry[0] - 1;
     Kdll_KernelHashEntry *pNewEntry;
-    uint32_t folded_hash;
+    uint32_t bucket;
     uint16_t entry;
 
     VP_RENDER_FUNCTION_ENTER;
 
-    entry = pHashTable->pool;
-    if (!entry)
+    // Grow the table (entries and buckets) when the pool is exhausted
+    if (!pHashTable->pool && !KernelDll_ExtendHashTable(pHashTable))
     {
         return 0;
     }
+    entry = pHashTable->pool;
 
     // Get entry from pool
-    pNewEntry = &pHashEntry[entry];
+    pNewEntry = &pHashTable->HashEntry[entry - 1];
     pHashTable->pool = pNewEntry->next;
     if (pHashTable->last == entry)
     {
@@ -4097,13 +4260,13 @@ uint16_t KernelDll_AllocateHashEntry(Kdll_KernelHashTable *pHashTable,
     }
 
     // Initialize entry, attach to the hash table
-    FOLD_HASH(folded_hash, hash);
+    HASH_BUCKET(bucket, hash, pHashTable->iHashSize);
     pNewEntry->dwHash      = hash;
-    pNewEntry->next        = pHashTable->wHashTable[folded_hash];
+    pNewEntry->next        = pHashTable->wHashTable[bucket];
     pNewEntry->iFilter     = 0;
     pNewEntry->pFilter     = nullptr;
     pNewEntry->pCacheEntry = nullptr;
-    pHashTable->wHashTable[folded_hash] = entry;
+    pHashTable->wHashTable[bucket] = entry;
     return entry;
 }
 
@@ -4113,67 +4276,35 @@ uint16_t KernelDll_AllocateHashEntry(Kdll_KernelHashTable *pHashTable,
 bool KernelDll_GarbageCollection(Kdll_State *pState, int32_t size)
 {
     Kdll_KernelCache     *pCache     = &pState->KernelCache;
-    Kdll_CacheEntry      *pEntry     = pCache->pCacheEntries;
-    Kdll_CacheEntry      *pOldest    = nullptr;
     Kdll_KernelHashTable *pHashTable = &pState->KernelHashTable;
-    Kdll_KernelHashEntry *pHashEntry = &pHashTable->HashEntry[0] - 1;
-    uint32_t              dwOldest   = (uint32_t)-1;
-    uint16_t              wEntry     = 0;
-    int32_t i;
+    Kdll_CacheEntry      *pOldest;
+    uint16_t              wEntry;
 
     MOS_UNUSED(size);
 
     VP_RENDER_FUNCTION_ENTER;
 
-    // Adjust refresh values to avoid overflow
-    if (pState->dwRefresh > 0xffff0000)
+    // Evict least recently used kernels that are not loaded until there is room for a new one
+    while (pCache->iCacheEntries >= pCache->iCacheLimit)
     {
-        pState->dwRefresh -= 0x80000000;
-        for (i = pCache->iCacheMaxEntries; i > 0; i--)
-        {
-            if (pEntry->dwRefresh < 0x80000000)
-                pEntry->dwRefresh = 0;
-            else
-                pEntry->dwRefresh -= 0x80000000;
-            pEntry = pEntry->pNextEntry;
-        }
-    }
-
-    // No need to deallocate old entries
-    if (pCache->iCacheEntries < DL_MAX_COMBINED_KERNELS)
-    {
-        return true;
-    }
+        for (pOldest = pCache->pLruTail; pOldest && pOldest->dwLoaded; pOldest = pOldest->pLruPrev);
 
-    for (i = pCache->iCacheMaxEntries; i > 0; i--)
-    {
-        // deallocate old unreferenced entries
-        if (pEntry->iKCID != -1 && pEntry->dwLoaded == 0)
+        // No entry to release, sanity checks
+        wEntry = (pOldest) ? pOldest->wHashEntry : 0;
+        if (wEntry == 0 ||
+            wEntry > pHashTable->iHashSize ||
+            pHashTable->HashEntry[wEntry - 1].pCacheEntry != pOldest)
         {
-            if (pEntry->dwRefresh < dwOldest)
-            {
-                pOldest  = pEntry;
-                dwOldest = pEntry->dwRefresh;
-                wEntry   = pEntry->wHashEntry;
-            }
+            VP_RENDER_ASSERT(false);
+            return false;
         }
-        pEntry = pEntry->pNextEntry;
-    }
 
-    // No entry to release, sanity checks
-    pHashEntry += wEntry;
-    if (!pOldest ||
-        wEntry == 0 ||
-        pHashEntry->pCacheEntry != pOldest)
-    {
-        VP_RENDER_ASSERT(false);
-        return false;
+        // Release hash and cache entries
+        KernelDll_ReleaseHashEntry(pHashTable, wEntry);
+        KernelDll_ReleaseCacheEntry(pCache, pOldest);
+        pCache->dwEvictions++;
     }
 
-    // Release hash and cache entries
-    KernelDll_ReleaseHashEntry(pHashTable, wEntry);
-    KernelDll_ReleaseCacheEntry(pCache, pOldest);
-
     return true;
 }
 
@@ -4183,10 +4314,9 @@ bool KernelDll_GarbageCollection(Kdll_State *pState, int32_t size)
 Kdll_CacheEntry *
 KernelDll_AllocateCacheEntry(Kdll_KernelCache *pCache, int32_t iSize)
 {
-    Kdll_CacheEntry *pEntry          = pCache->pCacheEntries;
+    Kdll_CacheEntry *pEntry          = nullptr;
     uint8_t *pCacheBinary               = nullptr;
     Kdll_CacheEntry *pCacheNextEntry = nullptr;
-    int32_t i, j;
 
     VP_RENDER_FUNCTION_ENTER;
 
@@ -4196,25 +4326,14 @@ KernelDll_AllocateCacheEntry(Kdll_KernelCache *pCache, int32_t iSize)
         return nullptr;
     }
 
-    // Search empty entry
-    j = pCache->iCacheMaxEntries;
-    for (i = 0; i < j; i++)
-    {
-        if (pEntry->iKCID == -1)
-        {
-            break;
-        }
-        pEntry = pEntry->pNextEntry;
-    }
-    if (i == j)
+    // Get empty entry, try to allocate more cache entries if none is left
+    if (!pCache->pFreeEntries &&
+        !KernelDll_AllocateAdditionalCacheEntries(pCache))
     {
-        // Try to allocate more cache entries
-        pEntry = KernelDll_AllocateAdditionalCacheEntries(pCache);
-        if(! pEntry)
-        {
-            return nullptr;
-        }
+        return nullptr;
     }
+    pEntry               = pCache->pFreeEntries;
+    pCache->pFreeEntries = pEntry->pLruPrev;
 
     // Reset entry
     pCacheBinary    = pEntry->pBinary;
@@ -4224,6 +4343,9 @@ KernelDll_AllocateCacheEntry(Kdll_KernelCache *pCache, int32_t iSize)
     pEntry->pBinary    = pCacheBinary;
     pEntry->pNextEntry = pCacheNextEntry;
 
+    // New kernel is the most recently used
+    KernelDll_LinkCacheEntry(pCache, pEntry);
+
     // Increment entries
     pCache->iCacheEntries++;
     return pEntry;
@@ -4242,7 +4364,7 @@ KernelDll_AllocateAdditionalCacheEntries(Kdll_KernelCache *pCache)
     VP_RENDER_FUNCTION_ENTER;
 
     // Check num
-    if (pCache->iCacheEntries + DL_NEW_COMBINED_KERNELS > DL_MAX_COMBINED_KERNELS)
+    if (pCache->iCacheMaxEntries + DL_NEW_COMBINED_KERNELS > pCache->iCacheLimit)
     {
         VP_RENDER_ASSERTMESSAGE("KernelDll_AllocateAdditionalCacheEntries: Can't allocate more kernel cache entries\n");
         return nullptr;
@@ -4272,28 +4394,56 @@ KernelDll_AllocateAdditionalCacheEntries(Kdll_KernelCache *pCache)
         if(j != DL_NEW_COMBINED_KERNELS - 1)
         {
             pNewEntry->pNextEntry = pNewEntry + 1;
+            pNewEntry->pLruPrev   = pNewEntry + 1;
         }
         else
         {
             pNewEntry->pNextEntry = nullptr;
+            pNewEntry->pLruPrev   = pCache->pFreeEntries;
         }
     }
 
     pCache->iCacheMaxEntries += DL_NEW_COMBINED_KERNELS;
     pCache->iCacheSize       += DL_NEW_COMBINED_KERNELS * DL_CACHE_BLOCK_SIZE;
     pCache->iCacheFree       += DL_NEW_COMBINED_KERNELS * DL_CACHE_BLOCK_SIZE;
+    pCache->pFreeEntries      = pNewEntry - DL_NEW_COMBINED_KERNELS;
     return (Kdll_CacheEntry *)(pNewEntry - DL_NEW_COMBINED_KERNELS);
 }
 
 //--------------------------------------------------------------
-// KernelDll_AddKernel - Add kernel into hash table and kernel cache
+// KernelDll_SetCombinedKernelCacheCapacity - Set max number of combined kernels kept in cache
 //--------------------------------------------------------------
-Kdll_CacheEntry *
-KernelDll_AddKernel(Kdll_State       *pState,           // Kernel Dll state
-                    Kdll_SearchState *pSearchState,     // Search state
-                    Kdll_FilterEntry *pFilter,          // Original filter
-                    int32_t           iFilterSize,      // Original filter size
-                    uint32_t          dwHash)
+void KernelDll_SetCombinedKernelCacheCapacity(Kdll_State *pState, int32_t iMaxKernels)
+{
+    VP_RENDER_FUNCTION_ENTER;
+
+    if (!pState)
+    {
+        return;
+    }
+
+    // Cache grows in blocks of DL_NEW_COMBINED_KERNELS entries
+    iMaxKernels = MOS_MAX(iMaxKernels, DL_DEFAULT_COMBINED_KERNELS);
+    iMaxKernels = MOS_MIN(iMaxKernels, DL_MAX_COMBINED_KERNELS_LIMIT);
+    iMaxKernels = MOS_ALIGN_CEIL(iMaxKernels, DL_NEW_COMBINED_KERNELS);
+
+    pState->KernelCache.iCacheLimit = iMaxKernels;
+}
+
+//--------------------------------------------------------------
+// KernelDll_StoreKernel - Store kernel and metadata into kernel cache and hash table
+//--------------------------------------------------------------
+static Kdll_CacheEntry *KernelDll_StoreKernel(
+    Kdll_State             *pState,                 // Kernel Dll state
+    const uint8_t          *pKernel,                // Combined kernel binary
+    int32_t                 iKernelSize,            // Combined kernel size
+    const Kdll_FilterEntry *pModifiedFilter,        // Modified filter (used for rendering)
+    int32_t                 iModifiedFilterSize,    // Modified filter size
+    const Kdll_CSC_Params  *pCscParams,             // CSC parameters associated with the kernel
+    MEDIA_CSPACE            colorfill_cspace,       // Intermediate color space for colorfill
+    Kdll_FilterEntry       *pFilter,                // Original filter
+    int32_t                 iFilterSize,            // Original filter size
+    uint32_t                dwHash)
 {
     Kdll_CacheEntry      *pCacheEntry;
     Kdll_KernelHashTable *pHashTable;
@@ -4302,21 +4452,18 @@ KernelDll_AddKernel(Kdll_State       *pState,           // Kernel Dll state
     int32_t size;
     uint8_t *ptr;
 
-    VP_RENDER_FUNCTION_ENTER;
-
     // Check kernel
-    if (pSearchState->KernelSize <= 0)
+    if (iKernelSize <= 0)
     {
         return nullptr;
     }
 
     // Get hash table
     pHashTable = &pState->KernelHashTable;
-    pHashEntry = &pHashTable->HashEntry[0] - 1;  // all indices are 1 based (0 = null)
 
     // allocate space in kernel cache to store the kernel, filter, CSC parameters
-    size  = pSearchState->KernelSize +                                  // Kernel
-            pSearchState->iFilterSize * sizeof(Kdll_FilterEntry) * 2 +  // Original + Modified Filter
+    size  = iKernelSize +                                                // Kernel
+            (iModifiedFilterSize + iFilterSize) * sizeof(Kdll_FilterEntry) +  // Original + Modified Filter
             sizeof(Kdll_CSC_Params) +                                   // CSC parameters
             sizeof(VPHAL_CSPACE);                                       // Intermediate Color Space for colorfill
 
@@ -4343,33 +4490,32 @@ KernelDll_AddKernel(Kdll_State       *pState,           // Kernel Dll state
     // Setup cache entry, copy kernel
     pCacheEntry->iKUID       = -1;
     pCacheEntry->iKCID       = pState->KernelCache.iCacheID;  // Create new kernel cache id (KCID)
-    pCacheEntry->dwRefresh   = pState->dwRefresh++;
     pCacheEntry->wHashEntry  = entry;
 
     // Save kernel
-    pCacheEntry->iSize = pSearchState->KernelSize;
-    MOS_SecureMemcpy(pCacheEntry->pBinary, pSearchState->KernelSize, (void *)pSearchState->Kernel, pSearchState->KernelSize);
-    ptr = pCacheEntry->pBinary + pSearchState->KernelSize;
+    pCacheEntry->iSize = iKernelSize;
+    MOS_SecureMemcpy(pCacheEntry->pBinary, iKernelSize, (void *)pKernel, iKernelSize);
+    ptr = pCacheEntry->pBinary + iKernelSize;
 
     // Save modified filter
-    pCacheEntry->iFilterSize = pSearchState->iFilterSize;
+    pCacheEntry->iFilterSize = iModifiedFilterSize;
     pCacheEntry->pFilter     = (Kdll_FilterEntry *) (ptr);
-    MOS_SecureMemcpy(ptr, pSearchState->iFilterSize * sizeof(Kdll_FilterEntry), (void *)pSearchState->Filter, pSearchState->iFilterSize * sizeof(Kdll_FilterEntry));
-    ptr += pSearchState->iFilterSize * sizeof(Kdll_FilterEntry);
+    MOS_SecureMemcpy(ptr, iModifiedFilterSize * sizeof(Kdll_FilterEntry), (void *)pModifiedFilter, iModifiedFilterSize * sizeof(Kdll_FilterEntry));
+    ptr += iModifiedFilterSize * sizeof(Kdll_FilterEntry);
 
     // Save CSC parameters associated with the kernel
     pCacheEntry->pCscParams = (Kdll_CSC_Params *) (ptr);
-    MOS_SecureMemcpy(ptr, sizeof(Kdll_CSC_Params), (void *)&pSearchState->CscParams, sizeof(Kdll_CSC_Params));
+    MOS_SecureMemcpy(ptr, sizeof(Kdll_CSC_Params), (void *)pCscParams, sizeof(Kdll_CSC_Params));
     ptr += sizeof(Kdll_CSC_Params);
     // Save intermediate color space for colorfill
-    pCacheEntry->colorfill_cspace = pState->colorfill_cspace;
+    pCacheEntry->colorfill_cspace = colorfill_cspace;
     ptr += sizeof(VPHAL_CSPACE);
 
     // increment KCID (Range = 0x00010000 - 0x7fffffff)
     pState->KernelCache.iCacheID = 0x00010000 + (pState->KernelCache.iCacheID - 0x0000ffff) % 0x7fff0000;
 
-    // Setup hash entry, copy filter
-    pHashEntry += entry;
+    // Setup hash entry, copy filter (hash entries may have been reallocated by KernelDll_AllocateHashEntry)
+    pHashEntry = &pHashTable->HashEntry[entry - 1];  // all indices are 1 based (0 = null)
     pHashEntry->pCacheEntry = pCacheEntry;
 
     // Save original filter for search purposes - modified filter is used for rendering
@@ -4380,35 +4526,224 @@ KernelDll_AddKernel(Kdll_State       *pState,           // Kernel Dll state
     return pCacheEntry;
 }
 
+//--------------------------------------------------------------
+// KernelDll_AddKernel - Add kernel into hash table and kernel cache
+//--------------------------------------------------------------
+Kdll_CacheEntry *
+KernelDll_AddKernel(Kdll_State       *pState,           // Kernel Dll state
+                    Kdll_SearchState *pSearchState,     // Search state
+                    Kdll_FilterEntry *pFilter,          // Original filter
+                    int32_t           iFilterSize,      // Original filter size
+                    uint32_t          dwHash)
+{
+    Kdll_CacheEntry *pCacheEntry;
+
+    VP_RENDER_FUNCTION_ENTER;
+
+    pCacheEntry = KernelDll_StoreKernel(
+        pState,
+        pSearchState->Kernel,
+        pSearchState->KernelSize,
+        pSearchState->Filter,
+        pSearchState->iFilterSize,
+        &pSearchState->CscParams,
+        pState->colorfill_cspace,
+        pFilter,
+        iFilterSize,
+        dwHash);
+
+    // Persist the newly built kernel for subsequent runs
+    if (pCacheEntry && pState->DiskCache.bEnabled)
+    {
+        KernelDll_AddDiskCacheRecord(&pState->DiskCache, pCacheEntry, pFilter, iFilterSize, dwHash);
+    }
+
+    return pCacheEntry;
+}
+
+//--------------------------------------------------------------
+// KernelDll_RuleTableSize - Size in bytes of a rule table including the EOF rule
+//--------------------------------------------------------------
+static int32_t KernelDll_RuleTableSize(const Kdll_RuleEntry *pRuleTable)
+{
+    const Kdll_RuleEntry *pRule = pRuleTable;
+
+    for (; pRule->id != RID_Op_EOF; pRule++)
+    {
+        // Skip extended rules (variable length)
+        if (RID_IS_EXTENDED(pRule->id))
+        {
+            pRule += pRule->value;
+        }
+    }
+
+    return (int32_t)((pRule + 1 - pRuleTable) * sizeof(Kdll_RuleEntry));
+}
+
+//--------------------------------------------------------------
+// KernelDll_DiskCacheChecksum - Checksum of kernel binaries and linking rules
+//--------------------------------------------------------------
+static uint32_t KernelDll_DiskCacheChecksum(Kdll_State *pState)
+{
+    uint32_t dwChecksum;
+
+    // The combined kernels only depend on the platform kernel binaries and the
+    // rules used to select and link them, so the checksum of those identifies
+    // the platform and driver build as well
+    dwChecksum = KernelDll_SimpleHash(pState->ComponentKernelCache.pCache, pState->ComponentKernelCache.iCacheSize);
+    if (pState->bEnableCMFC && pState->CmFcPatchCache.pCache)
+    {
+        dwChecksum = (dwChecksum * 0x1000193) ^
+                     KernelDll_SimpleHash(pState->CmFcPatchCache.pCache, pState->CmFcPatchCache.iCacheSize);
+    }
+    if (pState->pRuleTableDefault)
+    {
+        dwChecksum = (dwChecksum * 0x1000193) ^
+                     KernelDll_SimpleHash((void *)pState->pRuleTableDefault, KernelDll_RuleTableSize(pState->pRuleTableDefault));
+    }
+    if (pState->pRuleTableCustom)
+    {
+        dwChecksum = (dwChecksum * 0x1000193) ^
+                     KernelDll_SimpleHash((void *)pState->pRuleTableCustom, KernelDll_RuleTableSize(pState->pRuleTableCustom));
+    }
+
+    return dwChecksum;
+}
+
+//--------------------------------------------------------------
+// KernelDll_RestoreKernelFromDiskCache - Load combined kernel persisted by a previous run
+//--------------------------------------------------------------
+static Kdll_CacheEntry *KernelDll_RestoreKernelFromDiskCache(
+    Kdll_State       *pState,
+    Kdll_FilterEntry *pFilter,
+    int32_t           iFilterSize,
+    uint32_t          dwHash)
+{
+    Kdll_DiskCache       *pDiskCache = &pState->DiskCache;
+    Kdll_DiskCacheRecord *pRecord;
+    Kdll_FilterEntry     *pModifiedFilter;
+    Kdll_CacheEntry      *pCacheEntry;
+
+    if (!pDiskCache->bEnabled)
+    {
+        return nullptr;
+    }
+
+    pRecord = KernelDll_FindDiskCacheRecord(pDiskCache, pFilter, iFilterSize, dwHash);
+    if (!pRecord)
+    {
+        pDiskCache->dwMisses++;
+        return nullptr;
+    }
+
+    // Records never carry procamp matrices, their CSC parameters are used as is
+    pModifiedFilter = (Kdll_FilterEntry *)(pRecord + 1) + pRecord->iFilter;
+    pCacheEntry     = KernelDll_StoreKernel(
+        pState,
+        (uint8_t *)(pModifiedFilter + pRecord->iFilterSize),
+        pRecord->iKernelSize,
+        pModifiedFilter,
+        pRecord->iFilterSize,
+        &pRecord->CscParams,
+        pRecord->colorfill_cspace,
+        pFilter,
+        iFilterSize,
+        dwHash);
+
+    if (pCacheEntry)
+    {
+        pDiskCache->dwHits++;
+    }
+    else
+    {
+        pDiskCache->dwMisses++;
+    }
+
+    return pCacheEntry;
+}
+
+//---------------------------------------------------------------------------------------
+// KernelDll_LoadDiskCache - Load persistent combined kernel cache
+//
+// Parameters:
+//    Kdll_State *pState - [in/out] Kernel Dll state
+//    const char *szDir  - [in]     Cache directory, nullptr or empty to disable
+//
+// Output: true  - Persistent cache is enabled (file may be empty or missing)
+//         false - Persistent cache is disabled
+//
+// The cache is opt-in: the caller reads the directory from the
+// __VPHAL_FC_KERNEL_CACHE_DIRECTORY user setting after the state is allocated.
+//-----------------------------------------------------------------------------------------
+bool KernelDll_LoadDiskCache(Kdll_State *pState, const char *szDir)
+{
+    VP_RENDER_FUNCTION_ENTER;
+
+    if (!pState)
+    {
+        return false;
+    }
+
+    KernelDll_CloseDiskCache(&pState->DiskCache);
+    if (!szDir || !szDir[0])
+    {
+        return false;
+    }
+
+    return KernelDll_OpenDiskCache(&pState->DiskCache, szDir, KernelDll_DiskCacheChecksum(pState));
+}
+
+//---------------------------------------------------------------------------------------
+// KernelDll_SaveDiskCache - Write persistent combined kernel cache back to disk
+//
+// Parameters:
+//    Kdll_State *pState - [in] Kernel Dll state
+//
+// Output: true  - Cache file is up to date
+//         false - Failed to write the cache file
+//-----------------------------------------------------------------------------------------
+bool KernelDll_SaveDiskCache(Kdll_State *pState)
+{
+    VP_RENDER_FUNCTION_ENTER;
+
+    if (!pState)
+    {
+        return false;
+    }
+
+    return KernelDll_WriteDiskCache(&pState->DiskCache);
+}
+
 //--------------------------------------------------------------
 // KernelDll_ReleaseHashEntry - Release hash table entry
 //--------------------------------------------------------------
 void KernelDll_ReleaseHashEntry(Kdll_KernelHashTable *pHashTable, uint16_t entry)
 {
-    Kdll_KernelHashEntry *pHashEntry = &pHashTable->HashEntry[0] - 1;
-    uint32_t folded_hash;
+    Kdll_KernelHashEntry *pHashEntry = pHashTable->HashEntry - 1;
+    uint32_t bucket;
     uint16_t next;
 
     VP_RENDER_FUNCTION_ENTER;
 
-    if (entry == 0)
+    if (entry == 0 || entry > pHashTable->iHashSize)
     {
         return;
     }
 
     // unlink entry
     next = pHashEntry[entry].next;
-    pHashEntry[entry].next = 0;
+    pHashEntry[entry].next        = 0;
+    pHashEntry[entry].pCacheEntry = nullptr;
 
     // remove references to entry from hash table
-    FOLD_HASH(folded_hash, pHashEntry[entry].dwHash);
-    if (pHashTable->wHashTable[folded_hash] == entry)
+    HASH_BUCKET(bucket, pHashEntry[entry].dwHash, pHashTable->iHashSize);
+    if (pHashTable->wHashTable[bucket] == entry)
     {
-        pHashTable->wHashTable[folded_hash] = next;
+        pHashTable->wHashTable[bucket] = next;
     }
     else
     {
-        uint16_t prev = pHashTable->wHashTable[folded_hash];
+        uint16_t prev = pHashTable->wHashTable[bucket];
 
         while (prev != 0 &&
                pHashEntry[prev].next != entry)
@@ -4440,8 +4775,18 @@ void KernelDll_ReleaseHashEntry(Kdll_KernelHashTable *pHashTable, uint16_t entry
 void KernelDll_ReleaseCacheEntry(Kdll_KernelCache *pCache,
                                  Kdll_CacheEntry  *pEntry)
 {
+    if (pEntry->iKCID == -1)
+    {
+        return;
+    }
+
+    KernelDll_UnlinkCacheEntry(pCache, pEntry);
+
     pEntry->iKUID = -1;
     pEntry->iKCID = -1;
+    pEntry->wHashEntry   = 0;
+    pEntry->pLruPrev     = pCache->pFreeEntries;
+    pCache->pFreeEntries = pEntry;
     pCache->iCacheEntries--;
 }
 
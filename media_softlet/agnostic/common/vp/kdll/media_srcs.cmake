@@ -20,6 +20,7 @@
 
 set(TMP_SOURCES_
     ${CMAKE_CURRENT_LIST_DIR}/hal_kerneldll_next.c
+    ${CMAKE_CURRENT_LIST_DIR}/hal_kerneldll_disk_cache.c
     ${CMAKE_CURRENT_LIST_DIR}/hal_kernelrules_next.c
 )
 
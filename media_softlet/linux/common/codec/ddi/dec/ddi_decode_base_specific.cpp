@@ -34,6 +34,7 @@
 #include "media_interfaces_codechal_next.h"
 #include "ddi_decode_trace_specific.h"
 #include "media_libva_caps_next.h"
+#include "media_libva_interface_next.h"
 
 namespace decode
 {
@@ -307,6 +308,16 @@ VAStatus DdiDecodeBase::DecodeCombineBitstream(DDI_MEDIA_CONTEXT *mediaCtx)
         return VA_STATUS_SUCCESS;
     }
 
+    // The bitstream of this frame did not fit into the buffer picked by AllocBsBuffer.
+    // Raise the bitstream size of the context with headroom, so every buffer of the ring
+    // is grown by AllocBsBuffer on its next use and later frames are written in place
+    // instead of being gathered here.
+    uint32_t bsSize = MOS_ALIGN_CEIL(m_decodeCtx->DecodeParams.m_dataSize + (m_decodeCtx->DecodeParams.m_dataSize >> 1), MOS_PAGE_SIZE);
+    if (bsSize > bufMgr->dwMaxBsSize)
+    {
+        bufMgr->dwMaxBsSize = bsSize;
+    }
+
     PDDI_MEDIA_BUFFER newBitstreamBuffer;
     // allocate a new bit stream buffer
     newBitstreamBuffer = (DDI_MEDIA_BUFFER *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_BUFFER));
@@ -316,7 +327,7 @@ VAStatus DdiDecodeBase::DecodeCombineBitstream(DDI_MEDIA_CONTEXT *mediaCtx)
         return VA_STATUS_ERROR_DECODING_ERROR;
     }
 
-    newBitstreamBuffer->iSize     = m_decodeCtx->DecodeParams.m_dataSize;
+    newBitstreamBuffer->iSize     = bufMgr->dwMaxBsSize;
     newBitstreamBuffer->uiType    = VASliceDataBufferType;
     newBitstreamBuffer->format    = Media_Format_Buffer;
     newBitstreamBuffer->uiOffset  = 0;
@@ -624,15 +635,19 @@ VAStatus DdiDecodeBase::AllocBsBuffer(
         bsBufObj->pMediaCtx = m_decodeCtx->pMediaCtx;
         bsBufBaseAddr       = bufMgr->pBitStreamBase[bufMgr->dwBitstreamIndex];
 
+        // dwMaxBsSize may have been raised by DecodeCombineBitstream after this buffer was created,
+        // grow the buffer now while it is idle so the slices of this frame are appended in place.
+        int32_t bsSize = MOS_MAX(buf->iSize, (int32_t)bufMgr->dwMaxBsSize);
+
         if (bsBufBaseAddr == nullptr)
         {
             createBsBuffer = true;
-            if (buf->iSize > bsBufObj->iSize)
+            if (bsSize > bsBufObj->iSize)
             {
-                bsBufObj->iSize = buf->iSize;
+                bsBufObj->iSize = bsSize;
             }
         }
-        else if (buf->iSize > bsBufObj->iSize)
+        else if (bsSize > bsBufObj->iSize)
         {
            // free bo
             MediaLibvaUtilNext::UnlockBuffer(bsBufObj);
@@ -640,7 +655,7 @@ VAStatus DdiDecodeBase::AllocBsBuffer(
             bsBufBaseAddr = nullptr;
 
             createBsBuffer  = true;
-            bsBufObj->iSize = buf->iSize;
+            bsBufObj->iSize = bsSize;
         }
 
         if (createBsBuffer)
@@ -796,6 +811,8 @@ VAStatus DdiDecodeBase::ExtraDownScaling(
     {
         // check vp context
         VAContextID vpCtxID = VA_INVALID_ID;
+        DdiMediaFunctions *vpComp = MediaLibvaInterfaceNext::GetComponent(mediaCtx, CompVp);
+        DDI_CODEC_CHK_NULL(vpComp, "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
         if (mediaCtx->pVpCtxHeap != nullptr && mediaCtx->pVpCtxHeap->pHeapBase != nullptr)
         {
             // Get VP Context from heap.
@@ -804,7 +821,7 @@ VAStatus DdiDecodeBase::ExtraDownScaling(
         else
         {
             // Create VP Context.
-            vaStatus = mediaCtx->m_compList[CompVp]->CreateContext(ctx, 0, 0, 0, 0, 0, 0, &vpCtxID);
+            vaStatus = vpComp->CreateContext(ctx, 0, 0, 0, 0, 0, 0, &vpCtxID);
             DDI_CHK_RET(vaStatus, "Create VP Context failed.");
         }
 
@@ -816,13 +833,13 @@ VAStatus DdiDecodeBase::ExtraDownScaling(
         VAProcPipelineParameterBuffer* pInputPipelineParam = m_procBuf;
         DDI_CODEC_CHK_NULL(pInputPipelineParam, "nullptr pInputPipelineParam", VA_STATUS_ERROR_ALLOCATION_FAILED);
 
-        vaStatus = mediaCtx->m_compList[CompVp]->BeginPicture(ctx, vpCtxID, pInputPipelineParam->additional_outputs[0]);
+        vaStatus = vpComp->BeginPicture(ctx, vpCtxID, pInputPipelineParam->additional_outputs[0]);
         DDI_CHK_RET(vaStatus, "VP BeginPicture failed");
 
         vaStatus = m_decodeCtx->pVpDdiInterface->DdiSetProcPipelineParams(ctx, pVpCtx, pInputPipelineParam);
         DDI_CHK_RET(vaStatus, "VP SetProcPipelineParams failed.");
 
-        vaStatus = mediaCtx->m_compList[CompVp]->EndPicture(ctx, vpCtxID);
+        vaStatus = vpComp->EndPicture(ctx, vpCtxID);
         DDI_CHK_RET(vaStatus, "VP EndPicture failed.");
     }
 #endif
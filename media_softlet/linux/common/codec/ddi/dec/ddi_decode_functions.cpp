@@ -100,10 +100,11 @@ VAStatus DdiDecodeFunctions::CreateConfig (
     auto configList = mediaCtx->m_capsNext->GetConfigList();
     DDI_CODEC_CHK_NULL(configList, "Get configList failed", VA_STATUS_ERROR_INVALID_PARAMETER);
 
-    for (int i = 0; i < configList->size(); i++)
+    // configs of one profile and entrypoint are contiguous in configList
+    auto configRange = mediaCtx->m_capsNext->m_capsTable->QueryConfigRange(profile, entrypoint);
+    if (configRange != nullptr)
     {
-        if ((configList->at(i).profile == profile) &&
-            (configList->at(i).entrypoint == entrypoint))
+        for (uint32_t i = configRange->first; i < configRange->first + configRange->count; i++)
         {
             if (decAttributes[0].value == configList->at(i).componentData.data.sliceMode   &&
                 decAttributes[1].value == configList->at(i).componentData.data.encryptType &&
@@ -1065,19 +1066,13 @@ VAStatus DdiDecodeFunctions::StatusReport(
                     (tempNewReport.codecStatus == CODECHAL_STATUS_RESET)        ||
                     (tempNewReport.codecStatus == CODECHAL_STATUS_INCOMPLETE))
                 {
-                    PDDI_MEDIA_SURFACE_HEAP_ELEMENT mediaSurfaceHeapElmt = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)mediaCtx->pSurfaceHeap->pHeapBase;
-
-                    uint32_t j = 0;
-                    for (j = 0; j < mediaCtx->pSurfaceHeap->uiAllocatedHeapElements && mediaSurfaceHeapElmt != nullptr; j++, mediaSurfaceHeapElmt++)
+                    PDDI_MEDIA_SURFACE_HEAP_ELEMENT mediaSurfaceHeapElmt = MediaLibvaUtilNext::GetPMediaSurfaceFromBo(mediaCtx->pSurfaceHeap, bo);
+                    if (mediaSurfaceHeapElmt != nullptr)
                     {
-                        if (mediaSurfaceHeapElmt->pSurface != nullptr && bo == mediaSurfaceHeapElmt->pSurface->bo)
-                        {
-                            mediaSurfaceHeapElmt->pSurface->curStatusReport.decode.status = (uint32_t)tempNewReport.codecStatus;
-                            mediaSurfaceHeapElmt->pSurface->curStatusReport.decode.errMbNum = (uint32_t)tempNewReport.numMbsAffected;
-                            mediaSurfaceHeapElmt->pSurface->curStatusReport.decode.crcValue = (uint32_t)tempNewReport.frameCrc;
-                            mediaSurfaceHeapElmt->pSurface->curStatusReportQueryState = DDI_MEDIA_STATUS_REPORT_QUERY_STATE_COMPLETED;
-                            break;
-                        }
+                        mediaSurfaceHeapElmt->pSurface->curStatusReport.decode.status = (uint32_t)tempNewReport.codecStatus;
+                        mediaSurfaceHeapElmt->pSurface->curStatusReport.decode.errMbNum = (uint32_t)tempNewReport.numMbsAffected;
+                        mediaSurfaceHeapElmt->pSurface->curStatusReport.decode.crcValue = (uint32_t)tempNewReport.frameCrc;
+                        mediaSurfaceHeapElmt->pSurface->curStatusReportQueryState = DDI_MEDIA_STATUS_REPORT_QUERY_STATE_COMPLETED;
                     }
 
                 }
@@ -101,6 +101,7 @@ VAStatus DdiEncodeBase::AddToStatusReportQueue(void *codedBuf)
     DDI_CODEC_CHK_NULL(codedBuf, "Null codedBuf", VA_STATUS_ERROR_INVALID_BUFFER);
 
     int32_t idx                                       = m_encodeCtx->statusReportBuf.ulHeadPosition;
+    UpdateStatusReportIndex(m_encodeCtx->statusReportBuf.infos[idx].pCodedBuf, codedBuf, idx);
     m_encodeCtx->statusReportBuf.infos[idx].pCodedBuf = codedBuf;
     m_encodeCtx->statusReportBuf.infos[idx].uiSize    = 0;
     m_encodeCtx->statusReportBuf.infos[idx].uiStatus  = 0;
@@ -435,6 +436,7 @@ VAStatus DdiEncodeBase::RemoveFromStatusReportQueue(DDI_MEDIA_BUFFER *buf)
 
     if (index >= 0)
     {
+        UpdateStatusReportIndex(m_encodeCtx->statusReportBuf.infos[index].pCodedBuf, nullptr, index);
         m_encodeCtx->statusReportBuf.infos[index].pCodedBuf = nullptr;
         m_encodeCtx->statusReportBuf.infos[index].uiSize    = 0;
     }
@@ -529,24 +531,17 @@ VAStatus DdiEncodeBase::GetSizeFromStatusReportBuffer(
     DDI_CODEC_CHK_NULL(status, "Null status", VA_STATUS_ERROR_INVALID_CONTEXT);
     DDI_CODEC_CHK_NULL(index, "Null index", VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    int32_t i = 0;
-    for (i = 0; i < DDI_ENCODE_MAX_STATUS_REPORT_BUFFER; i++)
+    // check if the buffer has already been added to status report queue
+    int32_t i = FindInStatusReportQueue((void *)buf->bo);
+    if (i != DDI_CODEC_INVALID_BUFFER_INDEX)
     {
-        // check if the buffer has already been added to status report queue
-        if (m_encodeCtx->statusReportBuf.infos[i].pCodedBuf == (void *)buf->bo)
-        {
-            *size   = m_encodeCtx->statusReportBuf.infos[i].uiSize;
-            *status = m_encodeCtx->statusReportBuf.infos[i].uiStatus;
-
-            break;
-        }
+        *size   = m_encodeCtx->statusReportBuf.infos[i].uiSize;
+        *status = m_encodeCtx->statusReportBuf.infos[i].uiStatus;
     }
-
-    if (i >= DDI_ENCODE_MAX_STATUS_REPORT_BUFFER)
+    else
     {
         // no matching buffer has been found
         *size   = 0;
-        i       = DDI_CODEC_INVALID_BUFFER_INDEX;
         eStatus = MOS_STATUS_INVALID_HANDLE;
     }
 
@@ -646,14 +641,58 @@ bool DdiEncodeBase::CodedBufferExistInStatusReport(DDI_MEDIA_BUFFER *buf)
         return false;
     }
 
-    for (int32_t i = 0; i < DDI_ENCODE_MAX_STATUS_REPORT_BUFFER; i++)
+    return FindInStatusReportQueue((void *)buf->bo) != DDI_CODEC_INVALID_BUFFER_INDEX;
+}
+
+void DdiEncodeBase::UpdateStatusReportIndex(void *oldCodedBuf, void *newCodedBuf, int32_t index)
+{
+    if (oldCodedBuf != nullptr)
     {
-        if (m_encodeCtx->statusReportBuf.infos[i].pCodedBuf == (void *)buf->bo)
+        auto range = m_statusReportIndex.equal_range(oldCodedBuf);
+        for (auto it = range.first; it != range.second; ++it)
         {
-            return true;
+            if (it->second == index)
+            {
+                m_statusReportIndex.erase(it);
+                break;
+            }
         }
     }
-    return false;
+
+    if (newCodedBuf != nullptr)
+    {
+        m_statusReportIndex.emplace(newCodedBuf, index);
+    }
+}
+
+int32_t DdiEncodeBase::FindInStatusReportQueue(void *codedBuf)
+{
+    int32_t index = DDI_CODEC_INVALID_BUFFER_INDEX;
+
+    if (codedBuf == nullptr)
+    {
+        // empty slots are not indexed
+        for (int32_t i = 0; i < DDI_ENCODE_MAX_STATUS_REPORT_BUFFER; i++)
+        {
+            if (m_encodeCtx->statusReportBuf.infos[i].pCodedBuf == nullptr)
+            {
+                return i;
+            }
+        }
+        return index;
+    }
+
+    // same coded buffer may be queued more than once, keep the lowest slot as the linear search did
+    auto range = m_statusReportIndex.equal_range(codedBuf);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (index == DDI_CODEC_INVALID_BUFFER_INDEX || it->second < index)
+        {
+            index = it->second;
+        }
+    }
+
+    return index;
 }
 
 bool DdiEncodeBase::EncBufferExistInStatusReport(
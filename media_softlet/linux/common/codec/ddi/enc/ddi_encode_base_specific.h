@@ -28,6 +28,7 @@
 #define __DDI_ENCODE_BASE_SPECIFIC_H__
 
 #include <va/va.h>
+#include <unordered_map>
 #include "ddi_codec_base_specific.h"
 #include "ddi_libva_encoder_specific.h"
 #include "codechal_setting.h"
@@ -570,6 +571,32 @@ protected:
         return VA_STATUS_SUCCESS;
     }
 
+    //!
+    //! \brief    Update coded buffer index of status report queue
+    //! \details  Called whenever a slot of statusReportBuf.infos changes its coded buffer
+    //!
+    //! \param    [in] oldCodedBuf
+    //!           Coded buffer previously stored in the slot
+    //! \param    [in] newCodedBuf
+    //!           Coded buffer stored in the slot from now on
+    //! \param    [in] index
+    //!           Slot index in status report queue
+    //!
+    //! \return   void
+    //!
+    void UpdateStatusReportIndex(void *oldCodedBuf, void *newCodedBuf, int32_t index);
+
+    //!
+    //! \brief    Find coded buffer in status report queue
+    //!
+    //! \param    [in] codedBuf
+    //!           Coded buffer bo
+    //!
+    //! \return   int32_t
+    //!           Slot index if found, else DDI_CODEC_INVALID_BUFFER_INDEX
+    //!
+    int32_t FindInStatusReportQueue(void *codedBuf);
+
     //!
     //! \brief    Clean Up Buffer and Return
     //!
@@ -586,6 +613,8 @@ protected:
     uint8_t m_scalingLists4x4[6][16]{};          //!< Inverse quantization scale lists 4x4.
     uint8_t m_scalingLists8x8[2][64]{};          //!< Inverse quantization scale lists 8x8
 
+    std::unordered_multimap<void *, int32_t> m_statusReportIndex;  //!< Coded buffer to slot index of statusReportBuf.infos
+
 MEDIA_CLASS_DEFINE_END(encode__DdiEncodeBase)
 };
 
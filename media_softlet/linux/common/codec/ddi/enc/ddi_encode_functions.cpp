@@ -75,10 +75,11 @@ VAStatus DdiEncodeFunctions::CreateConfig (
     auto configList = mediaCtx->m_capsNext->GetConfigList();
     DDI_CODEC_CHK_NULL(configList, "Get configList failed", VA_STATUS_ERROR_INVALID_PARAMETER);
 
-    for(int i = 0; i < configList->size(); i++)
+    // configs of one profile and entrypoint are contiguous in configList
+    auto configRange = mediaCtx->m_capsNext->m_capsTable->QueryConfigRange(profile, entrypoint);
+    if (configRange != nullptr)
     {
-        if((configList->at(i).profile == profile)        &&
-           (configList->at(i).entrypoint == entrypoint))
+        for (uint32_t i = configRange->first; i < configRange->first + configRange->count; i++)
         {
             if((rcMode      == configList->at(i).componentData.data.rcMode)       &&
                (feiFunction == configList->at(i).componentData.data.feiFunction))
@@ -25,6 +25,7 @@
 //! \brief    implemantation of media caps table class on specific os
 //!
 
+#include <algorithm>
 #include "media_capstable_specific.h"
 #include "media_libva.h"
 #include "hwinfo_linux.h"
@@ -84,25 +85,48 @@ VAStatus MediaCapsTableSpecific::Init(DDI_MEDIA_CONTEXT *mediaCtx)
         return VA_STATUS_ERROR_INVALID_PARAMETER;
     }
 
-    for (auto profileMapIter: *m_profileMap)
+    // Size both lists first, so each takes a single allocation.
+    size_t configNum = 0;
+    size_t pairNum   = 0;
+    for (const auto &profileMapIter: *m_profileMap)
+    {
+        DDI_CHK_NULL(profileMapIter.second, "Null pointer", VA_STATUS_ERROR_INVALID_PARAMETER);
+        for (const auto &entrypointMapIter: *profileMapIter.second)
+        {
+            auto entrypointData = entrypointMapIter.second;
+            DDI_CHK_NULL(entrypointData, "Null pointer", VA_STATUS_ERROR_INVALID_PARAMETER);
+            auto componentData  = entrypointData->configDataList;
+            configNum += (componentData && componentData->size() != 0) ? componentData->size() : 1;
+            pairNum++;
+        }
+    }
+    m_configList.clear();
+    m_configList.reserve(configNum);
+    m_configIndex.clear();
+    m_configIndex.reserve(pairNum);
+
+    for (const auto &profileMapIter: *m_profileMap)
     {
         auto profile = profileMapIter.first;
-        for(auto entrypointMapIter: *profileMapIter.second)
+        for (const auto &entrypointMapIter: *profileMapIter.second)
         {
             auto entrypoint     = entrypointMapIter.first;
             auto entrypointData = entrypointMapIter.second;
-            DDI_CHK_NULL(entrypointData, "Null pointer", VA_STATUS_ERROR_INVALID_PARAMETER);
 
             auto attriblist     = entrypointData->attribList;
             DDI_CHK_NULL(attriblist, "Null pointer", VA_STATUS_ERROR_INVALID_PARAMETER);
 
+            ConfigIndexEntry index = {};
+            index.profile          = profile;
+            index.entrypoint       = entrypoint;
+            index.range.first      = m_configList.size();
+
             auto componentData  = entrypointData->configDataList;
             int32_t numAttribList = attriblist->size();
             if(componentData && componentData->size() != 0)
             {
-                for(int i = 0; i < componentData->size(); i++)
+                for (const auto &configData : *componentData)
                 {
-                    auto configData = componentData->at(i);
                     m_configList.emplace_back(profile, entrypoint, const_cast<VAConfigAttrib*>(attriblist->data()), numAttribList, configData);
                 }
             }
@@ -111,6 +135,9 @@ VAStatus MediaCapsTableSpecific::Init(DDI_MEDIA_CONTEXT *mediaCtx)
                 ComponentData configData = {};
                 m_configList.emplace_back(profile, entrypoint, const_cast<VAConfigAttrib*>(attriblist->data()), numAttribList, configData);
             }
+
+            index.range.count = m_configList.size() - index.range.first;
+            m_configIndex.push_back(index);
         }
     }
 
@@ -228,22 +255,38 @@ VAStatus MediaCapsTableSpecific::CreateConfig(
     DDI_UNUSED(numAttribs);
     DDI_UNUSED(configId);
 
-    VAStatus ret = VA_STATUS_ERROR_UNSUPPORTED_PROFILE;
-    for (auto configItem : m_configList)
+    if (QueryConfigRange(profile, entrypoint) != nullptr)
     {
-        // check profile, entrypoint here
-        if (configItem.profile == profile)
-        {
-            ret = VA_STATUS_ERROR_UNSUPPORTED_ENTRYPOINT;
-            if(configItem.entrypoint == entrypoint)
-            {
-                ret = VA_STATUS_SUCCESS;
-                break;
-            }
-        }
+        return VA_STATUS_SUCCESS;
+    }
+
+    // Every entrypoint of a profile owns at least one config, so a profile is
+    // supported as long as it has any entrypoint.
+    auto profileMapIter = m_profileMap->find(profile);
+    if (profileMapIter != m_profileMap->end() && profileMapIter->second && !profileMapIter->second->empty())
+    {
+        return VA_STATUS_ERROR_UNSUPPORTED_ENTRYPOINT;
+    }
+
+    return VA_STATUS_ERROR_UNSUPPORTED_PROFILE;
+}
+
+const ConfigRange* MediaCapsTableSpecific::QueryConfigRange(
+    VAProfile       profile,
+    VAEntrypoint    entrypoint)
+{
+    DDI_FUNC_ENTER;
+
+    auto it = std::lower_bound(m_configIndex.begin(), m_configIndex.end(), std::make_pair(profile, entrypoint),
+        [](const ConfigIndexEntry &entry, const std::pair<VAProfile, VAEntrypoint> &key) {
+            return entry.profile < key.first || (entry.profile == key.first && entry.entrypoint < key.second);
+        });
+    if (it == m_configIndex.end() || it->profile != profile || it->entrypoint != entrypoint)
+    {
+        return nullptr;
     }
 
-    return ret;
+    return &it->range;
 }
 
 bool MediaCapsTableSpecific::IsDecConfigId(VAConfigID configId)
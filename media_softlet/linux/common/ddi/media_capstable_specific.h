@@ -76,6 +76,27 @@ struct ConfigLinux
 
 typedef std::vector<ConfigLinux> ConfigList;
 
+//!
+//! \struct ConfigRange
+//! \brief  Contiguous m_configList entries of one profile and entrypoint
+//!
+struct ConfigRange
+{
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+//!
+//! \struct ConfigIndexEntry
+//! \brief  Config list range of one profile and entrypoint pair
+//!
+struct ConfigIndexEntry
+{
+    VAProfile    profile    = VAProfileNone;
+    VAEntrypoint entrypoint = VAEntrypointVLD;
+    ConfigRange  range      = {};
+};
+
 #define CONFIG_ATTRIB_NONE 0x00000000
 
 // This offset is for cap fallback enabling, can be removed when all refactor done
@@ -103,6 +124,13 @@ private:
     ImgTable      *m_imgTbl     = nullptr;
     DdiCpCapsInterface *m_cpCaps = nullptr;
 
+    //!
+    //! \brief  Config list ranges built with m_configList, sorted by profile and
+    //!         entrypoint as m_profileMap is. A vector is reserved once per Init,
+    //!         where a hash map would allocate a node per pair.
+    //!
+    std::vector<ConfigIndexEntry> m_configIndex = {};
+
 public:
     //!
     //! \brief  Store config
@@ -167,6 +195,22 @@ public:
     ConfigLinux* QueryConfigItemFromIndex(
         VAConfigID    configId);
 
+    //!
+    //! \brief    Get the config list entries of a profile and entrypoint
+    //!
+    //! \param    [in] profile
+    //!           VA profile
+    //!
+    //! \param    [in] entrypoint
+    //!           VA entrypoint
+    //!
+    //! \return   const ConfigRange*
+    //!           nullptr if the profile and entrypoint pair is not supported
+    //!
+    const ConfigRange* QueryConfigRange(
+        VAProfile      profile,
+        VAEntrypoint   entrypoint);
+
     //!
     //! \brief    Create a configuration
     //! \details  It passes in the attribute list that specifies the attributes it
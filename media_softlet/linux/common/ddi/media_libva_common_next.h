@@ -31,6 +31,7 @@
 #include <va/va.h>
 #include <va/va_backend.h>
 #include <semaphore.h>
+#include <unordered_map>
 #include "GmmLib.h"
 #include "mos_bufmgr_api.h"
 #include "mos_defs_specific.h"
@@ -296,6 +297,7 @@ typedef struct _DDI_MEDIA_SURFACE_HEAP_ELEMENT
     PDDI_MEDIA_SURFACE                      pSurface;
     uint32_t                                uiVaSurfaceID;
     struct _DDI_MEDIA_SURFACE_HEAP_ELEMENT *pNextFree;
+    MOS_LINUX_BO                           *pIndexedBo;    // bo this element is registered with in pBoIndex
 }DDI_MEDIA_SURFACE_HEAP_ELEMENT, *PDDI_MEDIA_SURFACE_HEAP_ELEMENT;
 
 typedef struct _DDI_MEDIA_BUFFER_HEAP_ELEMENT
@@ -327,6 +329,9 @@ typedef struct _DDI_MEDIA_HEAP
     uint32_t           uiHeapElementSize;
     uint32_t           uiAllocatedHeapElements;
     void               *pFirstFreeHeapElement;
+    // bo to heap element index, surface heap only. Filled on lookup, not at allocation,
+    // since the surface bo is created and may be replaced after the element is taken.
+    std::unordered_map<MOS_LINUX_BO *, uint32_t> *pBoIndex;
 }DDI_MEDIA_HEAP, *PDDI_MEDIA_HEAP;
 
 #ifndef ANDROID
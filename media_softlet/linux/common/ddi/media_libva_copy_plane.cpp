@@ -0,0 +1,272 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_libva_copy_plane.cpp
+//! \brief    CPU plane copy of vaGetImage/vaPutImage and its worker pool
+//!
+
+#include <string.h>
+#include <algorithm>
+#include <system_error>
+#if defined(__x86_64__) || defined(__i386__)
+#include <smmintrin.h>
+#endif
+#include "media_libva_copy_plane.h"
+
+MediaLibvaUtilNext_WorkerPool::MediaLibvaUtilNext_WorkerPool(uint32_t workerNum)
+{
+    uint32_t hwThreads = std::thread::hardware_concurrency();
+    m_workerNum        = (hwThreads > 1) ? std::min(workerNum, hwThreads - 1) : 0;
+}
+
+MediaLibvaUtilNext_WorkerPool::~MediaLibvaUtilNext_WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_taskCond.notify_all();
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void MediaLibvaUtilNext_WorkerPool::StartWorkers()
+{
+    uint32_t workerNum = m_workerNum;
+    m_workers.reserve(workerNum);
+    while (m_workers.size() < workerNum)
+    {
+        try
+        {
+            m_workers.emplace_back(&MediaLibvaUtilNext_WorkerPool::WorkerThread, this);
+        }
+        catch (const std::system_error &)
+        {
+            // Out of threads, run with the workers started so far.
+            break;
+        }
+    }
+    m_workerNum = (uint32_t)m_workers.size();
+}
+
+bool MediaLibvaUtilNext_WorkerPool::RunNextTask(std::unique_lock<std::mutex> &lock)
+{
+    if (m_task == nullptr || m_nextTask >= m_taskNum)
+    {
+        return false;
+    }
+
+    uint32_t                             index = m_nextTask++;
+    const std::function<void(uint32_t)> &task  = *m_task;
+    lock.unlock();
+    task(index);
+    lock.lock();
+
+    if (--m_pending == 0)
+    {
+        m_doneCond.notify_all();
+    }
+    return true;
+}
+
+void MediaLibvaUtilNext_WorkerPool::WorkerThread()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop)
+    {
+        if (!RunNextTask(lock))
+        {
+            m_taskCond.wait(lock);
+        }
+    }
+}
+
+void MediaLibvaUtilNext_WorkerPool::Run(uint32_t taskNum, const std::function<void(uint32_t)> &task)
+{
+    std::unique_lock<std::mutex> jobLock(m_jobMutex, std::try_to_lock);
+    if (!jobLock.owns_lock() || m_workerNum == 0 || taskNum <= 1)
+    {
+        for (uint32_t i = 0; i < taskNum; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    if (m_workers.empty())
+    {
+        StartWorkers();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task     = &task;
+    m_taskNum  = taskNum;
+    m_nextTask = 0;
+    m_pending  = taskNum;
+    m_taskCond.notify_all();
+
+    // The caller takes tasks too, so the job completes even if no worker wakes up.
+    while (RunNextTask(lock))
+    {
+    }
+    m_doneCond.wait(lock, [this] { return m_pending == 0; });
+
+    m_task    = nullptr;
+    m_taskNum = 0;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+//!
+//! \brief  Copy rows with SSE4.1 streaming loads (MOVNTDQA)
+//! \details Reading write-combined memory with normal loads is uncached, one bus
+//!          transaction per load. Streaming loads fetch a whole line into a fill
+//!          buffer instead, and behave as normal loads on write-back memory.
+//!          Built with a target attribute since the DDI is not compiled with -msse4.1,
+//!          callers must check cpu support first.
+//!
+__attribute__((target("sse4.1")))
+static void CopyRowsStreamingLoad(
+    uint8_t       *dst,
+    uint32_t      dstPitch,
+    const uint8_t *src,
+    uint32_t      srcPitch,
+    uint32_t      rowSize,
+    uint32_t      height)
+{
+    // Streaming loads are weakly ordered, fence once so they observe all earlier writes.
+    _mm_mfence();
+
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint8_t *rowSrc  = src;
+        uint8_t       *rowDst  = dst;
+        uint32_t      rowBytes = rowSize;
+
+        // MOVNTDQA needs 16 byte aligned source
+        uint32_t headBytes = std::min((uint32_t)((16 - ((uintptr_t)rowSrc & 15)) & 15), rowBytes);
+        memcpy(rowDst, rowSrc, headBytes);
+        rowSrc   += headBytes;
+        rowDst   += headBytes;
+        rowBytes -= headBytes;
+
+        for (; rowBytes >= 64; rowBytes -= 64, rowSrc += 64, rowDst += 64)
+        {
+            __m128i xmm0 = _mm_stream_load_si128((__m128i *)rowSrc);
+            __m128i xmm1 = _mm_stream_load_si128((__m128i *)(rowSrc + 16));
+            __m128i xmm2 = _mm_stream_load_si128((__m128i *)(rowSrc + 32));
+            __m128i xmm3 = _mm_stream_load_si128((__m128i *)(rowSrc + 48));
+            _mm_storeu_si128((__m128i *)rowDst, xmm0);
+            _mm_storeu_si128((__m128i *)(rowDst + 16), xmm1);
+            _mm_storeu_si128((__m128i *)(rowDst + 32), xmm2);
+            _mm_storeu_si128((__m128i *)(rowDst + 48), xmm3);
+        }
+        for (; rowBytes >= 16; rowBytes -= 16, rowSrc += 16, rowDst += 16)
+        {
+            _mm_storeu_si128((__m128i *)rowDst, _mm_stream_load_si128((__m128i *)rowSrc));
+        }
+        memcpy(rowDst, rowSrc, rowBytes);
+
+        dst += dstPitch;
+        src += srcPitch;
+    }
+}
+#endif
+
+void MediaLibvaUtilNext_CopyPlane::CopyRows(
+    uint8_t       *dst,
+    uint32_t      dstPitch,
+    const uint8_t *src,
+    uint32_t      srcPitch,
+    uint32_t      rowSize,
+    uint32_t      height,
+    bool          srcUncached)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool streamingLoadSupported = __builtin_cpu_supports("sse4.1");
+    if (srcUncached && streamingLoadSupported)
+    {
+        CopyRowsStreamingLoad(dst, dstPitch, src, srcPitch, rowSize, height);
+        return;
+    }
+#endif
+
+    // Sizes are derived from the pitches, so the per row bound checks of MOS_SecureMemcpy are not needed.
+    if (dstPitch == srcPitch && rowSize == srcPitch)
+    {
+        memcpy(dst, src, (size_t)rowSize * height);
+        return;
+    }
+
+    for (uint32_t y = 0; y < height; y++)
+    {
+        memcpy(dst, src, rowSize);
+        dst += dstPitch;
+        src += srcPitch;
+    }
+}
+
+uint32_t MediaLibvaUtilNext_CopyPlane::SplitBands(uint32_t height, uint32_t workerNum, uint32_t &bandHeight)
+{
+    if (height == 0 || workerNum == 0)
+    {
+        bandHeight = 0;
+        return 0;
+    }
+
+    bandHeight = (height - 1) / workerNum + 1;
+    return (height - 1) / bandHeight + 1;
+}
+
+void MediaLibvaUtilNext_CopyPlane::Copy(
+    MediaLibvaUtilNext_WorkerPool *workerPool,
+    uint8_t       *dst,
+    uint32_t      dstPitch,
+    const uint8_t *src,
+    uint32_t      srcPitch,
+    uint32_t      rowSize,
+    uint32_t      height,
+    bool          srcUncached)
+{
+    uint64_t planeBytes = (uint64_t)rowSize * height;
+    uint32_t workerNum  = 0;
+    if (workerPool)
+    {
+        workerNum = (uint32_t)std::min(planeBytes / m_bytesPerWork, (uint64_t)workerPool->GetMaxConcurrency());
+    }
+
+    if (workerNum <= 1)
+    {
+        CopyRows(dst, dstPitch, src, srcPitch, rowSize, height, srcUncached);
+        return;
+    }
+
+    // Split the plane into bands of rows, copied by the pool workers and the caller.
+    uint32_t bandHeight = 0;
+    uint32_t bandNum    = SplitBands(height, workerNum, bandHeight);
+    workerPool->Run(bandNum, [&](uint32_t band) {
+        uint32_t y = band * bandHeight;
+        CopyRows(dst + (size_t)y * dstPitch, dstPitch, src + (size_t)y * srcPitch, srcPitch,
+            rowSize, std::min(bandHeight, height - y), srcUncached);
+    });
+}
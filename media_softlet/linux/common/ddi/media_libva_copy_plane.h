@@ -0,0 +1,176 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     media_libva_copy_plane.h
+//! \brief    CPU plane copy of vaGetImage/vaPutImage and its worker pool
+//! \details  Has no OS or libva dependency, so it is tested directly by the ULT.
+//!
+
+#ifndef __MEDIA_LIBVA_COPY_PLANE_H__
+#define __MEDIA_LIBVA_COPY_PLANE_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "media_class_trace.h"
+
+//!
+//! \brief  Small pool of persistent worker threads owned by the media context
+//! \details Splits a job into tasks run by the workers and the calling thread.
+//!          Threads are started on the first job, so contexts which never use
+//!          the pool do not pay for them. Only one job runs at a time, a
+//!          caller finding the pool busy runs all of its tasks inline.
+//!
+class MediaLibvaUtilNext_WorkerPool {
+public:
+    //!
+    //! \brief  Constructor
+    //! \param  [in] workerNum
+    //!         Max number of worker threads, the calling thread is not included
+    //!
+    MediaLibvaUtilNext_WorkerPool(uint32_t workerNum);
+    ~MediaLibvaUtilNext_WorkerPool();
+
+    //!
+    //! \brief  Run task(0) .. task(taskNum - 1) and wait for all of them
+    //!
+    //! \param  [in] taskNum
+    //!         Number of tasks
+    //! \param  [in] task
+    //!         Task function, called with the task index
+    //!
+    void Run(uint32_t taskNum, const std::function<void(uint32_t)> &task);
+
+    //!
+    //! \brief  Max number of threads running tasks of one job, caller included
+    //!
+    uint32_t GetMaxConcurrency() const { return m_workerNum.load() + 1; }
+
+private:
+    void StartWorkers();
+    void WorkerThread();
+    bool RunNextTask(std::unique_lock<std::mutex> &lock);
+
+    std::atomic<uint32_t>                 m_workerNum;             // lowered by StartWorkers if threads run out
+    std::vector<std::thread>              m_workers;
+    std::mutex                            m_jobMutex;              // serializes jobs
+    std::mutex                            m_mutex;                 // guards the state below
+    std::condition_variable               m_taskCond;
+    std::condition_variable               m_doneCond;
+    const std::function<void(uint32_t)>  *m_task        = nullptr;
+    uint32_t                              m_taskNum     = 0;
+    uint32_t                              m_nextTask    = 0;
+    uint32_t                              m_pending     = 0;
+    bool                                  m_stop        = false;
+MEDIA_CLASS_DEFINE_END(MediaLibvaUtilNext_WorkerPool)
+};
+
+class MediaLibvaUtilNext_CopyPlane {
+public:
+    //!
+    //! \brief  Copy a plane, large planes are split into bands of rows
+    //! \details The bands are copied by the worker pool and the calling thread,
+    //!          one band per m_bytesPerWork bytes up to the pool concurrency.
+    //!
+    //! \param  [in] workerPool
+    //!         Worker pool, the plane is copied on the calling thread if nullptr
+    //! \param  [in] dst
+    //!         Destination plane
+    //! \param  [in] dstPitch
+    //!         Destination plane pitch
+    //! \param  [in] src
+    //!         Source plane
+    //! \param  [in] srcPitch
+    //!         Source plane pitch
+    //! \param  [in] rowSize
+    //!         Bytes to copy per row
+    //! \param  [in] height
+    //!         Number of rows
+    //! \param  [in] srcUncached
+    //!         Source is a write-combined surface mapping, read it with streaming loads when the cpu supports them
+    //!
+    static void Copy(
+        MediaLibvaUtilNext_WorkerPool *workerPool,
+        uint8_t       *dst,
+        uint32_t      dstPitch,
+        const uint8_t *src,
+        uint32_t      srcPitch,
+        uint32_t      rowSize,
+        uint32_t      height,
+        bool          srcUncached);
+
+    //!
+    //! \brief  Copy rows of a plane band on the calling thread
+    //!
+    //! \param  [in] dst
+    //!         Destination of the first row
+    //! \param  [in] dstPitch
+    //!         Destination plane pitch
+    //! \param  [in] src
+    //!         Source of the first row
+    //! \param  [in] srcPitch
+    //!         Source plane pitch
+    //! \param  [in] rowSize
+    //!         Bytes to copy per row
+    //! \param  [in] height
+    //!         Number of rows
+    //! \param  [in] srcUncached
+    //!         Read source with streaming loads
+    //!
+    static void CopyRows(
+        uint8_t       *dst,
+        uint32_t      dstPitch,
+        const uint8_t *src,
+        uint32_t      srcPitch,
+        uint32_t      rowSize,
+        uint32_t      height,
+        bool          srcUncached);
+
+    //!
+    //! \brief  Split height rows into at most workerNum bands of bandHeight rows
+    //! \details Every band but the last has bandHeight rows, the last one has
+    //!          the remaining rows. Fewer bands than workerNum are returned when
+    //!          the rows do not divide evenly, e.g. 5 rows for 4 workers give 3
+    //!          bands of 2, 2 and 1 rows, and never more bands than rows.
+    //!
+    //! \param  [in] height
+    //!         Number of rows
+    //! \param  [in] workerNum
+    //!         Max number of bands
+    //! \param  [out] bandHeight
+    //!         Rows per band
+    //!
+    //! \return uint32_t
+    //!         Number of bands, 0 if height or workerNum is 0
+    //!
+    static uint32_t SplitBands(uint32_t height, uint32_t workerNum, uint32_t &bandHeight);
+
+    static constexpr uint64_t m_bytesPerWork = 4 * 1024 * 1024;  //!< Min bytes of a band worth an extra thread
+
+MEDIA_CLASS_DEFINE_END(MediaLibvaUtilNext_CopyPlane)
+};
+
+#endif  //__MEDIA_LIBVA_COPY_PLANE_H__
@@ -30,6 +30,7 @@
 #endif
 
 #include <drm_fourcc.h>
+#include <vector>
 
 #include "media_libva_util_next.h"
 #include "media_libva_interface_next.h"
@@ -47,6 +48,7 @@
 #include "media_libva_register.h"
 
 MEDIA_MUTEX_T MediaLibvaInterfaceNext::m_GlobalMutex = MEDIA_MUTEX_INITIALIZER;
+MEDIA_MUTEX_T MediaLibvaInterfaceNext::m_compListMutex = MEDIA_MUTEX_INITIALIZER;
 
 void MediaLibvaInterfaceNext::FreeForMediaContext(PDDI_MEDIA_CONTEXT mediaCtx)
 {
@@ -58,6 +60,10 @@ void MediaLibvaInterfaceNext::FreeForMediaContext(PDDI_MEDIA_CONTEXT mediaCtx)
     {
         mediaCtx->SkuTable.reset();
         mediaCtx->WaTable.reset();
+        if (mediaCtx->pSurfaceHeap)
+        {
+            MOS_Delete(mediaCtx->pSurfaceHeap->pBoIndex);
+        }
         MOS_FreeMemory(mediaCtx->pSurfaceHeap);
         MOS_FreeMemory(mediaCtx->pBufferHeap);
         MOS_FreeMemory(mediaCtx->pImageHeap);
@@ -311,13 +317,17 @@ VAStatus MediaLibvaInterfaceNext::Initialize (
     mediaCtx->modularizedGpuCtxEnabled = true;
 
     mediaCtx->m_userSettingPtr  = std::make_shared<MediaUserSetting::MediaUserSetting>();
+    mediaCtx->m_copyWorkerPool  = std::make_shared<MediaLibvaUtilNext_WorkerPool>(DDI_COPY_WORKER_NUM);
 
     MOS_CONTEXT mosCtx          = {};
     mosCtx.fd                   = mediaCtx->fd;
     mosCtx.m_userSettingPtr     = mediaCtx->m_userSettingPtr;
 
-    MosInterface::InitOsUtilities(&mosCtx);
-    MosOcaInterfaceSpecific::InitInterface(&mosCtx);
+    {
+        MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_OS_UTILITIES);
+        MosInterface::InitOsUtilities(&mosCtx);
+        MosOcaInterfaceSpecific::InitInterface(&mosCtx);
+    }
 
     mediaCtx->pGtSystemInfo = (MEDIA_SYSTEM_INFO *)MOS_AllocAndZeroMemory(sizeof(MEDIA_SYSTEM_INFO));
     if (nullptr == mediaCtx->pGtSystemInfo)
@@ -326,11 +336,14 @@ VAStatus MediaLibvaInterfaceNext::Initialize (
         return VA_STATUS_ERROR_ALLOCATION_FAILED;
     }
 
-    if (MosInterface::CreateOsDeviceContext(&mosCtx, &mediaCtx->m_osDeviceContext) != MOS_STATUS_SUCCESS)
     {
-        DDI_ASSERTMESSAGE("Unable to create MOS device context.");
-        FreeForMediaContext(mediaCtx);
-        return VA_STATUS_ERROR_OPERATION_FAILED;
+        MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_OS_DEVICE_CONTEXT);
+        if (MosInterface::CreateOsDeviceContext(&mosCtx, &mediaCtx->m_osDeviceContext) != MOS_STATUS_SUCCESS)
+        {
+            DDI_ASSERTMESSAGE("Unable to create MOS device context.");
+            FreeForMediaContext(mediaCtx);
+            return VA_STATUS_ERROR_OPERATION_FAILED;
+        }
     }
     mediaCtx->pDrmBufMgr                = mosCtx.bufmgr;
     mediaCtx->iDeviceId                 = mosCtx.iDeviceId;
@@ -355,14 +368,20 @@ VAStatus MediaLibvaInterfaceNext::Initialize (
 
     mediaCtx->pMediaCopyState           = *mosCtx.ppMediaCopyState;
 
-    if (HeapInitialize(mediaCtx) != VA_STATUS_SUCCESS)
     {
-        DestroyMediaContextMutex(mediaCtx);
-        FreeForMediaContext(mediaCtx);
-        return VA_STATUS_ERROR_ALLOCATION_FAILED;
+        MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_HEAP);
+        if (HeapInitialize(mediaCtx) != VA_STATUS_SUCCESS)
+        {
+            DestroyMediaContextMutex(mediaCtx);
+            FreeForMediaContext(mediaCtx);
+            return VA_STATUS_ERROR_ALLOCATION_FAILED;
+        }
     }
 
-    mediaCtx->m_hwInfo = MediaInterfacesHwInfoDevice::CreateFactory(mediaCtx->platform);
+    {
+        MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_HW_INFO);
+        mediaCtx->m_hwInfo = MediaInterfacesHwInfoDevice::CreateFactory(mediaCtx->platform);
+    }
     if(!mediaCtx->m_hwInfo)
     {
         DDI_ASSERTMESSAGE("Query hwInfo failed. Not supported GFX device.");
@@ -371,7 +390,10 @@ VAStatus MediaLibvaInterfaceNext::Initialize (
         return VA_STATUS_ERROR_ALLOCATION_FAILED;
     }
 
-    mediaCtx->m_capsNext = MediaLibvaCapsNext::CreateCaps(mediaCtx);
+    {
+        MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_CAPS);
+        mediaCtx->m_capsNext = MediaLibvaCapsNext::CreateCaps(mediaCtx);
+    }
     if (!mediaCtx->m_capsNext)
     {
         DDI_ASSERTMESSAGE("Caps create failed. Not supported GFX device.");
@@ -434,6 +456,7 @@ VAStatus MediaLibvaInterfaceNext::Initialize (
 VAStatus MediaLibvaInterfaceNext::InitCompList(PDDI_MEDIA_CONTEXT mediaCtx)
 {
     DDI_FUNC_ENTER;
+    MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_COMP_LIST);
 
     VAStatus status = VA_STATUS_SUCCESS;
     mediaCtx->m_compList[CompCommon] = MOS_New(DdiMediaFunctions);
@@ -445,10 +468,19 @@ VAStatus MediaLibvaInterfaceNext::InitCompList(PDDI_MEDIA_CONTEXT mediaCtx)
         return status;
     }
 
+    const char *lazyCompInit  = getenv(DDI_LAZY_COMP_INIT_ENV);
+    mediaCtx->m_lazyCompInit  = (lazyCompInit != nullptr && atoi(lazyCompInit) != 0);
+
     for(int i = CompCommon + 1; i < CompCount; i++)
     {
         if (FunctionsFactory::IsRegistered((CompType)i))
         {
+            if (mediaCtx->m_lazyCompInit)
+            {
+                // created by GetComponent on first use
+                mediaCtx->m_compList[i] = nullptr;
+                continue;
+            }
             mediaCtx->m_compList[i] = FunctionsFactory::Create((CompType)i);
             if (nullptr == mediaCtx->m_compList[i])
             {
@@ -486,6 +518,37 @@ void MediaLibvaInterfaceNext::ReleaseCompList(PDDI_MEDIA_CONTEXT mediaCtx)
     }
 }
 
+DdiMediaFunctions *MediaLibvaInterfaceNext::GetComponent(PDDI_MEDIA_CONTEXT mediaCtx, CompType type)
+{
+    if (mediaCtx == nullptr || (uint32_t)type >= CompCount)
+    {
+        return nullptr;
+    }
+
+    // Slots are only ever filled once, so a published component needs no lock
+    DdiMediaFunctions *comp = __atomic_load_n(&mediaCtx->m_compList[type], __ATOMIC_ACQUIRE);
+    if (comp != nullptr || !mediaCtx->m_lazyCompInit)
+    {
+        return comp;
+    }
+
+    MediaLibvaUtilNext_LockGuard guard(&m_compListMutex);
+    comp = mediaCtx->m_compList[type];
+    if (comp == nullptr && FunctionsFactory::IsRegistered(type))
+    {
+        MediaLibvaUtilNext_InitPhase phase(DDI_INIT_PHASE_LAZY_COMP, type);
+        comp = FunctionsFactory::Create(type);
+        if (comp == nullptr)
+        {
+            DDI_ASSERTMESSAGE("Unable to create compList %d.", type);
+            return nullptr;
+        }
+        __atomic_store_n(&mediaCtx->m_compList[type], comp, __ATOMIC_RELEASE);
+    }
+
+    return comp;
+}
+
 void MediaLibvaInterfaceNext::FreeSurfaceHeapElements(PDDI_MEDIA_CONTEXT mediaCtx)
 {
     DDI_FUNC_ENTER;
@@ -613,6 +676,7 @@ VAStatus MediaLibvaInterfaceNext::HeapDestroy(PDDI_MEDIA_CONTEXT mediaCtx)
     DDI_CHK_NULL(mediaCtx, "nullptr ctx", VA_STATUS_ERROR_INVALID_CONTEXT);
     // destroy heaps
     MOS_FreeMemory(mediaCtx->pSurfaceHeap->pHeapBase);
+    MOS_Delete(mediaCtx->pSurfaceHeap->pBoIndex);
     MOS_FreeMemory(mediaCtx->pSurfaceHeap);
 
     MOS_FreeMemory(mediaCtx->pBufferHeap->pHeapBase);
@@ -1121,20 +1185,23 @@ VAStatus MediaLibvaInterfaceNext::CreateContext (
 
     if(mediaDrvCtx->m_capsNext->m_capsTable->IsDecConfigId(configId) && REMOVE_CONFIG_ID_DEC_OFFSET(configId) < mediaDrvCtx->m_capsNext->m_capsTable->m_configList.size())
     {
-        DDI_CHK_NULL(mediaDrvCtx->m_compList[CompDecode],  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
-        vaStatus = mediaDrvCtx->m_compList[CompDecode]->CreateContext(
+        DdiMediaFunctions *decodeComp = GetComponent(mediaDrvCtx, CompDecode);
+        DDI_CHK_NULL(decodeComp,  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+        vaStatus = decodeComp->CreateContext(
             ctx, configId, pictureWidth, pictureHeight, flag, renderTarget, renderTargetsNum, context);
     }
     else if(mediaDrvCtx->m_capsNext->m_capsTable->IsEncConfigId(configId) && REMOVE_CONFIG_ID_ENC_OFFSET(configId) < mediaDrvCtx->m_capsNext->m_capsTable->m_configList.size())
     {
-        DDI_CHK_NULL(mediaDrvCtx->m_compList[CompEncode],  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
-        vaStatus = mediaDrvCtx->m_compList[CompEncode]->CreateContext(
+        DdiMediaFunctions *encodeComp = GetComponent(mediaDrvCtx, CompEncode);
+        DDI_CHK_NULL(encodeComp,  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+        vaStatus = encodeComp->CreateContext(
             ctx, configId, pictureWidth, pictureHeight, flag, renderTarget, renderTargetsNum, context);
     }
     else if(mediaDrvCtx->m_capsNext->m_capsTable->IsVpConfigId(configId) && mediaDrvCtx->m_capsNext->m_capsTable->m_configList.size())
     {
-        DDI_CHK_NULL(mediaDrvCtx->m_compList[CompVp],  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
-        vaStatus = mediaDrvCtx->m_compList[CompVp]->CreateContext(
+        DdiMediaFunctions *vpComp = GetComponent(mediaDrvCtx, CompVp);
+        DDI_CHK_NULL(vpComp,  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+        vaStatus = vpComp->CreateContext(
             ctx, configId, pictureWidth, pictureHeight, flag, renderTarget, renderTargetsNum, context);
     }
     else
@@ -1169,7 +1236,8 @@ VAStatus MediaLibvaInterfaceNext::DestroyContext (
     DDI_CHK_NULL(mediaDrvCtx, "nullptr mediaDrvCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
 
     CompType componentIndex = MapComponentFromCtxType(ctxType);
-    DDI_CHK_NULL(mediaDrvCtx->m_compList[componentIndex], "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *comp = GetComponent(mediaDrvCtx, componentIndex);
+    DDI_CHK_NULL(comp, "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
 
     if(componentIndex != CompCodec && componentIndex != CompEncode &&
         componentIndex != CompDecode && componentIndex != CompVp &&
@@ -1177,7 +1245,7 @@ VAStatus MediaLibvaInterfaceNext::DestroyContext (
     {
         return VA_STATUS_ERROR_INVALID_CONTEXT;
     }
-    return mediaDrvCtx->m_compList[componentIndex]->DestroyContext(ctx, context);
+    return comp->DestroyContext(ctx, context);
 }
 
 VAStatus MediaLibvaInterfaceNext::CreateBuffer (
@@ -1205,11 +1273,12 @@ VAStatus MediaLibvaInterfaceNext::CreateBuffer (
     DDI_CHK_NULL(ctxPtr,    "nullptr ctxPtr",   VA_STATUS_ERROR_INVALID_CONTEXT);
 
     CompType componentIndex = MapComponentFromCtxType(ctxType);
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex], "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp, "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
     *bufId = VA_INVALID_ID;
 
     MosUtilities::MosLockMutex(&mediaCtx->BufferMutex);
-    VAStatus vaStatus = mediaCtx->m_compList[componentIndex]->CreateBuffer(ctx, context, type, size, elementsNum, data, bufId);
+    VAStatus vaStatus = comp->CreateBuffer(ctx, context, type, size, elementsNum, data, bufId);
     MosUtilities::MosUnlockMutex(&mediaCtx->BufferMutex);
 
     MOS_TraceEventExt(EVENT_VA_BUFFER, EVENT_TYPE_END, bufId, sizeof(bufId), nullptr, 0);
@@ -1240,9 +1309,10 @@ VAStatus MediaLibvaInterfaceNext::DestroyBuffer (
     ctxType = MediaLibvaCommonNext::GetCtxTypeFromVABufferID(mediaCtx, bufId);
 
     CompType componentIndex = MapComponentFromCtxType(ctxType);
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex], "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp, "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    VAStatus vaStatus = mediaCtx->m_compList[componentIndex]->DestroyBuffer(mediaCtx, bufId);
+    VAStatus vaStatus = comp->DestroyBuffer(mediaCtx, bufId);
 
     MOS_TraceEventExt(EVENT_VA_FREE_BUFFER, EVENT_TYPE_END, nullptr, 0, nullptr, 0);
     return vaStatus;
@@ -1281,9 +1351,10 @@ VAStatus MediaLibvaInterfaceNext::BeginPicture (
     MosUtilities::MosUnlockMutex(&mediaCtx->SurfaceMutex);
 
     CompType componentIndex = MapComponentFromCtxType(ctxType);
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex],  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp,  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[componentIndex]->BeginPicture(ctx, context, renderTarget);
+    return comp->BeginPicture(ctx, context, renderTarget);
 }
 
 VAStatus MediaLibvaInterfaceNext::RenderPicture (
@@ -1312,9 +1383,10 @@ VAStatus MediaLibvaInterfaceNext::RenderPicture (
     uint32_t ctxType = DDI_MEDIA_CONTEXT_TYPE_NONE;
     void     *ctxPtr = MediaLibvaCommonNext::GetContextFromContextID(ctx, context, &ctxType);
     CompType componentIndex = MapComponentFromCtxType(ctxType);
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex],  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp,  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[componentIndex]->RenderPicture(ctx, context, buffers, buffersNum);
+    return comp->RenderPicture(ctx, context, buffers, buffersNum);
 }
 
 VAStatus MediaLibvaInterfaceNext::EndPicture(
@@ -1331,9 +1403,10 @@ VAStatus MediaLibvaInterfaceNext::EndPicture(
     PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,                              "nullptr mediaCtx",  VA_STATUS_ERROR_INVALID_CONTEXT);
     CompType componentIndex = MapComponentFromCtxType(ctxType);
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex],  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp,  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    VAStatus vaStatus = mediaCtx->m_compList[componentIndex]->EndPicture(ctx, context);
+    VAStatus vaStatus = comp->EndPicture(ctx, context);
 
     MOS_TraceEventExt(EVENT_VA_PICTURE, EVENT_TYPE_END, &context, sizeof(context), &vaStatus, sizeof(vaStatus));
     PERF_UTILITY_STOP_ONCE("First Frame Time", PERF_MOS, PERF_LEVEL_DDI);
@@ -1385,8 +1458,142 @@ VAStatus MediaLibvaInterfaceNext::SyncSurface(
         componentIndex = CompVp;
     }
 
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex],  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
-    return mediaCtx->m_compList[componentIndex]->StatusCheck(mediaCtx, surface, renderTarget);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp,  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    return comp->StatusCheck(mediaCtx, surface, renderTarget);
+}
+
+VAStatus MediaLibvaInterfaceNext::SyncSurfaces(
+    VADriverContextP    ctx,
+    VASurfaceID         *surfaces,
+    uint32_t            numSurfaces,
+    int64_t             timeoutNs)
+{
+    DDI_FUNC_ENTER;
+
+    DDI_CHK_NULL(ctx,      "nullptr ctx",      VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(surfaces, "nullptr surfaces", VA_STATUS_ERROR_INVALID_PARAMETER);
+    DDI_CHK_CONDITION(numSurfaces == 0, "Invalid numSurfaces", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
+    DDI_CHK_NULL(mediaCtx,               "nullptr mediaCtx",                VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(mediaCtx->pSurfaceHeap, "nullptr mediaCtx->pSurfaceHeap",  VA_STATUS_ERROR_INVALID_CONTEXT);
+
+    // Every started surface sync gets its end event, also when returning early
+    struct SyncTraceEnd
+    {
+        uint32_t pending = 0;
+        void End()
+        {
+            pending--;
+            MOS_TraceEventExt(EVENT_VA_SYNC, EVENT_TYPE_END, nullptr, 0, nullptr, 0);
+        }
+        ~SyncTraceEnd()
+        {
+            while (pending > 0)
+            {
+                End();
+            }
+        }
+    } traceEnd;
+
+    std::vector<DDI_MEDIA_SURFACE *> mediaSurfaces(numSurfaces, nullptr);
+    std::vector<MOS_LINUX_BO *>      bos;
+    bos.reserve(numSurfaces);
+    for (uint32_t i = 0; i < numSurfaces; i++)
+    {
+        MOS_TraceEventExt(EVENT_VA_SYNC, EVENT_TYPE_START, &surfaces[i], sizeof(VAGenericID), nullptr, 0);
+        traceEnd.pending++;
+        DDI_CHK_LESS((uint32_t)surfaces[i], mediaCtx->pSurfaceHeap->uiAllocatedHeapElements, "Invalid renderTarget", VA_STATUS_ERROR_INVALID_SURFACE);
+
+        DDI_MEDIA_SURFACE *surface = MediaLibvaCommonNext::GetSurfaceFromVASurfaceID(mediaCtx, surfaces[i]);
+        DDI_CHK_NULL(surface, "nullptr surface", VA_STATUS_ERROR_INVALID_CONTEXT);
+        if (surface->pCurrentFrameSemaphore)
+        {
+            MediaLibvaUtilNext::WaitSemaphore(surface->pCurrentFrameSemaphore);
+            MediaLibvaUtilNext::PostSemaphore(surface->pCurrentFrameSemaphore);
+        }
+        MOS_TraceEventExt(EVENT_VA_SYNC, EVENT_TYPE_INFO, surface->bo? &surface->bo->handle:nullptr, sizeof(uint32_t), nullptr, 0);
+
+        mediaSurfaces[i] = surface;
+        if (surface->bo)
+        {
+            bos.push_back(surface->bo);
+        }
+    }
+
+    // zero is an expected return value when not hit timeout
+    if (!bos.empty() &&
+        0 != mos_bo_wait_multi(bos.data(), (int)bos.size(), timeoutNs < 0 ? DDI_BO_INFINITE_TIMEOUT : timeoutNs))
+    {
+        DDI_NORMALMESSAGE("SyncSurfaces: surface is still used by HW\n\r");
+        return VA_STATUS_ERROR_TIMEDOUT;
+    }
+
+    for (uint32_t i = 0; i < numSurfaces; i++)
+    {
+        traceEnd.End();
+
+        DDI_MEDIA_SURFACE *surface       = mediaSurfaces[i];
+        CompType          componentIndex = CompCommon;
+        PDDI_DECODE_CONTEXT decCtx = (PDDI_DECODE_CONTEXT)surface->pDecCtx;
+        if (decCtx && surface->curCtxType == DDI_MEDIA_CONTEXT_TYPE_DECODER)
+        {
+            componentIndex = CompDecode;
+        }
+        else if (surface->curCtxType == DDI_MEDIA_CONTEXT_TYPE_VP)
+        {
+            componentIndex = CompVp;
+        }
+
+        DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+        DDI_CHK_NULL(comp,  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+        VAStatus vaStatus = comp->StatusCheck(mediaCtx, surface, surfaces[i]);
+        if (vaStatus != VA_STATUS_SUCCESS)
+        {
+            return vaStatus;
+        }
+    }
+
+    return VA_STATUS_SUCCESS;
+}
+
+VAStatus MediaLibvaInterfaceNext::ExportSurfaceSyncFd(
+    VADriverContextP    ctx,
+    VASurfaceID         surfaceId,
+    int32_t             *syncFd)
+{
+    DDI_FUNC_ENTER;
+
+    DDI_CHK_NULL(ctx,    "nullptr ctx",    VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(syncFd, "nullptr syncFd", VA_STATUS_ERROR_INVALID_PARAMETER);
+
+    PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
+    DDI_CHK_NULL(mediaCtx,               "nullptr mediaCtx",                VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(mediaCtx->pSurfaceHeap, "nullptr mediaCtx->pSurfaceHeap",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_LESS((uint32_t)surfaceId, mediaCtx->pSurfaceHeap->uiAllocatedHeapElements, "Invalid surfaceId", VA_STATUS_ERROR_INVALID_SURFACE);
+
+    DDI_MEDIA_SURFACE *surface = MediaLibvaCommonNext::GetSurfaceFromVASurfaceID(mediaCtx, surfaceId);
+    DDI_CHK_NULL(surface,     "nullptr surface",     VA_STATUS_ERROR_INVALID_SURFACE);
+    DDI_CHK_NULL(surface->bo, "nullptr surface->bo", VA_STATUS_ERROR_INVALID_SURFACE);
+
+    // Make sure the frame in flight is submitted, so its fences are in the bo deps.
+    if (surface->pCurrentFrameSemaphore)
+    {
+        MediaLibvaUtilNext::WaitSemaphore(surface->pCurrentFrameSemaphore);
+        MediaLibvaUtilNext::PostSemaphore(surface->pCurrentFrameSemaphore);
+    }
+
+    int fd  = -1;
+    int ret = mos_bo_export_sync_fd(surface->bo, &fd);
+    if (ret != 0)
+    {
+        DDI_ASSERTMESSAGE("Failed to export sync fd for surface %d, ret %d", surfaceId, ret);
+        return (ret == -EPERM) ? VA_STATUS_ERROR_UNIMPLEMENTED : VA_STATUS_ERROR_OPERATION_FAILED;
+    }
+    *syncFd = fd;
+
+    return VA_STATUS_SUCCESS;
 }
 
 VAStatus MediaLibvaInterfaceNext::QuerySurfaceError(
@@ -1425,9 +1632,10 @@ VAStatus MediaLibvaInterfaceNext::PutSurface(
     PDDI_MEDIA_CONTEXT mediaDrvCtx   = GetMediaContext(ctx);
 
     DDI_CHK_NULL(mediaDrvCtx,                      "nullptr mediaDrvCtx",   VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaDrvCtx->m_compList[CompVp],  "nullptr complist",      VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *vpComp = GetComponent(mediaDrvCtx, CompVp);
+    DDI_CHK_NULL(vpComp,  "nullptr complist",      VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaDrvCtx->m_compList[CompVp]->PutSurface(ctx, surface, draw, srcx, srcy, srcw, srch, destx, desty, destw, desth, cliprects, numberCliprects, flags);
+    return vpComp->PutSurface(ctx, surface, draw, srcx, srcy, srcw, srch, destx, desty, destw, desth, cliprects, numberCliprects, flags);
 }
 
 VAImage* MediaLibvaInterfaceNext::GetVAImageFromVAImageID(PDDI_MEDIA_CONTEXT mediaCtx, VAImageID imageID)
@@ -1481,8 +1689,9 @@ VAStatus MediaLibvaInterfaceNext::DestroyImage(
         return VA_STATUS_ERROR_INVALID_PARAMETER;
     }
 
-    DDI_CHK_NULL(mediaCtx->m_compList[CompCommon],  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
-    mediaCtx->m_compList[CompCommon]->DestroyBuffer(mediaCtx, vaImage->buf);
+    DdiMediaFunctions *commonComp = GetComponent(mediaCtx, CompCommon);
+    DDI_CHK_NULL(commonComp,  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    commonComp->DestroyBuffer(mediaCtx, vaImage->buf);
     MOS_FreeMemory(vaImage);
 
     DestroyImageFromVAImageID(mediaCtx, image);
@@ -1492,19 +1701,19 @@ VAStatus MediaLibvaInterfaceNext::DestroyImage(
 }
 
 void MediaLibvaInterfaceNext::CopyPlane(
+    PDDI_MEDIA_CONTEXT mediaCtx,
     uint8_t  *dst,
     uint32_t dstPitch,
     uint8_t  *src,
     uint32_t srcPitch,
-    uint32_t height)
+    uint32_t height,
+    bool     srcUncached)
 {
-    uint32_t rowSize = std::min(dstPitch, srcPitch);
-    for (int y = 0; y < height; y += 1)
-    {
-        MOS_SecureMemcpy(dst, rowSize, src, rowSize);
-        dst += dstPitch;
-        src += srcPitch;
-    }
+    DDI_CHK_NULL(dst, "nullptr dst", );
+    DDI_CHK_NULL(src, "nullptr src", );
+
+    MediaLibvaUtilNext_CopyPlane::Copy(mediaCtx ? mediaCtx->m_copyWorkerPool.get() : nullptr,
+        dst, dstPitch, src, srcPitch, std::min(dstPitch, srcPitch), height, srcUncached);
 }
 
 VAStatus MediaLibvaInterfaceNext::CopySurfaceToImage(
@@ -1551,7 +1760,7 @@ VAStatus MediaLibvaInterfaceNext::CopySurfaceToImage(
     uint8_t *ySrc = (uint8_t*)surfData;
     uint8_t *yDst = (uint8_t*)imageData;
 
-    CopyPlane(yDst, image->pitches[0], ySrc, surface->iPitch, image->height);
+    CopyPlane(mediaCtx, yDst, image->pitches[0], ySrc, surface->iPitch, image->height, true);
     if (image->num_planes > 1)
     {
         uint8_t *uSrc = ySrc + surface->iPitch * surface->iHeight;
@@ -1562,13 +1771,13 @@ VAStatus MediaLibvaInterfaceNext::CopySurfaceToImage(
         uint32_t imageChromaHeight = 0;
         GetChromaPitchHeight(MediaFormatToOsFormat(surface->format), surface->iPitch, surface->iHeight, &chromaPitch, &chromaHeight);
         GetChromaPitchHeight(image->format.fourcc, image->pitches[0], image->height, &imageChromaPitch, &imageChromaHeight);
-        CopyPlane(uDst, image->pitches[1], uSrc, chromaPitch, imageChromaHeight);
+        CopyPlane(mediaCtx, uDst, image->pitches[1], uSrc, chromaPitch, imageChromaHeight, true);
 
         if(image->num_planes > 2)
         {
             uint8_t *vSrc = uSrc + chromaPitch * chromaHeight;
             uint8_t *vDst = yDst + image->offsets[2];
-            CopyPlane(vDst, image->pitches[2], vSrc, chromaPitch, imageChromaHeight);
+            CopyPlane(mediaCtx, vDst, image->pitches[2], vSrc, chromaPitch, imageChromaHeight, true);
         }
     }
 
@@ -1633,8 +1842,9 @@ VAStatus MediaLibvaInterfaceNext::GetImage(
     {
         VAContextID context = VA_INVALID_ID;
         //Create VP Context.
-        DDI_CHK_NULL(mediaCtx->m_compList[CompVp],  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
-        vaStatus = mediaCtx->m_compList[CompVp]->CreateContext(ctx, 0, 0, 0, 0, 0, 0, &context);
+        DdiMediaFunctions *vpComp = GetComponent(mediaCtx, CompVp);
+        DDI_CHK_NULL(vpComp,  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+        vaStatus = vpComp->CreateContext(ctx, 0, 0, 0, 0, 0, 0, &context);
         DDI_CHK_RET(vaStatus, "Create VP Context failed.");
 
         //Create target surface for VP pipeline.
@@ -1642,7 +1852,7 @@ VAStatus MediaLibvaInterfaceNext::GetImage(
         if (mediaFmt == Media_Format_Count)
         {
             DDI_ASSERTMESSAGE("Unsupported surface type.");
-            mediaCtx->m_compList[CompVp]->DestroyContext(ctx, context);
+            vpComp->DestroyContext(ctx, context);
             return VA_STATUS_ERROR_UNSUPPORTED_RT_FORMAT;
         }
 
@@ -1650,7 +1860,7 @@ VAStatus MediaLibvaInterfaceNext::GetImage(
         if (!surfDesc)
         {
             DDI_ASSERTMESSAGE("nullptr surfDesc.");
-            mediaCtx->m_compList[CompVp]->DestroyContext(ctx, context);
+            vpComp->DestroyContext(ctx, context);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
 
@@ -1664,7 +1874,7 @@ VAStatus MediaLibvaInterfaceNext::GetImage(
         if (VA_INVALID_SURFACE == targetSurface)
         {
             DDI_ASSERTMESSAGE("Create temp surface failed.");
-            mediaCtx->m_compList[CompVp]->DestroyContext(ctx, context);
+            vpComp->DestroyContext(ctx, context);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
 
@@ -1679,18 +1889,18 @@ VAStatus MediaLibvaInterfaceNext::GetImage(
         dstRect.height = vaimg->height;
 
         //Execute VP pipeline.
-        vaStatus = mediaCtx->m_compList[CompVp]->ProcessPipeline(ctx, context, surface, &srcRect, targetSurface, &dstRect);
+        vaStatus = vpComp->ProcessPipeline(ctx, context, surface, &srcRect, targetSurface, &dstRect);
         if (vaStatus != VA_STATUS_SUCCESS)
         {
             DDI_ASSERTMESSAGE("VP Pipeline failed.");
             DestroySurfaces(ctx, &targetSurface, 1);
-            mediaCtx->m_compList[CompVp]->DestroyContext(ctx, context);
+            vpComp->DestroyContext(ctx, context);
             return vaStatus;
         }
         vaStatus = SyncSurface(ctx, targetSurface);
         DDI_CHK_RET(vaStatus, "Sync surface failed.");
 
-        vaStatus = mediaCtx->m_compList[CompVp]->DestroyContext(ctx, context);
+        vaStatus = vpComp->DestroyContext(ctx, context);
         DDI_CHK_RET(vaStatus, "destroy context failed.");
 
         outputSurface = targetSurface;
@@ -1785,8 +1995,9 @@ VAStatus MediaLibvaInterfaceNext::PutImage(
         VAContextID context     = VA_INVALID_ID;
 
         //Create VP Context.
-        DDI_CHK_NULL(mediaCtx->m_compList[CompVp],  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
-        vaStatus = mediaCtx->m_compList[CompVp]->CreateContext(ctx, 0, 0, 0, 0, 0, 0, &context);
+        DdiMediaFunctions *vpComp = GetComponent(mediaCtx, CompVp);
+        DDI_CHK_NULL(vpComp,  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+        vaStatus = vpComp->CreateContext(ctx, 0, 0, 0, 0, 0, 0, &context);
         DDI_CHK_RET(vaStatus, "Create VP Context failed");
 
         //Create temp surface for VP pipeline.
@@ -1860,7 +2071,7 @@ VAStatus MediaLibvaInterfaceNext::PutImage(
         dstRect.height = destHeight;
 
         //Execute VP pipeline.
-        vaStatus = mediaCtx->m_compList[CompVp]->ProcessPipeline(ctx, context, tempSurface, &srcRect, surface, &dstRect);
+        vaStatus = vpComp->ProcessPipeline(ctx, context, tempSurface, &srcRect, surface, &dstRect);
         if (vaStatus != VA_STATUS_SUCCESS)
         {
             DDI_ASSERTMESSAGE("VP Pipeline failed.");
@@ -1874,7 +2085,7 @@ VAStatus MediaLibvaInterfaceNext::PutImage(
         vaStatus = DestroySurfaces(ctx, &tempSurface, 1);
         DDI_CHK_RET(vaStatus, "destroy surface failed.");
 
-        vaStatus = mediaCtx->m_compList[CompVp]->DestroyContext(ctx, context);
+        vaStatus = vpComp->DestroyContext(ctx, context);
     }
     else
     {
@@ -1911,7 +2122,7 @@ VAStatus MediaLibvaInterfaceNext::PutImage(
         {
             uint8_t *ySrc = (uint8_t *)imageData + vaimg->offsets[0];
             uint8_t *yDst = (uint8_t *)surfData;
-            CopyPlane(yDst, mediaSurface->iPitch, ySrc, vaimg->pitches[0], srcHeight);
+            CopyPlane(mediaCtx, yDst, mediaSurface->iPitch, ySrc, vaimg->pitches[0], srcHeight);
 
             if (vaimg->num_planes > 1)
             {
@@ -1923,12 +2134,12 @@ VAStatus MediaLibvaInterfaceNext::PutImage(
 
                 uint8_t *uSrc = (uint8_t *)imageData + vaimg->offsets[1];
                 uint8_t *uDst = yDst + mediaSurface->iPitch * mediaSurface->iHeight;
-                CopyPlane(uDst, chromaPitch, uSrc, vaimg->pitches[1], chromaHeight);
+                CopyPlane(mediaCtx, uDst, chromaPitch, uSrc, vaimg->pitches[1], chromaHeight);
                 if (vaimg->num_planes > 2)
                 {
                     uint8_t *vSrc = (uint8_t *)imageData + vaimg->offsets[2];
                     uint8_t *vDst = uDst + chromaPitch * chromaHeight;
-                    CopyPlane(vDst, chromaPitch, vSrc, vaimg->pitches[2], chromaHeight);
+                    CopyPlane(mediaCtx, vDst, chromaPitch, vSrc, vaimg->pitches[2], chromaHeight);
                 }
             }
         } 
@@ -2162,9 +2373,10 @@ VAStatus MediaLibvaInterfaceNext::CreateConfig(
     DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", VA_STATUS_ERROR_INVALID_CONTEXT);
 
     CompType componentIndex = MapCompTypeFromEntrypoint(entrypoint);
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex],  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp,  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[componentIndex]->CreateConfig(
+    return comp->CreateConfig(
         ctx, profile, entrypoint, attribList, attribsNum, configId);
 }
 
@@ -2506,9 +2718,10 @@ VAStatus MediaLibvaInterfaceNext::QueryVideoProcFilters(
     DDI_CHK_NULL(ctx, "nullptr ctx", VA_STATUS_ERROR_INVALID_CONTEXT);
     PDDI_MEDIA_CONTEXT mediaCtx   = GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,                      "nullptr mediaCtx",  VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaCtx->m_compList[CompVp],  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *vpComp = GetComponent(mediaCtx, CompVp);
+    DDI_CHK_NULL(vpComp,  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[CompVp]->QueryVideoProcFilters(ctx, context, filters, filtersNum);
+    return vpComp->QueryVideoProcFilters(ctx, context, filters, filtersNum);
 }
 
 VAStatus MediaLibvaInterfaceNext::QueryVideoProcFilterCaps(
@@ -2522,9 +2735,10 @@ VAStatus MediaLibvaInterfaceNext::QueryVideoProcFilterCaps(
     DDI_CHK_NULL(ctx,                          "nullptr ctx",       VA_STATUS_ERROR_INVALID_CONTEXT);
     PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,                     "nullptr mediaCtx",  VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaCtx->m_compList[CompVp], "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *vpComp = GetComponent(mediaCtx, CompVp);
+    DDI_CHK_NULL(vpComp, "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[CompVp]->QueryVideoProcFilterCaps(ctx, context, type, filterCaps, filterCapsNum);
+    return vpComp->QueryVideoProcFilterCaps(ctx, context, type, filterCaps, filterCapsNum);
 }
 
 VAStatus MediaLibvaInterfaceNext::QueryVideoProcPipelineCaps(
@@ -2538,8 +2752,10 @@ VAStatus MediaLibvaInterfaceNext::QueryVideoProcPipelineCaps(
     DDI_CHK_NULL(ctx,                           "nullptr ctx",       VA_STATUS_ERROR_INVALID_CONTEXT);
     PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,                      "nullptr mediaCtx",  VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaCtx->m_compList[CompVp],  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaCtx->m_compList[CompDecode], "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *vpComp = GetComponent(mediaCtx, CompVp);
+    DDI_CHK_NULL(vpComp,  "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *decodeComp = GetComponent(mediaCtx, CompDecode);
+    DDI_CHK_NULL(decodeComp, "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
     if(context < DDI_MEDIA_VACONTEXTID_BASE)
     {
@@ -2549,12 +2765,12 @@ VAStatus MediaLibvaInterfaceNext::QueryVideoProcPipelineCaps(
 
     if ((context & DDI_MEDIA_MASK_VACONTEXT_TYPE) == DDI_MEDIA_SOFTLET_VACONTEXTID_VP_OFFSET)
     {
-        return mediaCtx->m_compList[CompVp]->QueryVideoProcPipelineCaps(ctx, context, filters, filtersNum, pipelineCaps);
+        return vpComp->QueryVideoProcPipelineCaps(ctx, context, filters, filtersNum, pipelineCaps);
     }
     else if ((context & DDI_MEDIA_MASK_VACONTEXT_TYPE) == DDI_MEDIA_SOFTLET_VACONTEXTID_DECODER_OFFSET)
     {
         //Decode+SFC, go SFC path, the restriction here is the capability of SFC
-        return mediaCtx->m_compList[CompDecode]->QueryVideoProcPipelineCaps(ctx, context, filters, filtersNum, pipelineCaps);
+        return decodeComp->QueryVideoProcPipelineCaps(ctx, context, filters, filtersNum, pipelineCaps);
     }
     else
     {
@@ -2877,8 +3093,9 @@ VAStatus MediaLibvaInterfaceNext::SyncSurface2 (
         componentIndex = CompVp;
     }
 
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex],  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
-    return mediaCtx->m_compList[componentIndex]->StatusCheck(mediaCtx, surface, surfaceId);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp,  "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    return comp->StatusCheck(mediaCtx, surface, surfaceId);
 }
 
 VAStatus MediaLibvaInterfaceNext::SyncBuffer (
@@ -3007,9 +3224,10 @@ VAStatus MediaLibvaInterfaceNext::CreateProtectedSession(
     DDI_CHK_NULL(ctx,                          "nullptr ctx",       VA_STATUS_ERROR_INVALID_CONTEXT);
     PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,                     "nullptr mediaCtx",  VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaCtx->m_compList[CompCp], "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *cpComp = GetComponent(mediaCtx, CompCp);
+    DDI_CHK_NULL(cpComp, "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[CompCp]->CreateProtectedSession(ctx, configId, protectedSession);
+    return cpComp->CreateProtectedSession(ctx, configId, protectedSession);
 }
 
 VAStatus MediaLibvaInterfaceNext::DestroyProtectedSession(
@@ -3020,9 +3238,10 @@ VAStatus MediaLibvaInterfaceNext::DestroyProtectedSession(
     DDI_CHK_NULL(ctx,                          "nullptr ctx",       VA_STATUS_ERROR_INVALID_CONTEXT);
     PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,                     "nullptr mediaCtx",  VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaCtx->m_compList[CompCp], "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *cpComp = GetComponent(mediaCtx, CompCp);
+    DDI_CHK_NULL(cpComp, "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[CompCp]->DestroyProtectedSession(ctx, protectedSession);
+    return cpComp->DestroyProtectedSession(ctx, protectedSession);
 }
 
 VAStatus MediaLibvaInterfaceNext::AttachProtectedSession(
@@ -3034,9 +3253,10 @@ VAStatus MediaLibvaInterfaceNext::AttachProtectedSession(
     DDI_CHK_NULL(ctx,                          "nullptr ctx",       VA_STATUS_ERROR_INVALID_CONTEXT);
     PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,                     "nullptr mediaCtx",  VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaCtx->m_compList[CompCp], "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *cpComp = GetComponent(mediaCtx, CompCp);
+    DDI_CHK_NULL(cpComp, "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[CompCp]->AttachProtectedSession(ctx, context, protectedSession);
+    return cpComp->AttachProtectedSession(ctx, context, protectedSession);
 }
 
 VAStatus MediaLibvaInterfaceNext::DetachProtectedSession(
@@ -3047,9 +3267,10 @@ VAStatus MediaLibvaInterfaceNext::DetachProtectedSession(
     DDI_CHK_NULL(ctx,                          "nullptr ctx",       VA_STATUS_ERROR_INVALID_CONTEXT);
     PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,                     "nullptr mediaCtx",  VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaCtx->m_compList[CompCp], "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *cpComp = GetComponent(mediaCtx, CompCp);
+    DDI_CHK_NULL(cpComp, "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[CompCp]->DetachProtectedSession(ctx, context);
+    return cpComp->DetachProtectedSession(ctx, context);
 }
 
 VAStatus MediaLibvaInterfaceNext::ProtectedSessionExecute(
@@ -3061,9 +3282,10 @@ VAStatus MediaLibvaInterfaceNext::ProtectedSessionExecute(
     DDI_CHK_NULL(ctx,                          "nullptr ctx",       VA_STATUS_ERROR_INVALID_CONTEXT);
     PDDI_MEDIA_CONTEXT mediaCtx = GetMediaContext(ctx);
     DDI_CHK_NULL(mediaCtx,                     "nullptr mediaCtx",  VA_STATUS_ERROR_INVALID_CONTEXT);
-    DDI_CHK_NULL(mediaCtx->m_compList[CompCp], "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *cpComp = GetComponent(mediaCtx, CompCp);
+    DDI_CHK_NULL(cpComp, "nullptr complist",  VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    return mediaCtx->m_compList[CompCp]->ProtectedSessionExecute(ctx, protectedSession, data);
+    return cpComp->ProtectedSessionExecute(ctx, protectedSession, data);
 }
 #endif
 
@@ -5207,10 +5429,11 @@ VAStatus MediaLibvaInterfaceNext::MapBufferInternal(
 
     ctxType = MediaLibvaCommonNext::GetCtxTypeFromVABufferID(mediaCtx, bufId);
     CompType componentIndex = MapComponentFromCtxType(ctxType);
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex], "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp, "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
 
     MOS_TraceEventExt(EVENT_VA_MAP, EVENT_TYPE_INFO, &ctxType, sizeof(ctxType), &mediaBuf->uiType, sizeof(uint32_t));
-    vaStatus = mediaCtx->m_compList[componentIndex]->MapBufferInternal(mediaCtx, bufId, buf, flag);
+    vaStatus = comp->MapBufferInternal(mediaCtx, bufId, buf, flag);
 
     MOS_TraceEventExt(EVENT_VA_MAP, EVENT_TYPE_END, nullptr, 0, nullptr, 0);
     return vaStatus;
@@ -5240,9 +5463,10 @@ VAStatus MediaLibvaInterfaceNext::UnmapBuffer(
 
     ctxType = MediaLibvaCommonNext::GetCtxTypeFromVABufferID(mediaCtx, bufId);
     CompType componentIndex = MapComponentFromCtxType(ctxType);
-    DDI_CHK_NULL(mediaCtx->m_compList[componentIndex], "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
+    DdiMediaFunctions *comp = GetComponent(mediaCtx, componentIndex);
+    DDI_CHK_NULL(comp, "nullptr complist", VA_STATUS_ERROR_INVALID_CONTEXT);
 
-    vaStatus = mediaCtx->m_compList[componentIndex]->UnmapBuffer(mediaCtx, bufId);
+    vaStatus = comp->UnmapBuffer(mediaCtx, bufId);
 
     MOS_TraceEventExt(EVENT_VA_MAP, EVENT_TYPE_END, nullptr, 0, nullptr, 0);
     return vaStatus;
@@ -33,6 +33,9 @@
 #include "media_libva_common_next.h"
 #include "ddi_media_functions.h"
 
+#define DDI_LAZY_COMP_INIT_ENV "GFX_MEDIA_LAZY_COMP_INIT"   // non-zero to create components on first use
+#define DDI_COPY_WORKER_NUM    3                            // worker threads of the media context copy pool, caller excluded
+
 class MediaLibvaInterfaceNext
 {
 public:
@@ -56,6 +59,19 @@ public:
     //!
     static void ReleaseCompList(PDDI_MEDIA_CONTEXT mediaCtx);
 
+    //!
+    //! \brief  Get component, creating it on first use when component init is lazy
+    //!
+    //! \param  [in] mediaCtx
+    //!         Pointer to ddi media context
+    //! \param  [in] type
+    //!         Component type
+    //!
+    //! \return DdiMediaFunctions*
+    //!     Component functions, nullptr if it could not be created
+    //!
+    static DdiMediaFunctions *GetComponent(PDDI_MEDIA_CONTEXT mediaCtx, CompType type);
+
     //!
     //! \brief  Initialize
     //!
@@ -1284,6 +1300,48 @@ public:
         VADriverContextP    ctx,
         VASurfaceID         renderTarget);
 
+    //!
+    //! \brief  Sync a set of surfaces
+    //! \details    Waits for all surfaces with one multi object wait on the
+    //!             bufmgr instead of one wait per surface
+    //! \param  [in] ctx
+    //!         Pointer to VA driver context
+    //! \param  [in] surfaces
+    //!         VA surface ids
+    //! \param  [in] numSurfaces
+    //!         Number of surfaces
+    //! \param  [in] timeoutNs
+    //!         Time out period for all surfaces, negative to wait forever
+    //!
+    //! \return VAStatus
+    //!     VA_STATUS_SUCCESS if success, VA_STATUS_ERROR_TIMEDOUT if any surface
+    //!     is still in use when time out, else fail reason
+    //!
+    static VAStatus SyncSurfaces(
+        VADriverContextP    ctx,
+        VASurfaceID         *surfaces,
+        uint32_t            numSurfaces,
+        int64_t             timeoutNs);
+
+    //!
+    //! \brief  Export surface completion fence
+    //! \details    The fd becomes readable when the GPU work pending on the
+    //!             surface at the time of the call completes. Caller owns the fd
+    //! \param  [in] ctx
+    //!         Pointer to VA driver context
+    //! \param  [in] surfaceId
+    //!         VA surface id
+    //! \param  [out] syncFd
+    //!         Pollable sync file fd
+    //!
+    //! \return VAStatus
+    //!     VA_STATUS_SUCCESS if success, else fail reason
+    //!
+    static VAStatus ExportSurfaceSyncFd(
+        VADriverContextP    ctx,
+        VASurfaceID         surfaceId,
+        int32_t             *syncFd);
+
     //!
     //! \brief   Query Surface Error
     //!
@@ -1530,7 +1588,12 @@ private:
 
     //!
     //! \brief  Copy plane from src to dst row by row when src and dst strides are different
+    //! \details Large planes are split into bands of rows copied by the worker
+    //!          pool of the media context and the calling thread, see
+    //!          MediaLibvaUtilNext_CopyPlane.
     //!
+    //! \param  [in] mediaCtx
+    //!         Pointer to ddi media context
     //! \param  [in] dst
     //!         Destination plane
     //! \param  [in] dstPitch
@@ -1541,13 +1604,17 @@ private:
     //!         Source plane pitch
     //! \param  [in] height
     //!         Plane hight
+    //! \param  [in] srcUncached
+    //!         Source is a write-combined surface mapping, read it with streaming loads when the cpu supports them
     //!
     static void CopyPlane(
+        PDDI_MEDIA_CONTEXT mediaCtx,
         uint8_t  *dst,
         uint32_t dstPitch,
         uint8_t  *src,
         uint32_t srcPitch,
-        uint32_t height);
+        uint32_t height,
+        bool     srcUncached = false);
 
     //!
     //! \brief  Map CompType from entrypoint
@@ -2199,6 +2266,8 @@ public:
 public:
     // Global mutex
     static MEDIA_MUTEX_T m_GlobalMutex;
+    // Guards lazy component creation
+    static MEDIA_MUTEX_T m_compListMutex;
 MEDIA_CLASS_DEFINE_END(MediaLibvaInterfaceNext)
 };
 
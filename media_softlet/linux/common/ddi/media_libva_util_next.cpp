@@ -24,6 +24,7 @@
 //! \brief    libva util next implementaion.
 //!
 #include <sys/time.h>
+#include <system_error>
 #include "inttypes.h"
 #include "media_libva_util_next.h"
 #include "media_interfaces_mcpy_next.h"
@@ -1071,12 +1072,20 @@ PDDI_MEDIA_SURFACE_HEAP_ELEMENT MediaLibvaUtilNext::AllocPMediaSurfaceFromHeap(P
             mediaSurfaceHeapElmt                  = &surfaceHeapBase[surfaceHeap->uiAllocatedHeapElements + i];
             mediaSurfaceHeapElmt->pNextFree       = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &surfaceHeapBase[surfaceHeap->uiAllocatedHeapElements + i + 1];
             mediaSurfaceHeapElmt->uiVaSurfaceID   = surfaceHeap->uiAllocatedHeapElements + i;
+            mediaSurfaceHeapElmt->pSurface        = nullptr;
+            mediaSurfaceHeapElmt->pIndexedBo      = nullptr;
         }
         surfaceHeap->uiAllocatedHeapElements     += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
     }
 
+    if (nullptr == surfaceHeap->pBoIndex)
+    {
+        surfaceHeap->pBoIndex = MOS_New(std::unordered_map<MOS_LINUX_BO *, uint32_t>);
+    }
+
     mediaSurfaceHeapElmt                          = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)surfaceHeap->pFirstFreeHeapElement;
     surfaceHeap->pFirstFreeHeapElement            = mediaSurfaceHeapElmt->pNextFree;
+    mediaSurfaceHeapElmt->pIndexedBo              = nullptr;
 
     return mediaSurfaceHeapElmt;
 }
@@ -1092,12 +1101,73 @@ void MediaLibvaUtilNext::ReleasePMediaSurfaceFromHeap(PDDI_MEDIA_HEAP surfaceHea
 
     PDDI_MEDIA_SURFACE_HEAP_ELEMENT mediaSurfaceHeapElmt                   = &mediaSurfaceHeapBase[vaSurfaceID];
     DDI_CHK_NULL(mediaSurfaceHeapElmt->pSurface, "surface is already released", );
+    if (surfaceHeap->pBoIndex && mediaSurfaceHeapElmt->pIndexedBo)
+    {
+        auto it = surfaceHeap->pBoIndex->find(mediaSurfaceHeapElmt->pIndexedBo);
+        if (it != surfaceHeap->pBoIndex->end() && it->second == vaSurfaceID)
+        {
+            surfaceHeap->pBoIndex->erase(it);
+        }
+        mediaSurfaceHeapElmt->pIndexedBo   = nullptr;
+    }
     void *firstFree                        = surfaceHeap->pFirstFreeHeapElement;
     surfaceHeap->pFirstFreeHeapElement     = (void*)mediaSurfaceHeapElmt;
     mediaSurfaceHeapElmt->pNextFree        = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)firstFree;
     mediaSurfaceHeapElmt->pSurface         = nullptr;
 }
 
+PDDI_MEDIA_SURFACE_HEAP_ELEMENT MediaLibvaUtilNext::GetPMediaSurfaceFromBo(PDDI_MEDIA_HEAP surfaceHeap, MOS_LINUX_BO *bo)
+{
+    DDI_FUNC_ENTER;
+    DDI_CHK_NULL(surfaceHeap, "nullptr surfaceHeap", nullptr);
+    if (nullptr == bo)
+    {
+        return nullptr;
+    }
+
+    PDDI_MEDIA_SURFACE_HEAP_ELEMENT mediaSurfaceHeapBase = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)surfaceHeap->pHeapBase;
+    DDI_CHK_NULL(mediaSurfaceHeapBase, "nullptr mediaSurfaceHeapBase", nullptr);
+
+    if (surfaceHeap->pBoIndex)
+    {
+        auto it = surfaceHeap->pBoIndex->find(bo);
+        if (it != surfaceHeap->pBoIndex->end())
+        {
+            // surface bo may be replaced after registration, so validate the hit
+            if (it->second < surfaceHeap->uiAllocatedHeapElements &&
+                mediaSurfaceHeapBase[it->second].pSurface != nullptr &&
+                mediaSurfaceHeapBase[it->second].pSurface->bo == bo)
+            {
+                return &mediaSurfaceHeapBase[it->second];
+            }
+            surfaceHeap->pBoIndex->erase(it);
+        }
+    }
+
+    // a bo is indexed on its first lookup only, so a miss scans the whole heap once
+    // and records the element for the next lookup.
+    for (uint32_t i = 0; i < surfaceHeap->uiAllocatedHeapElements; i++)
+    {
+        PDDI_MEDIA_SURFACE_HEAP_ELEMENT mediaSurfaceHeapElmt = &mediaSurfaceHeapBase[i];
+        if (mediaSurfaceHeapElmt->pSurface != nullptr && bo == mediaSurfaceHeapElmt->pSurface->bo)
+        {
+            if (surfaceHeap->pBoIndex)
+            {
+                auto it = surfaceHeap->pBoIndex->find(mediaSurfaceHeapElmt->pIndexedBo);
+                if (it != surfaceHeap->pBoIndex->end() && it->second == i)
+                {
+                    surfaceHeap->pBoIndex->erase(it);
+                }
+                (*surfaceHeap->pBoIndex)[bo]     = i;
+                mediaSurfaceHeapElmt->pIndexedBo = bo;
+            }
+            return mediaSurfaceHeapElmt;
+        }
+    }
+
+    return nullptr;
+}
+
 VAStatus MediaLibvaUtilNext::CreateSurface(DDI_MEDIA_SURFACE  *surface, PDDI_MEDIA_CONTEXT mediaDrvCtx)
 {
     VAStatus hr = VA_STATUS_SUCCESS;
@@ -2581,3 +2651,15 @@ void MediaLibvaUtilNext::MediaPrintFps()
     return;
 }
 #endif
+
+MediaLibvaUtilNext_InitPhase::~MediaLibvaUtilNext_InitPhase()
+{
+    uint64_t end  = 0;
+    uint64_t freq = 0;
+    MosUtilities::MosQueryPerformanceCounter(&end);
+    MosUtilities::MosQueryPerformanceFrequency(&freq);
+
+    uint32_t event[] = {m_phase, m_param, freq ? (uint32_t)((end - m_start) * 1000000 / freq) : 0};
+    MOS_TraceEventExt(EVENT_DDI_INIT_PHASE, EVENT_TYPE_INFO, event, sizeof(event), nullptr, 0);
+    DDI_NORMALMESSAGE("Init phase %u (%u) took %u us.", event[0], event[1], event[2]);
+}
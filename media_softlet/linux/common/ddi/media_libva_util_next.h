@@ -28,6 +28,7 @@
 #define __MEDIA_LIBVA_UTIL_NEXT_H__
 
 #include "media_libva_common_next.h"
+#include "media_libva_copy_plane.h"
 #include "vp_common.h"
 
 #ifdef ANDROID
@@ -475,6 +476,22 @@ public:
     //!
     static void ReleasePMediaSurfaceFromHeap(PDDI_MEDIA_HEAP surfaceHeap, uint32_t vaSurfaceID);
 
+    //!
+    //! \brief  Get pmedia surface heap element from bo
+    //! \details Looks up the bo index of the surface heap and falls back to a
+    //!          heap walk on miss, the found element is registered in the index.
+    //!          Caller should hold SurfaceMutex.
+    //!
+    //! \param  [in] surfaceHeap
+    //!         Pointer to ddi media heap
+    //! \param  [in] bo
+    //!         Buffer object of the surface
+    //!
+    //! \return PDDI_MEDIA_SURFACE_HEAP_ELEMENT
+    //!     Pointer to ddi media surface heap element, nullptr if not found
+    //!
+    static PDDI_MEDIA_SURFACE_HEAP_ELEMENT GetPMediaSurfaceFromBo(PDDI_MEDIA_HEAP surfaceHeap, MOS_LINUX_BO *bo);
+
     //!
     //! \brief  Create surface
     //! 
@@ -870,4 +887,38 @@ public:
 MEDIA_CLASS_DEFINE_END(MediaLibvaUtilNext_LockGuard)   
 };
 
+//!
+//! \brief  Driver initialization phases reported by MediaLibvaUtilNext_InitPhase
+//!
+enum DDI_INIT_PHASE
+{
+    DDI_INIT_PHASE_OS_UTILITIES = 0,
+    DDI_INIT_PHASE_OS_DEVICE_CONTEXT,
+    DDI_INIT_PHASE_HEAP,
+    DDI_INIT_PHASE_HW_INFO,
+    DDI_INIT_PHASE_CAPS,
+    DDI_INIT_PHASE_COMP_LIST,
+    DDI_INIT_PHASE_LAZY_COMP,
+};
+
+//!
+//! \brief  Helper inline class timing one driver initialization phase as a
+//!         stack-allocated object. The duration in microseconds is reported
+//!         as EVENT_DDI_INIT_PHASE and as a DDI normal message when leaving
+//!         the scope, so every return path of the phase is covered.
+//!
+class MediaLibvaUtilNext_InitPhase {
+private:
+    uint32_t m_phase = 0;
+    uint32_t m_param = 0;
+    uint64_t m_start = 0;
+public:
+    MediaLibvaUtilNext_InitPhase(uint32_t phase, uint32_t param = 0):m_phase(phase), m_param(param)
+    {
+        MosUtilities::MosQueryPerformanceCounter(&m_start);
+    }
+    ~MediaLibvaUtilNext_InitPhase();
+MEDIA_CLASS_DEFINE_END(MediaLibvaUtilNext_InitPhase)
+};
+
 #endif  //__MEDIA_LIBVA_UTIL_NEXT_H__
@@ -20,6 +20,7 @@
 
 set(TMP_SOURCES_
     ${CMAKE_CURRENT_LIST_DIR}/media_libva_util_next.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/media_libva_copy_plane.cpp
     ${CMAKE_CURRENT_LIST_DIR}/ddi_media_functions.cpp
     ${CMAKE_CURRENT_LIST_DIR}/media_capstable_specific.cpp
     ${CMAKE_CURRENT_LIST_DIR}/media_libva_caps_next.cpp
@@ -29,6 +30,7 @@ set(TMP_SOURCES_
 
 set(TMP_HEADERS_
     ${CMAKE_CURRENT_LIST_DIR}/media_libva_util_next.h
+    ${CMAKE_CURRENT_LIST_DIR}/media_libva_copy_plane.h
     ${CMAKE_CURRENT_LIST_DIR}/capstable_data_image_format_definition.h
     ${CMAKE_CURRENT_LIST_DIR}/capstable_data_linux_definition.h
     ${CMAKE_CURRENT_LIST_DIR}/ddi_media_functions.h
@@ -453,6 +453,8 @@ static inline int mos_query_device_type(int fd)
 drm_export int mos_bo_map_wc(struct mos_linux_bo *bo);
 drm_export void mos_bo_clear_relocs(struct mos_linux_bo *bo, int start);
 drm_export int mos_bo_wait(struct mos_linux_bo *bo, int64_t timeout_ns);
+drm_export int mos_bo_wait_multi(struct mos_linux_bo **bos, int count, int64_t timeout_ns);
+drm_export int mos_bo_export_sync_fd(struct mos_linux_bo *bo, int *sync_fd);
 
 drm_export bool mos_bo_is_softpin(struct mos_linux_bo *bo);
 drm_export bool mos_bo_is_exec_object_async(struct mos_linux_bo *bo);
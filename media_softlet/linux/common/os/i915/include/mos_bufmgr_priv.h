@@ -315,6 +315,22 @@ struct mos_bufmgr {
      */
     int (*bo_wait)(struct mos_linux_bo *bo, int64_t timeout_ns) = nullptr;
 
+    /**
+     * Wait on several buffer objects of this bufmgr with a single call.
+     *
+     * Returns 0 once every object is idle, -ETIME if any of them is still
+     * busy when the timeout expires. Timeout semantics follow bo_wait. If
+     * not implemented, mos_bo_wait_multi waits on the objects one by one.
+     */
+    int (*bo_wait_multi)(struct mos_linux_bo **bos, int count, int64_t timeout_ns) = nullptr;
+
+    /**
+     * Export a sync file fd which signals once the GPU work pending on the
+     * object at the time of the call completes. The fd can be polled, the
+     * caller owns it and must close it.
+     */
+    int (*bo_export_sync_fd)(struct mos_linux_bo *bo, int *sync_fd) = nullptr;
+
     void (*bo_clear_relocs)(struct mos_linux_bo *bo, int start) = nullptr;
     struct mos_linux_context *(*context_create)(struct mos_bufmgr *bufmgr) = nullptr;
     struct mos_linux_context *(*context_create_ext)(
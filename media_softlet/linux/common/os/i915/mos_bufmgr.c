@@ -64,6 +64,7 @@
 #include "string.h"
 
 #include "i915_drm.h"
+#include "dma-buf.h"
 #include "mos_vma.h"
 #include "mos_util_debug.h"
 #include "mos_oca_defs_specific.h"
@@ -119,6 +120,11 @@
 struct mos_gem_bo_bucket {
     drmMMListHead head;
     unsigned long size;
+    /**
+     * Protects head, so allocations of different sizes do not serialize
+     * on bufmgr_gem->lock. Lock order: bufmgr_gem->lock -> bucket lock -> vma_lock.
+     */
+    pthread_mutex_t lock;
 };
 
 struct mos_bufmgr_gem {
@@ -172,6 +178,8 @@ struct mos_bufmgr_gem {
 
     // manage address for softpin buffer object
     mos_vma_heap vma_heap[MEMZONE_COUNT];
+    // protects vma_heap, innermost lock
+    pthread_mutex_t vma_lock;
     bool use_softpin;
     bool softpin_va1Malign;
 
@@ -978,6 +986,7 @@ mos_gem_bo_memzone_for_address(uint64_t address)
 
 /**
  * Allocate a section of virtual memory for a buffer, assigning an address.
+ * Caller must hold bufmgr_gem->vma_lock.
  */
 static uint64_t
 mos_gem_bo_vma_alloc(struct mos_bufmgr *bufmgr,
@@ -1010,7 +1019,9 @@ mos_gem_bo_vma_free(struct mos_bufmgr *bufmgr,
 
     CHK_CONDITION(address == 0ull, "invalid address.\n", );
     enum mos_memory_zone memzone = mos_gem_bo_memzone_for_address(address);
+    pthread_mutex_lock(&bufmgr_gem->vma_lock);
     mos_vma_heap_free(&bufmgr_gem->vma_heap[memzone], address, size);
+    pthread_mutex_unlock(&bufmgr_gem->vma_lock);
 }
 
 drm_export struct mos_linux_bo *
@@ -1050,7 +1061,11 @@ mos_gem_bo_alloc_internal(struct mos_bufmgr *bufmgr,
          */
         alloc->ext.pat_index = PAT_INDEX_INVALID;
     }
-    pthread_mutex_lock(&bufmgr_gem->lock);
+    /* Only the bucket of this size is locked, bo of other sizes could be
+     * allocated or released concurrently.
+     */
+    if (bucket != nullptr)
+        pthread_mutex_lock(&bucket->lock);
     /* Get a buffer out of the cache if available */
 retry:
     alloc_from_cache = false;
@@ -1107,7 +1122,8 @@ retry:
             }
         }
     }
-    pthread_mutex_unlock(&bufmgr_gem->lock);
+    if (bucket != nullptr)
+        pthread_mutex_unlock(&bucket->lock);
 
     if (!alloc_from_cache) {
 
@@ -1663,6 +1679,7 @@ mos_gem_cleanup_bo_cache(struct mos_bufmgr_gem *bufmgr_gem, time_t time)
         struct mos_gem_bo_bucket *bucket =
             &bufmgr_gem->cache_bucket[i];
 
+        pthread_mutex_lock(&bucket->lock);
         while (!DRMLISTEMPTY(&bucket->head)) {
             struct mos_bo_gem *bo_gem;
 
@@ -1675,6 +1692,7 @@ mos_gem_cleanup_bo_cache(struct mos_bufmgr_gem *bufmgr_gem, time_t time)
 
             mos_gem_bo_free(&bo_gem->bo);
         }
+        pthread_mutex_unlock(&bucket->lock);
     }
 
     bufmgr_gem->time = time;
@@ -1742,7 +1760,9 @@ mos_gem_bo_unreference_final(struct mos_linux_bo *bo, time_t time)
         bo_gem->name = nullptr;
         bo_gem->validate_index = -1;
 
+        pthread_mutex_lock(&bucket->lock);
         DRMLISTADDTAIL(&bo_gem->head, &bucket->head);
+        pthread_mutex_unlock(&bucket->lock);
     } else {
         mos_gem_bo_free(bo);
     }
@@ -2446,6 +2466,7 @@ mos_bufmgr_cleanup_cache(struct mos_bufmgr_gem *bufmgr_gem)
             mos_gem_bo_free(&bo_gem->bo);
         }
         bufmgr_gem->cache_bucket[i].size = 0;
+        pthread_mutex_destroy(&bucket->lock);
     }
     bufmgr_gem->num_buckets = 0;
 }
@@ -2479,6 +2500,7 @@ mos_bufmgr_gem_destroy(struct mos_bufmgr *bufmgr)
 
     mos_vma_heap_finish(&bufmgr_gem->vma_heap[MEMZONE_SYS]);
     mos_vma_heap_finish(&bufmgr_gem->vma_heap[MEMZONE_DEVICE]);
+    pthread_mutex_destroy(&bufmgr_gem->vma_lock);
 
     if (bufmgr_gem->mem_profiler_fd != -1)
     {
@@ -3438,14 +3460,14 @@ mos_gem_bo_set_softpin(MOS_LINUX_BO *bo)
     struct mos_bo_gem *bo_gem = (struct mos_bo_gem *) bo;
     struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *) bo->bufmgr;
 
-    pthread_mutex_lock(&bufmgr_gem->lock);
+    pthread_mutex_lock(&bufmgr_gem->vma_lock);
     if (!mos_gem_bo_is_softpin(bo))
     {
         uint64_t alignment = (bufmgr_gem->softpin_va1Malign) ? PAGE_SIZE_1M : PAGE_SIZE_64K;
         uint64_t offset = mos_gem_bo_vma_alloc(bo->bufmgr, (enum mos_memory_zone)bo_gem->mem_region, bo->size, alignment);
         ret = mos_gem_bo_set_softpin_offset(bo, offset);
     }
-    pthread_mutex_unlock(&bufmgr_gem->lock);
+    pthread_mutex_unlock(&bufmgr_gem->vma_lock);
 
     if (ret == 0)
     {
@@ -3575,6 +3597,36 @@ mos_gem_bo_export_to_prime(struct mos_linux_bo *bo, int *prime_fd)
     return 0;
 }
 
+/**
+ * i915 tracks every execbuf in the reservation object of the bo, so the
+ * implicit fences of its dma-buf cover all pending GPU access.
+ */
+static int
+mos_gem_bo_export_sync_fd(struct mos_linux_bo *bo, int *sync_fd)
+{
+    struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *) bo->bufmgr;
+    struct mos_bo_gem *bo_gem = (struct mos_bo_gem *) bo;
+    struct dma_buf_export_sync_file export_sync_file;
+    int prime_fd = -1;
+    int ret;
+
+    if (drmPrimeHandleToFD(bufmgr_gem->fd, bo_gem->gem_handle,
+                   DRM_CLOEXEC, &prime_fd) != 0)
+        return -errno;
+
+    memclear(export_sync_file);
+    export_sync_file.flags = DMA_BUF_SYNC_RW;
+    export_sync_file.fd = -1;
+    ret = drmIoctl(prime_fd, DMA_BUF_IOCTL_EXPORT_SYNC_FILE, &export_sync_file);
+    if (ret != 0)
+        ret = -errno;
+    close(prime_fd);
+
+    if (ret == 0)
+        *sync_fd = export_sync_file.fd;
+    return ret;
+}
+
 static int
 mos_gem_bo_flink(struct mos_linux_bo *bo, uint32_t * name)
 {
@@ -3863,6 +3915,7 @@ add_bucket(struct mos_bufmgr_gem *bufmgr_gem, int size)
 
     DRMINITLISTHEAD(&bufmgr_gem->cache_bucket[i].head);
     bufmgr_gem->cache_bucket[i].size = size;
+    pthread_mutex_init(&bufmgr_gem->cache_bucket[i].lock, nullptr);
     bufmgr_gem->num_buckets++;
 }
 
@@ -5314,6 +5367,7 @@ mos_bufmgr_gem_init_i915(int fd, int batch_size)
     bufmgr_gem->bufmgr.get_context_param = mos_gem_get_context_param;
     bufmgr_gem->bufmgr.bo_create_from_prime = mos_gem_bo_create_from_prime;
     bufmgr_gem->bufmgr.bo_export_to_prime = mos_gem_bo_export_to_prime;
+    bufmgr_gem->bufmgr.bo_export_sync_fd = mos_gem_bo_export_sync_fd;
     bufmgr_gem->bufmgr.reg_read = mos_bufmg_reg_read;
     bufmgr_gem->bufmgr.get_reset_stats = mos_bufmg_get_reset_stats;
     bufmgr_gem->bufmgr.get_context_param_sseu = mos_bufmgr_get_context_param_sseu;
@@ -5499,6 +5553,7 @@ mos_bufmgr_gem_init_i915(int fd, int batch_size)
     DRMLISTADD(&bufmgr_gem->managers, &bufmgr_list);
 
     bufmgr_gem->use_softpin = false;
+    pthread_mutex_init(&bufmgr_gem->vma_lock, nullptr);
     mos_vma_heap_init(&bufmgr_gem->vma_heap[MEMZONE_SYS], MEMZONE_SYS_START, MEMZONE_SYS_SIZE);
     mos_vma_heap_init(&bufmgr_gem->vma_heap[MEMZONE_DEVICE], MEMZONE_DEVICE_START, MEMZONE_DEVICE_SIZE);
 
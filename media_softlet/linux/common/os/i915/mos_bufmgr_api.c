@@ -34,6 +34,7 @@
 #include <stdint.h>
 #include <assert.h>
 #include <errno.h>
+#include <time.h>
 #include <drm.h>
 #include <i915_drm.h>
 #include "libdrm_macros.h"
@@ -866,6 +867,73 @@ mos_bo_wait(struct mos_linux_bo *bo, int64_t timeout_ns)
     }
 }
 
+drm_export int
+mos_bo_wait_multi(struct mos_linux_bo **bos, int count, int64_t timeout_ns)
+{
+    if(!bos || count <= 0)
+    {
+        MOS_OS_CRITICALMESSAGE("Input null ptr\n");
+        return -EINVAL;
+    }
+
+    bool same_bufmgr = true;
+    for (int i = 0; i < count; i++)
+    {
+        if(!bos[i])
+        {
+            MOS_OS_CRITICALMESSAGE("Input null ptr\n");
+            return -EINVAL;
+        }
+        same_bufmgr &= (bos[i]->bufmgr == bos[0]->bufmgr);
+    }
+
+    if (same_bufmgr && bos[0]->bufmgr && bos[0]->bufmgr->bo_wait_multi)
+    {
+        return bos[0]->bufmgr->bo_wait_multi(bos, count, timeout_ns);
+    }
+
+    // One wait per object against a common deadline.
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+    {
+        int64_t remaining = timeout_ns;
+        if (timeout_ns > 0)
+        {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            int64_t elapsed = (int64_t)(now.tv_sec - start.tv_sec) * 1000000000LL + (now.tv_nsec - start.tv_nsec);
+            remaining = elapsed < timeout_ns ? timeout_ns - elapsed : 0;
+        }
+        int ret = mos_bo_wait(bos[i], remaining);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+    return 0;
+}
+
+drm_export int
+mos_bo_export_sync_fd(struct mos_linux_bo *bo, int *sync_fd)
+{
+    if(!bo || !sync_fd)
+    {
+        MOS_OS_CRITICALMESSAGE("Input null ptr\n");
+        return -EINVAL;
+    }
+
+    if (bo->bufmgr && bo->bufmgr->bo_export_sync_fd)
+    {
+        return bo->bufmgr->bo_export_sync_fd(bo, sync_fd);
+    }
+    else
+    {
+        MOS_OS_CRITICALMESSAGE("Unsupported\n");
+        return -EPERM;
+    }
+}
+
 drm_export void
 mos_bo_clear_relocs(struct mos_linux_bo *bo, int start)
 {
@@ -25,6 +25,8 @@
 //!
 
 #include <unistd.h>
+#include <algorithm>
+#include <unordered_map>
 #include "mos_gpucontext_specific_next.h"
 #include "mos_context_specific_next.h"
 #include "mos_graphicsresource_specific_next.h"
@@ -551,6 +553,9 @@ MOS_STATUS GpuContextSpecificNext::Init(OsContextNext *osContext,
 
     m_nextFetchIndex = 0;
 
+    const char *cmdBufRing = getenv(MOS_CMD_BUF_RING_ENV);
+    m_cmdBufRingEnabled    = (cmdBufRing != nullptr && atoi(cmdBufRing) != 0);
+
     m_cmdBufFlushed = true;
 
     m_osContext = osContext;
@@ -578,6 +583,10 @@ MOS_STATUS GpuContextSpecificNext::Init(OsContextNext *osContext,
     m_writeModeList = (bool *)MOS_AllocAndZeroMemory(sizeof(bool) * ALLOCATIONLIST_SIZE);
     MOS_OS_CHK_NULL_RETURN(m_writeModeList);
 
+    m_resIndex = (ResourceIndexEntry *)MOS_AllocAndZeroMemory(sizeof(ResourceIndexEntry) * m_resIndexSize);
+    MOS_OS_CHK_NULL_RETURN(m_resIndex);
+    m_resIndexGeneration = 1;
+
     m_GPUStatusTag = 1;
 
     StoreCreateOptions(createOption);
@@ -668,6 +677,12 @@ void GpuContextSpecificNext::Clear()
     }
     MOS_FreeMemAndSetNull(m_statusBufferResource);
 
+    if (m_cmdBufRingEnabled)
+    {
+        MOS_OS_NORMALMESSAGE("Command buffer ring: %u slots, %u stalls, %u reallocations.",
+            (uint32_t)m_cmdBufPool.size(), m_cmdBufRingStalls.load(), m_cmdBufRingReallocs.load());
+    }
+
     if(m_cmdBufPoolMutex)
     {
         MosUtilities::MosLockMutex(m_cmdBufPoolMutex);
@@ -701,6 +716,8 @@ void GpuContextSpecificNext::Clear()
     m_attachedResources = nullptr;
     MOS_SafeFreeMemory(m_writeModeList);
     m_writeModeList = nullptr;
+    MOS_SafeFreeMemory(m_resIndex);
+    m_resIndex = nullptr;
 
     for (int i=0; i<MAX_ENGINE_INSTANCE_NUM; i++)
     {
@@ -723,27 +740,13 @@ MOS_STATUS GpuContextSpecificNext::RegisterResource(
     MOS_OS_CHK_NULL_RETURN(osResource);
 
     MOS_OS_CHK_NULL_RETURN(m_attachedResources);
+    MOS_OS_CHK_NULL_RETURN(m_resIndex);
 
-    PMOS_RESOURCE registeredResources = m_attachedResources;
-    uint32_t      allocationIndex     = 0;
-
-    for ( allocationIndex = 0; allocationIndex < m_resCount; allocationIndex++, registeredResources++)
-    {
-        if (osResource->bo == registeredResources->bo)
-        {
-            break;
-        }
-    }
+    uint32_t allocationIndex = LookupResourceIndex(osResource->bo);
 
     // Allocation list to be updated
     if (allocationIndex < m_maxNumAllocations)
     {
-        // New buffer
-        if (allocationIndex == m_resCount)
-        {
-            m_resCount++;
-        }
-
         // Set allocation
         if (m_gpuContext >= MOS_GPU_CONTEXT_MAX)
         {
@@ -751,6 +754,13 @@ MOS_STATUS GpuContextSpecificNext::RegisterResource(
             return MOS_STATUS_UNKNOWN; 
         }
 
+        // New buffer
+        if (allocationIndex == m_resCount)
+        {
+            InsertResourceIndex(osResource->bo, allocationIndex);
+            m_resCount++;
+        }
+
         osResource->iAllocationIndex[m_gpuContext] = (allocationIndex);
         m_attachedResources[allocationIndex]           = *osResource;
         m_writeModeList[allocationIndex] |= writeFlag;
@@ -767,6 +777,51 @@ MOS_STATUS GpuContextSpecificNext::RegisterResource(
     return MOS_STATUS_SUCCESS;
 }
 
+uint32_t GpuContextSpecificNext::LookupResourceIndex(MOS_LINUX_BO *bo)
+{
+    uint32_t slot = (uint32_t)(((uintptr_t)bo >> 6) * 0x9E3779B1u) & (m_resIndexSize - 1);
+
+    for (uint32_t probe = 0; probe < m_resIndexSize; probe++, slot = (slot + 1) & (m_resIndexSize - 1))
+    {
+        ResourceIndexEntry &entry = m_resIndex[slot];
+        if (entry.generation != m_resIndexGeneration)
+        {
+            break;
+        }
+        if (entry.bo == bo)
+        {
+            return entry.allocationIndex;
+        }
+    }
+
+    return m_resCount;
+}
+
+void GpuContextSpecificNext::InsertResourceIndex(MOS_LINUX_BO *bo, uint32_t allocationIndex)
+{
+    uint32_t slot = (uint32_t)(((uintptr_t)bo >> 6) * 0x9E3779B1u) & (m_resIndexSize - 1);
+
+    // Allocation list is capped at ALLOCATIONLIST_SIZE, so a free slot always exists
+    while (m_resIndex[slot].generation == m_resIndexGeneration)
+    {
+        slot = (slot + 1) & (m_resIndexSize - 1);
+    }
+
+    m_resIndex[slot].bo              = bo;
+    m_resIndex[slot].allocationIndex = allocationIndex;
+    m_resIndex[slot].generation      = m_resIndexGeneration;
+}
+
+void GpuContextSpecificNext::ResetResourceIndex()
+{
+    m_resIndexGeneration++;
+    if (m_resIndexGeneration == 0 && m_resIndex)
+    {
+        MosUtilities::MosZeroMemory(m_resIndex, sizeof(ResourceIndexEntry) * m_resIndexSize);
+        m_resIndexGeneration = 1;
+    }
+}
+
 MOS_STATUS GpuContextSpecificNext::SetPatchEntry(
     MOS_STREAM_HANDLE streamState,
     PMOS_PATCH_ENTRY_PARAMS params)
@@ -825,7 +880,11 @@ MOS_STATUS GpuContextSpecificNext::GetCommandBuffer(
     bool needToAlloc = ((isPrimaryCmdBuffer && m_cmdBufFlushed) ||
                         (!isPrimaryCmdBuffer && !hasSecondaryCmdBuffer));
 
-    if (needToAlloc)
+    if (needToAlloc && m_cmdBufRingEnabled)
+    {
+        MOS_OS_CHK_STATUS_RETURN(FetchCmdBufFromRing(cmdBuf));
+    }
+    else if (needToAlloc)
     {
         MosUtilities::MosLockMutex(m_cmdBufPoolMutex);
         if (m_cmdBufPool.size() < MAX_CMD_BUF_NUM)
@@ -882,7 +941,10 @@ MOS_STATUS GpuContextSpecificNext::GetCommandBuffer(
             return MOS_STATUS_UNKNOWN;
         }
         MosUtilities::MosUnlockMutex(m_cmdBufPoolMutex);
+    }
 
+    if (needToAlloc)
+    {
         // util now, we got new command buffer from CmdBufMgr, next step to fill in the input command buffer
         MOS_OS_CHK_STATUS_RETURN(cmdBuf->GetResource()->ConvertToMosResource(&comamndBuffer->OsResource));
         comamndBuffer->pCmdBase   = (uint32_t *)cmdBuf->GetResource()->GetLockedAddr();
@@ -925,7 +987,7 @@ MOS_STATUS GpuContextSpecificNext::GetCommandBuffer(
         // Command buffers are treated as cyclical buffers, the CB after the just submitted one
         // has the minimal fence value that we should wait
         m_nextFetchIndex++;
-        if (m_nextFetchIndex >= MAX_CMD_BUF_NUM)
+        if (m_nextFetchIndex >= (m_cmdBufRingEnabled ? m_cmdBufPool.size() : MAX_CMD_BUF_NUM))
         {
             m_nextFetchIndex = 0;
         }
@@ -1272,6 +1334,16 @@ MOS_STATUS GpuContextSpecificNext::SubmitCommandBuffer(
     std::vector<PMOS_RESOURCE> mappedResList;
     std::vector<MOS_LINUX_BO *> skipSyncBoList;
 
+    // Patches are recorded in runs against the same command buffer, so the target
+    // classification is kept for the last target and only redone when it changes.
+    MOS_LINUX_BO *lastCmdBo         = nullptr;
+    bool          isSecondaryCmdBuf = false;
+    bool          isSlaveCmdBuf     = false;
+
+    // Relocation offsets of this context, indexed once on the first relocated patch.
+    std::unordered_map<MOS_LINUX_BO *, uint64_t> contextOffsets;
+    bool                                         contextOffsetsIndexed = false;
+
     // Now, the patching will be done, based on the patch list.
     for (uint32_t patchIndex = 0; patchIndex < m_currentNumPatchLocations; patchIndex++)
     {
@@ -1280,31 +1352,35 @@ MOS_STATUS GpuContextSpecificNext::SubmitCommandBuffer(
 
         auto tempCmdBo = currentPatch->cmdBo == nullptr ? cmd_bo : currentPatch->cmdBo;
 
-        // Following are for Nested BB buffer, if it's nested BB, we need to ensure it's locked.
-        if (tempCmdBo != cmd_bo)
+        if (tempCmdBo != lastCmdBo)
         {
-            bool isSecondaryCmdBuf = false;
-            it = m_secondaryCmdBufs.begin();
-            while(it != m_secondaryCmdBufs.end())
+            lastCmdBo         = tempCmdBo;
+            isSecondaryCmdBuf = false;
+            isSlaveCmdBuf     = false;
+            for (auto &secondary : m_secondaryCmdBufs)
             {
-                if (it->second->OsResource.bo == tempCmdBo)
+                if (secondary.second->OsResource.bo == tempCmdBo)
                 {
                     isSecondaryCmdBuf = true;
+                    isSlaveCmdBuf     = (secondary.second->iSubmissionType & SUBMISSION_TYPE_MULTI_PIPE_SLAVE) != 0;
                     break;
                 }
-                it++;
             }
 
-            for(auto allocIdx = 0; allocIdx < m_numAllocations && (!isSecondaryCmdBuf); allocIdx++)
+            // Following are for Nested BB buffer, if it's nested BB, we need to ensure it's locked.
+            if (tempCmdBo != cmd_bo && !isSecondaryCmdBuf)
             {
-                auto tempRes = (PMOS_RESOURCE)m_allocationList[allocIdx].hAllocation;
-                if (tempCmdBo == tempRes->bo)
+                uint32_t allocIdx = LookupResourceIndex(tempCmdBo);
+                if (allocIdx < m_numAllocations)
                 {
-                    GraphicsResourceNext::LockParams param;
-                    param.m_writeRequest = true;
-                    tempRes->pGfxResourceNext->Lock(m_osContext, param);
-                    mappedResList.push_back(tempRes);
-                    break;
+                    auto tempRes = (PMOS_RESOURCE)m_allocationList[allocIdx].hAllocation;
+                    if (std::find(mappedResList.begin(), mappedResList.end(), tempRes) == mappedResList.end())
+                    {
+                        GraphicsResourceNext::LockParams param;
+                        param.m_writeRequest = true;
+                        tempRes->pGfxResourceNext->Lock(m_osContext, param);
+                        mappedResList.push_back(tempRes);
+                    }
                 }
             }
         }
@@ -1331,14 +1407,22 @@ MOS_STATUS GpuContextSpecificNext::SubmitCommandBuffer(
         {
             if (alloc_bo != tempCmdBo)
             {
-                auto item_ctx = perStreamParameters->contextOffsetList.begin();
-                for (; item_ctx != perStreamParameters->contextOffsetList.end(); item_ctx++)
+                if (!contextOffsetsIndexed)
                 {
-                    if (item_ctx->intel_context == perStreamParameters->intel_context && item_ctx->target_bo == alloc_bo)
+                    for (auto &item_ctx : perStreamParameters->contextOffsetList)
                     {
-                        boOffset = item_ctx->offset64;
-                        break;
+                        if (item_ctx.intel_context == perStreamParameters->intel_context)
+                        {
+                            // emplace keeps the first entry, as the list scan did
+                            contextOffsets.emplace(item_ctx.target_bo, item_ctx.offset64);
+                        }
                     }
+                    contextOffsetsIndexed = true;
+                }
+                auto item_ctx = contextOffsets.find(alloc_bo);
+                if (item_ctx != contextOffsets.end())
+                {
+                    boOffset = item_ctx->second;
                 }
             }
         }
@@ -1357,17 +1441,9 @@ MOS_STATUS GpuContextSpecificNext::SubmitCommandBuffer(
 
         if (scalaEnabled)
         {
-            it = m_secondaryCmdBufs.begin();
-            while(it != m_secondaryCmdBufs.end())
+            if (isSlaveCmdBuf && !mos_bo_is_exec_object_async(alloc_bo))
             {
-                if (it->second->OsResource.bo == tempCmdBo &&
-                    it->second->iSubmissionType & SUBMISSION_TYPE_MULTI_PIPE_SLAVE &&
-                    !mos_bo_is_exec_object_async(alloc_bo))
-                {
-                    skipSyncBoList.push_back(alloc_bo);
-                    break;
-                }
-                it++;
+                skipSyncBoList.push_back(alloc_bo);
             }
         }
         else if (cmdBuffer->iSubmissionType & SUBMISSION_TYPE_MULTI_PIPE_SLAVE &&
@@ -1680,6 +1756,7 @@ if (streamState->dumpCommandBuffer)
     m_currentNumPatchLocations = 0;
     MosUtilities::MosZeroMemory(m_patchLocationList, sizeof(PATCHLOCATIONLIST) * m_maxNumAllocations);
     m_resCount = 0;
+    ResetResourceIndex();
 
     MosUtilities::MosZeroMemory(m_writeModeList, sizeof(bool) * m_maxNumAllocations);
 finish:
@@ -1889,6 +1966,124 @@ void GpuContextSpecificNext::IncrementGpuStatusTag()
     }
 }
 
+MOS_STATUS GpuContextSpecificNext::FetchCmdBufFromRing(CommandBufferNext *&cmdBuf)
+{
+    MOS_OS_FUNCTION_ENTER;
+
+    MOS_OS_CHK_NULL_RETURN(m_cmdBufMgr);
+
+    // Slots are only touched by the thread owning this gpu context, the pool mutex
+    // just keeps GetPendingSubmissions off the vector while the ring grows.
+    uint32_t ringSize = m_cmdBufPool.size();
+    if (ringSize > 0)
+    {
+        auto slot = static_cast<CommandBufferSpecificNext *>(m_cmdBufPool[m_nextFetchIndex]);
+        MOS_OS_CHK_NULL_RETURN(slot);
+
+        // A slot whose buffer is still being recorded has not been submitted yet,
+        // so its kernel fence says nothing, it can only be skipped by growing.
+        MOS_LINUX_BO *slotBo    = static_cast<GraphicsResourceSpecificNext *>(slot->GetResource())->GetBufferObject();
+        bool          recording = (!m_cmdBufFlushed && m_commandBuffer->OsResource.bo == slotBo);
+        for (auto &secondary : m_secondaryCmdBufs)
+        {
+            recording |= (secondary.second && secondary.second->OsResource.bo == slotBo);
+        }
+
+        bool busy = recording || (slot->isBusy() > 0);
+        if (recording && ringSize >= MAX_CMD_BUF_NUM)
+        {
+            MOS_OS_ASSERTMESSAGE("Command buffer ring full of unsubmitted buffers.");
+            return MOS_STATUS_UNKNOWN;
+        }
+        else if (!busy || ringSize >= MAX_CMD_BUF_NUM)
+        {
+            if (busy)
+            {
+                m_cmdBufRingStalls.fetch_add(1, std::memory_order_relaxed);
+                slot->waitReady();
+            }
+            if (slot->GetCmdBufSize() < m_commandBufferSize)
+            {
+                m_cmdBufRingReallocs.fetch_add(1, std::memory_order_relaxed);
+                MOS_OS_CHK_STATUS_RETURN(slot->ReSize(m_commandBufferSize));
+            }
+            cmdBuf = slot;
+            return MOS_STATUS_SUCCESS;
+        }
+    }
+
+    // The oldest slot is still in flight, double the ring. New slots go in front of
+    // it so the ring stays ordered from oldest to latest submission.
+    uint32_t growNum = (ringSize == 0) ? MOS_CMD_BUF_RING_INIT_NUM : ringSize;
+    growNum          = MOS_MIN(growNum, MAX_CMD_BUF_NUM - ringSize);
+
+    std::vector<CommandBufferNext *> newSlots;
+    MOS_STATUS                       eStatus = MOS_STATUS_SUCCESS;
+    for (uint32_t i = 0; i < growNum; i++)
+    {
+        CommandBufferNext *newCmdBuf = m_cmdBufMgr->PickupOneCmdBuf(m_commandBufferSize);
+        if (newCmdBuf == nullptr)
+        {
+            MOS_OS_ASSERTMESSAGE("Invalid (nullptr) Pointer.");
+            eStatus = MOS_STATUS_NULL_POINTER;
+            break;
+        }
+        if ((eStatus = newCmdBuf->BindToGpuContext(this)) != MOS_STATUS_SUCCESS)
+        {
+            MOS_OS_ASSERTMESSAGE("Invalid status of BindToGpuContext.");
+            m_cmdBufMgr->ReleaseCmdBuf(newCmdBuf);
+            break;
+        }
+        newSlots.push_back(newCmdBuf);
+    }
+
+    if (newSlots.empty())
+    {
+        return eStatus;
+    }
+
+    MosUtilities::MosLockMutex(m_cmdBufPoolMutex);
+    m_cmdBufPool.insert(m_cmdBufPool.begin() + m_nextFetchIndex, newSlots.begin(), newSlots.end());
+    MosUtilities::MosUnlockMutex(m_cmdBufPoolMutex);
+    m_cmdBufRingReallocs.fetch_add(1, std::memory_order_relaxed);
+
+    cmdBuf = m_cmdBufPool[m_nextFetchIndex];
+    return MOS_STATUS_SUCCESS;
+}
+
+uint32_t GpuContextSpecificNext::GetPendingSubmissions(uint32_t maxCount, uint32_t &probeBudget)
+{
+    uint32_t pending = 0;
+
+    if (m_cmdBufPoolMutex == nullptr)
+    {
+        return 0;
+    }
+
+    MosUtilities::MosLockMutex(m_cmdBufPoolMutex);
+    uint32_t poolSize = m_cmdBufPool.size();
+    for (uint32_t i = 0; i < poolSize && pending < maxCount && probeBudget > 0; i++)
+    {
+        // walk back from the most recently fetched command buffer
+        uint32_t index  = (m_nextFetchIndex + poolSize - 1 - i) % poolSize;
+        auto     cmdBuf = static_cast<CommandBufferSpecificNext *>(m_cmdBufPool[index]);
+        probeBudget--;
+        if (cmdBuf && cmdBuf->isBusy() > 0)
+        {
+            pending++;
+        }
+        else if (i > 0)
+        {
+            // one context executes in order, so older command buffers are idle too.
+            // the latest one may still be in recording and is skipped.
+            break;
+        }
+    }
+    MosUtilities::MosUnlockMutex(m_cmdBufPoolMutex);
+
+    return pending;
+}
+
 void GpuContextSpecificNext::UpdatePriority(int32_t priority)
 {
     if(m_currCtxPriority == priority)
@@ -1920,6 +2115,7 @@ void GpuContextSpecificNext::ResetGpuContextStatus()
 
     MosUtilities::MosZeroMemory(m_attachedResources, sizeof(MOS_RESOURCE) * ALLOCATIONLIST_SIZE);
     m_resCount = 0;
+    ResetResourceIndex();
 
     MosUtilities::MosZeroMemory(m_writeModeList, sizeof(bool) * ALLOCATIONLIST_SIZE);
 
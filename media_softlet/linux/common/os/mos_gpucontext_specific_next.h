@@ -27,6 +27,7 @@
 #ifndef __GPU_CONTEXT_SPECIFIC_NEXT_H__
 #define __GPU_CONTEXT_SPECIFIC_NEXT_H__
 
+#include <atomic>
 #include "mos_gpucontext_next.h"
 #include "mos_graphicsresource_specific_next.h"
 #include "mos_oca_interface_specific.h"
@@ -36,6 +37,9 @@
 #define ENGINE_INSTANCE_SELECT_VEBOX_INSTANCE_SHIFT          8
 #define ENGINE_INSTANCE_SELECT_VDBOX_INSTANCE_SHIFT          0
 
+#define MOS_CMD_BUF_RING_ENV                                 "GFX_MEDIA_CMDBUF_RING"   // non-zero to enable per context ring
+#define MOS_CMD_BUF_RING_INIT_NUM                            4
+
 //!
 //! \class  GpuContextSpecific
 //! \brief  Linux/Android specific gpu context 
@@ -213,6 +217,26 @@ public:
     void       IncrementGpuStatusTag();
 
     void       ResetGpuContextStatus();
+
+    //!
+    //! \brief    Count busy command buffers from the most recent one backwards
+    //! \details  Stops at the first idle command buffer after the latest one, which
+    //!           may still be in recording, or when probeBudget runs out.
+    //!
+    uint32_t   GetPendingSubmissions(uint32_t maxCount, uint32_t &probeBudget) override;
+
+    //!
+    //! \brief    Get command buffer ring statistics
+    //! \param    [out] stalls
+    //!           Times the ring was full and waited for the oldest buffer to retire
+    //! \param    [out] reallocs
+    //!           Times the ring grew or a slot was re-allocated with a bigger size
+    //!
+    void       GetCmdBufRingStats(uint32_t &stalls, uint32_t &reallocs)
+    {
+        stalls   = m_cmdBufRingStalls.load(std::memory_order_relaxed);
+        reallocs = m_cmdBufRingReallocs.load(std::memory_order_relaxed);
+    }
     
     //!
     //! \brief  Set the Gpu priority for workload scheduling.
@@ -321,6 +345,33 @@ protected:
     MOS_STATUS ReportMemoryInfo(
         struct mos_bufmgr *bufmgr);
 
+    //!
+    //! \brief    Look up the allocation index of a registered bo
+    //! \param    [in] bo
+    //!           Buffer object of the resource
+    //! \return   uint32_t
+    //!           Allocation index if the bo is registered, otherwise m_resCount
+    //!
+    uint32_t LookupResourceIndex(MOS_LINUX_BO *bo);
+
+    //!
+    //! \brief    Add a bo to the resource index
+    //! \param    [in] bo
+    //!           Buffer object of the resource
+    //! \param    [in] allocationIndex
+    //!           Allocation index of the resource
+    //! \return   void
+    //!
+    void InsertResourceIndex(MOS_LINUX_BO *bo, uint32_t allocationIndex);
+
+    //!
+    //! \brief    Invalidate all entries of the resource index
+    //! \details  Bumps the generation so that reset is O(1) per submission,
+    //!           the table is only cleared when the generation wraps
+    //! \return   void
+    //!
+    void ResetResourceIndex();
+
 #if (_DEBUG || _RELEASE_INTERNAL)
     MOS_LINUX_BO* GetNopCommandBuffer(
         MOS_STREAM_HANDLE streamState);
@@ -331,6 +382,18 @@ protected:
 
     void UnlockPendingOcaBuffers(PMOS_COMMAND_BUFFER cmdBuffer, PMOS_CONTEXT mosContext);
 
+    //!
+    //! \brief    Fetch the next command buffer from the per context ring
+    //! \details  The oldest slot is reused as soon as its buffer is idle. While it is
+    //!           still busy the ring grows geometrically up to MAX_CMD_BUF_NUM, then
+    //!           waits for it. Only growth goes to CmdBufMgr.
+    //! \param    [out] cmdBuf
+    //!           Command buffer bound to this gpu context
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS FetchCmdBufFromRing(CommandBufferNext *&cmdBuf);
+
     virtual MOS_GPU_COMPONENT_ID GetGpuComponentId()
     {
         return MOS_GPU_COMPONENT_DEFAULT;
@@ -346,6 +409,14 @@ protected:
     //! \brief    next fetch index of m_cmdBufPool
     uint32_t m_nextFetchIndex = 0;
 
+    //! \brief    Keep m_cmdBufPool as a ring of owned command buffers, recycled
+    //!           in place once the kernel fence of the slot retires
+    bool m_cmdBufRingEnabled = false;
+
+    //! \brief    Command buffer ring statistics
+    std::atomic<uint32_t> m_cmdBufRingStalls   = {0};
+    std::atomic<uint32_t> m_cmdBufRingReallocs = {0};
+
     //! \brief    initialized comamnd buffer size
     uint32_t m_commandBufferSize = 0;
 
@@ -374,6 +445,17 @@ protected:
     PMOS_RESOURCE m_attachedResources = nullptr;  //!< Pointer to resources list
     bool         *m_writeModeList     = nullptr;  //!< Write mode
 
+    //! \brief    Open addressing index from bo to allocation index
+    struct ResourceIndexEntry
+    {
+        MOS_LINUX_BO *bo              = nullptr;
+        uint32_t      allocationIndex = 0;
+        uint32_t      generation      = 0;  //!< Entry is valid only when equal to m_resIndexGeneration
+    };
+    static constexpr uint32_t m_resIndexSize       = 2 * ALLOCATIONLIST_SIZE;  //!< Power of 2, load factor <= 0.5
+    ResourceIndexEntry       *m_resIndex           = nullptr;
+    uint32_t                  m_resIndexGeneration = 1;
+
     //! \brief    GPU Status tag
     uint32_t m_GPUStatusTag = 0;
 
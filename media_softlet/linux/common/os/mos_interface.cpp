@@ -2897,6 +2897,27 @@ uint64_t MosInterface::GetGpuStatusSyncTag(
     return 0;
 }
 
+uint32_t MosInterface::GetEngineLoad(
+    MOS_STREAM_HANDLE streamState,
+    MOS_GPU_NODE      node,
+    uint32_t          maxCount)
+{
+    MOS_OS_FUNCTION_ENTER;
+
+    if (streamState == nullptr || streamState->osDeviceContext == nullptr)
+    {
+        return 0;
+    }
+
+    auto gpuContextMgr = streamState->osDeviceContext->GetGpuContextMgr();
+    if (gpuContextMgr == nullptr)
+    {
+        return 0;
+    }
+
+    return gpuContextMgr->GetPendingSubmissions(node, maxCount);
+}
+
 MOS_STATUS MosInterface::GetGpuStatusBufferResource(
     MOS_STREAM_HANDLE   streamState,
     MOS_RESOURCE_HANDLE &resource,
@@ -24,27 +24,126 @@
 //! \brief    interface for virtual memory address allocation
 //!
 
+#include <map>
+#include <new>
+#include <set>
 #include "mos_vma.h"
 
+/* Free ranges are kept in two balanced trees: by address, to find the neighbours
+ * of a freed range and coalesce with them, and by size, to find the smallest hole
+ * an allocation fits into. Both are O(log n) in the number of holes, where a hole
+ * list has to be walked on every allocation and free.
+ */
+struct mos_vma_size_order
+{
+    /* Smallest hole first; equal sized holes from the top of the heap first */
+    bool operator()(const std::pair<uint64_t, uint64_t> &a, const std::pair<uint64_t, uint64_t> &b) const
+    {
+        return a.first != b.first ? a.first < b.first : a.second > b.second;
+    }
+};
+
+struct _mos_vma_holes
+{
+    std::map<uint64_t, uint64_t>                                by_offset;   // offset -> size
+    std::set<std::pair<uint64_t, uint64_t>, mos_vma_size_order> by_size;     // (size, offset)
+    uint64_t                                                    free_size = 0;
+};
+
+typedef std::map<uint64_t, uint64_t>::iterator mos_vma_hole_iter;
+
+/* Holes with less than alignment - 1 bytes to spare may not fit an aligned
+ * allocation. Only this many of them are inspected before falling back to the
+ * smallest hole which is known to fit.
+ */
+#define MOS_VMA_MAX_MISFIT_PROBES 16
+
+/* Tree nodes are allocated on insertion, which throws std::bad_alloc when out of
+ * memory. The exception must not escape the C interface, so every update which
+ * needs a new node is done before the nodes it replaces are released, and is
+ * rolled back on failure leaving the heap unchanged.
+ */
+static bool
+mos_vma_holes_insert(struct _mos_vma_holes *holes, uint64_t offset, uint64_t size)
+{
+    mos_vma_hole_iter hole;
+    try
+    {
+        hole = holes->by_offset.emplace(offset, size).first;
+    }
+    catch (const std::bad_alloc &)
+    {
+        return false;
+    }
+
+    try
+    {
+        holes->by_size.emplace(size, offset);
+    }
+    catch (const std::bad_alloc &)
+    {
+        holes->by_offset.erase(hole);
+        return false;
+    }
+
+    holes->free_size += size;
+    return true;
+}
+
+/* Change the size of a hole keeping its offset */
+static bool
+mos_vma_holes_resize(struct _mos_vma_holes *holes, mos_vma_hole_iter hole, uint64_t size)
+{
+    try
+    {
+        holes->by_size.emplace(size, hole->first);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return false;
+    }
+
+    holes->by_size.erase(std::make_pair(hole->second, hole->first));
+    holes->free_size = holes->free_size - hole->second + size;
+    hole->second     = size;
+    return true;
+}
+
+static void
+mos_vma_holes_erase(struct _mos_vma_holes *holes, mos_vma_hole_iter hole)
+{
+    holes->by_size.erase(std::make_pair(hole->second, hole->first));
+    holes->free_size -= hole->second;
+    holes->by_offset.erase(hole);
+}
+
 void
 mos_vma_heap_init(mos_vma_heap *heap, uint64_t start, uint64_t size)
 {
     assert(heap);
-    list_inithead(&heap->holes);
-    mos_vma_heap_free(heap, start, size);
+    heap->holes = new (std::nothrow) struct _mos_vma_holes;
+    assert(heap->holes);
 
     /* Default to using high addresses */
     heap->alloc_high = true;
+
+    heap->alloc_count  = 0;
+    heap->free_count   = 0;
+    heap->failed_count = 0;
+
+    if (heap->holes && !mos_vma_holes_insert(heap->holes, start, size))
+    {
+        delete heap->holes;
+        heap->holes = nullptr;
+    }
 }
 
 void
 mos_vma_heap_finish(mos_vma_heap *heap)
 {
     assert(heap);
-    list_for_each_entry_safe(mos_vma_hole, hole, &heap->holes, link)
-    {
-        free(hole);
-    }
+    delete heap->holes;
+    heap->holes = nullptr;
 }
 
 #ifdef _DEBUG
@@ -52,89 +151,111 @@ static void
 mos_vma_heap_validate(mos_vma_heap *heap)
 {
     assert(heap);
-    uint64_t prev_offset = 0;
+    struct _mos_vma_holes *holes = heap->holes;
+    uint64_t free_size = 0;
+    uint64_t prev_end  = 0;
+    bool     first     = true;
 
-    list_for_each_entry(mos_vma_hole, hole, &heap->holes, link)
+    assert(holes->by_offset.size() == holes->by_size.size());
+
+    for (auto &hole : holes->by_offset)
     {
-        assert(hole->offset > 0);
-        assert(hole->size > 0);
+        assert(hole.first > 0);
+        assert(hole.second > 0);
+        assert(holes->by_size.count(std::make_pair(hole.second, hole.first)) == 1);
+
+        /* Holes must not overlap and, in fact, must be strictly apart. If
+         * hole.first == prev_end, then we failed to join holes during a
+         * mos_vma_heap_free.
+         */
+        assert(first || hole.first > prev_end);
+
+        /* Only the top-most hole may overflow, and only to 0, i.e. 2^64. */
+        assert(hole.first + hole.second == 0 ||
+               hole.first + hole.second > hole.first);
+
+        prev_end   = hole.first + hole.second;
+        first      = false;
+        free_size += hole.second;
+    }
 
-        if (&hole->link == heap->holes.next)
-        {
-            /* This must be the top-most hole.  Assert that, if it overflows, it
-            * overflows to 0, i.e. 2^64.
-            */
-            assert(hole->size + hole->offset == 0 ||
-                    hole->size + hole->offset > hole->offset);
-        }
-        else
-        {
-            /* This is not the top-most hole so it must not overflow and, in
-            * fact, must be strictly lower than the top-most hole.  If
-            * hole->size + hole->offset == prev_offset, then we failed to join
-            * holes during a mos_vma_heap_free.
-            */
-            assert(hole->size + hole->offset > hole->offset &&
-                    hole->size + hole->offset < prev_offset);
-        }
-        prev_offset = hole->offset;
-   }
+    assert(free_size == holes->free_size);
 }
 #else
 #define mos_vma_heap_validate(heap)
 #endif
 
-static void
-mos_vma_hole_alloc(mos_vma_hole *hole, uint64_t offset, uint64_t size)
+/* Carve an allocation out of a hole, return false if out of memory with the hole unchanged */
+static bool
+mos_vma_hole_alloc(struct _mos_vma_holes *holes, mos_vma_hole_iter hole, uint64_t offset, uint64_t size)
 {
-    assert(hole);
-    assert(hole->offset <= offset);
-    assert(hole->size >= offset - hole->offset + size);
-
-    if (offset == hole->offset && size == hole->size) {
-        /* Just get rid of the hole. */
-        list_del(&hole->link);
-        free(hole);
-        return;
-    }
+    uint64_t hole_offset = hole->first;
+    uint64_t hole_size   = hole->second;
 
-    uint64_t waste = (hole->size - size) - (offset - hole->offset);
-    if (waste == 0) {
-        /* We allocated at the top.  Shrink the hole down. */
-        hole->size -= size;
-        return;
-    }
+    assert(hole_offset <= offset);
+    assert(hole_size >= offset - hole_offset + size);
 
-    if (offset == hole->offset) {
-        /* We allocated at the bottom. Shrink the hole up. */
-        hole->offset += size;
-        hole->size -= size;
-        return;
+    /* Keep what is left at the top of the old hole as a new hole. */
+    uint64_t waste = (hole_size - size) - (offset - hole_offset);
+    if (waste && !mos_vma_holes_insert(holes, offset + size, waste))
+    {
+        return false;
     }
 
-    /* We allocated in the middle.  We need to split the old hole into two
-    * holes, one high and one low.
-    */
-    mos_vma_hole *high_hole = (mos_vma_hole*)calloc(1, sizeof(*hole));
-    if(high_hole == nullptr)
+    /* Shrink the old hole to what is left at the bottom, or drop it. */
+    if (offset == hole_offset)
+    {
+        mos_vma_holes_erase(holes, hole);
+    }
+    else if (!mos_vma_holes_resize(holes, hole, offset - hole_offset))
     {
-        assert(high_hole);
+        if (waste)
+        {
+            mos_vma_holes_erase(holes, holes->by_offset.find(offset + size));
+        }
+        return false;
+    }
 
-        return;
+    return true;
+}
+
+/* Place an allocation inside a hole, return false if the aligned allocation does not fit */
+static bool
+mos_vma_hole_fit(mos_vma_heap *heap, uint64_t hole_offset, uint64_t hole_size,
+                 uint64_t size, uint64_t alignment, uint64_t *offset)
+{
+    if (size > hole_size)
+        return false;
+
+    if (heap->alloc_high) {
+        /* Compute the offset as the highest address where a chunk of the
+        * given size can be without going over the top of the hole.
+        *
+        * This calculation is known to not overflow because we know that
+        * hole_size + hole_offset can only overflow to 0 and size > 0.
+        */
+        *offset = (hole_size - size) + hole_offset;
+
+        /* Align the offset.  We align down and not up because we are
+        * allocating from the top of the hole and not the bottom.
+        */
+        *offset = (*offset / alignment) * alignment;
+
+        return *offset >= hole_offset;
     }
 
-    high_hole->offset = offset + size;
-    high_hole->size = waste;
+    *offset = hole_offset;
 
-    /* Adjust the hole to be the amount of space left at he bottom of the
-    * original hole.
-    */
-    hole->size = offset - hole->offset;
+    /* Align the offset */
+    uint64_t misalign = *offset % alignment;
+    if (misalign) {
+        uint64_t pad = alignment - misalign;
+        if (pad > hole_size - size)
+            return false;
 
-    /* Place the new hole before the old hole so that the list is in order
-    * from high to low.
-    */
-    list_addtail(&high_hole->link, &hole->link);
+        *offset += pad;
+    }
+    return true;
 }
 
 uint64_t
@@ -145,58 +266,52 @@ mos_vma_heap_alloc(mos_vma_heap *heap, uint64_t size, uint64_t alignment)
     assert(size > 0);
     assert(alignment > 0);
 
-    mos_vma_heap_validate(heap);
-
-    if (heap->alloc_high) {
-        list_for_each_entry_safe(mos_vma_hole, hole, &heap->holes, link)
-        {
-            if (size > hole->size)
-                continue;
+    struct _mos_vma_holes *holes = heap->holes;
+    if (holes == nullptr)
+        return 0;
 
-            /* Compute the offset as the highest address where a chunk of the
-            * given size can be without going over the top of the hole.
-            *
-            * This calculation is known to not overflow because we know that
-            * hole->size + hole->offset can only overflow to 0 and size > 0.
-            */
-            uint64_t offset = (hole->size - size) + hole->offset;
-
-            /* Align the offset.  We align down and not up because we are
-            * allocating from the top of the hole and not the bottom.
-            */
-            offset = (offset / alignment) * alignment;
+    mos_vma_heap_validate(heap);
 
-            if (offset < hole->offset)
-            continue;
+    /* Best fit: walk holes from the smallest one which is large enough. Holes
+     * with at least alignment - 1 spare bytes always fit, so give up on the
+     * smaller ones after a few misfits.
+     */
+    uint64_t fit_size = (size + alignment - 1 > size) ? size + alignment - 1 : size;
+    int      misfits  = 0;
+    auto     it       = holes->by_size.lower_bound(std::make_pair(size, UINT64_MAX));
 
-            mos_vma_hole_alloc(hole, offset, size);
+    while (it != holes->by_size.end())
+    {
+        uint64_t offset = 0;
+        if (mos_vma_hole_fit(heap, it->second, it->first, size, alignment, &offset))
+        {
+            if (!mos_vma_hole_alloc(holes, holes->by_offset.find(it->second), offset, size))
+            {
+                break;
+            }
+            heap->alloc_count++;
             mos_vma_heap_validate(heap);
             return offset;
         }
-    } else {
-        list_for_each_entry_safe_rev(mos_vma_hole, hole, &heap->holes, link) {
-            if (size > hole->size)
-                continue;
-
-            uint64_t offset = hole->offset;
 
-            /* Align the offset */
-            uint64_t misalign = offset % alignment;
-            if (misalign) {
-                uint64_t pad = alignment - misalign;
-                if (pad > hole->size - size)
-                    continue;
-
-                offset += pad;
+        if (it->first < fit_size && ++misfits >= MOS_VMA_MAX_MISFIT_PROBES)
+        {
+            /* Skip the remaining small holes only if a hole known to fit
+             * exists, otherwise keep probing them.
+             */
+            auto fit = holes->by_size.lower_bound(std::make_pair(fit_size, UINT64_MAX));
+            fit_size = 0;
+            if (fit != holes->by_size.end())
+            {
+                it = fit;
+                continue;
             }
-
-            mos_vma_hole_alloc(hole, offset, size);
-            mos_vma_heap_validate(heap);
-            return offset;
         }
+        ++it;
     }
 
     /* Failed to allocate */
+    heap->failed_count++;
     return 0;
 }
 
@@ -217,26 +332,33 @@ mos_vma_heap_alloc_addr(mos_vma_heap *heap, uint64_t offset, uint64_t size)
     */
     assert(offset + size == 0 || offset + size > offset);
 
-    /* Find the hole if one exists. */
-    list_for_each_entry_safe(mos_vma_hole, hole, &heap->holes, link)
-    {
-        if (hole->offset > offset)
-            continue;
+    struct _mos_vma_holes *holes = heap->holes;
+    if (holes == nullptr)
+        return false;
 
-        /* Holes are ordered high-to-low so the first hole we find with
-        * hole->offset <= is our hole.  If it's not big enough to contain the
-        * requested range, then the allocation fails.
-        */
-        assert(hole->offset <= offset);
-        if (hole->size < offset - hole->offset + size)
-            return false;
+    /* The hole containing the range, if one exists, is the last hole
+    * starting at or below offset.
+    */
+    auto hole = holes->by_offset.upper_bound(offset);
+    if (hole == holes->by_offset.begin())
+        return false;
+    --hole;
 
-        mos_vma_hole_alloc(hole, offset, size);
-        return true;
-    }
+    /* If it's not big enough to contain the requested range, then the
+    * allocation fails.
+    */
+    assert(hole->first <= offset);
+    if (hole->second < offset - hole->first + size)
+        return false;
 
-    /* We didn't find a suitable hole */
-    return false;
+    if (!mos_vma_hole_alloc(holes, hole, offset, size))
+    {
+        heap->failed_count++;
+        return false;
+    }
+    heap->alloc_count++;
+    mos_vma_heap_validate(heap);
+    return true;
 }
 
 void
@@ -256,60 +378,76 @@ mos_vma_heap_free(mos_vma_heap *heap, uint64_t offset, uint64_t size)
     */
     assert(offset + size == 0 || offset + size > offset);
 
+    struct _mos_vma_holes *holes = heap->holes;
+    if (holes == nullptr)
+        return;
+
     mos_vma_heap_validate(heap);
 
     /* Find immediately higher and lower holes if they exist. */
-    mos_vma_hole *high_hole = NULL, *low_hole = NULL;
-    list_for_each_entry(mos_vma_hole, hole, &heap->holes, link)
+    mos_vma_hole_iter high_hole = holes->by_offset.lower_bound(offset);
+    mos_vma_hole_iter low_hole  = holes->by_offset.end();
+    if (high_hole != holes->by_offset.begin())
     {
-        if (hole->offset <= offset) {
-            low_hole = hole;
-            break;
-        }
-        high_hole = hole;
+        low_hole = std::prev(high_hole);
     }
 
-    if (high_hole)
+    if (high_hole != holes->by_offset.end())
     {
-        assert(offset + size <= high_hole->offset);
+        assert(offset + size <= high_hole->first);
     }
+    bool high_adjacent = high_hole != holes->by_offset.end() && offset + size == high_hole->first;
 
-    bool high_adjacent = high_hole && offset + size == high_hole->offset;
-
-    if (low_hole) {
-        assert(low_hole->offset + low_hole->size > low_hole->offset);
-        assert(low_hole->offset + low_hole->size <= offset);
+    if (low_hole != holes->by_offset.end())
+    {
+        assert(low_hole->first + low_hole->second > low_hole->first);
+        assert(low_hole->first + low_hole->second <= offset);
     }
-    bool low_adjacent = low_hole && low_hole->offset + low_hole->size == offset;
-
-    if (low_adjacent && high_adjacent) {
-        /* Merge the two holes */
-        low_hole->size += size + high_hole->size;
-        list_del(&high_hole->link);
-        free(high_hole);
-    } else if (low_adjacent) {
-        /* Merge into the low hole */
-        low_hole->size += size;
-    } else if (high_adjacent) {
-        /* Merge into the high hole */
-        high_hole->offset = offset;
-        high_hole->size += size;
-    } else {
-        /* Neither hole is adjacent; make a new one */
-        mos_vma_hole *hole = (mos_vma_hole*)calloc(1, sizeof(*hole));
-        assert(hole);
-        if(hole)
-        {
-            hole->offset = offset;
-            hole->size = size;
-
-            /* Add it after the high hole so we maintain high-to-low ordering */
-            if (high_hole)
-                list_add(&hole->link, &high_hole->link);
-            else
-                list_add(&hole->link, &heap->holes);
-        }
+    bool low_adjacent = low_hole != holes->by_offset.end() && low_hole->first + low_hole->second == offset;
+
+    /* Merge with the adjacent holes, if any. The low hole is grown in place and
+     * keeps its offset, otherwise a new hole replaces the high one. If that
+     * runs out of memory the range is lost to the heap, but the heap stays
+     * consistent.
+     */
+    bool merged;
+    if (low_adjacent)
+    {
+        uint64_t high_size = high_adjacent ? high_hole->second : 0;
+        merged = mos_vma_holes_resize(holes, low_hole, low_hole->second + size + high_size);
+    }
+    else
+    {
+        merged = mos_vma_holes_insert(holes, offset, size + (high_adjacent ? high_hole->second : 0));
+    }
+    if (!merged)
+    {
+        return;
+    }
+
+    if (high_adjacent)
+    {
+        mos_vma_holes_erase(holes, high_hole);
     }
+    heap->free_count++;
 
     mos_vma_heap_validate(heap);
 }
+
+void
+mos_vma_heap_get_stats(mos_vma_heap *heap, mos_vma_heap_stats *stats)
+{
+    assert(heap);
+    assert(stats);
+
+    struct _mos_vma_holes *holes = heap->holes;
+
+    stats->free_size     = holes ? holes->free_size : 0;
+    stats->hole_count    = holes ? holes->by_offset.size() : 0;
+    stats->largest_hole  = (holes && !holes->by_size.empty()) ? holes->by_size.rbegin()->first : 0;
+    stats->fragmentation = stats->free_size ?
+        (uint32_t)(1000 - (stats->largest_hole / (double)stats->free_size) * 1000) : 0;
+    stats->alloc_count   = heap->alloc_count;
+    stats->free_count    = heap->free_count;
+    stats->failed_count  = heap->failed_count;
+}
@@ -37,21 +37,35 @@
 extern "C" {
 #endif
 
+struct _mos_vma_holes;
+
 typedef struct _mos_vma_heap {
-   struct list_head holes;
+   /** Free address ranges, ordered both by address (to find and coalesce
+    * neighbours) and by size (to find the best fit), see mos_vma.c.
+    */
+   struct _mos_vma_holes *holes;
 
    /** If true, util_vma_heap_alloc will prefer high addresses
     *
     * Default is true.
     */
    bool alloc_high;
+
+   /** Statistics */
+   uint64_t alloc_count;
+   uint64_t free_count;
+   uint64_t failed_count;
 } mos_vma_heap;
 
-typedef struct _mos_vma_hole {
-   struct list_head link;
-   uint64_t offset;
-   uint64_t size;
-} mos_vma_hole;
+typedef struct _mos_vma_heap_stats {
+   uint64_t free_size;      // total size of free ranges
+   uint64_t hole_count;     // number of free ranges
+   uint64_t largest_hole;   // size of the largest free range
+   uint32_t fragmentation;  // 0 (one free range) to 1000 (free space in many tiny ranges), 1 - largest_hole / free_size in permille
+   uint64_t alloc_count;
+   uint64_t free_count;
+   uint64_t failed_count;
+} mos_vma_heap_stats;
 
 //!
 //! \brief  Initialize vma heap
@@ -120,6 +134,18 @@ bool mos_vma_heap_alloc_addr(mos_vma_heap *heap, uint64_t addr, uint64_t size);
 //!
 void mos_vma_heap_free(mos_vma_heap *heap, uint64_t offset, uint64_t size);
 
+//!
+//! \brief  Get free space and fragmentation statistics of a specific vma heap
+//!
+//! \param  [in] heap
+//!         Pointer to vma heap
+//! \param  [out] stats
+//!         Statistics of the heap
+//!
+//! \return void
+//!
+void mos_vma_heap_get_stats(mos_vma_heap *heap, mos_vma_heap_stats *stats);
+
 #ifdef __cplusplus
 } /* extern C */
 #endif
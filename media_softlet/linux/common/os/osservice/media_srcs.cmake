@@ -23,12 +23,14 @@ configure_file(${CMAKE_CURRENT_LIST_DIR}/mos_compat.h.in ${CMAKE_BINARY_DIR}/mos
 set(TMP_SOURCES_
     ${CMAKE_CURRENT_LIST_DIR}/mos_util_debug_specific.cpp
     ${CMAKE_CURRENT_LIST_DIR}/mos_utilities_specific.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/mos_trace_ring_specific.cpp
 )
 
 set(TMP_HEADERS_
     ${CMAKE_BINARY_DIR}/mos_compat.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_utilities_specific.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_util_debug_specific.h
+    ${CMAKE_CURRENT_LIST_DIR}/mos_trace_ring_specific.h
 )
 
 set(SOFTLET_MOS_COMMON_SOURCES_
@@ -0,0 +1,405 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file        mos_trace_ring_specific.cpp
+//! \brief       Per-thread trace event rings drained to the ftrace marker in batches
+//!
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "mos_trace_ring_specific.h"
+#include "mos_os_trace_event.h"
+
+// Record layout: uint32_t length, uint32_t reserved, uint64_t capture time, payload, padded to 8 bytes.
+#define MOS_TRACE_RING_REC_HEADER   (2 * sizeof(uint32_t) + sizeof(uint64_t))
+#define MOS_TRACE_RING_REC_ALIGN    (8)
+#define MOS_TRACE_RING_WRAP         (0xffffffff)    // rest of the ring is unused, restart at 0
+#define MOS_TRACE_RING_MAX_IOV      (64)
+#define MOS_TRACE_TAG               (0x494D5445)    // IMTE (IntelMediaTraceEvent) as ftrace raw marker tag
+
+struct MosTraceRingBuffer
+{
+    uint8_t               *buf      = nullptr;
+    uint32_t              size      = 0;        // power of 2
+    uint32_t              tid       = 0;
+    std::atomic<uint64_t> head      = {0};      // written by producer
+    std::atomic<uint64_t> tail      = {0};      // written by flusher
+    std::atomic<uint64_t> dropped   = {0};
+    std::atomic<bool>     orphaned  = {false};  // producer thread exited
+    uint64_t              pending   = 0;        // producer only, head of the reserved record
+    uint64_t              pendingTs = 0;        // producer only, capture time of the reserved record
+    uint64_t              reported  = 0;        // flusher only, dropped count already reported
+};
+
+namespace
+{
+struct MosTraceRingHolder
+{
+    MosTraceRingBuffer *ring = nullptr;
+    ~MosTraceRingHolder();
+};
+
+std::mutex                         s_ringLock;
+std::condition_variable            s_ringCond;
+std::vector<MosTraceRingBuffer *>  s_rings;
+std::thread                        s_flusher;
+bool                               s_stop = false;
+thread_local MosTraceRingHolder    t_ring;
+
+// Joins the flusher if the process exits without MosTraceEventClose, a
+// joinable std::thread would otherwise terminate in its destructor.
+struct MosTraceRingExit
+{
+    ~MosTraceRingExit()
+    {
+        MosTraceRing::Close();
+    }
+} s_ringExit;
+
+inline uint64_t RecordSize(uint32_t size)
+{
+    return (MOS_TRACE_RING_REC_HEADER + size + MOS_TRACE_RING_REC_ALIGN - 1) & ~(uint64_t)(MOS_TRACE_RING_REC_ALIGN - 1);
+}
+
+inline uint64_t CaptureTime()
+{
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void FreeRing(MosTraceRingBuffer *ring)
+{
+    free(ring->buf);
+    delete ring;
+}
+
+// Free rings of exited threads, s_ringLock held and no flusher draining them
+void FreeOrphanedRings()
+{
+    auto end = std::remove_if(s_rings.begin(), s_rings.end(), [](MosTraceRingBuffer *ring) {
+        if (!ring->orphaned.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        FreeRing(ring);
+        return true;
+    });
+    s_rings.erase(end, s_rings.end());
+}
+}  // namespace
+
+std::atomic<bool>     MosTraceRing::m_enabled    = {false};
+int32_t               MosTraceRing::m_fd         = -1;
+uint32_t              MosTraceRing::m_ringSize   = 0;
+
+MosTraceRingHolder::~MosTraceRingHolder()
+{
+    if (ring)
+    {
+        ring->orphaned.store(true, std::memory_order_release);
+    }
+    ring = nullptr;
+}
+
+bool MosTraceRing::Init(int32_t fd, uint32_t ringSize)
+{
+    Close();
+    if (fd < 0 || ringSize == 0)
+    {
+        return false;
+    }
+
+    uint32_t size = MOS_TRACE_RING_MIN_SIZE;
+    while (size < ringSize && size < MOS_TRACE_RING_MAX_SIZE)
+    {
+        size <<= 1;
+    }
+
+    std::lock_guard<std::mutex> lock(s_ringLock);
+    // Rings kept from a previous Init may hold events written after its Close, drop them.
+    FreeOrphanedRings();
+    for (auto ring : s_rings)
+    {
+        ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+        ring->reported = ring->dropped.load(std::memory_order_relaxed);
+    }
+
+    m_fd       = fd;
+    m_ringSize = size;
+    s_stop     = false;
+    try
+    {
+        s_flusher = std::thread(FlushThread);
+    }
+    catch (const std::system_error &)
+    {
+        m_fd = -1;
+        return false;
+    }
+    m_enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+void MosTraceRing::Close()
+{
+    if (!m_enabled.exchange(false))
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_ringLock);
+        s_stop = true;
+    }
+    s_ringCond.notify_all();
+    if (s_flusher.joinable())
+    {
+        s_flusher.join();
+    }
+
+    // Producers which checked IsEnabled before it was cleared may still be
+    // writing to their ring, so rings of live threads are flushed but kept
+    // until the thread exits. Only the rings of exited threads are freed.
+    std::vector<MosTraceRingBuffer *> rings;
+    {
+        std::lock_guard<std::mutex> lock(s_ringLock);
+        rings = s_rings;
+    }
+    for (auto ring : rings)
+    {
+        Drain(ring);
+    }
+
+    std::lock_guard<std::mutex> lock(s_ringLock);
+    FreeOrphanedRings();
+    m_fd = -1;
+}
+
+MosTraceRingBuffer *MosTraceRing::GetThreadRing()
+{
+    if (t_ring.ring)
+    {
+        return t_ring.ring;
+    }
+
+    MosTraceRingBuffer *ring = new (std::nothrow) MosTraceRingBuffer;
+    if (ring == nullptr)
+    {
+        return nullptr;
+    }
+    ring->size = m_ringSize;
+    ring->tid  = (uint32_t)syscall(SYS_gettid);
+    if (ring->size == 0 || posix_memalign((void **)&ring->buf, MOS_TRACE_RING_REC_ALIGN, ring->size) != 0)
+    {
+        delete ring;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(s_ringLock);
+    if (!m_enabled.load(std::memory_order_relaxed))
+    {
+        FreeRing(ring);
+        return nullptr;
+    }
+    try
+    {
+        s_rings.push_back(ring);
+    }
+    catch (const std::bad_alloc &)
+    {
+        FreeRing(ring);
+        return nullptr;
+    }
+    t_ring.ring = ring;
+    return ring;
+}
+
+uint8_t *MosTraceRing::Reserve(uint32_t size)
+{
+    MosTraceRingBuffer *ring = GetThreadRing();
+    if (ring == nullptr)
+    {
+        return nullptr;
+    }
+
+    uint64_t head   = ring->head.load(std::memory_order_relaxed);
+    uint64_t tail   = ring->tail.load(std::memory_order_acquire);
+    uint64_t need   = RecordSize(size);
+    uint64_t offset = head & (ring->size - 1);
+    uint64_t skip   = (offset + need > ring->size) ? ring->size - offset : 0;
+
+    if (need > ring->size / 2 || skip + need > ring->size - (head - tail))
+    {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    if (skip)
+    {
+        // Remaining space at the end is always 8 byte aligned, so the marker fits.
+        *(uint32_t *)(ring->buf + offset) = MOS_TRACE_RING_WRAP;
+        offset = 0;
+    }
+    ring->pending   = head + skip;
+    ring->pendingTs = CaptureTime();
+    return ring->buf + offset + MOS_TRACE_RING_REC_HEADER;
+}
+
+void MosTraceRing::Commit(uint32_t size)
+{
+    MosTraceRingBuffer *ring = t_ring.ring;
+    if (ring == nullptr)
+    {
+        return;
+    }
+
+    uint8_t *record = ring->buf + (ring->pending & (ring->size - 1));
+    ((uint32_t *)record)[0] = size;
+    ((uint32_t *)record)[1] = 0;
+    ((uint64_t *)record)[1] = ring->pendingTs;
+    ring->head.store(ring->pending + RecordSize(size), std::memory_order_release);
+}
+
+bool MosTraceRing::Write(const void *data, uint32_t size)
+{
+    uint8_t *dst = Reserve(size);
+    if (dst == nullptr)
+    {
+        return false;
+    }
+    memcpy(dst, data, size);
+    Commit(size);
+    return true;
+}
+
+void MosTraceRing::Drain(MosTraceRingBuffer *ring)
+{
+    struct iovec iov[MOS_TRACE_RING_MAX_IOV];
+    uint32_t     batch[9];
+    uint64_t     tail = ring->tail.load(std::memory_order_relaxed);
+    uint64_t     head = ring->head.load(std::memory_order_acquire);
+
+    while (tail != head)
+    {
+        // iov[0] is the batch marker, it tells decoders which thread captured the
+        // records behind it and when, the ftrace tid and time are the flusher's.
+        int32_t  count   = 1;
+        uint64_t next    = tail;
+        uint64_t firstTs = 0;
+        uint64_t lastTs  = 0;
+        while (next != head && count < MOS_TRACE_RING_MAX_IOV)
+        {
+            uint64_t offset = next & (ring->size - 1);
+            uint32_t len    = *(uint32_t *)(ring->buf + offset);
+            if (len == MOS_TRACE_RING_WRAP)
+            {
+                next += ring->size - offset;
+                continue;
+            }
+            lastTs  = *(uint64_t *)(ring->buf + offset + 2 * sizeof(uint32_t));
+            firstTs = (count == 1) ? lastTs : firstTs;
+            iov[count].iov_base = ring->buf + offset + MOS_TRACE_RING_REC_HEADER;
+            iov[count].iov_len  = len;
+            count++;
+            next += RecordSize(len);
+        }
+        if (count > 1)
+        {
+            batch[0] = MOS_TRACE_TAG;
+            batch[1] = (EVENT_TRACE_RING_BATCH << 16) | (6 * sizeof(uint32_t));
+            batch[2] = EVENT_TYPE_INFO;
+            batch[3] = ring->tid;
+            batch[4] = (uint32_t)(count - 1);
+            batch[5] = (uint32_t)firstTs;
+            batch[6] = (uint32_t)(firstTs >> 32);
+            batch[7] = (uint32_t)lastTs;
+            batch[8] = (uint32_t)(lastTs >> 32);
+            iov[0].iov_base = batch;
+            iov[0].iov_len  = sizeof(batch);
+            // trace_marker_raw only implements write, so each iovec lands as its own event.
+            ssize_t ret = writev(m_fd, iov, count);
+            (void)ret;
+        }
+        tail = next;
+        ring->tail.store(tail, std::memory_order_release);
+    }
+
+    uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+    if (dropped != ring->reported)
+    {
+        uint32_t event[5];
+        event[0] = MOS_TRACE_TAG;
+        event[1] = (EVENT_TRACE_RING_OVERRUN << 16) | (2 * sizeof(uint32_t));
+        event[2] = EVENT_TYPE_INFO;
+        event[3] = ring->tid;
+        event[4] = (uint32_t)(dropped - ring->reported);
+        ssize_t ret = write(m_fd, event, sizeof(event));
+        (void)ret;
+        ring->reported = dropped;
+    }
+}
+
+void MosTraceRing::FlushThread()
+{
+    std::vector<MosTraceRingBuffer *> rings;
+    std::vector<MosTraceRingBuffer *> orphaned;
+    std::unique_lock<std::mutex>      lock(s_ringLock);
+    while (!s_stop)
+    {
+        s_ringCond.wait_for(lock, std::chrono::microseconds(MOS_TRACE_RING_FLUSH_INTERVAL_US));
+
+        // Drain without the lock so threads creating their ring are not blocked
+        // by the writes. Only this thread frees rings while it runs.
+        rings = s_rings;
+        lock.unlock();
+        orphaned.clear();
+        for (auto ring : rings)
+        {
+            // Read orphaned first, the exiting thread publishes no more records after it.
+            if (ring->orphaned.load(std::memory_order_acquire))
+            {
+                orphaned.push_back(ring);
+            }
+            Drain(ring);
+        }
+        lock.lock();
+
+        for (auto ring : orphaned)
+        {
+            s_rings.erase(std::find(s_rings.begin(), s_rings.end(), ring));
+            FreeRing(ring);
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file        mos_trace_ring_specific.h
+//! \brief       Per-thread trace event rings drained to the ftrace marker in batches
+//!
+
+#ifndef __MOS_TRACE_RING_SPECIFIC_H__
+#define __MOS_TRACE_RING_SPECIFIC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "media_class_trace.h"
+
+#define MOS_TRACE_RING_ENV                 "GFX_MEDIA_TRACE_RING"   // per thread ring size in KB, unset or 0 disables the rings
+#define MOS_TRACE_RING_MIN_SIZE            (16 * 1024)
+#define MOS_TRACE_RING_MAX_SIZE            (64 * 1024 * 1024)
+#define MOS_TRACE_RING_FLUSH_INTERVAL_US   (1000)
+
+struct MosTraceRingBuffer;
+
+//!
+//! \brief    Batched trace event output
+//! \details  Every trace producing thread owns a single producer single consumer
+//!           ring. Producers reserve a slot, build the IMTE record in place and
+//!           publish it with a release store, so the hot path has neither a
+//!           syscall nor a lock nor a heap allocation. A flusher thread drains
+//!           all rings to the trace marker fd with writev, one iovec per record,
+//!           which keeps every IMTE record a separate ftrace event. Events that
+//!           do not fit are dropped and reported as EVENT_TRACE_RING_OVERRUN.
+//!           Since the ftrace timestamp and pid of a drained record are the
+//!           flusher's, every writev starts with an EVENT_TRACE_RING_BATCH
+//!           record carrying the producer tid, the record count and the
+//!           CLOCK_MONOTONIC capture time of the first and last record, in ns.
+//!           Use "trace_clock mono" to correlate them with ftrace time.
+//!
+class MosTraceRing
+{
+public:
+    //!
+    //! \brief    Start batching trace events to fd
+    //! \param    [in] fd
+    //!           Trace marker file descriptor, owned by the caller
+    //! \param    [in] ringSize
+    //!           Per thread ring size in bytes, rounded up to power of 2
+    //! \return   bool
+    //!           true if the flusher is running
+    //!
+    static bool Init(int32_t fd, uint32_t ringSize);
+
+    //!
+    //! \brief    Flush pending events and stop the flusher
+    //! \details  Rings of live threads are kept until the thread exits, since a
+    //!           producer may still be writing to its ring when Close runs.
+    //!
+    static void Close();
+
+    //!
+    //! \brief    Check whether trace events go through the rings
+    //!
+    static bool IsEnabled()
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    //!
+    //! \brief    Reserve space for one record in the calling thread's ring
+    //! \param    [in] size
+    //!           Maximum record size in bytes
+    //! \return   uint8_t *
+    //!           Record storage, nullptr if the ring is full and the event is dropped
+    //!
+    static uint8_t *Reserve(uint32_t size);
+
+    //!
+    //! \brief    Publish the record returned by the last Reserve
+    //! \param    [in] size
+    //!           Actual record size, no larger than the reserved size
+    //!
+    static void Commit(uint32_t size);
+
+    //!
+    //! \brief    Copy a complete record into the calling thread's ring
+    //! \return   bool
+    //!           false if the event is dropped
+    //!
+    static bool Write(const void *data, uint32_t size);
+
+private:
+    static MosTraceRingBuffer *GetThreadRing();
+    static void FlushThread();
+    static void Drain(MosTraceRingBuffer *ring);
+
+    static std::atomic<bool>     m_enabled;
+    static int32_t               m_fd;
+    static uint32_t              m_ringSize;
+
+MEDIA_CLASS_DEFINE_END(MosTraceRing)
+};
+
+#endif // __MOS_TRACE_RING_SPECIFIC_H__
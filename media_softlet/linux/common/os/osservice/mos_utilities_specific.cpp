@@ -44,6 +44,7 @@
 #include "mos_utilities_specific.h"
 #include "mos_utilities.h"
 #include "mos_util_debug.h"
+#include "mos_trace_ring_specific.h"
 #include "inttypes.h"
 
 int32_t g_mosMemAllocCounter         = 0;
@@ -2488,13 +2489,28 @@ void MosUtilities::MosTraceEventInit()
         m_mosTraceLevel = &m_mosTraceControlData->level;
     }
 
-    // close first, if already opened.
+    // close first, if already opened. The flusher of a previous init still
+    // writes to the old fd, so stop it before the fd is closed or reused.
+    MosTraceRing::Close();
     if (MosUtilitiesSpecificNext::m_mosTraceFd >= 0)
     {
         close(MosUtilitiesSpecificNext::m_mosTraceFd);
         MosUtilitiesSpecificNext::m_mosTraceFd = -1;
     }
     MosUtilitiesSpecificNext::m_mosTraceFd = open(MosUtilitiesSpecificNext::m_mosTracePath, O_WRONLY);
+
+    // optional per thread rings, events are written out by a flusher thread in batches
+    val = getenv(MOS_TRACE_RING_ENV);
+    if (val && MosUtilitiesSpecificNext::m_mosTraceFd >= 0)
+    {
+        uint32_t ringKB = static_cast<uint32_t>(strtoul(val, nullptr, 0));
+        // 0 keeps the direct writes, oversized values are clamped before the KB conversion can overflow
+        if (ringKB > 0)
+        {
+            ringKB = (ringKB > MOS_TRACE_RING_MAX_SIZE / 1024) ? MOS_TRACE_RING_MAX_SIZE / 1024 : ringKB;
+            MosTraceRing::Init(MosUtilitiesSpecificNext::m_mosTraceFd, ringKB * 1024);
+        }
+    }
     return;
 }
 
@@ -2508,6 +2524,7 @@ void MosUtilities::MosTraceEventClose()
         munmap((void *)m_mosTraceControlData, TRACE_SETTING_SIZE);
         m_mosTraceControlData = nullptr;
     }
+    MosTraceRing::Close();
     if (MosUtilitiesSpecificNext::m_mosTraceFd >= 0)
     {
         close(MosUtilitiesSpecificNext::m_mosTraceFd);
@@ -2523,6 +2540,19 @@ void MosUtilities::MosTraceSetupInfo(uint32_t DrvVer, uint32_t PlatFamily, uint3
     // not implemented
 }
 
+static inline void MosTraceWrite(const void *buf, uint32_t size)
+{
+    if (MosTraceRing::IsEnabled())
+    {
+        MosTraceRing::Write(buf, size);
+    }
+    else
+    {
+        ssize_t ret = write(MosUtilitiesSpecificNext::m_mosTraceFd, buf, size);
+        (void)ret;
+    }
+}
+
 void MosUtilities::MosTraceEvent(
     uint16_t         usId,
     uint8_t          ucType,
@@ -2555,7 +2585,13 @@ void MosUtilities::MosTraceEvent(
             }
         }
 
-        if (dwSize1 + dwSize2 + TRACE_EVENT_HEADER_SIZE > sizeof(traceBuf))
+        bool ring = MosTraceRing::IsEnabled();
+        if (ring)
+        {
+            // build the record in place, nullptr means the ring is full and the event is dropped
+            pTraceBuf = MosTraceRing::Reserve(dwSize1 + dwSize2 + TRACE_EVENT_HEADER_SIZE);
+        }
+        else if (dwSize1 + dwSize2 + TRACE_EVENT_HEADER_SIZE > sizeof(traceBuf))
         {
             pTraceBuf = (uint8_t *)MOS_AllocAndZeroMemory(TRACE_EVENT_MAX_SIZE);
         }
@@ -2580,10 +2616,17 @@ void MosUtilities::MosTraceEvent(
                 MOS_SecureMemcpy(pTraceBuf+nLen, dwSize2, pArg2, dwSize2);
                 nLen += dwSize2;
             }
-            size_t writeSize = write(MosUtilitiesSpecificNext::m_mosTraceFd, pTraceBuf, nLen);
-            if (traceBuf != pTraceBuf)
+            if (ring)
             {
-                MOS_FreeMemory(pTraceBuf);
+                MosTraceRing::Commit(nLen);
+            }
+            else
+            {
+                size_t writeSize = write(MosUtilitiesSpecificNext::m_mosTraceFd, pTraceBuf, nLen);
+                if (traceBuf != pTraceBuf)
+                {
+                    MOS_FreeMemory(pTraceBuf);
+                }
             }
         }
 #if Backtrace_FOUND
@@ -2603,7 +2646,7 @@ void MosUtilities::MosTraceEvent(
                 header[2] = 0;
                 header[3] = (uint32_t)num;
                 nLen += num*sizeof(void *);
-                size_t ret = write(MosUtilitiesSpecificNext::m_mosTraceFd, traceBuf, nLen);
+                MosTraceWrite(traceBuf, nLen);
             }
         }
 #endif
@@ -2636,7 +2679,6 @@ void MosUtilities::MosTraceDataDump(
     if (MosUtilitiesSpecificNext::m_mosTraceFd >= 0 && pBuf && pcName)
     {
         uint8_t *pTraceBuf = (uint8_t *)MOS_AllocAndZeroMemory(TRACE_EVENT_MAX_SIZE);
-        size_t writeSize = 0;
 
         if (pTraceBuf)
         {
@@ -2651,7 +2693,7 @@ void MosUtilities::MosTraceDataDump(
             header[4] = flags;
             memcpy(&header[5], pcName, nLen);
             nLen += TRACE_EVENT_HEADER_SIZE + 8 + 1;
-            writeSize = write(MosUtilitiesSpecificNext::m_mosTraceFd, pTraceBuf, nLen);
+            MosTraceWrite(pTraceBuf, nLen);
             // send dump data
             header[2] = EVENT_TYPE_INFO;
             const uint8_t *pData = static_cast<const uint8_t *>(pBuf);
@@ -2669,14 +2711,14 @@ void MosUtilities::MosTraceDataDump(
                 memcpy(pDst, &len, sizeof(len));
                 memcpy(pDst+sizeof(len), pData, size);
                 nLen = TRACE_EVENT_HEADER_SIZE + size + sizeof(len);
-                writeSize = write(MosUtilitiesSpecificNext::m_mosTraceFd, pTraceBuf, nLen);
+                MosTraceWrite(pTraceBuf, nLen);
                 dwSize -= size;
                 pData += size;
             }
             // send dump end
             header[1] = EVENT_DATA_DUMP << 16;
             header[2] = EVENT_TYPE_END;
-            writeSize = write(MosUtilitiesSpecificNext::m_mosTraceFd, pTraceBuf, TRACE_EVENT_HEADER_SIZE);
+            MosTraceWrite(pTraceBuf, TRACE_EVENT_HEADER_SIZE);
 
             MOS_FreeMemory(pTraceBuf);
         }
@@ -56,6 +56,7 @@ extern drm_export int drmIoctl(int fd, unsigned long request, void *arg);
  */
 static int64_t __xe_bufmgr_debug__;
 #define XE_DEBUG_SYNCHRONIZATION   (1ull << 0)
+#define XE_DEBUG_BO_CACHE          (1ull << 1)
 #define __XE_TEST_DEBUG(flags) (__xe_bufmgr_debug__ & flags)
 #endif
 
@@ -102,13 +103,15 @@ enum ENV_KEYS {
     INTEL_XE_BUFMGR_DEBUG = 2,
     RESERVED_3 = 3,
     INTEL_ENGINE_TIMESLICE=4,
+    INTEL_XE_BO_CACHE_SIZE=5,
     INTEL_ENV_COUNT,
 };
 
 static std::map<uint32_t, std::string> ENV_VARIABLE_TABLE = {
     {INTEL_TILE_INSTANCE, "INTEL_TILE_INSTANCE"},
     {INTEL_XE_BUFMGR_DEBUG, "INTEL_XE_BUFMGR_DEBUG"},
-    {INTEL_ENGINE_TIMESLICE, "INTEL_ENGINE_TIMESLICE"}
+    {INTEL_ENGINE_TIMESLICE, "INTEL_ENGINE_TIMESLICE"},
+    {INTEL_XE_BO_CACHE_SIZE, "INTEL_XE_BO_CACHE_SIZE"}
 };
 
 /**
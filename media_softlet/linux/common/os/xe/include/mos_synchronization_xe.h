@@ -75,6 +75,10 @@ int mos_sync_syncobj_timeline_wait(int fd, uint32_t *handles, uint64_t *points,
 
 int mos_sync_syncobj_handle_to_syncfile_fd(int fd, int syncobj_handle);
 int mos_sync_import_syncfile_to_external_bo(int fd, int prime_fd, int syncfile_fd);
+int __mos_sync_syncobj_transfer(int fd,
+        uint32_t handle_dst, uint64_t point_dst,
+        uint32_t handle_src, uint64_t point_src,
+        uint32_t flags);
 int mos_sync_syncobj_timeline_to_binary(int fd, uint32_t binary_handle,
         uint32_t timeline_handle,
         uint64_t point,
@@ -160,9 +160,21 @@ typedef struct mos_xe_device {
 } mos_xe_device;
 
 struct mos_xe_gem_bo_bucket {
+    /**
+     * Cached bo of this size class, oldest first, one list per memory class
+     */
     drmMMListHead sys_head;
     drmMMListHead vram_head;
     unsigned long size;
+
+    /**
+     * Statistics, see __mos_gem_dump_bo_cache_xe
+     */
+    uint64_t hits;          // allocations served from the cache
+    uint64_t misses;        // allocations that had to create a new bo
+    uint64_t evictions;     // cached bo released by trim
+    uint32_t cached_count;  // bo currently held in the cache
+    uint64_t cached_bytes;  // bytes currently held in the cache
 };
 
 struct mos_xe_bucket_lab {
@@ -187,6 +199,28 @@ struct mos_xe_bucket_lab {
     uint64_t                    max_cache_size;
     uint8_t                     cache_mode;
     bool                        enable_bo_reuse;
+
+/**
+ * Cached bo older than this (in seconds) are released on the next trim
+ */
+#define    BO_CACHE_EXPIRE_TIME_DEFAULT   2
+/**
+ * Default limit of cached bytes per memory class: 0 keeps bo reuse off.
+ * bo reuse is opt-in by env INTEL_XE_BO_CACHE_SIZE (in MB), e.g. INTEL_XE_BO_CACHE_SIZE=256
+ */
+#define    BO_CACHE_MAX_BYTES_DEFAULT     0
+/**
+ * Max cached bo inspected (busy/compatibility check) per allocation
+ */
+#define    BO_CACHE_MAX_PROBES            4
+    /**
+     * Cached bo of all buckets, oldest first, indexed by mos_xe_mem_class
+     */
+    drmMMListHead               lru_head[MOS_XE_MEM_CLASS_MAX];
+    uint64_t                    cached_bytes[MOS_XE_MEM_CLASS_MAX];
+    uint64_t                    max_cached_bytes[MOS_XE_MEM_CLASS_MAX];
+    time_t                      expire_time;
+    time_t                      last_trim_time;
 };
 
 typedef struct mos_xe_bufmgr_gem {
@@ -426,6 +460,30 @@ typedef struct mos_xe_bo_gem {
      */
     std::map<uint32_t, struct mos_xe_bo_dep> write_deps;
 
+    /**
+     * Boolean of whether this bo could be put into bo cache when released;
+     * false for scanout surfaces and bo out of any cache bucket.
+     */
+    bool reusable;
+    /**
+     * Bucket holding this bo while it is in the bo cache, nullptr otherwise
+     */
+    struct mos_xe_gem_bo_bucket *cache_bucket;
+    /**
+     * Links in bucket list and memory class lru list while it is in the bo cache
+     */
+    drmMMListHead bucket_list;
+    drmMMListHead lru_list;
+    /**
+     * Time (in seconds, monotonic) when this bo was put into the bo cache
+     */
+    time_t free_time;
+    /**
+     * Deps of the last use while this bo is in the bo cache, pair of dummy EXEC_QUEUE_ID and mos_xe_bo_dep.
+     * read_deps and write_deps are cleared on cache put, so a reused bo starts without stale deps.
+     */
+    std::map<uint32_t, struct mos_xe_bo_dep> cache_deps;
+
 } mos_xe_bo_gem;
 
 struct mos_xe_external_bo_info {
@@ -452,6 +510,7 @@ int mos_query_engines_xe(struct mos_bufmgr *bufmgr,
                       unsigned int *nengine,
                       void *engine_map);
 static void mos_gem_bo_wait_rendering_xe(struct mos_linux_bo *bo);
+static int mos_gem_bo_busy_xe(struct mos_linux_bo *bo);
 
 static struct mos_xe_gem_bo_bucket*
 __mos_gem_find_bucket_xe(
@@ -786,6 +845,411 @@ __mos_bo_mark_mmaps_incoherent_xe(struct mos_linux_bo *bo)
 #endif
 }
 
+static inline int
+__mos_bo_cache_mem_class_xe(int mem_region)
+{
+    return MEMZONE_DEVICE == mem_region ? MOS_XE_MEM_CLASS_VRAM : MOS_XE_MEM_CLASS_SYSMEM;
+}
+
+static inline drmMMListHead *
+__mos_bo_cache_bucket_head_xe(struct mos_xe_gem_bo_bucket *bucket, int mem_class)
+{
+    return MOS_XE_MEM_CLASS_VRAM == mem_class ? &bucket->vram_head : &bucket->sys_head;
+}
+
+/**
+ * Remove a bo from the bo cache: both bucket list and memory class lru list.
+ * Caller must hold bufmgr_gem->m_lock.
+ */
+static void
+__mos_bo_cache_remove_xe(struct mos_xe_bufmgr_gem *bufmgr_gem, struct mos_xe_bo_gem *bo_gem)
+{
+    struct mos_xe_bucket_lab *lab = &bufmgr_gem->bucket_lab;
+    struct mos_xe_gem_bo_bucket *bucket = bo_gem->cache_bucket;
+    int mem_class = __mos_bo_cache_mem_class_xe(bo_gem->mem_region);
+
+    DRMLISTDELINIT(&bo_gem->bucket_list);
+    DRMLISTDELINIT(&bo_gem->lru_list);
+
+    bucket->cached_count--;
+    bucket->cached_bytes -= bo_gem->bo.size;
+    lab->cached_bytes[mem_class] -= bo_gem->bo.size;
+    bo_gem->cache_bucket = nullptr;
+}
+
+/**
+ * Add a bo to the tail of its bucket list and memory class lru list.
+ * Caller must hold bufmgr_gem->m_lock.
+ */
+static void
+__mos_bo_cache_add_xe(struct mos_xe_bufmgr_gem *bufmgr_gem,
+            struct mos_xe_bo_gem *bo_gem,
+            struct mos_xe_gem_bo_bucket *bucket,
+            time_t time)
+{
+    struct mos_xe_bucket_lab *lab = &bufmgr_gem->bucket_lab;
+    int mem_class = __mos_bo_cache_mem_class_xe(bo_gem->mem_region);
+
+    bo_gem->free_time = time;
+    bo_gem->cache_bucket = bucket;
+    DRMLISTADDTAIL(&bo_gem->bucket_list, __mos_bo_cache_bucket_head_xe(bucket, mem_class));
+    DRMLISTADDTAIL(&bo_gem->lru_list, &lab->lru_head[mem_class]);
+
+    bucket->cached_count++;
+    bucket->cached_bytes += bo_gem->bo.size;
+    lab->cached_bytes[mem_class] += bo_gem->bo.size;
+}
+
+/**
+ * Wait for the deps a bo had when it was put into the bo cache.
+ * Deps on exec_queue destroyed since then are skipped, their timeline syncobj is gone.
+ * Caller must not hold bufmgr_gem->m_lock, the syncobj wait runs without it.
+ *
+ * @timeout_nsec 0 to check busy state, return -ETIME immediately if busy.
+ * @return 0 if all deps are signaled, and cache_deps is cleared then.
+ */
+static int
+__mos_bo_cache_wait_xe(struct mos_xe_bufmgr_gem *bufmgr_gem,
+            struct mos_xe_bo_gem *bo_gem,
+            int64_t timeout_nsec)
+{
+    int ret = MOS_XE_SUCCESS;
+    std::map<uint32_t, uint64_t> timeline_data; //pair(syncobj, point)
+    std::map<uint32_t, struct mos_xe_bo_dep> no_write_deps;
+    std::vector<uint32_t> handles;
+    std::vector<uint64_t> points;
+    std::set<uint32_t> exec_queue_ids;
+
+    if (bo_gem->cache_deps.empty())
+    {
+        return MOS_XE_SUCCESS;
+    }
+
+    bufmgr_gem->m_lock.lock();
+    bufmgr_gem->sync_obj_rw_lock.lock_shared();
+    MOS_XE_GET_KEYS_FROM_MAP(bufmgr_gem->global_ctx_info, exec_queue_ids);
+
+    // cache_deps are merged read and write deps, pass them as read deps of a write wait
+    mos_sync_get_bo_wait_timeline_deps(exec_queue_ids,
+                bo_gem->cache_deps,
+                no_write_deps,
+                timeline_data,
+                INVALID_EXEC_QUEUE_ID,
+                EXEC_OBJECT_WRITE_XE);
+    bufmgr_gem->m_lock.unlock();
+
+    for (auto it : timeline_data)
+    {
+        handles.push_back(it.first);
+        points.push_back(it.second);
+    }
+
+    if (handles.size() > 0)
+    {
+        ret = mos_sync_syncobj_timeline_wait(bufmgr_gem->fd,
+                        handles.data(),
+                        points.data(),
+                        handles.size(),
+                        timeout_nsec,
+                        DRM_SYNCOBJ_WAIT_FLAGS_WAIT_ALL,
+                        nullptr);
+    }
+    bufmgr_gem->sync_obj_rw_lock.unlock_shared();
+
+    if (MOS_XE_SUCCESS == ret)
+    {
+        bo_gem->cache_deps.clear();
+    }
+
+    return ret;
+}
+
+/**
+ * Trim the bo cache: release the oldest bo of each memory class while the class is
+ * over its byte limit (pressure), and bo cached longer than lab->expire_time (time based,
+ * checked once per second). With force, the whole cache is released.
+ *
+ * Trimmed bo are moved to @release_list, caller must free them by __mos_bo_cache_release_xe
+ * after dropping the lock since freeing waits for rendering.
+ * Caller must hold bufmgr_gem->m_lock.
+ */
+static void
+__mos_bo_cache_trim_xe(struct mos_xe_bufmgr_gem *bufmgr_gem,
+            time_t time,
+            bool force,
+            drmMMListHead *release_list)
+{
+    struct mos_xe_bucket_lab *lab = &bufmgr_gem->bucket_lab;
+    bool check_expire = force || lab->last_trim_time != time;
+
+    for (int mem_class = 0; mem_class < MOS_XE_MEM_CLASS_MAX; mem_class++)
+    {
+        drmMMListHead *lru = &lab->lru_head[mem_class];
+
+        while (!DRMLISTEMPTY(lru))
+        {
+            struct mos_xe_bo_gem *bo_gem = DRMLISTENTRY(struct mos_xe_bo_gem, lru->next, lru_list);
+
+            if (!force
+                && lab->cached_bytes[mem_class] <= lab->max_cached_bytes[mem_class]
+                && (!check_expire || time - bo_gem->free_time <= lab->expire_time))
+            {
+                break;
+            }
+
+            bo_gem->cache_bucket->evictions++;
+            __mos_bo_cache_remove_xe(bufmgr_gem, bo_gem);
+            DRMLISTADDTAIL(&bo_gem->lru_list, release_list);
+        }
+    }
+
+    if (check_expire)
+    {
+        lab->last_trim_time = time;
+    }
+}
+
+static void
+__mos_bo_cache_release_xe(drmMMListHead *release_list)
+{
+    while (!DRMLISTEMPTY(release_list))
+    {
+        struct mos_xe_bo_gem *bo_gem = DRMLISTENTRY(struct mos_xe_bo_gem, release_list->next, lru_list);
+
+        DRMLISTDELINIT(&bo_gem->lru_list);
+        // read_deps and write_deps were cleared on cache put, wait for the saved ones before unbind
+        __mos_bo_cache_wait_xe((struct mos_xe_bufmgr_gem *)bo_gem->bo.bufmgr, bo_gem, INT64_MAX);
+        mos_bo_free_xe(&bo_gem->bo);
+    }
+}
+
+/**
+ * Put a released bo into the bo cache instead of closing it.
+ * The bo keeps its gem handle, vm binding and cpu mapping for reuse.
+ *
+ * @return true if the bo is cached, false if caller should free it.
+ */
+static bool
+__mos_bo_cache_put_xe(struct mos_linux_bo *bo)
+{
+    struct mos_xe_bufmgr_gem *bufmgr_gem = (struct mos_xe_bufmgr_gem *) bo->bufmgr;
+    struct mos_xe_bo_gem *bo_gem = (struct mos_xe_bo_gem *) bo;
+    struct mos_xe_bucket_lab *lab = nullptr;
+    struct mos_xe_gem_bo_bucket *bucket = nullptr;
+    struct timespec time;
+    drmMMListHead release_list;
+    int mem_class;
+
+    if (nullptr == bufmgr_gem)
+    {
+        return false;
+    }
+
+    lab = &bufmgr_gem->bucket_lab;
+    mem_class = __mos_bo_cache_mem_class_xe(bo_gem->mem_region);
+    if (!lab->enable_bo_reuse
+        || !bo_gem->reusable
+        || bo_gem->is_userptr
+        || bo_gem->is_imported
+        || bo_gem->is_exported
+        || bo->vm_id == INVALID_VM
+        || bo->size > lab->max_cached_bytes[mem_class])
+    {
+        return false;
+    }
+
+    DRMINITLISTHEAD(&release_list);
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    bufmgr_gem->m_lock.lock();
+
+    bucket = __mos_gem_find_bucket_xe(lab->cache_buckets, lab->num_buckets, bo->size);
+    if (nullptr == bucket || bucket->size != bo->size)
+    {
+        bufmgr_gem->m_lock.unlock();
+        return false;
+    }
+
+    /**
+     * Move the deps of the last use aside: a reused bo must not carry them into its
+     * next exec, while the cache still needs them for busy check and release.
+     */
+    bo_gem->cache_deps = bo_gem->read_deps;
+    if (bo_gem->write_deps.count(bo_gem->last_exec_write_exec_queue) > 0
+        && bo_gem->write_deps[bo_gem->last_exec_write_exec_queue].dep)
+    {
+        struct mos_xe_bo_dep &write_dep = bo_gem->write_deps[bo_gem->last_exec_write_exec_queue];
+        struct mos_xe_bo_dep &cache_dep = bo_gem->cache_deps[bo_gem->last_exec_write_exec_queue];
+
+        if (nullptr == cache_dep.dep || cache_dep.exec_timeline_index < write_dep.exec_timeline_index)
+        {
+            cache_dep = write_dep;
+        }
+    }
+    bo_gem->read_deps.clear();
+    bo_gem->write_deps.clear();
+    bo_gem->last_exec_read_exec_queue = INVALID_EXEC_QUEUE_ID;
+    bo_gem->last_exec_write_exec_queue = INVALID_EXEC_QUEUE_ID;
+    bo_gem->exec_list.clear();
+
+    __mos_bo_cache_add_xe(bufmgr_gem, bo_gem, bucket, time.tv_sec);
+
+    __mos_bo_cache_trim_xe(bufmgr_gem, time.tv_sec, false, &release_list);
+
+    bufmgr_gem->m_lock.unlock();
+
+    __mos_bo_cache_release_xe(&release_list);
+
+    return true;
+}
+
+/**
+ * Get an idle bo with compatible attributes from the bo cache.
+ * Only the oldest BO_CACHE_MAX_PROBES compatible bo of the bucket are inspected, since
+ * creating a new bo is cheaper than searching through busy ones.
+ * The candidates are taken out of the cache under m_lock and probed for busy
+ * without it, busy ones go back to the tail of the cache.
+ *
+ * @return cached bo removed from the cache, nullptr on miss.
+ */
+static struct mos_xe_bo_gem *
+__mos_bo_cache_get_xe(struct mos_xe_bufmgr_gem *bufmgr_gem,
+            struct mos_xe_gem_bo_bucket *bucket,
+            int mem_region,
+            uint16_t cpu_caching,
+            uint16_t pat_index,
+            uint32_t alignment)
+{
+    struct mos_xe_bo_gem *bo_gem = nullptr;
+    struct mos_xe_bo_gem *candidates[BO_CACHE_MAX_PROBES];
+    drmMMListHead *head = __mos_bo_cache_bucket_head_xe(bucket, __mos_bo_cache_mem_class_xe(mem_region));
+    drmMMListHead *list = nullptr;
+    drmMMListHead release_list;
+    struct timespec time;
+    int count = 0;
+
+    DRMINITLISTHEAD(&release_list);
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    bufmgr_gem->m_lock.lock();
+
+    for (list = head->next; list != head && count < BO_CACHE_MAX_PROBES;)
+    {
+        struct mos_xe_bo_gem *entry = DRMLISTENTRY(struct mos_xe_bo_gem, list, bucket_list);
+
+        list = list->next;
+        if (entry->cpu_caching != cpu_caching
+            || entry->pat_index != pat_index
+            || (alignment && entry->bo.offset64 % alignment))
+        {
+            continue;
+        }
+
+        __mos_bo_cache_remove_xe(bufmgr_gem, entry);
+        candidates[count++] = entry;
+    }
+
+    bufmgr_gem->m_lock.unlock();
+
+    for (int i = 0; i < count && nullptr == bo_gem; i++)
+    {
+        if (MOS_XE_SUCCESS == __mos_bo_cache_wait_xe(bufmgr_gem, candidates[i], 0))
+        {
+            bo_gem = candidates[i];
+        }
+    }
+
+    bufmgr_gem->m_lock.lock();
+
+    for (int i = 0; i < count; i++)
+    {
+        if (candidates[i] != bo_gem)
+        {
+            __mos_bo_cache_add_xe(bufmgr_gem, candidates[i], bucket, time.tv_sec);
+        }
+    }
+
+    if (bo_gem)
+    {
+        bucket->hits++;
+    }
+    else
+    {
+        bucket->misses++;
+    }
+
+    //Note: also trim on allocation, so stale bo do not stay when nothing is released for a long time.
+    __mos_bo_cache_trim_xe(bufmgr_gem, time.tv_sec, false, &release_list);
+
+    bufmgr_gem->m_lock.unlock();
+
+    __mos_bo_cache_release_xe(&release_list);
+
+    return bo_gem;
+}
+
+/**
+ * Release all bo in the bo cache, e.g. before bucket sizes change or bufmgr destroy.
+ */
+static void
+__mos_bo_cache_purge_xe(struct mos_xe_bufmgr_gem *bufmgr_gem)
+{
+    drmMMListHead release_list;
+
+    DRMINITLISTHEAD(&release_list);
+
+    bufmgr_gem->m_lock.lock();
+    __mos_bo_cache_trim_xe(bufmgr_gem, 0, true, &release_list);
+    bufmgr_gem->m_lock.unlock();
+
+    __mos_bo_cache_release_xe(&release_list);
+}
+
+/**
+ * Dump bo cache statistics per bucket.
+ * Enabled by env "export INTEL_XE_BUFMGR_DEBUG=2" (XE_DEBUG_BO_CACHE) in debug or release internal version.
+ */
+static void
+__mos_gem_dump_bo_cache_xe(struct mos_xe_bufmgr_gem *bufmgr_gem)
+{
+#if (_DEBUG || _RELEASE_INTERNAL)
+    if (__XE_TEST_DEBUG(XE_DEBUG_BO_CACHE))
+    {
+        struct mos_xe_bucket_lab *lab = &bufmgr_gem->bucket_lab;
+        uint64_t hits = 0, misses = 0, evictions = 0;
+
+        bufmgr_gem->m_lock.lock();
+        for (int i = 0; i < lab->num_buckets; i++)
+        {
+            struct mos_xe_gem_bo_bucket *bucket = &lab->cache_buckets[i];
+
+            hits += bucket->hits;
+            misses += bucket->misses;
+            evictions += bucket->evictions;
+            if (bucket->hits || bucket->misses || bucket->cached_count)
+            {
+                MOS_DRM_NORMALMESSAGE("bo cache bucket %lu: hits %lu, misses %lu, evictions %lu, cached %u (%lu bytes)",
+                            bucket->size,
+                            bucket->hits,
+                            bucket->misses,
+                            bucket->evictions,
+                            bucket->cached_count,
+                            bucket->cached_bytes);
+            }
+        }
+        MOS_DRM_NORMALMESSAGE("bo cache total: hits %lu, misses %lu, evictions %lu, sys %lu/%lu bytes, vram %lu/%lu bytes",
+                    hits,
+                    misses,
+                    evictions,
+                    lab->cached_bytes[MOS_XE_MEM_CLASS_SYSMEM],
+                    lab->max_cached_bytes[MOS_XE_MEM_CLASS_SYSMEM],
+                    lab->cached_bytes[MOS_XE_MEM_CLASS_VRAM],
+                    lab->max_cached_bytes[MOS_XE_MEM_CLASS_VRAM]);
+        bufmgr_gem->m_lock.unlock();
+    }
+#endif
+}
+
 static inline void
 mos_bo_reference_xe(struct mos_linux_bo *bo)
 {
@@ -813,7 +1277,10 @@ drm_export void mos_bo_unreference_xe(struct mos_linux_bo *bo)
 
         DRMLISTDEL(&bo_gem->name_list);
 
-        mos_bo_free_xe(bo);
+        if (!__mos_bo_cache_put_xe(bo))
+        {
+            mos_bo_free_xe(bo);
+        }
     }
 }
 
@@ -1306,33 +1773,21 @@ mos_bo_alloc_xe(struct mos_bufmgr *bufmgr,
     struct mos_xe_gem_bo_bucket *bucket = nullptr;
     int ret;
 
-    /**
-     * Note: must use MOS_New to allocate buffer instead of malloc since mos_xe_bo_gem
-     * contains std::vector and std::map. Otherwise both will have no instance.
-     */
-    bo_gem = MOS_New(mos_xe_bo_gem);
-    MOS_DRM_CHK_NULL_RETURN_VALUE(bo_gem, nullptr)
-    memclear(bo_gem->bo);
-    bo_gem->is_exported = false;
-    bo_gem->is_imported = false;
-    bo_gem->is_userptr = false;
-    bo_gem->last_exec_read_exec_queue = INVALID_EXEC_QUEUE_ID;
-    bo_gem->last_exec_write_exec_queue = INVALID_EXEC_QUEUE_ID;
-    atomic_set(&bo_gem->map_count, 0);
-    bo_gem->mem_virtual = nullptr;
-    bo_gem->mem_region = MEMZONE_SYS;
+    int mem_region = MEMZONE_SYS;
+    uint16_t pat_index = alloc->ext.pat_index == PAT_INDEX_INVALID ? 0 : alloc->ext.pat_index;
+
     bo_align = MAX(alloc->alignment, bufmgr_gem->default_alignment[MOS_XE_MEM_CLASS_SYSMEM]);
 
     if (bufmgr_gem->has_vram &&
             (MOS_MEMPOOL_VIDEOMEMORY == alloc->ext.mem_type || MOS_MEMPOOL_DEVICEMEMORY == alloc->ext.mem_type))
     {
-        bo_gem->mem_region = MEMZONE_DEVICE;
+        mem_region = MEMZONE_DEVICE;
         bo_align = MAX(alloc->alignment, bufmgr_gem->default_alignment[MOS_XE_MEM_CLASS_VRAM]);
         alloc->ext.cpu_cacheable = false;
     }
 
     memclear(create);
-    if (MEMZONE_DEVICE == bo_gem->mem_region)
+    if (MEMZONE_DEVICE == mem_region)
     {
         //Note: memory_region is related to gt_id for multi-tiles gpu, take gt_id into consideration in case of multi-tiles
         create.placement = bufmgr_gem->mem_regions_mask & (~0x1);
@@ -1372,6 +1827,49 @@ mos_bo_alloc_xe(struct mos_bufmgr *bufmgr,
         create.flags |= DRM_XE_GEM_CREATE_FLAG_SCANOUT;
     }
 
+    /**
+     * Get a bo out of the bo cache if available;
+     * it keeps gem handle, vm binding and cpu mapping from its last use.
+     */
+    if (bucket && lab->enable_bo_reuse && !alloc->ext.scanout_surf)
+    {
+        bo_gem = __mos_bo_cache_get_xe(bufmgr_gem, bucket, mem_region, create.cpu_caching, pat_index, bo_align);
+        if (bo_gem)
+        {
+            bo_gem->is_exported = false;
+            bo_gem->bo.align = bo_align;
+            atomic_set(&bo_gem->map_count, 0);
+            DRMINITLISTHEAD(&bo_gem->name_list);
+            memcpy(bo_gem->name, alloc->name, (strlen(alloc->name) + 1) > MAX_NAME_SIZE ? MAX_NAME_SIZE : (strlen(alloc->name) + 1));
+            atomic_set(&bo_gem->ref_count, 1);
+
+            MOS_DRM_NORMALMESSAGE("buf %d (%s) %ldb, bo:0x%lx from bo cache",
+                bo_gem->gem_handle, alloc->name, alloc->size, (uint64_t)&bo_gem->bo);
+
+            return &bo_gem->bo;
+        }
+    }
+
+    /**
+     * Note: must use MOS_New to allocate buffer instead of malloc since mos_xe_bo_gem
+     * contains std::vector and std::map. Otherwise both will have no instance.
+     */
+    bo_gem = MOS_New(mos_xe_bo_gem);
+    MOS_DRM_CHK_NULL_RETURN_VALUE(bo_gem, nullptr)
+    memclear(bo_gem->bo);
+    bo_gem->is_exported = false;
+    bo_gem->is_imported = false;
+    bo_gem->is_userptr = false;
+    bo_gem->last_exec_read_exec_queue = INVALID_EXEC_QUEUE_ID;
+    bo_gem->last_exec_write_exec_queue = INVALID_EXEC_QUEUE_ID;
+    atomic_set(&bo_gem->map_count, 0);
+    bo_gem->mem_virtual = nullptr;
+    bo_gem->mem_region = mem_region;
+    bo_gem->reusable = bucket != nullptr && !alloc->ext.scanout_surf;
+    bo_gem->cache_bucket = nullptr;
+    DRMINITLISTHEAD(&bo_gem->bucket_list);
+    DRMINITLISTHEAD(&bo_gem->lru_list);
+
     ret = drmIoctl(bufmgr_gem->fd,
         DRM_IOCTL_XE_GEM_CREATE,
         &create);
@@ -1388,7 +1886,7 @@ mos_bo_alloc_xe(struct mos_bufmgr *bufmgr,
     /**
      * Note: Better to get a default pat_index to overwite invalid argv. Normally it should not happen.
      */
-    bo_gem->pat_index = alloc->ext.pat_index == PAT_INDEX_INVALID ? 0 : alloc->ext.pat_index;
+    bo_gem->pat_index = pat_index;
 
     if (bufmgr_gem->mem_profiler_fd != -1)
     {
@@ -2014,6 +2512,205 @@ mos_gem_bo_wait_xe(struct mos_linux_bo *bo, int64_t timeout_ns)
     return 0;
 }
 
+/**
+ * Collect the timeline deps of all bos, keeping the max point per syncobj.
+ * Caller must hold m_lock and sync_obj_rw_lock in shared mode, taken in that
+ * order like the other waiters.
+ */
+static void
+__mos_gem_bo_get_timeline_deps_multi_xe(struct mos_xe_bufmgr_gem *bufmgr_gem,
+            struct mos_linux_bo **bos,
+            int count,
+            uint32_t rw_flags,
+            std::map<uint32_t, uint64_t> &timeline_data)
+{
+    std::map<uint32_t, uint64_t> bo_timeline_data;
+    std::set<uint32_t> exec_queue_ids;
+
+    timeline_data.clear();
+    MOS_XE_GET_KEYS_FROM_MAP(bufmgr_gem->global_ctx_info, exec_queue_ids);
+    for (int i = 0; i < count; i++)
+    {
+        mos_xe_bo_gem *bo_gem = (mos_xe_bo_gem *)bos[i];
+        mos_sync_get_bo_wait_timeline_deps(exec_queue_ids,
+                    bo_gem->read_deps,
+                    bo_gem->write_deps,
+                    bo_timeline_data,
+                    bo_gem->last_exec_write_exec_queue,
+                    rw_flags);
+        for (auto it : bo_timeline_data)
+        {
+            if (timeline_data[it.first] < it.second)
+            {
+                timeline_data[it.first] = it.second;
+            }
+        }
+    }
+}
+
+/**
+ * Wait for the rendering of several bos with one syncobj timeline wait.
+ *
+ * @timeout_ns indicates to relative timeout:
+ *     if timeout_ns < 0, wait until all bos are idle;
+ *     if timeout_ns == 0, check busy state of all bos and return -ETIME if any is busy;
+ *     if timeout_ns > 0, return -ETIME if any bo is still busy after timeout_ns.
+ */
+static int
+mos_gem_bo_wait_multi_xe(struct mos_linux_bo **bos, int count, int64_t timeout_ns)
+{
+    MOS_DRM_CHK_NULL_RETURN_VALUE(bos, -EINVAL)
+    MOS_DRM_CHK_NULL_RETURN_VALUE(bos[0], -EINVAL)
+    mos_xe_bufmgr_gem *bufmgr_gem = (mos_xe_bufmgr_gem *)bos[0]->bufmgr;
+    MOS_DRM_CHK_NULL_RETURN_VALUE(bufmgr_gem, -EINVAL)
+
+    int ret = MOS_XE_SUCCESS;
+    int64_t timeout_nsec = 0;
+    std::map<uint32_t, uint64_t> timeline_data; //pair(syncobj, point)
+    std::vector<uint32_t> handles;
+    std::vector<uint64_t> points;
+
+    if (timeout_ns < 0)
+    {
+        timeout_nsec = INT64_MAX;
+    }
+    else if (timeout_ns > 0)
+    {
+        // syncobj wait takes an absolute CLOCK_MONOTONIC time
+        struct timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        int64_t now = (int64_t)time.tv_sec * 1000000000LL + time.tv_nsec;
+        timeout_nsec = (timeout_ns > INT64_MAX - now) ? INT64_MAX : now + timeout_ns;
+    }
+
+    bufmgr_gem->m_lock.lock();
+    bufmgr_gem->sync_obj_rw_lock.lock_shared();
+    __mos_gem_bo_get_timeline_deps_multi_xe(bufmgr_gem,
+                bos,
+                count,
+                EXEC_OBJECT_READ_XE | EXEC_OBJECT_WRITE_XE,
+                timeline_data);
+    bufmgr_gem->m_lock.unlock();
+
+    for (auto it : timeline_data)
+    {
+        handles.push_back(it.first);
+        points.push_back(it.second);
+    }
+
+    if (handles.size() > 0)
+    {
+        ret = mos_sync_syncobj_timeline_wait(bufmgr_gem->fd,
+                        handles.data(),
+                        points.data(),
+                        handles.size(),
+                        timeout_nsec,
+                        DRM_SYNCOBJ_WAIT_FLAGS_WAIT_ALL,
+                        nullptr);
+        if (ret)
+        {
+            ret = -errno;
+        }
+    }
+    bufmgr_gem->sync_obj_rw_lock.unlock_shared();
+
+    return ret;
+}
+
+/**
+ * Export a sync file which signals once all pending deps of the bo signal.
+ *
+ * Each dep is transferred to its own point of a temporary timeline syncobj.
+ * The fence of the last point is a fence chain which only signals after all
+ * previous points, so converting that point to a binary syncobj gives a
+ * single fence covering all deps.
+ */
+static int
+mos_gem_bo_export_sync_fd_xe(struct mos_linux_bo *bo, int *sync_fd)
+{
+    MOS_DRM_CHK_NULL_RETURN_VALUE(bo, -EINVAL)
+    MOS_DRM_CHK_NULL_RETURN_VALUE(sync_fd, -EINVAL)
+    mos_xe_bufmgr_gem *bufmgr_gem = (mos_xe_bufmgr_gem *)bo->bufmgr;
+    MOS_DRM_CHK_NULL_RETURN_VALUE(bufmgr_gem, -EINVAL)
+
+    int ret = MOS_XE_SUCCESS;
+    int timeline_syncobj = INVALID_HANDLE;
+    int binary_syncobj = INVALID_HANDLE;
+    uint64_t point = 0;
+    std::map<uint32_t, uint64_t> timeline_data; //pair(syncobj, point)
+
+    bufmgr_gem->m_lock.lock();
+    bufmgr_gem->sync_obj_rw_lock.lock_shared();
+    __mos_gem_bo_get_timeline_deps_multi_xe(bufmgr_gem,
+                &bo,
+                1,
+                EXEC_OBJECT_READ_XE | EXEC_OBJECT_WRITE_XE,
+                timeline_data);
+    bufmgr_gem->m_lock.unlock();
+
+    if (timeline_data.empty())
+    {
+        // Nothing pending, export an already signaled fence.
+        binary_syncobj = mos_sync_syncobj_create(bufmgr_gem->fd, DRM_SYNCOBJ_CREATE_SIGNALED);
+    }
+    else
+    {
+        timeline_syncobj = mos_sync_syncobj_create(bufmgr_gem->fd, 0);
+        binary_syncobj = mos_sync_syncobj_create(bufmgr_gem->fd, 0);
+        if (timeline_syncobj > 0 && binary_syncobj > 0)
+        {
+            for (auto it : timeline_data)
+            {
+                ret = __mos_sync_syncobj_transfer(bufmgr_gem->fd,
+                            timeline_syncobj, ++point,
+                            it.first, it.second,
+                            0);
+                if (ret)
+                {
+                    ret = -errno;
+                    break;
+                }
+            }
+            if (MOS_XE_SUCCESS == ret)
+            {
+                ret = mos_sync_syncobj_timeline_to_binary(bufmgr_gem->fd,
+                            binary_syncobj, timeline_syncobj, point, 0);
+                if (ret)
+                {
+                    ret = -errno;
+                }
+            }
+        }
+    }
+    bufmgr_gem->sync_obj_rw_lock.unlock_shared();
+
+    if (binary_syncobj <= 0 || (timeline_data.size() > 0 && timeline_syncobj <= 0))
+    {
+        MOS_DRM_ASSERTMESSAGE("failed to create syncobj for sync fd export");
+        ret = -ENOMEM;
+    }
+
+    if (MOS_XE_SUCCESS == ret)
+    {
+        *sync_fd = mos_sync_syncobj_handle_to_syncfile_fd(bufmgr_gem->fd, binary_syncobj);
+        if (*sync_fd < 0)
+        {
+            ret = -errno;
+        }
+    }
+
+    if (timeline_syncobj > 0)
+    {
+        mos_sync_syncobj_destroy(bufmgr_gem->fd, timeline_syncobj);
+    }
+    if (binary_syncobj > 0)
+    {
+        mos_sync_syncobj_destroy(bufmgr_gem->fd, binary_syncobj);
+    }
+
+    return ret;
+}
+
 /**
  * Map gpu resource for CPU read or write.
  *
@@ -2966,7 +3663,12 @@ mos_query_device_blob_xe(struct mos_bufmgr *bufmgr, MEDIA_SYSTEM_INFO* gfx_info)
 static void
 mos_enable_reuse_xe(struct mos_bufmgr *bufmgr)
 {
-    MOS_UNIMPLEMENT(bufmgr);
+    MOS_DRM_CHK_NULL_NO_STATUS_RETURN(bufmgr)
+    struct mos_xe_bufmgr_gem *bufmgr_gem = (struct mos_xe_bufmgr_gem *)bufmgr;
+    struct mos_xe_bucket_lab *lab = &bufmgr_gem->bucket_lab;
+
+    //Note: bo reuse stays off unless env INTEL_XE_BO_CACHE_SIZE sets a cache size.
+    lab->enable_bo_reuse = lab->max_cached_bytes[MOS_XE_MEM_CLASS_SYSMEM] > 0;
 }
 
 // The function is not supported on KMD
@@ -3088,6 +3790,10 @@ mos_bufmgr_gem_destroy_xe(struct mos_bufmgr *bufmgr)
     struct mos_xe_device *dev = &bufmgr_gem->xe_device;
     int i, ret;
 
+    /* Release bo kept in the bo cache before vm and vma heaps are gone. */
+    __mos_gem_dump_bo_cache_xe(bufmgr_gem);
+    __mos_bo_cache_purge_xe(bufmgr_gem);
+
     /* Release userptr bo kept hanging around for optimisation. */
 
     mos_vma_heap_finish(&bufmgr_gem->vma_heap[MEMZONE_SYS]);
@@ -3387,6 +4093,11 @@ __mos_gem_add_bucket_xe(struct mos_xe_bufmgr_gem *bufmgr_gem, int size)
         DRMINITLISTHEAD(&lab->cache_buckets[i].sys_head);
         DRMINITLISTHEAD(&lab->cache_buckets[i].vram_head);
         lab->cache_buckets[i].size = size;
+        lab->cache_buckets[i].hits = 0;
+        lab->cache_buckets[i].misses = 0;
+        lab->cache_buckets[i].evictions = 0;
+        lab->cache_buckets[i].cached_count = 0;
+        lab->cache_buckets[i].cached_bytes = 0;
         lab->num_buckets++;
     }
     else
@@ -3428,9 +4139,26 @@ __mos_gem_init_cache_buckets(struct mos_xe_bufmgr_gem *bufmgr_gem)
 {
     unsigned long size, max_cache_size = 64 * 1024 * 1024;
     struct mos_xe_bucket_lab *lab = &bufmgr_gem->bucket_lab;
+    int64_t bo_cache_size_mb = BO_CACHE_MAX_BYTES_DEFAULT / (1024 * 1024);
     lab->cache_mode = CACHE_BUCKET_MODE_DEFAULT;
     lab->max_cache_size = max_cache_size;
 
+    /* bo reuse is enabled later by mos_enable_reuse_xe */
+    lab->enable_bo_reuse = false;
+    lab->expire_time = BO_CACHE_EXPIRE_TIME_DEFAULT;
+    lab->last_trim_time = 0;
+    MOS_READ_ENV_VARIABLE(INTEL_XE_BO_CACHE_SIZE, MOS_USER_FEATURE_VALUE_TYPE_INT64, bo_cache_size_mb);
+    if (bo_cache_size_mb < 0)
+    {
+        bo_cache_size_mb = 0;
+    }
+    for (int mem_class = 0; mem_class < MOS_XE_MEM_CLASS_MAX; mem_class++)
+    {
+        DRMINITLISTHEAD(&lab->lru_head[mem_class]);
+        lab->cached_bytes[mem_class] = 0;
+        lab->max_cached_bytes[mem_class] = (uint64_t)bo_cache_size_mb * 1024 * 1024;
+    }
+
     /* OK, so power of two buckets was too wasteful of memory.
      * Give 3 other sizes between each power of two, to hopefully
      * cover things accurately enough.  (The alternative is
@@ -3458,6 +4186,9 @@ static void
 __mos_gem_cleanup_cache_bucket_xe(struct mos_xe_bufmgr_gem *bufmgr_gem)
 {
     struct mos_xe_bucket_lab *lab = &bufmgr_gem->bucket_lab;
+
+    //Note: cached bo point to their buckets, release them before buckets change.
+    __mos_bo_cache_purge_xe(bufmgr_gem);
     for (int i = 0; i < lab->num_buckets; i++) {
         struct mos_xe_gem_bo_bucket *bucket =
             &lab->cache_buckets[i];
@@ -3562,7 +4293,7 @@ mos_gem_realloc_cache_bucket_xe(struct mos_bufmgr *bufmgr, uint8_t alloc_mode)
  *
  * \param fd File descriptor of the opened DRM device.
  */
-struct mos_bufmgr *
+drm_export struct mos_bufmgr *
 mos_bufmgr_gem_init_xe(int fd, int batch_size)
 {
     //Note: don't put this field in bufmgr in case of bufmgr inaccessable in some functions
@@ -3611,6 +4342,8 @@ mos_bufmgr_gem_init_xe(int fd, int batch_size)
     bufmgr_gem->bufmgr.bo_busy = mos_gem_bo_busy_xe;
     bufmgr_gem->bufmgr.bo_wait_rendering = mos_gem_bo_wait_rendering_xe;
     bufmgr_gem->bufmgr.bo_wait = mos_gem_bo_wait_xe;
+    bufmgr_gem->bufmgr.bo_wait_multi = mos_gem_bo_wait_multi_xe;
+    bufmgr_gem->bufmgr.bo_export_sync_fd = mos_gem_bo_export_sync_fd_xe;
     bufmgr_gem->bufmgr.bo_map_wc = mos_bo_map_wc_xe;
     bufmgr_gem->bufmgr.bo_unmap = mos_bo_unmap_xe;
     bufmgr_gem->bufmgr.bo_unmap_wc = mos_bo_unmap_wc_xe;
@@ -402,6 +402,7 @@ MOS_STATUS GpuContextSpecificNextXe::EndSubmitCommandBuffer(
     m_currentNumPatchLocations = 0;
     MosUtilities::MosZeroMemory(m_patchLocationList, sizeof(PATCHLOCATIONLIST) * m_maxNumAllocations);
     m_resCount = 0;
+    ResetResourceIndex();
 
     MosUtilities::MosZeroMemory(m_writeModeList, sizeof(bool) * m_maxNumAllocations);
 
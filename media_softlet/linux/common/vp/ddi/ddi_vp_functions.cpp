@@ -581,20 +581,19 @@ VAStatus DdiVpFunctions::CreateConfig (
     auto configList = mediaCtx->m_capsNext->GetConfigList();
     DDI_VP_CHK_NULL(configList, "Get configList failed", VA_STATUS_ERROR_INVALID_PARAMETER);
 
-    for(int i = 0; i < configList->size(); i++)
+    // the first config of the profile and entrypoint is used for vp
+    auto configRange = mediaCtx->m_capsNext->m_capsTable->QueryConfigRange(profile, entrypoint);
+    if (configRange != nullptr && configRange->count != 0)
     {
-        if((configList->at(i).profile == profile) && (configList->at(i).entrypoint == entrypoint))
+        uint32_t curConfigID = ADD_CONFIG_ID_VP_OFFSET(configRange->first);
+        if(!mediaCtx->m_capsNext->m_capsTable->IsVpConfigId(curConfigID))
         {
-            uint32_t curConfigID = ADD_CONFIG_ID_VP_OFFSET(i);
-            if(!mediaCtx->m_capsNext->m_capsTable->IsVpConfigId(curConfigID))
-            {
-                 DDI_VP_ASSERTMESSAGE("DDI: Invalid configID.");
-                 return VA_STATUS_ERROR_INVALID_CONFIG;
-            }
-
-            *configId = curConfigID;
-            return VA_STATUS_SUCCESS;
+             DDI_VP_ASSERTMESSAGE("DDI: Invalid configID.");
+             return VA_STATUS_ERROR_INVALID_CONFIG;
         }
+
+        *configId = curConfigID;
+        return VA_STATUS_SUCCESS;
     }
 
     return VA_STATUS_ERROR_ATTR_NOT_SUPPORTED;